@@ -11,9 +11,15 @@
 #include <thread>
 #include <mutex>
 #include <memory>
+#include <algorithm>
 #include <limits>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
 
 #include "seal/seal.h"
+#include "seal/util/polyarithsmallmod.h"
 
 using namespace std;
 using namespace seal;
@@ -167,6 +173,12 @@ void example_bfv_performance();
 
 void example_ckks_performance();
 
+void example_serialization_performance();
+
+void example_context_startup_performance();
+
+void example_galois_performance();
+
 int main()
 {
 #ifdef SEAL_VERSION
@@ -184,6 +196,9 @@ int main()
         cout << " 7. CKKS Basics II" << endl;
         cout << " 8. CKKS Basics III" << endl;
         cout << " 9. CKKS Performance Test" << endl;
+        cout << "10. Serialization Performance Test" << endl;
+        cout << "11. Context Startup Performance Test" << endl;
+        cout << "12. Galois Automorphism Performance Test" << endl;
         cout << " 0. Exit" << endl;
 
         /*
@@ -244,6 +259,18 @@ int main()
             break;
         }
 
+        case 10:
+            example_serialization_performance();
+            break;
+
+        case 11:
+            example_context_startup_performance();
+            break;
+
+        case 12:
+            example_galois_performance();
+            break;
+
         case 0:
             return 0;
 
@@ -2354,6 +2381,41 @@ void example_bfv_performance()
         cout << "Average rotate rows random: " << avg_rotate_rows_random << " microseconds" << endl;
         cout << "Average rotate columns: " << avg_rotate_columns << " microseconds" << endl;
         cout.flush();
+
+        /*
+        [Batching Throughput]
+        Batching is very fast compared to the homomorphic operations, so we also
+        time it separately over many more iterations. The plaintext and the result
+        vector are allocated only once, so only the batching itself is measured.
+        */
+        int batch_count = 1000;
+        Plaintext plain(poly_modulus_degree, 0);
+        vector<uint64_t> pod_vector2(batch_encoder.slot_count());
+        time_start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < batch_count; i++)
+        {
+            batch_encoder.encode(pod_vector, plain);
+        }
+        time_end = chrono::high_resolution_clock::now();
+        auto time_batch_total = chrono::duration_cast<
+            chrono::microseconds>(time_end - time_start);
+        time_start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < batch_count; i++)
+        {
+            batch_encoder.decode(plain, pod_vector2);
+        }
+        time_end = chrono::high_resolution_clock::now();
+        auto time_unbatch_total = chrono::duration_cast<
+            chrono::microseconds>(time_end - time_start);
+        if (pod_vector2 != pod_vector)
+        {
+            throw runtime_error("Batch/unbatch failed. Something is wrong.");
+        }
+        cout << "Batching throughput: " << (batch_count * 1000000LL) /
+            max<long long>(time_batch_total.count(), 1) << " batches/second" << endl;
+        cout << "Unbatching throughput: " << (batch_count * 1000000LL) /
+            max<long long>(time_unbatch_total.count(), 1) << " unbatches/second" << endl;
+        cout.flush();
     };
 
     EncryptionParameters parms(scheme_type::BFV);
@@ -2662,3 +2724,446 @@ void example_ckks_performance()
     // parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(32768));
     // performance_test(SEALContext::Create(parms));
 }
+
+void example_serialization_performance()
+{
+    print_example_banner("Example: Serialization Performance Test");
+
+    /*
+    In this example we time saving and loading of the different objects with
+    each of the compression modes, and print the size of the result relative
+    to the size of the object in memory. Compression modes that are not
+    available in this build are skipped.
+    */
+    auto performance_test = [](auto context)
+    {
+        print_parameters(context);
+
+        KeyGenerator keygen(context);
+        auto public_key = keygen.public_key();
+        auto relin_keys = keygen.relin_keys(DefaultParams::dbc_max());
+        auto gal_keys = keygen.galois_keys(DefaultParams::dbc_max());
+        Encryptor encryptor(context, public_key);
+        Evaluator evaluator(context);
+        BatchEncoder batch_encoder(context);
+
+        /*
+        A batched plaintext of small values, a fresh ciphertext, and the same
+        ciphertext switched down to the last level.
+        */
+        vector<uint64_t> pod_vector(batch_encoder.slot_count());
+        for (size_t i = 0; i < pod_vector.size(); i++)
+        {
+            pod_vector[i] = i & 0xFF;
+        }
+        Plaintext plain;
+        batch_encoder.encode(pod_vector, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+        Ciphertext encrypted_last = encrypted;
+        evaluator.mod_switch_to_inplace(encrypted_last, context->last_parms_id());
+
+        auto key_byte_count = [](const auto &keys)
+        {
+            size_t uint64_count = 0;
+            for (auto &key_vector : keys.data())
+            {
+                for (auto &key : key_vector)
+                {
+                    uint64_count += key.uint64_count();
+                }
+            }
+            return uint64_count * sizeof(uint64_t);
+        };
+
+        /*
+        Saves and loads the object count times with every compression mode.
+        */
+        auto measure = [](const string &name, const auto &object, auto loaded,
+            size_t byte_count, int count)
+        {
+            for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz,
+                compr_mode_type::deflate })
+            {
+                if (!is_supported_compr_mode(compr_mode))
+                {
+                    continue;
+                }
+                string mode_name = (compr_mode == compr_mode_type::none) ? "none" :
+                    (compr_mode == compr_mode_type::lz) ? "lz" : "deflate";
+
+                chrono::microseconds time_save_sum(0);
+                chrono::microseconds time_load_sum(0);
+                string saved;
+                for (int i = 0; i < count; i++)
+                {
+                    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+                    auto time_start = chrono::high_resolution_clock::now();
+                    object.save(stream, compr_mode);
+                    auto time_end = chrono::high_resolution_clock::now();
+                    time_save_sum += chrono::duration_cast<
+                        chrono::microseconds>(time_end - time_start);
+                    saved = stream.str();
+
+                    time_start = chrono::high_resolution_clock::now();
+                    loaded.unsafe_load(stream);
+                    time_end = chrono::high_resolution_clock::now();
+                    time_load_sum += chrono::duration_cast<
+                        chrono::microseconds>(time_end - time_start);
+                }
+
+                /*
+                Throughput is given in terms of the size of the object in memory,
+                so the modes are directly comparable.
+                */
+                double total_mb = static_cast<double>(byte_count) * count / (1 << 20);
+                cout << setw(16) << left << name << setw(8) << mode_name << right
+                    << setw(10) << saved.size() << " bytes"
+                    << fixed << setprecision(2)
+                    << " (ratio " << static_cast<double>(byte_count) /
+                        static_cast<double>(saved.size()) << ")"
+                    << setprecision(0)
+                    << ", save " << total_mb * 1000000.0 /
+                        static_cast<double>(max<long long>(time_save_sum.count(), 1)) << " MB/s"
+                    << ", load " << total_mb * 1000000.0 /
+                        static_cast<double>(max<long long>(time_load_sum.count(), 1)) << " MB/s"
+                    << endl;
+                cout.unsetf(ios::fixed);
+            }
+        };
+
+        int count = 20;
+        measure("Plaintext", plain, Plaintext(),
+            plain.coeff_count() * sizeof(uint64_t), count);
+        measure("Ciphertext", encrypted, Ciphertext(),
+            encrypted.uint64_count() * sizeof(uint64_t), count);
+        measure("Ciphertext last", encrypted_last, Ciphertext(),
+            encrypted_last.uint64_count() * sizeof(uint64_t), count);
+        measure("PublicKey", public_key, PublicKey(),
+            public_key.data().uint64_count() * sizeof(uint64_t), count);
+        measure("RelinKeys", relin_keys, RelinKeys(), key_byte_count(relin_keys), 1);
+        measure("GaloisKeys", gal_keys, GaloisKeys(), key_byte_count(gal_keys), 1);
+
+        /*
+        Loading with validation against the context checks every coefficient
+        against its modulus. Data from trusted storage can instead be loaded
+        with trusted_load, which relies on the checksum stored with the data and
+        checks only the metadata.
+        */
+        auto measure_validation = [&context](const string &name, const auto &object,
+            auto loaded, int count)
+        {
+            stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+            object.save(stream);
+            string saved = stream.str();
+            chrono::microseconds time_load_sum(0);
+            chrono::microseconds time_trusted_load_sum(0);
+            for (int i = 0; i < count; i++)
+            {
+                stream.str(saved);
+                auto time_start = chrono::high_resolution_clock::now();
+                loaded.load(context, stream);
+                auto time_end = chrono::high_resolution_clock::now();
+                time_load_sum += chrono::duration_cast<
+                    chrono::microseconds>(time_end - time_start);
+
+                stream.str(saved);
+                time_start = chrono::high_resolution_clock::now();
+                loaded.trusted_load(context, stream);
+                time_end = chrono::high_resolution_clock::now();
+                time_trusted_load_sum += chrono::duration_cast<
+                    chrono::microseconds>(time_end - time_start);
+            }
+            cout << setw(16) << left << name << right
+                << "load " << time_load_sum.count() / count << " microseconds"
+                << ", trusted_load " << time_trusted_load_sum.count() / count
+                << " microseconds" << endl;
+        };
+        measure_validation("Ciphertext", encrypted, Ciphertext(), count);
+        measure_validation("RelinKeys", relin_keys, RelinKeys(), 5);
+        measure_validation("GaloisKeys", gal_keys, GaloisKeys(), 1);
+
+        /*
+        An application that sends objects over the network typically needs them
+        in a byte buffer. Going through a stringstream copies the data once into
+        the stream and once more out of it, and the same on the way back. With
+        save_size the buffer is allocated once at the exact size, and save and
+        load work on it directly.
+        */
+        auto measure_buffer = [](const string &name, const auto &object,
+            auto loaded, int count)
+        {
+            chrono::microseconds time_stream_sum(0);
+            chrono::microseconds time_buffer_sum(0);
+            for (int i = 0; i < count; i++)
+            {
+                auto time_start = chrono::high_resolution_clock::now();
+                {
+                    stringstream stream(ios_base::in | ios_base::out | ios_base::binary);
+                    object.save(stream);
+                    string saved = stream.str();
+                    vector<SEAL_BYTE> buffer(saved.size());
+                    memcpy(buffer.data(), saved.data(), saved.size());
+
+                    stringstream in_stream(string(reinterpret_cast<const char*>(
+                        buffer.data()), buffer.size()),
+                        ios_base::in | ios_base::binary);
+                    loaded.unsafe_load(in_stream);
+                }
+                auto time_end = chrono::high_resolution_clock::now();
+                time_stream_sum += chrono::duration_cast<
+                    chrono::microseconds>(time_end - time_start);
+
+                time_start = chrono::high_resolution_clock::now();
+                {
+                    vector<SEAL_BYTE> buffer(object.save_size());
+                    object.save(buffer.data(), buffer.size());
+                    loaded.unsafe_load(buffer.data(), buffer.size());
+                }
+                time_end = chrono::high_resolution_clock::now();
+                time_buffer_sum += chrono::duration_cast<
+                    chrono::microseconds>(time_end - time_start);
+            }
+            cout << setw(16) << left << name << right
+                << "round trip through stringstream "
+                << time_stream_sum.count() / count << " microseconds"
+                << ", through buffer " << time_buffer_sum.count() / count
+                << " microseconds" << endl;
+        };
+        measure_buffer("Ciphertext", encrypted, Ciphertext(), count);
+        measure_buffer("PublicKey", public_key, PublicKey(), count);
+        measure_buffer("RelinKeys", relin_keys, RelinKeys(), 5);
+        measure_buffer("GaloisKeys", gal_keys, GaloisKeys(), 1);
+
+        /*
+        Galois keys saved with save_mappable can instead be memory-mapped. This
+        only reads the metadata, so the time no longer depends on the key size,
+        and processes mapping the same file share its memory.
+        */
+        string path = "example_galois_keys.seal";
+        string mapped_path = "example_galois_keys_mapped.seal";
+        {
+            ofstream file(path, ios_base::binary);
+            gal_keys.save(file);
+            ofstream mapped_file(mapped_path, ios_base::binary);
+            gal_keys.save_mappable(mapped_file);
+        }
+        GaloisKeys loaded_keys;
+        auto time_start = chrono::high_resolution_clock::now();
+        {
+            ifstream file(path, ios_base::binary);
+            loaded_keys.unsafe_load(file);
+        }
+        auto time_end = chrono::high_resolution_clock::now();
+        auto time_load = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        time_start = chrono::high_resolution_clock::now();
+        loaded_keys.unsafe_load_mapped(mapped_path);
+        time_end = chrono::high_resolution_clock::now();
+        auto time_load_mapped = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        cout << "GaloisKeys load from file: " << time_load.count() << " microseconds" << endl;
+        cout << "GaloisKeys mapped load: " << time_load_mapped.count() << " microseconds" << endl;
+        loaded_keys = GaloisKeys();
+        remove(path.c_str());
+        remove(mapped_path.c_str());
+
+        /*
+        A worker evaluating a circuit that rotates only by 1 and 8 steps can load
+        just those two keys from a file saved with save_indexed.
+        */
+        {
+            ofstream file(path, ios_base::binary);
+            gal_keys.save_indexed(file);
+        }
+        time_start = chrono::high_resolution_clock::now();
+        {
+            ifstream file(path, ios_base::binary);
+            loaded_keys.load(context, file, vector<int>{ 1, 8 });
+        }
+        time_end = chrono::high_resolution_clock::now();
+        auto time_load_indexed = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        size_t all_key_bytes = key_byte_count(gal_keys);
+        size_t loaded_key_bytes = key_byte_count(loaded_keys);
+        cout << "GaloisKeys indexed load of " << loaded_keys.size() << " of "
+            << gal_keys.size() << " keys: " << time_load_indexed.count()
+            << " microseconds" << endl;
+        cout << "Memory saved per worker: " << (all_key_bytes - loaded_key_bytes) / 1024
+            << " KB of " << all_key_bytes / 1024 << " KB" << endl;
+        remove(path.c_str());
+
+        /*
+        KeyGenerator::save_galois_keys writes each Galois key to the stream as
+        soon as it is generated, so the full set of keys never has to be held
+        in memory before it is saved.
+        */
+        time_start = chrono::high_resolution_clock::now();
+        {
+            ofstream file(path, ios_base::binary);
+            keygen.galois_keys(DefaultParams::dbc_max()).save(file);
+        }
+        time_end = chrono::high_resolution_clock::now();
+        auto time_generate_save = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        time_start = chrono::high_resolution_clock::now();
+        {
+            ofstream file(path, ios_base::binary);
+            keygen.save_galois_keys(file, DefaultParams::dbc_max());
+        }
+        time_end = chrono::high_resolution_clock::now();
+        auto time_generate_streamed = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        cout << "GaloisKeys generate and save: " << time_generate_save.count()
+            << " microseconds, streamed: " << time_generate_streamed.count()
+            << " microseconds" << endl;
+        remove(path.c_str());
+
+        /*
+        Most of the time spent creating a SEALContext goes into NTT tables. A
+        saved SEALContext contains them, so restoring it only copies them.
+        */
+        time_start = chrono::high_resolution_clock::now();
+        auto created_context = SEALContext::Create(context->context_data()->parms());
+        time_end = chrono::high_resolution_clock::now();
+        auto time_create = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        vector<SEAL_BYTE> context_buffer(context->save_size());
+        context->save(context_buffer.data(), context_buffer.size());
+        time_start = chrono::high_resolution_clock::now();
+        auto loaded_context = SEALContext::Load(context_buffer.data(), context_buffer.size());
+        time_end = chrono::high_resolution_clock::now();
+        auto time_context_load = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+        cout << "SEALContext create: " << time_create.count() << " microseconds, load: "
+            << time_context_load.count() << " microseconds ("
+            << context_buffer.size() / 1024 << " KB)" << endl;
+        cout.flush();
+    };
+
+    EncryptionParameters parms(scheme_type::BFV);
+    parms.set_poly_modulus_degree(4096);
+    parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(4096));
+    parms.set_plain_modulus(786433);
+    performance_test(SEALContext::Create(parms));
+
+    cout << endl;
+    parms.set_poly_modulus_degree(8192);
+    parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(8192));
+    parms.set_plain_modulus(786433);
+    performance_test(SEALContext::Create(parms));
+}
+
+void example_context_startup_performance()
+{
+    print_example_banner("Example: Context Startup Performance Test");
+
+    /*
+    Creating a SEALContext generates NTT tables for every prime, and the
+    modulus switching chain needs them again at every level. SEALContext::Create
+    generates the tables of every prime once, on all hardware threads, and the
+    levels copy them. Here we compare it to using a single thread, and to
+    restoring a context saved with SEALContext::save.
+    */
+    for (size_t poly_modulus_degree : { 4096, 8192, 16384, 32768 })
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(poly_modulus_degree);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(poly_modulus_degree));
+        parms.set_plain_modulus(786433);
+
+        auto time_start = chrono::high_resolution_clock::now();
+        auto context = SEALContext::Create(parms, true, 1);
+        auto time_end = chrono::high_resolution_clock::now();
+        auto time_single = chrono::duration_cast<chrono::milliseconds>(time_end - time_start);
+        context.reset();
+
+        time_start = chrono::high_resolution_clock::now();
+        context = SEALContext::Create(parms);
+        time_end = chrono::high_resolution_clock::now();
+        auto time_parallel = chrono::duration_cast<chrono::milliseconds>(time_end - time_start);
+
+        vector<SEAL_BYTE> buffer(context->save_size());
+        context->save(buffer.data(), buffer.size());
+        context.reset();
+        time_start = chrono::high_resolution_clock::now();
+        context = SEALContext::Load(buffer.data(), buffer.size());
+        time_end = chrono::high_resolution_clock::now();
+        auto time_load = chrono::duration_cast<chrono::milliseconds>(time_end - time_start);
+
+        cout << "poly_modulus_degree " << setw(5) << poly_modulus_degree << " ("
+            << parms.coeff_modulus().size() << " primes): create on 1 thread "
+            << time_single.count() << " ms, on " << thread::hardware_concurrency()
+            << " threads " << time_parallel.count() << " ms, load "
+            << time_load.count() << " ms" << endl;
+    }
+}
+
+void example_galois_performance()
+{
+    print_example_banner("Example: Galois Automorphism Performance Test");
+
+    /*
+    Rotations apply a Galois automorphism to every polynomial of a ciphertext
+    before switching keys. In NTT form (as in CKKS) the automorphism permutes
+    the values, and the permutation takes two bit reversals per value to find.
+    The GaloisTool of a SEALContext computes the permutation for a Galois
+    element when it is first used and keeps it, so that applying the
+    automorphism becomes a single gather. In coefficient form (as in BFV) the
+    automorphism is computed directly as before. Here we compare the direct
+    computation to the GaloisTool, for a one-step rotation.
+    */
+    int count = 1000;
+    for (size_t poly_modulus_degree : { 4096, 8192, 16384, 32768 })
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        parms.set_poly_modulus_degree(poly_modulus_degree);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(poly_modulus_degree));
+        auto context = SEALContext::Create(parms);
+        auto &galois_tool = *context->context_data()->galois_tool();
+        int coeff_count_power = galois_tool.coeff_count_power();
+        uint64_t galois_elt = util::steps_to_galois_elt(1, poly_modulus_degree);
+        auto &modulus = parms.coeff_modulus()[0];
+
+        vector<uint64_t> input(poly_modulus_degree);
+        vector<uint64_t> result(poly_modulus_degree);
+        random_device rd;
+        for (auto &value : input)
+        {
+            value = rd() % modulus.value();
+        }
+
+        auto time_us = [count](auto &&apply)
+        {
+            auto time_start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < count; i++)
+            {
+                apply();
+            }
+            auto time_end = chrono::high_resolution_clock::now();
+            return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(
+                time_end - time_start).count()) / (1000.0 * count);
+        };
+
+        auto time_direct = time_us([&]() {
+            util::apply_galois(input.data(), coeff_count_power, galois_elt, modulus,
+                result.data());
+        });
+        auto time_tool = time_us([&]() {
+            galois_tool.apply_galois(input.data(), galois_elt, modulus, result.data());
+        });
+        auto time_direct_ntt = time_us([&]() {
+            util::apply_galois_ntt(input.data(), coeff_count_power, galois_elt,
+                result.data());
+        });
+
+        // The first call computes the table
+        auto time_start = chrono::high_resolution_clock::now();
+        galois_tool.apply_galois_ntt(input.data(), galois_elt, result.data());
+        auto time_end = chrono::high_resolution_clock::now();
+        auto time_first_ntt = chrono::duration_cast<chrono::microseconds>(
+            time_end - time_start);
+        auto time_tool_ntt = time_us([&]() {
+            galois_tool.apply_galois_ntt(input.data(), galois_elt, result.data());
+        });
+
+        cout << "poly_modulus_degree " << setw(5) << poly_modulus_degree << fixed
+            << setprecision(1) << ": coefficient form direct " << time_direct
+            << " us, GaloisTool " << time_tool << " us; NTT form direct "
+            << time_direct_ntt << " us, GaloisTool " << time_tool_ntt
+            << " us (first call " << time_first_ntt.count() << " us)" << endl;
+    }
+}
@@ -91,13 +91,198 @@ namespace seal
             pos *= gen;
             pos &= (m - 1);
         }
+
+        // Inverse map from coefficient positions to slots
+        inv_matrix_reps_index_map_ = allocate_uint(slots_, pool_);
+        for (size_t i = 0; i < slots_; i++)
+        {
+            inv_matrix_reps_index_map_[matrix_reps_index_map_[i]] = i;
+        }
+    }
+
+    namespace
+    {
+        // Converts a slot value to a coefficient modulo plain_modulus
+        inline uint64_t to_plain_coeff(uint64_t value, uint64_t)
+        {
+            return value;
+        }
+
+        inline uint64_t to_plain_coeff(int64_t value, uint64_t modulus)
+        {
+            return (value < 0) ? (modulus + static_cast<uint64_t>(value)) :
+                static_cast<uint64_t>(value);
+        }
+
+        // Converts a coefficient modulo plain_modulus to a slot value
+        template<typename T>
+        inline T from_plain_coeff(uint64_t value, uint64_t modulus);
+
+        template<>
+        inline uint64_t from_plain_coeff(uint64_t value, uint64_t)
+        {
+            return value;
+        }
+
+        template<>
+        inline int64_t from_plain_coeff(uint64_t value, uint64_t modulus)
+        {
+            return (value > (modulus >> 1)) ?
+                (static_cast<int64_t>(value) - static_cast<int64_t>(modulus)) :
+                static_cast<int64_t>(value);
+        }
+    }
+
+    template<typename T>
+    void BatchEncoder::encode_internal(const T *values, size_t values_size,
+        uint64_t *destination) const
+    {
+        auto &tables = *context_->context_data()->plain_ntt_tables();
+        uint64_t modulus = tables.modulus().value();
+        uint64_t two_times_modulus = modulus * 2;
+
+        // The first layer of the inverse NTT combines adjacent coefficients, 
+        // which we read directly from their slots. Empty slots are zero.
+        // Note: The slot permutation already accounts for bit-reversal.
+        size_t h = slots_ >> 1;
+        for (size_t i = 0; i < h; i++)
+        {
+            size_t slot1 = inv_matrix_reps_index_map_[2 * i];
+            size_t slot2 = inv_matrix_reps_index_map_[2 * i + 1];
+            uint64_t U = (slot1 < values_size) ? to_plain_coeff(values[slot1], modulus) : 0;
+            uint64_t V = (slot2 < values_size) ? to_plain_coeff(values[slot2], modulus) : 0;
+            const uint64_t W = tables.get_from_inv_root_powers_div_two(h + i);
+            const uint64_t Wprime = tables.get_from_scaled_inv_root_powers_div_two(h + i);
+
+            // Same butterfly as in inverse_ntt_negacyclic_harvey_lazy
+            uint64_t T_diff = two_times_modulus - V + U;
+            uint64_t currU = U + V - (two_times_modulus & 
+                static_cast<uint64_t>(-static_cast<int64_t>((U << 1) >= T_diff)));
+            destination[2 * i] = (currU + (modulus & 
+                static_cast<uint64_t>(-static_cast<int64_t>(T_diff & 1)))) >> 1;
+            unsigned long long H;
+            multiply_uint64_hw64(Wprime, T_diff, &H);
+            destination[2 * i + 1] = W * T_diff - H * modulus;
+        }
+
+        // Remaining layers of the inverse NTT
+        inverse_ntt_negacyclic_harvey_lazy_partial(destination, tables, 2);
+
+        // Final reduction from [0, 2 * modulus)
+        for (size_t i = 0; i < slots_; i++)
+        {
+            if (destination[i] >= modulus)
+            {
+                destination[i] -= modulus;
+            }
+        }
+    }
+
+    template<typename T>
+    void BatchEncoder::decode_internal(const uint64_t *plain, size_t plain_coeff_count,
+        T *destination, MemoryPool &pool) const
+    {
+        auto &tables = *context_->context_data()->plain_ntt_tables();
+        uint64_t modulus = tables.modulus().value();
+        uint64_t two_times_modulus = modulus * 2;
+
+        // Make a zero-padded copy of plain
+        auto temp(allocate_uint(slots_, pool));
+        set_uint_uint(plain, plain_coeff_count, temp.get());
+        set_zero_uint(slots_ - plain_coeff_count, temp.get() + plain_coeff_count);
+
+        // All but the last layer of the NTT
+        ntt_negacyclic_harvey_lazy_partial(temp.get(), tables, 2);
+
+        // The last layer of the NTT combines adjacent coefficients, which we
+        // reduce and write directly to their slots
+        size_t m = slots_ >> 1;
+        for (size_t i = 0; i < m; i++)
+        {
+            uint64_t X = temp[2 * i];
+            uint64_t Y = temp[2 * i + 1];
+            const uint64_t W = tables.get_from_root_powers(m + i);
+            const uint64_t Wprime = tables.get_from_scaled_root_powers(m + i);
+
+            // Same butterfly as in ntt_negacyclic_harvey_lazy
+            uint64_t currX = X - (two_times_modulus & 
+                static_cast<uint64_t>(-static_cast<int64_t>(X >= two_times_modulus)));
+            unsigned long long Q;
+            multiply_uint64_hw64(Wprime, Y, &Q);
+            Q = W * Y - Q * modulus;
+            X = currX + Q;
+            Y = currX + (two_times_modulus - Q);
+
+            // Reduce from [0, 4 * modulus)
+            X -= two_times_modulus & static_cast<uint64_t>(
+                -static_cast<int64_t>(X >= two_times_modulus));
+            X -= modulus & static_cast<uint64_t>(-static_cast<int64_t>(X >= modulus));
+            Y -= two_times_modulus & static_cast<uint64_t>(
+                -static_cast<int64_t>(Y >= two_times_modulus));
+            Y -= modulus & static_cast<uint64_t>(-static_cast<int64_t>(Y >= modulus));
+
+            destination[inv_matrix_reps_index_map_[2 * i]] = 
+                from_plain_coeff<T>(X, modulus);
+            destination[inv_matrix_reps_index_map_[2 * i + 1]] = 
+                from_plain_coeff<T>(Y, modulus);
+        }
+    }
+
+    template<typename T>
+    void BatchEncoder::encode_ntt_internal(const T *values, size_t values_size,
+        parms_id_type parms_id, Plaintext &destination, MemoryPool &pool) const
+    {
+        // Validate input parameters
+        if (values_size > slots_)
+        {
+            throw logic_error("values_matrix size is too large");
+        }
+        auto context_data_ptr = context_->context_data(parms_id);
+        if (!context_data_ptr)
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_data_ptr;
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_mod_count = coeff_modulus.size();
+        uint64_t plain_modulus = parms.plain_modulus().value();
+        uint64_t plain_upper_half_threshold = context_data.plain_upper_half_threshold();
+        auto &coeff_small_ntt_tables = context_data.small_ntt_tables();
+
+        // Batch into a temporary buffer
+        auto temp(allocate_uint(slots_, pool));
+        encode_internal(values, values_size, temp.get());
+
+        // Resize to fit the entire NTT transformed (ciphertext size) polynomial
+        // Note that the new coefficients are automatically set to 0
+        destination.parms_id() = parms_id_zero;
+        destination.resize(mul_safe(slots_, coeff_mod_count));
+
+        for (size_t j = 0; j < coeff_mod_count; j++)
+        {
+            // Lift from [0, plain_modulus) to the centered representative modulo
+            // each coefficient modulus prime
+            uint64_t *destination_ptr = destination.data() + (j * slots_);
+            for (size_t i = 0; i < slots_; i++)
+            {
+                uint64_t value = temp[i];
+                destination_ptr[i] = (value >= plain_upper_half_threshold) ?
+                    negate_uint_mod(barrett_reduce_64(plain_modulus - value,
+                        coeff_modulus[j]), coeff_modulus[j]) :
+                    barrett_reduce_64(value, coeff_modulus[j]);
+            }
+            ntt_negacyclic_harvey(destination_ptr, coeff_small_ntt_tables[j]);
+        }
+
+        destination.parms_id() = parms_id;
+        destination.scale() = 1.0;
     }
 
     void BatchEncoder::encode(const vector<uint64_t> &values_matrix, 
         Plaintext &destination)
     {
-        auto &context_data = *context_->context_data();
-
         // Validate input parameters
         size_t values_matrix_size = values_matrix.size();
         if (values_matrix_size > slots_)
@@ -105,6 +290,7 @@ namespace seal
             throw logic_error("values_matrix size is too large");
         }
 #ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
         uint64_t modulus = context_data.parms().plain_modulus().value();
         for (auto v : values_matrix)
         {
@@ -119,28 +305,12 @@ namespace seal
         destination.resize(slots_);
         destination.parms_id() = parms_id_zero;
 
-        // First write the values to destination coefficients. 
-        // Read in top row, then bottom row.
-        for (size_t i = 0; i < values_matrix_size; i++)
-        {
-            *(destination.data() + matrix_reps_index_map_[i]) = values_matrix[i];
-        }
-        for (size_t i = values_matrix_size; i < slots_; i++)
-        {
-            *(destination.data() + matrix_reps_index_map_[i]) = 0;
-        }
-
-        // Transform destination using inverse of negacyclic NTT
-        // Note: We already performed bit-reversal when reading in the matrix
-        inverse_ntt_negacyclic_harvey(destination.data(), *context_data.plain_ntt_tables());
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
     }
 
     void BatchEncoder::encode(const vector<int64_t> &values_matrix, 
         Plaintext &destination)
     {
-        auto &context_data = *context_->context_data();
-        uint64_t modulus = context_data.parms().plain_modulus().value();
-
         // Validate input parameters
         size_t values_matrix_size = values_matrix.size();
         if (values_matrix_size > slots_)
@@ -148,6 +318,8 @@ namespace seal
             throw logic_error("values_matrix size is too large");
         }
 #ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
         uint64_t plain_modulus_div_two = modulus >> 1;
         for (auto v : values_matrix)
         {
@@ -162,29 +334,59 @@ namespace seal
         destination.resize(slots_);
         destination.parms_id() = parms_id_zero;
 
-        // First write the values to destination coefficients.  
-        // Read in top row, then bottom row.
-        for (size_t i = 0; i < values_matrix_size; i++)
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
+    }
+
+    void BatchEncoder::encode(const vector<uint64_t> &values_matrix, 
+        parms_id_type parms_id, Plaintext &destination, MemoryPoolHandle pool)
+    {
+        if (!pool)
         {
-            *(destination.data() + matrix_reps_index_map_[i]) = 
-                (values_matrix[i] < 0) ? (modulus + static_cast<uint64_t>(values_matrix[i])) : 
-                    static_cast<uint64_t>(values_matrix[i]);
+            throw invalid_argument("pool is uninitialized");
         }
-        for (size_t i = values_matrix_size; i < slots_; i++)
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
+        for (auto v : values_matrix)
         {
-            *(destination.data() + matrix_reps_index_map_[i]) = 0;
+            // Validate the i-th input
+            if (v >= modulus)
+            {
+                throw invalid_argument("input value is larger than plain_modulus");
+            }
         }
+#endif
+        encode_ntt_internal(values_matrix.data(), values_matrix.size(), parms_id,
+            destination, pool);
+    }
 
-        // Transform destination using inverse of negacyclic NTT
-        // Note: We already performed bit-reversal when reading in the matrix
-        inverse_ntt_negacyclic_harvey(destination.data(), *context_data.plain_ntt_tables());
+    void BatchEncoder::encode(const vector<int64_t> &values_matrix, 
+        parms_id_type parms_id, Plaintext &destination, MemoryPoolHandle pool)
+    {
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
+        uint64_t plain_modulus_div_two = modulus >> 1;
+        for (auto v : values_matrix)
+        {
+            // Validate the i-th input
+            if (unsigned_gt(llabs(v), plain_modulus_div_two))
+            {
+                throw invalid_argument("input value is larger than plain_modulus");
+            }
+        }
+#endif
+        encode_ntt_internal(values_matrix.data(), values_matrix.size(), parms_id,
+            destination, pool);
     }
 #ifdef SEAL_USE_MSGSL_SPAN
     void BatchEncoder::encode(gsl::span<const uint64_t> values_matrix, 
         Plaintext &destination)
     {
-        auto &context_data = *context_->context_data();
-
         // Validate input parameters
         size_t values_matrix_size = static_cast<size_t>(values_matrix.size());
         if (values_matrix_size > slots_)
@@ -192,6 +394,7 @@ namespace seal
             throw logic_error("values_matrix size is too large");
         }
 #ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
         uint64_t modulus = context_data.parms().plain_modulus().value();
         for (auto v : values_matrix)
         {
@@ -206,30 +409,12 @@ namespace seal
         destination.resize(slots_);
         destination.parms_id() = parms_id_zero;
 
-        // First write the values to destination coefficients. Read 
-        // in top row, then bottom row.
-        using index_type = decltype(values_matrix)::index_type;
-        for (size_t i = 0; i < values_matrix_size; i++)
-        {
-            *(destination.data() + matrix_reps_index_map_[i]) = 
-                values_matrix[static_cast<index_type>(i)];
-        }
-        for (size_t i = values_matrix_size; i < slots_; i++)
-        {
-            *(destination.data() + matrix_reps_index_map_[i]) = 0;
-        }
-
-        // Transform destination using inverse of negacyclic NTT
-        // Note: We already performed bit-reversal when reading in the matrix
-        inverse_ntt_negacyclic_harvey(destination.data(), *context_data.plain_ntt_tables());
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
     }
 
     void BatchEncoder::encode(gsl::span<const int64_t> values_matrix, 
         Plaintext &destination)
     {
-        auto &context_data = *context_->context_data();
-        uint64_t modulus = context_data.parms().plain_modulus().value();
-
         // Validate input parameters
         size_t values_matrix_size = static_cast<size_t>(values_matrix.size());
         if (values_matrix_size > slots_)
@@ -237,6 +422,8 @@ namespace seal
             throw logic_error("values_matrix size is too large");
         }
 #ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
         uint64_t plain_modulus_div_two = modulus >> 1;
         for (auto v : values_matrix)
         {
@@ -251,24 +438,64 @@ namespace seal
         destination.resize(slots_);
         destination.parms_id() = parms_id_zero;
 
-        // First write the values to destination coefficients. Read 
-        // in top row, then bottom row.
-        using index_type = decltype(values_matrix)::index_type;
-        for (size_t i = 0; i < values_matrix_size; i++)
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
+    }
+
+    void BatchEncoder::encode(gsl::span<const uint64_t> values_matrix,
+        gsl::span<uint64_t> destination)
+    {
+        // Validate input parameters
+        size_t values_matrix_size = static_cast<size_t>(values_matrix.size());
+        if (values_matrix_size > slots_)
         {
-            *(destination.data() + matrix_reps_index_map_[i]) = 
-                (values_matrix[static_cast<index_type>(i)] < 0) ? 
-                (modulus + static_cast<uint64_t>(values_matrix[static_cast<index_type>(i)])) : 
-                static_cast<uint64_t>(values_matrix[static_cast<index_type>(i)]);
+            throw logic_error("values_matrix size is too large");
+        }
+        if (unsigned_neq(destination.size(), slots_))
+        {
+            throw invalid_argument("destination has incorrect size");
         }
-        for (size_t i = values_matrix_size; i < slots_; i++)
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
+        for (auto v : values_matrix)
         {
-            *(destination.data() + matrix_reps_index_map_[i]) = 0;
+            // Validate the i-th input
+            if (v >= modulus)
+            {
+                throw invalid_argument("input value is larger than plain_modulus");
+            }
         }
+#endif
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
+    }
 
-        // Transform destination using inverse of negacyclic NTT
-        // Note: We already performed bit-reversal when reading in the matrix
-        inverse_ntt_negacyclic_harvey(destination.data(), *context_data.plain_ntt_tables());
+    void BatchEncoder::encode(gsl::span<const int64_t> values_matrix,
+        gsl::span<uint64_t> destination)
+    {
+        // Validate input parameters
+        size_t values_matrix_size = static_cast<size_t>(values_matrix.size());
+        if (values_matrix_size > slots_)
+        {
+            throw logic_error("values_matrix size is too large");
+        }
+        if (unsigned_neq(destination.size(), slots_))
+        {
+            throw invalid_argument("destination has incorrect size");
+        }
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        uint64_t modulus = context_data.parms().plain_modulus().value();
+        uint64_t plain_modulus_div_two = modulus >> 1;
+        for (auto v : values_matrix)
+        {
+            // Validate the i-th input
+            if (unsigned_gt(llabs(v), plain_modulus_div_two))
+            {
+                throw invalid_argument("input value is larger than plain_modulus");
+            }
+        }
+#endif
+        encode_internal(values_matrix.data(), values_matrix_size, destination.data());
     }
 #endif
     void BatchEncoder::encode(Plaintext &plain, MemoryPoolHandle pool)
@@ -306,20 +533,7 @@ namespace seal
         plain.resize(slots_);
         plain.parms_id() = parms_id_zero;
 
-        // First write the values to destination coefficients. Read 
-        // in top row, then bottom row.
-        for (size_t i = 0; i < input_plain_coeff_count; i++)
-        {
-            *(plain.data() + matrix_reps_index_map_[i]) = temp[i];
-        }
-        for (size_t i = input_plain_coeff_count; i < slots_; i++)
-        {
-            *(plain.data() + matrix_reps_index_map_[i]) = 0;
-        }
-
-        // Transform destination using inverse of negacyclic NTT
-        // Note: We already performed bit-reversal when reading in the matrix
-        inverse_ntt_negacyclic_harvey(plain.data(), *context_data.plain_ntt_tables());
+        encode_internal(temp.get(), input_plain_coeff_count, plain.data());
     }
 
     void BatchEncoder::decode(const Plaintext &plain, vector<uint64_t> &destination,
@@ -338,28 +552,13 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
-        auto &context_data = *context_->context_data();
-
         // Set destination size
         destination.resize(slots_);
 
         // Never include the leading zero coefficient (if present)
         size_t plain_coeff_count = min(plain.coeff_count(), slots_);
 
-        auto temp_dest(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.data(), plain_coeff_count, temp_dest.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp_dest.get() + plain_coeff_count);
-
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp_dest.get(), *context_data.plain_ntt_tables());
-
-        // Read top row
-        for (size_t i = 0; i < slots_; i++)
-        {
-            destination[i] = temp_dest[matrix_reps_index_map_[i]];
-        }
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
     }
 
     void BatchEncoder::decode(const Plaintext &plain, vector<int64_t> &destination,
@@ -378,33 +577,13 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
-        auto &context_data = *context_->context_data();
-        uint64_t modulus = context_data.parms().plain_modulus().value();
-
         // Set destination size
         destination.resize(slots_);
 
         // Never include the leading zero coefficient (if present)
         size_t plain_coeff_count = min(plain.coeff_count(), slots_);
 
-        auto temp_dest(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.data(), plain_coeff_count, temp_dest.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp_dest.get() + plain_coeff_count);
-
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp_dest.get(), *context_data.plain_ntt_tables());
-
-        // Read top row, then bottom row
-        uint64_t plain_modulus_div_two = modulus >> 1;
-        for (size_t i = 0; i < slots_; i++)
-        {
-            uint64_t curr_value = temp_dest[matrix_reps_index_map_[i]];
-            destination[i] = (curr_value > plain_modulus_div_two) ?
-                (static_cast<int64_t>(curr_value) - static_cast<int64_t>(modulus)) : 
-                static_cast<int64_t>(curr_value);
-        }
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
     }
 #ifdef SEAL_USE_MSGSL_SPAN
     void BatchEncoder::decode(const Plaintext &plain, gsl::span<uint64_t> destination,
@@ -422,10 +601,6 @@ namespace seal
         {
             throw invalid_argument("pool is uninitialized");
         }
-
-        auto &context_data = *context_->context_data();
-
-        using index_type = decltype(destination)::index_type;
         if(unsigned_gt(destination.size(), numeric_limits<int>::max()) || 
             unsigned_neq(destination.size(), slots_))
         {
@@ -435,20 +610,7 @@ namespace seal
         // Never include the leading zero coefficient (if present)
         size_t plain_coeff_count = min(plain.coeff_count(), slots_);
 
-        auto temp_dest(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.data(), plain_coeff_count, temp_dest.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp_dest.get() + plain_coeff_count);
-
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp_dest.get(), *context_data.plain_ntt_tables());
-
-        // Read top row
-        for (size_t i = 0; i < slots_; i++)
-        {
-            destination[static_cast<index_type>(i)] = temp_dest[matrix_reps_index_map_[i]];
-        }
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
     }
 
     void BatchEncoder::decode(const Plaintext &plain, gsl::span<int64_t> destination,
@@ -466,11 +628,6 @@ namespace seal
         {
             throw invalid_argument("pool is uninitialized");
         }
-
-        auto &context_data = *context_->context_data();
-        uint64_t modulus = context_data.parms().plain_modulus().value();
-
-        using index_type = decltype(destination)::index_type;
         if(unsigned_gt(destination.size(), numeric_limits<int>::max()) || 
             unsigned_neq(destination.size(), slots_))
         {
@@ -480,24 +637,61 @@ namespace seal
         // Never include the leading zero coefficient (if present)
         size_t plain_coeff_count = min(plain.coeff_count(), slots_);
 
-        auto temp_dest(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.data(), plain_coeff_count, temp_dest.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp_dest.get() + plain_coeff_count);
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
+    }
 
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp_dest.get(), *context_data.plain_ntt_tables());
+    void BatchEncoder::decode(gsl::span<const uint64_t> plain,
+        gsl::span<uint64_t> destination, MemoryPoolHandle pool)
+    {
+        size_t plain_coeff_count = static_cast<size_t>(plain.size());
+        if (plain_coeff_count > slots_)
+        {
+            throw invalid_argument("plain is too large");
+        }
+        if (unsigned_neq(destination.size(), slots_))
+        {
+            throw invalid_argument("destination has incorrect size");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        if (!are_poly_coefficients_less_than(plain.data(),
+            plain_coeff_count, context_data.parms().plain_modulus().value()))
+        {
+            throw invalid_argument("plain is not valid for encryption parameters");
+        }
+#endif
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
+    }
 
-        // Read top row, then bottom row
-        uint64_t plain_modulus_div_two = modulus >> 1;
-        for (size_t i = 0; i < slots_; i++)
+    void BatchEncoder::decode(gsl::span<const uint64_t> plain,
+        gsl::span<int64_t> destination, MemoryPoolHandle pool)
+    {
+        size_t plain_coeff_count = static_cast<size_t>(plain.size());
+        if (plain_coeff_count > slots_)
+        {
+            throw invalid_argument("plain is too large");
+        }
+        if (unsigned_neq(destination.size(), slots_))
+        {
+            throw invalid_argument("destination has incorrect size");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+#ifdef SEAL_DEBUG
+        auto &context_data = *context_->context_data();
+        if (!are_poly_coefficients_less_than(plain.data(),
+            plain_coeff_count, context_data.parms().plain_modulus().value()))
         {
-            uint64_t curr_value = temp_dest[matrix_reps_index_map_[i]];
-            destination[static_cast<index_type>(i)] = (curr_value > plain_modulus_div_two) ?
-                    (static_cast<int64_t>(curr_value) - static_cast<int64_t>(modulus)) : 
-                    static_cast<int64_t>(curr_value);
+            throw invalid_argument("plain is not valid for encryption parameters");
         }
+#endif
+        decode_internal(plain.data(), plain_coeff_count, destination.data(), pool);
     }
 #endif
     void BatchEncoder::decode(Plaintext &plain, MemoryPoolHandle pool)
@@ -515,29 +709,12 @@ namespace seal
             throw invalid_argument("pool is uninitialized");
         }
 
-        auto &context_data = *context_->context_data();
-
         // Never include the leading zero coefficient (if present)
         size_t plain_coeff_count = min(plain.coeff_count(), slots_);
 
-        // Allocate temporary space to store a wide copy of plain
-        auto temp(allocate_uint(slots_, pool));
-
-        // Make a copy of poly
-        set_uint_uint(plain.data(), plain_coeff_count, temp.get());
-        set_zero_uint(slots_ - plain_coeff_count, temp.get() + plain_coeff_count);
-
-        // Transform destination using negacyclic NTT.
-        ntt_negacyclic_harvey(temp.get(), *context_data.plain_ntt_tables());
-
         // Set plain to full slot count size (note that all new coefficients are 
-        // set to zero).
+        // set to zero). Decoding copies the input first so it can be done in place.
         plain.resize(slots_);
-
-        // Read top row, then bottom row
-        for (size_t i = 0; i < slots_; i++)
-        {
-            *(plain.data() + i) = temp[matrix_reps_index_map_[i]];
-        }
+        decode_internal(plain.data(), plain_coeff_count, plain.data(), pool);
     }
 }
@@ -98,6 +98,52 @@ namespace seal
         @throws std::invalid_argument if values is too large
         */
         void encode(const std::vector<std::int64_t> &values, Plaintext &destination);
+
+        /**
+        Creates a plaintext from a given matrix directly in NTT form at the given
+        level. This function "batches" a given matrix of integers modulo the plaintext
+        modulus as above, lifts the resulting polynomial to the coefficient modulus
+        corresponding to parms_id, and transforms it to NTT form. The result can be
+        multiplied with BFV ciphertexts at that level, or at any lower level, using
+        Evaluator::multiply_plain without being transformed again. Encoding at
+        SEALContext::first_parms_id() therefore gives a plaintext usable at every level.
+        Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] values The matrix of integers modulo plaintext modulus to batch
+        @param[in] parms_id The parms_id for the resulting plaintext
+        @param[out] destination The plaintext polynomial to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if values is too large
+        @throws std::invalid_argument if parms_id is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void encode(const std::vector<std::uint64_t> &values, parms_id_type parms_id,
+            Plaintext &destination, MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Creates a plaintext from a given matrix directly in NTT form at the given
+        level. This function "batches" a given matrix of integers modulo the plaintext
+        modulus as above, lifts the resulting polynomial to the coefficient modulus
+        corresponding to parms_id, and transforms it to NTT form. The result can be
+        multiplied with BFV ciphertexts at that level, or at any lower level, using
+        Evaluator::multiply_plain without being transformed again. Encoding at
+        SEALContext::first_parms_id() therefore gives a plaintext usable at every level.
+        Dynamic memory allocations in the process are allocated from the memory pool
+        pointed to by the given MemoryPoolHandle.
+
+        @param[in] values The matrix of integers modulo plaintext modulus to batch
+        @param[in] parms_id The parms_id for the resulting plaintext
+        @param[out] destination The plaintext polynomial to overwrite with the result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if values is too large
+        @throws std::invalid_argument if parms_id is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void encode(const std::vector<std::int64_t> &values, parms_id_type parms_id,
+            Plaintext &destination, MemoryPoolHandle pool = MemoryManager::GetPool());
 #ifdef SEAL_USE_MSGSL_SPAN
         /**
         Creates a plaintext from a given matrix. This function "batches" a given matrix
@@ -134,6 +180,48 @@ namespace seal
         @throws std::invalid_argument if values is too large
         */
         void encode(gsl::span<const std::int64_t> values, Plaintext &destination);
+
+        /**
+        Creates a plaintext from a given matrix and writes its coefficients directly
+        to a caller-provided buffer, which avoids any allocation or resizing. The 
+        input must have size at most equal to the degree of the polynomial modulus,
+        and the destination must have size equal to the degree of the polynomial 
+        modulus. The first half of the elements represent the first row of the 
+        matrix, and the second half represent the second row. The numbers in the 
+        matrix can be at most equal to the plaintext modulus for it to represent a
+        valid plaintext.
+
+        If the destination overlaps the input values in memory, the behavior of this
+        function is undefined.
+
+        @param[in] values The matrix of integers modulo plaintext modulus to batch
+        @param[out] destination The buffer to overwrite with the plaintext coefficients
+        @throws std::invalid_argument if values is too large
+        @throws std::invalid_argument if destination has incorrect size
+        */
+        void encode(gsl::span<const std::uint64_t> values, 
+            gsl::span<std::uint64_t> destination);
+
+        /**
+        Creates a plaintext from a given matrix and writes its coefficients directly
+        to a caller-provided buffer, which avoids any allocation or resizing. The 
+        input must have size at most equal to the degree of the polynomial modulus,
+        and the destination must have size equal to the degree of the polynomial 
+        modulus. The first half of the elements represent the first row of the 
+        matrix, and the second half represent the second row. The numbers in the 
+        matrix can be at most equal to the plaintext modulus for it to represent a
+        valid plaintext.
+
+        If the destination overlaps the input values in memory, the behavior of this
+        function is undefined.
+
+        @param[in] values The matrix of integers modulo plaintext modulus to batch
+        @param[out] destination The buffer to overwrite with the plaintext coefficients
+        @throws std::invalid_argument if values is too large
+        @throws std::invalid_argument if destination has incorrect size
+        */
+        void encode(gsl::span<const std::int64_t> values, 
+            gsl::span<std::uint64_t> destination);
 #ifdef SEAL_USE_MSGSL_MULTISPAN
         /**
         Creates a plaintext from a given matrix. This function "batches" a given matrix
@@ -276,6 +364,47 @@ namespace seal
         */
         void decode(const Plaintext &plain, gsl::span<std::int64_t> destination,
             MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Inverse of encode. This function "unbatches" plaintext coefficients given in
+        a buffer into a matrix of integers modulo the plaintext modulus, and stores 
+        the result in the destination buffer, which must have size equal to the degree
+        of the polynomial modulus. The input must have size at most equal to the 
+        degree of the polynomial modulus, and coefficients less than the plaintext 
+        modulus. The input and destination may be the same buffer. Dynamic memory 
+        allocations in the process are allocated from the memory pool pointed to by 
+        the given MemoryPoolHandle.
+
+        @param[in] plain The plaintext coefficients to unbatch
+        @param[out] destination The matrix to be overwritten with the values in the slots
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if plain is too large
+        @throws std::invalid_argument if destination has incorrect size
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void decode(gsl::span<const std::uint64_t> plain, 
+            gsl::span<std::uint64_t> destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Inverse of encode. This function "unbatches" plaintext coefficients given in
+        a buffer into a matrix of integers modulo the plaintext modulus, and stores 
+        the result in the destination buffer, which must have size equal to the degree
+        of the polynomial modulus. The input must have size at most equal to the 
+        degree of the polynomial modulus, and coefficients less than the plaintext 
+        modulus. Dynamic memory allocations in the process are allocated from the 
+        memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] plain The plaintext coefficients to unbatch
+        @param[out] destination The matrix to be overwritten with the values in the slots
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if plain is too large
+        @throws std::invalid_argument if destination has incorrect size
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void decode(gsl::span<const std::uint64_t> plain, 
+            gsl::span<std::int64_t> destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool());
 #ifdef SEAL_USE_MSGSL_MULTISPAN
         /**
         Inverse of encode. This function "unbatches" a given plaintext into a matrix
@@ -372,6 +501,32 @@ namespace seal
 
         void populate_matrix_reps_index_map();
 
+        /**
+        Writes the batched plaintext coefficients for the given slot values to
+        destination, which must not overlap values. The slot permutation is fused
+        with the first layer of the inverse NTT.
+        */
+        template<typename T>
+        void encode_internal(const T *values, std::size_t values_size,
+            std::uint64_t *destination) const;
+
+        /**
+        Batches the given slot values, lifts the result to the coefficient modulus
+        at parms_id, and writes it to destination in NTT form.
+        */
+        template<typename T>
+        void encode_ntt_internal(const T *values, std::size_t values_size,
+            parms_id_type parms_id, Plaintext &destination, util::MemoryPool &pool) const;
+
+        /**
+        Writes the slot values for the given plaintext coefficients to destination.
+        The last layer of the NTT is fused with the slot permutation. The input is
+        copied first, so destination may overlap plain.
+        */
+        template<typename T>
+        void decode_internal(const std::uint64_t *plain, std::size_t plain_coeff_count,
+            T *destination, util::MemoryPool &pool) const;
+
         inline void reverse_bits(std::uint64_t *input)
         {
 #ifdef SEAL_DEBUG
@@ -401,5 +556,7 @@ namespace seal
         util::Pointer<std::uint64_t> roots_of_unity_;
 
         util::Pointer<std::uint64_t> matrix_reps_index_map_;
+
+        util::Pointer<std::uint64_t> inv_matrix_reps_index_map_;
     };
 }
@@ -1,8 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include <cstring>
 #include "seal/ciphertext.h"
 #include "seal/util/polycore.h"
+#include "seal/util/serialization.h"
 
 using namespace std;
 using namespace seal::util;
@@ -144,15 +146,12 @@ namespace seal
         const ct_coeff_type *ptr = data();
         for (size_t i = 0; i < size_; i++)
         {
-            for (size_t j = 0; j < coeff_mod_count_; j++)
+            for (size_t j = 0; j < coeff_mod_count_; j++, ptr += poly_modulus_degree_)
             {
-                uint64_t modulus = coeff_modulus[j].value();
-                for (size_t k = 0; k < poly_modulus_degree_; k++, ptr++)
+                if (!are_poly_coefficients_less_than(ptr, poly_modulus_degree_,
+                    coeff_modulus[j].value()))
                 {
-                    if (*ptr >= modulus)
-                    {
-                        return false;
-                    }
+                    return false;
                 }
             }
         }
@@ -195,7 +194,7 @@ namespace seal
         return true;
     }
 
-    void Ciphertext::save(ostream &stream) const
+    void Ciphertext::save(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -203,19 +202,8 @@ namespace seal
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            stream.write(reinterpret_cast<const char*>(&parms_id_), sizeof(parms_id_type));
-            SEAL_BYTE is_ntt_form_byte = static_cast<SEAL_BYTE>(is_ntt_form_);
-            stream.write(reinterpret_cast<const char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
-            uint64_t size64 = safe_cast<uint64_t>(size_);
-            stream.write(reinterpret_cast<const char*>(&size64), sizeof(uint64_t));
-            uint64_t poly_modulus_degree64 = safe_cast<uint64_t>(poly_modulus_degree_);
-            stream.write(reinterpret_cast<const char*>(&poly_modulus_degree64), sizeof(uint64_t));
-            uint64_t coeff_mod_count64 = safe_cast<uint64_t>(coeff_mod_count_);
-            stream.write(reinterpret_cast<const char*>(&coeff_mod_count64), sizeof(uint64_t));
-            stream.write(reinterpret_cast<const char*>(&scale_), sizeof(double));
-
-            // Save the data
-            data_.save(stream);
+            save_versioned(stream, compr_mode,
+                [this](ostream &members_stream) { save_members(members_stream); });
         }
         catch (const exception &)
         {
@@ -228,44 +216,55 @@ namespace seal
 
     void Ciphertext::unsafe_load(istream &stream)
     {
+        load_checked(stream);
+    }
+
+    size_t Ciphertext::save_size(compr_mode_type compr_mode) const
+    {
+        // The compressed size is only known after compressing
+        if (compr_mode == compr_mode_type::none)
+        {
+            return versioned_save_size(members_save_size());
+        }
+        return compute_save_size(
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t Ciphertext::save(SEAL_BYTE *out, size_t size, compr_mode_type compr_mode) const
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t Ciphertext::unsafe_load(const SEAL_BYTE *in, size_t size)
+    {
+        return load_from_buffer(in, size,
+            [this](istream &stream) { unsafe_load(stream); });
+    }
+
+    bool Ciphertext::load_checked(istream &stream)
+    {
+        bool verified = false;
         auto old_except_mask = stream.exceptions();
         try
         {
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            parms_id_type parms_id{};
-            stream.read(reinterpret_cast<char*>(&parms_id), sizeof(parms_id_type));
-            SEAL_BYTE is_ntt_form_byte;
-            stream.read(reinterpret_cast<char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
-            uint64_t size64 = 0;
-            stream.read(reinterpret_cast<char*>(&size64), sizeof(uint64_t));
-            uint64_t poly_modulus_degree64 = 0;
-            stream.read(reinterpret_cast<char*>(&poly_modulus_degree64), sizeof(uint64_t));
-            uint64_t coeff_mod_count64 = 0;
-            stream.read(reinterpret_cast<char*>(&coeff_mod_count64), sizeof(uint64_t));
-            double scale = 0;
-            stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
-
-            // Load the data
-            IntArray<ct_coeff_type> new_data(data_.pool());
-            new_data.load(stream);
-            if (unsigned_neq(new_data.size(),
-                mul_safe(size64, poly_modulus_degree64, coeff_mod_count64)))
+            // Ciphertexts saved before the versioned format was introduced
+            // start directly with the parms_id
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic == serialization_magic)
             {
-                throw invalid_argument("ciphertext data is invalid");
+                load_versioned(stream,
+                    [this](istream &members_stream) { load_members(members_stream); });
+                verified = true;
+            }
+            else
+            {
+                load_legacy(stream, magic);
             }
-
-            // Set values
-            parms_id_ = parms_id;
-            is_ntt_form_ = (is_ntt_form_byte == SEAL_BYTE(0)) ? false : true;
-            size_ = safe_cast<size_type>(size64);
-            poly_modulus_degree_ = safe_cast<size_type>(poly_modulus_degree64);
-            coeff_mod_count_ = safe_cast<size_type>(coeff_mod_count64);
-            scale_ = scale;
-
-            // Set the data
-            data_.swap_with(new_data);
         }
         catch (const exception &)
         {
@@ -274,5 +273,257 @@ namespace seal
         }
 
         stream.exceptions(old_except_mask);
+        return verified;
+    }
+
+    vector<SEAL_BYTE> Ciphertext::packed_bit_counts() const
+    {
+        // Every RNS component is packed to the largest bit count it takes in any
+        // of the polynomials; this is at most the bit count of the corresponding
+        // coefficient modulus prime
+        vector<SEAL_BYTE> bit_counts(coeff_mod_count_, SEAL_BYTE(0));
+        for (size_type i = 0; i < size_; i++)
+        {
+            for (size_type j = 0; j < coeff_mod_count_; j++)
+            {
+                int bit_count = get_max_significant_bit_count(
+                    data(i) + j * poly_modulus_degree_, poly_modulus_degree_);
+                bit_counts[j] = max(bit_counts[j], static_cast<SEAL_BYTE>(bit_count));
+            }
+        }
+        return bit_counts;
+    }
+
+    size_t Ciphertext::members_save_size() const
+    {
+        size_t members_size = sizeof(parms_id_type) + sizeof(SEAL_BYTE) +
+            3 * sizeof(uint64_t) + sizeof(double) + coeff_mod_count_;
+        for (auto bit_count : packed_bit_counts())
+        {
+            members_size = add_safe(members_size, mul_safe(size_,
+                packed_uint_save_size(poly_modulus_degree_, static_cast<int>(bit_count))));
+        }
+        return members_size;
+    }
+
+    void Ciphertext::save_members(ostream &stream) const
+    {
+        stream.write(reinterpret_cast<const char*>(&parms_id_), sizeof(parms_id_type));
+        SEAL_BYTE is_ntt_form_byte = static_cast<SEAL_BYTE>(is_ntt_form_);
+        stream.write(reinterpret_cast<const char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
+        uint64_t size64 = safe_cast<uint64_t>(size_);
+        stream.write(reinterpret_cast<const char*>(&size64), sizeof(uint64_t));
+        uint64_t poly_modulus_degree64 = safe_cast<uint64_t>(poly_modulus_degree_);
+        stream.write(reinterpret_cast<const char*>(&poly_modulus_degree64), sizeof(uint64_t));
+        uint64_t coeff_mod_count64 = safe_cast<uint64_t>(coeff_mod_count_);
+        stream.write(reinterpret_cast<const char*>(&coeff_mod_count64), sizeof(uint64_t));
+        stream.write(reinterpret_cast<const char*>(&scale_), sizeof(double));
+
+        vector<SEAL_BYTE> bit_counts = packed_bit_counts();
+        if (coeff_mod_count_)
+        {
+            stream.write(reinterpret_cast<const char*>(bit_counts.data()),
+                safe_cast<streamsize>(coeff_mod_count_));
+        }
+
+        // Save the data
+        for (size_type i = 0; i < size_; i++)
+        {
+            for (size_type j = 0; j < coeff_mod_count_; j++)
+            {
+                save_packed_uint(data(i) + j * poly_modulus_degree_,
+                    poly_modulus_degree_, static_cast<int>(bit_counts[j]), stream);
+            }
+        }
+    }
+
+    void Ciphertext::load_members(istream &stream)
+    {
+        parms_id_type parms_id{};
+        stream.read(reinterpret_cast<char*>(&parms_id), sizeof(parms_id_type));
+        SEAL_BYTE is_ntt_form_byte;
+        stream.read(reinterpret_cast<char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
+        uint64_t size64 = 0;
+        stream.read(reinterpret_cast<char*>(&size64), sizeof(uint64_t));
+        uint64_t poly_modulus_degree64 = 0;
+        stream.read(reinterpret_cast<char*>(&poly_modulus_degree64), sizeof(uint64_t));
+        uint64_t coeff_mod_count64 = 0;
+        stream.read(reinterpret_cast<char*>(&coeff_mod_count64), sizeof(uint64_t));
+        double scale = 0;
+        stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
+        if (size64 > SEAL_CIPHERTEXT_SIZE_MAX ||
+            poly_modulus_degree64 > SEAL_POLY_MOD_DEGREE_MAX ||
+            coeff_mod_count64 > SEAL_COEFF_MOD_COUNT_MAX)
+        {
+            throw invalid_argument("ciphertext data is invalid");
+        }
+        size_type size = safe_cast<size_type>(size64);
+        size_type poly_modulus_degree = safe_cast<size_type>(poly_modulus_degree64);
+        size_type coeff_mod_count = safe_cast<size_type>(coeff_mod_count64);
+
+        // Load the data
+        vector<SEAL_BYTE> bit_counts(coeff_mod_count);
+        if (coeff_mod_count)
+        {
+            stream.read(reinterpret_cast<char*>(bit_counts.data()),
+                safe_cast<streamsize>(coeff_mod_count));
+        }
+        IntArray<ct_coeff_type> new_data(
+            mul_safe(size, poly_modulus_degree, coeff_mod_count), data_.pool());
+        ct_coeff_type *new_data_ptr = new_data.begin();
+        for (size_type i = 0; i < size; i++)
+        {
+            for (size_type j = 0; j < coeff_mod_count; j++)
+            {
+                load_packed_uint(stream, poly_modulus_degree,
+                    static_cast<int>(bit_counts[j]), new_data_ptr);
+                new_data_ptr += poly_modulus_degree;
+            }
+        }
+
+        // Set values
+        parms_id_ = parms_id;
+        is_ntt_form_ = (is_ntt_form_byte == SEAL_BYTE(0)) ? false : true;
+        size_ = size;
+        poly_modulus_degree_ = poly_modulus_degree;
+        coeff_mod_count_ = coeff_mod_count;
+        scale_ = scale;
+
+        // Set the data
+        data_.swap_with(new_data);
+    }
+
+    void Ciphertext::load_legacy(istream &stream, uint64_t parms_id_word)
+    {
+        parms_id_type parms_id{};
+        parms_id[0] = parms_id_word;
+        stream.read(reinterpret_cast<char*>(parms_id.data() + 1),
+            sizeof(parms_id_type) - sizeof(uint64_t));
+        SEAL_BYTE is_ntt_form_byte;
+        stream.read(reinterpret_cast<char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
+        uint64_t size64 = 0;
+        stream.read(reinterpret_cast<char*>(&size64), sizeof(uint64_t));
+        uint64_t poly_modulus_degree64 = 0;
+        stream.read(reinterpret_cast<char*>(&poly_modulus_degree64), sizeof(uint64_t));
+        uint64_t coeff_mod_count64 = 0;
+        stream.read(reinterpret_cast<char*>(&coeff_mod_count64), sizeof(uint64_t));
+        double scale = 0;
+        stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
+
+        // Load the data
+        IntArray<ct_coeff_type> new_data(data_.pool());
+        new_data.load(stream);
+        if (unsigned_neq(new_data.size(),
+            mul_safe(size64, poly_modulus_degree64, coeff_mod_count64)))
+        {
+            throw invalid_argument("ciphertext data is invalid");
+        }
+
+        // Set values
+        parms_id_ = parms_id;
+        is_ntt_form_ = (is_ntt_form_byte == SEAL_BYTE(0)) ? false : true;
+        size_ = safe_cast<size_type>(size64);
+        poly_modulus_degree_ = safe_cast<size_type>(poly_modulus_degree64);
+        coeff_mod_count_ = safe_cast<size_type>(coeff_mod_count64);
+        scale_ = scale;
+
+        // Set the data
+        data_.swap_with(new_data);
+    }
+
+    void Ciphertext::save_mappable(ostream &stream, size_t &offset) const
+    {
+        uint64_t header[9]{};
+        copy_n(parms_id_.cbegin(), parms_id_.size(), header);
+        header[4] = static_cast<uint64_t>(is_ntt_form_);
+        header[5] = safe_cast<uint64_t>(size_);
+        header[6] = safe_cast<uint64_t>(poly_modulus_degree_);
+        header[7] = safe_cast<uint64_t>(coeff_mod_count_);
+        memcpy(header + 8, &scale_, sizeof(double));
+        stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+        offset = add_safe(offset, sizeof(header));
+
+        // Pad so that the coefficients are aligned
+        const char padding[mapped_data_alignment]{};
+        size_t padding_size = (mapped_data_alignment - offset % mapped_data_alignment) %
+            mapped_data_alignment;
+        stream.write(padding, safe_cast<streamsize>(padding_size));
+        offset = add_safe(offset, padding_size);
+
+        size_t data_size = mul_safe(data_.size(), sizeof(ct_coeff_type));
+        stream.write(reinterpret_cast<const char*>(data_.cbegin()),
+            safe_cast<streamsize>(data_size));
+        offset = add_safe(offset, data_size);
+    }
+
+    void Ciphertext::unsafe_load_mapped(SEAL_BYTE *buffer, size_t size, size_t &offset)
+    {
+        uint64_t header[9];
+        if (offset > size || size - offset < sizeof(header))
+        {
+            throw invalid_argument("ciphertext data is invalid");
+        }
+        memcpy(header, buffer + offset, sizeof(header));
+        offset += sizeof(header);
+        if (header[5] > SEAL_CIPHERTEXT_SIZE_MAX ||
+            header[6] > SEAL_POLY_MOD_DEGREE_MAX ||
+            header[7] > SEAL_COEFF_MOD_COUNT_MAX)
+        {
+            throw invalid_argument("ciphertext data is invalid");
+        }
+        size_type new_size = safe_cast<size_type>(header[5]);
+        size_type poly_modulus_degree = safe_cast<size_type>(header[6]);
+        size_type coeff_mod_count = safe_cast<size_type>(header[7]);
+
+        offset += (mapped_data_alignment - offset % mapped_data_alignment) %
+            mapped_data_alignment;
+        size_type data_count = mul_safe(new_size, poly_modulus_degree, coeff_mod_count);
+        size_t data_size = mul_safe(data_count, sizeof(ct_coeff_type));
+        if (offset > size || size - offset < data_size)
+        {
+            throw invalid_argument("ciphertext data is invalid");
+        }
+        auto new_data = IntArray<ct_coeff_type>::Aliasing(
+            reinterpret_cast<ct_coeff_type*>(buffer + offset), data_count, data_.pool());
+        offset += data_size;
+
+        // Set values
+        copy_n(header, parms_id_.size(), parms_id_.begin());
+        is_ntt_form_ = (header[4] != 0);
+        size_ = new_size;
+        poly_modulus_degree_ = poly_modulus_degree;
+        coeff_mod_count_ = coeff_mod_count;
+        memcpy(&scale_, header + 8, sizeof(double));
+
+        // Set the data
+        data_ = move(new_data);
+    }
+
+    Pointer<Ciphertext::ct_coeff_type> Ciphertext::make_contiguous(
+        vector<Ciphertext> &ciphertexts, MemoryPoolHandle pool)
+    {
+        size_t data_count = 0;
+        for (auto &ciphertext : ciphertexts)
+        {
+            data_count = add_safe(data_count, ciphertext.data_.size());
+        }
+
+        // Allocate room for shifting the start to a cache line boundary
+        constexpr size_t alignment_count = 64 / sizeof(ct_coeff_type);
+        auto buffer(allocate<ct_coeff_type>(
+            add_safe(data_count, alignment_count - 1), pool));
+        ct_coeff_type *destination = buffer.get();
+        destination += (alignment_count - (reinterpret_cast<uintptr_t>(destination) /
+            sizeof(ct_coeff_type)) % alignment_count) % alignment_count;
+
+        for (auto &ciphertext : ciphertexts)
+        {
+            size_type ciphertext_data_count = ciphertext.data_.size();
+            copy_n(ciphertext.data_.cbegin(), ciphertext_data_count, destination);
+            ciphertext.data_ = IntArray<ct_coeff_type>::Aliasing(destination,
+                ciphertext_data_count, ciphertext.data_.pool());
+            destination += ciphertext_data_count;
+        }
+        return buffer;
     }
 }
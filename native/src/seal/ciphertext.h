@@ -8,13 +8,20 @@
 #include <iostream>
 #include <algorithm>
 #include <memory>
+#include <vector>
 #include "seal/util/defines.h"
 #include "seal/context.h"
 #include "seal/memorymanager.h"
 #include "seal/intarray.h"
+#include "seal/serialization.h"
 
 namespace seal
 {
+    namespace util
+    {
+        class MappedKeys;
+    }
+
     /**
     Class to store a ciphertext element. The data for a ciphertext consists 
     of two or more polynomials, which are in Microsoft SEAL stored in a CRT form with 
@@ -539,11 +546,17 @@ namespace seal
         /**
         Saves the ciphertext to an output stream. The output is in binary format
         and not human-readable. The output stream must have the "binary" flag set.
+        The coefficients are bit-packed to the number of bits they actually use,
+        and ciphertexts saved in the older unpacked format can still be loaded.
+        The output can optionally be compressed; load detects this automatically.
 
         @param[in] stream The stream to save the ciphertext to
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
         @throws std::exception if the ciphertext could not be written to stream
         */
-        void save(std::ostream &stream) const;
+        void save(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
 
         /**
         Loads a ciphertext from an input stream overwriting the current ciphertext.
@@ -578,6 +591,98 @@ namespace seal
             }
         }
 
+        /**
+        Loads a ciphertext from an input stream overwriting the current ciphertext, and
+        verifies it to be valid for the given SEALContext like load does. The
+        data is verified against its stored checksum instead of checking every
+        coefficient, and only the metadata of the ciphertext is validated. Data in
+        the layout that preceded the versioned format has no checksum and is
+        validated fully. The checksum detects
+        corrupted data but not deliberately modified data, so this function
+        should only be used for data from trusted storage.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the ciphertext from
+        @throws std::invalid_argument if the context is not set or encryption
+        parameters are not valid
+        @throws std::exception if a valid ciphertext could not be read from stream
+        @throws std::invalid_argument if the data does not match its checksum
+        @throws std::invalid_argument if the loaded ciphertext is invalid for the
+        context
+        */
+        inline void trusted_load(std::shared_ptr<SEALContext> context,
+            std::istream &stream)
+        {
+            bool verified = load_checked(stream);
+            if (verified ? !is_metadata_valid_for(std::move(context)) :
+                !is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("ciphertext data is invalid");
+            }
+        }
+
+        /**
+        Returns the exact number of bytes that save writes for the ciphertext with the
+        given compression mode, for allocating a buffer to save to. With compression
+        enabled the ciphertext is compressed to determine the size.
+
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save_size(
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Saves the ciphertext to a buffer in the format that save writes to a stream,
+        without intermediate copies. Returns the number of bytes written.
+
+        @param[out] out The buffer to save the ciphertext to
+        @param[in] size The size of the buffer in bytes
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the ciphertext does not fit in size bytes
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save(SEAL_BYTE *out, std::size_t size,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Loads a ciphertext from a buffer overwriting the current ciphertext, and returns
+        the number of bytes read. No checking of the validity of the ciphertext
+        data against encryption parameters is performed. This function should
+        not be used unless the ciphertext comes from a fully trusted source.
+
+        @param[in] in The buffer to load the ciphertext from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid ciphertext could not be read from in
+        */
+        std::size_t unsafe_load(const SEAL_BYTE *in, std::size_t size);
+
+        /**
+        Loads a ciphertext from a buffer overwriting the current ciphertext, and returns
+        the number of bytes read. The loaded ciphertext is verified to be valid
+        for the given SEALContext.
+
+        @param[in] context The SEALContext
+        @param[in] in The buffer to load the ciphertext from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid ciphertext could not be read from in
+        @throws std::invalid_argument if the loaded ciphertext is invalid for the
+        context
+        */
+        inline std::size_t load(std::shared_ptr<SEALContext> context,
+            const SEAL_BYTE *in, std::size_t size)
+        {
+            std::size_t read_count = unsafe_load(in, size);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("ciphertext data is invalid");
+            }
+            return read_count;
+        }
+
         /**
         Returns whether the ciphertext is in NTT form.
         */
@@ -647,6 +752,75 @@ namespace seal
         struct CiphertextPrivateHelper;
 
     private:
+        friend class RelinKeys;
+
+        friend class GaloisKeys;
+
+        friend class util::MappedKeys;
+
+        /**
+        Writes the ciphertext in the layout of key files that can be
+        memory-mapped: the metadata as 64-bit words, followed by the unpacked
+        coefficients starting at a multiple of util::mapped_data_alignment bytes
+        from the start of the file. The offset is the position of the stream
+        relative to the start of the file and is advanced by the bytes written.
+        */
+        void save_mappable(std::ostream &stream, std::size_t &offset) const;
+
+        /**
+        Reads a ciphertext written by save_mappable from the given buffer at the
+        given offset, which is advanced past it. The ciphertext refers to the
+        coefficients in the buffer without copying them.
+
+        @throws std::invalid_argument if the buffer does not hold a valid
+        ciphertext at offset
+        */
+        void unsafe_load_mapped(SEAL_BYTE *buffer, std::size_t size,
+            std::size_t &offset);
+
+        /**
+        Moves the coefficients of the given ciphertexts, in order, to a single
+        newly allocated buffer starting at a 64-byte boundary, and makes the
+        ciphertexts refer to the buffer without owning it. Returns the buffer,
+        which must outlive the ciphertexts' references to it.
+        */
+        static util::Pointer<ct_coeff_type> make_contiguous(
+            std::vector<Ciphertext> &ciphertexts, MemoryPoolHandle pool);
+
+        /**
+        Does the work of unsafe_load. Returns true if the data was verified
+        against a stored checksum, which is the case unless it is in the layout
+        that preceded the versioned format.
+        */
+        bool load_checked(std::istream &stream);
+
+        /**
+        Returns for every RNS component the bit count its coefficients are
+        packed to when saved.
+        */
+        std::vector<SEAL_BYTE> packed_bit_counts() const;
+
+        /**
+        Returns the number of bytes save_members writes.
+        */
+        std::size_t members_save_size() const;
+
+        /**
+        Writes the members following the versioned serialization header.
+        */
+        void save_members(std::ostream &stream) const;
+
+        /**
+        Reads the members written by save_members.
+        */
+        void load_members(std::istream &stream);
+
+        /**
+        Reads a ciphertext saved in the format preceding the versioned one. The
+        first word of the parms_id has already been read.
+        */
+        void load_legacy(std::istream &stream, std::uint64_t parms_id_word);
+
         void reserve_internal(size_type size_capacity, 
             size_type poly_modulus_degree, size_type coeff_mod_count);
 
@@ -5,6 +5,8 @@
 #include <random>
 #include <limits>
 #include <cinttypes>
+#include <cstring>
+#include <algorithm>
 #include "seal/ckks.h"
 
 using namespace std;
@@ -12,10 +14,6 @@ using namespace seal::util;
 
 namespace seal
 {
-    // For C++14 compatibility need to define static constexpr
-    // member variables with no initialization here.
-    constexpr double CKKSEncoder::PI_;
-
     CKKSEncoder::CKKSEncoder(shared_ptr<SEALContext> context) : 
         context_(context)
     {
@@ -60,17 +58,198 @@ namespace seal
             pos &= (m - 1);
         }
 
-        roots_ = allocate<complex<double>>(coeff_count, pool_);
-        inv_roots_ = allocate<complex<double>>(coeff_count, pool_);
-        complex<double> psi{ cos((2 * PI_) / static_cast<double>(m)), 
-            sin((2 * PI_) / static_cast<double>(m)) };
-        for (size_t i = 0; i < coeff_count; i++)
+        fft_tables_ = make_unique<FFTTables>(logn, pool_);
+    }
+
+    void CKKSEncoder::encode_coeffs(const double *coeffs, 
+        const SEALContext::ContextData &context_data, double scale,
+        Plaintext &destination, MemoryPool &pool) const
+    {
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_mod_count = coeff_modulus.size();
+        size_t coeff_count = parms.poly_modulus_degree();
+        auto &small_ntt_tables = context_data.small_ntt_tables();
+
+        // Quick sanity check
+        if (!product_fits_in(coeff_mod_count, coeff_count))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Verify that the values are not too large to fit in coeff_modulus
+        // Note that we have an extra + 1 for the sign bit
+        double max_coeff = get_max_abs(coeffs, coeff_count);
+        if (!isfinite(max_coeff))
+        {
+            throw invalid_argument("encoded values are too large");
+        }
+        int max_coeff_bit_count = max(1, static_cast<int>(log2(max_coeff)) + 2);
+        if (max_coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
+        {
+            throw invalid_argument("encoded values are too large");
+        }
+
+        // Resize destination to appropriate size
+        // Need to first set parms_id to zero, otherwise resize
+        // will throw an exception.
+        destination.parms_id() = parms_id_zero;
+        destination.resize(mul_safe(coeff_count, coeff_mod_count));
+
+        // Decompose the rounded coefficients into RNS form
+        decompose_rounded(coeffs, coeff_count, context_data,
+            max_coeff_bit_count, destination.data(), coeff_count, pool);
+
+        // Transform to NTT domain
+        for (size_t i = 0; i < coeff_mod_count; i++)
+        {
+            ntt_negacyclic_harvey(destination.data(i * coeff_count), small_ntt_tables[i]);
+        }
+
+        destination.parms_id() = context_data.parms().parms_id();
+        destination.scale() = scale;
+    }
+
+    uint64_t CKKSEncoder::hash_values(const double *values, size_t count) noexcept
+    {
+        uint64_t hash = static_cast<uint64_t>(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            uint64_t word;
+            memcpy(&word, values + i, sizeof(uint64_t));
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+            hash ^= hash >> 32;
+        }
+        return hash;
+    }
+
+    namespace
+    {
+        // Combines the hash of the values with the remaining parts of the key
+        inline uint64_t cache_key(uint64_t values_hash, bool is_complex,
+            const parms_id_type &parms_id, double scale)
+        {
+            uint64_t scale_word;
+            memcpy(&scale_word, &scale, sizeof(uint64_t));
+            uint64_t key = values_hash ^ static_cast<uint64_t>(is_complex);
+            for (auto word : parms_id)
+            {
+                key = (key ^ word) * 0x9E3779B97F4A7C15ULL;
+                key ^= key >> 32;
+            }
+            key = (key ^ scale_word) * 0x9E3779B97F4A7C15ULL;
+            return key ^ (key >> 32);
+        }
+    }
+
+    bool CKKSEncoder::cache_lookup(const double *values, size_t count, 
+        uint64_t values_hash, bool is_complex, parms_id_type parms_id, 
+        double scale, Plaintext &destination)
+    {
+        uint64_t key = cache_key(values_hash, is_complex, parms_id, scale);
+
+        auto lock = cache_locker_.acquire_write();
+        auto entry = cache_find(key, values, count, is_complex, parms_id, scale);
+        if (entry == cache_list_.end())
+        {
+            return false;
+        }
+        destination = entry->plain;
+
+        // Mark as most recently used
+        cache_list_.splice(cache_list_.begin(), cache_list_, entry);
+        return true;
+    }
+
+    void CKKSEncoder::cache_insert(const double *values, size_t count,
+        uint64_t values_hash, bool is_complex, const Plaintext &plain)
+    {
+        uint64_t key = cache_key(values_hash, is_complex, plain.parms_id(), plain.scale());
+
+        auto lock = cache_locker_.acquire_write();
+        if (!cache_capacity_)
+        {
+            return;
+        }
+
+        // Replace an entry for the same values, parms_id and scale; entries
+        // that only have the same key are kept
+        auto entry = cache_find(key, values, count, is_complex, plain.parms_id(),
+            plain.scale());
+        if (entry != cache_list_.end())
+        {
+            cache_erase(entry);
+        }
+
+        // Evict the least recently used entries
+        while (cache_list_.size() >= cache_capacity_)
+        {
+            cache_erase(prev(cache_list_.end()));
+        }
+
+        Plaintext cached_plain(pool_);
+        cached_plain = plain;
+        cache_list_.push_front(CacheEntry{ key, is_complex, 
+            vector<double>(values, values + count), move(cached_plain) });
+        cache_map_.emplace(key, cache_list_.begin());
+    }
+
+    list<CKKSEncoder::CacheEntry>::iterator CKKSEncoder::cache_find(uint64_t key,
+        const double *values, size_t count, bool is_complex,
+        const parms_id_type &parms_id, double scale)
+    {
+        // The key is only a hash, so the entries are compared in full
+        auto range = cache_map_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto &entry = *it->second;
+            if (entry.is_complex == is_complex && entry.plain.parms_id() == parms_id &&
+                entry.plain.scale() == scale && entry.values.size() == count &&
+                equal(entry.values.cbegin(), entry.values.cend(), values))
+            {
+                return it->second;
+            }
+        }
+        return cache_list_.end();
+    }
+
+    void CKKSEncoder::cache_erase(list<CacheEntry>::iterator entry)
+    {
+        auto range = cache_map_.equal_range(entry->key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                cache_map_.erase(it);
+                break;
+            }
+        }
+        cache_list_.erase(entry);
+    }
+
+    void CKKSEncoder::set_cache_capacity(size_t capacity)
+    {
+        auto lock = cache_locker_.acquire_write();
+        cache_capacity_ = capacity;
+        while (cache_list_.size() > cache_capacity_)
         {
-            roots_[i] = pow(psi, static_cast<double>(reverse_bits(i, logn)));
-            inv_roots_[i] = 1.0 / roots_[i];
+            cache_erase(prev(cache_list_.end()));
         }
     }
 
+    size_t CKKSEncoder::cache_size()
+    {
+        auto lock = cache_locker_.acquire_read();
+        return cache_list_.size();
+    }
+
+    void CKKSEncoder::clear_cache()
+    {
+        auto lock = cache_locker_.acquire_write();
+        cache_map_.clear();
+        cache_list_.clear();
+    }
+
     void CKKSEncoder::encode_internal(double value, parms_id_type parms_id, 
         double scale, Plaintext &destination, MemoryPoolHandle pool)
     {
@@ -107,106 +286,26 @@ namespace seal
         // Compute the scaled value
         value *= scale;
 
-        int coeff_bit_count = static_cast<int>(log2(fabs(value))) + 2;
+        int coeff_bit_count = max(1, static_cast<int>(log2(fabs(value))) + 2);
         if (coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
         {
             throw invalid_argument("encoded value is too large");
         }
 
-        double two_pow_64 = pow(2.0, 64);
-
         // Resize destination to appropriate size
         // Need to first set parms_id to zero, otherwise resize
         // will throw an exception.
         destination.parms_id() = parms_id_zero;
         destination.resize(coeff_count * coeff_mod_count);
 
-        double coeffd = round(value);
-        bool is_negative = signbit(coeffd);
-        coeffd = fabs(coeffd);
-
-        // Use faster decomposition methods when possible
-        if (coeff_bit_count <= 64)
+        // Decompose the rounded value into the first coefficient of each
+        // RNS component and copy it to the rest
+        decompose_rounded(&value, 1, context_data, coeff_bit_count,
+            destination.data(), coeff_count, pool);
+        for (size_t j = 0; j < coeff_mod_count; j++)
         {
-            uint64_t coeffu = static_cast<uint64_t>(fabs(coeffd));
-
-            if (is_negative)
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        negate_uint_mod(coeffu % coeff_modulus[j].value(),
-                            coeff_modulus[j]));
-                }
-            }
-            else
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        coeffu % coeff_modulus[j].value());
-                }
-            }
-        }
-        else if (coeff_bit_count <= 128)
-        {
-            uint64_t coeffu[2]{
-                static_cast<uint64_t>(fmod(coeffd, two_pow_64)),
-                static_cast<uint64_t>(coeffd / two_pow_64) };
-
-            if (is_negative)
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        negate_uint_mod(barrett_reduce_128(
-                            coeffu, coeff_modulus[j]), coeff_modulus[j]));
-                }
-            }
-            else
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        barrett_reduce_128(coeffu, coeff_modulus[j]));
-                }
-            }
-        }
-        else
-        {
-            // Slow case
-            auto coeffu(allocate_uint(coeff_mod_count, pool));
-            auto decomp_coeffu(allocate_uint(coeff_mod_count, pool));
-
-            // We are at this point guaranteed to fit in the allocated space
-            set_zero_uint(coeff_mod_count, coeffu.get());
-            auto coeffu_ptr = coeffu.get();
-            while (coeffd >= 1)
-            {
-                *coeffu_ptr++ = static_cast<uint64_t>(fmod(coeffd, two_pow_64));
-                coeffd /= two_pow_64;
-            }
-
-            // Next decompose this coefficient
-            decompose_single_coeff(context_data, coeffu.get(), decomp_coeffu.get(), pool);
-
-            // Finally replace the sign if necessary
-            if (is_negative)
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        negate_uint_mod(decomp_coeffu[j], coeff_modulus[j]));
-                }
-            }
-            else
-            {
-                for (size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    fill_n(destination.data() + (j * coeff_count), coeff_count,
-                        decomp_coeffu[j]);
-                }
-            }
+            uint64_t *destination_ptr = destination.data() + (j * coeff_count);
+            fill_n(destination_ptr + 1, coeff_count - 1, *destination_ptr);
         }
 
         destination.parms_id() = parms_id;
@@ -235,8 +334,11 @@ namespace seal
             throw logic_error("invalid parameters");
         }
 
-        int coeff_bit_count = get_significant_bit_count(
-            static_cast<uint64_t>(llabs(value))) + 2;
+        // The magnitude of INT64_MIN is not an int64_t, so it is computed as
+        // an unsigned value
+        uint64_t coeffu = (value < 0) ? uint64_t(0) - static_cast<uint64_t>(value) :
+            static_cast<uint64_t>(value);
+        int coeff_bit_count = get_significant_bit_count(coeffu) + 2;
         if (coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
         {
             throw invalid_argument("encoded value is too large");
@@ -248,27 +350,274 @@ namespace seal
         destination.parms_id() = parms_id_zero;
         destination.resize(coeff_count * coeff_mod_count);
 
-        if (value < 0)
+        for (size_t j = 0; j < coeff_mod_count; j++)
+        {
+            uint64_t tmp = barrett_reduce_64(coeffu, coeff_modulus[j]);
+            if (value < 0)
+            {
+                tmp = negate_uint_mod(tmp, coeff_modulus[j]);
+            }
+            fill_n(destination.data() + (j * coeff_count), coeff_count, tmp);
+        }
+
+        destination.parms_id() = parms_id;
+        destination.scale() = 1.0;
+    }
+
+    void CKKSEncoder::decompose_rounded(const double *values, size_t count,
+        const SEALContext::ContextData &context_data, int max_coeff_bit_count,
+        uint64_t *destination, size_t stride, MemoryPool &pool) const
+    {
+        auto &coeff_modulus = context_data.parms().coeff_modulus();
+        size_t coeff_mod_count = coeff_modulus.size();
+
+        // Signs are stored separately from the magnitudes
+        auto is_negative(allocate_uint(count, pool));
+
+        if (max_coeff_bit_count <= 64)
         {
+            // Magnitudes fit in a single word
+            auto coeffu(allocate_uint(count, pool));
+            for (size_t i = 0; i < count; i++)
+            {
+                double coeffd = round(values[i]);
+                is_negative[i] = signbit(coeffd);
+                coeffu[i] = static_cast<uint64_t>(fabs(coeffd));
+            }
+
             for (size_t j = 0; j < coeff_mod_count; j++)
             {
-                uint64_t tmp = static_cast<uint64_t>(value);
-                tmp += coeff_modulus[j].value();
-                tmp %= coeff_modulus[j].value();
-                fill_n(destination.data() + (j * coeff_count), coeff_count, tmp);
+                auto &modulus = coeff_modulus[j];
+                uint64_t *destination_ptr = destination + (j * stride);
+                for (size_t i = 0; i < count; i++)
+                {
+                    uint64_t reduced = barrett_reduce_64(coeffu[i], modulus);
+                    destination_ptr[i] = is_negative[i] ?
+                        negate_uint_mod(reduced, modulus) : reduced;
+                }
             }
+            return;
         }
-        else
+
+        // A double has at most 53 significant bits, so every magnitude equals
+        // a 128-bit value times 2^(64 * word_index) for some word_index. We
+        // extract these exactly from the exponent and the mantissa.
+        double two_pow_64 = pow(2.0, 64);
+        auto coeffu(allocate_uint(mul_safe(count, size_t(2)), pool));
+        auto word_index(allocate_uint(count, pool));
+        for (size_t i = 0; i < count; i++)
+        {
+            double coeffd = round(values[i]);
+            is_negative[i] = signbit(coeffd);
+            coeffd = fabs(coeffd);
+
+            uint64_t *coeffu_ptr = coeffu.get() + (2 * i);
+            if (coeffd < two_pow_64)
+            {
+                coeffu_ptr[0] = static_cast<uint64_t>(coeffd);
+                coeffu_ptr[1] = 0;
+                word_index[i] = 0;
+                continue;
+            }
+
+            // Now coeffd = mantissa * 2^exponent with exponent > 64
+            int exponent;
+            uint64_t mantissa = static_cast<uint64_t>(
+                ldexp(frexp(coeffd, &exponent), 53));
+            int shift = exponent - 53;
+            int bit_shift = shift % bits_per_uint64;
+            word_index[i] = static_cast<uint64_t>(shift / bits_per_uint64);
+            coeffu_ptr[0] = mantissa << bit_shift;
+            coeffu_ptr[1] = bit_shift ? mantissa >> (bits_per_uint64 - bit_shift) : 0;
+        }
+
+        // Powers 2^(64 * k) modulo the current prime for each possible word_index
+        size_t word_count = static_cast<size_t>(
+            divide_round_up(max_coeff_bit_count, bits_per_uint64));
+        auto word_powers(allocate_uint(word_count, pool));
+        for (size_t j = 0; j < coeff_mod_count; j++)
+        {
+            auto &modulus = coeff_modulus[j];
+            const uint64_t two_pow_64_uint[2]{ 0, 1 };
+            uint64_t two_pow_64_mod = barrett_reduce_128(two_pow_64_uint, modulus);
+            word_powers[0] = 1;
+            for (size_t k = 1; k < word_count; k++)
+            {
+                word_powers[k] = multiply_uint_uint_mod(
+                    word_powers[k - 1], two_pow_64_mod, modulus);
+            }
+
+            uint64_t *destination_ptr = destination + (j * stride);
+            for (size_t i = 0; i < count; i++)
+            {
+                uint64_t reduced = barrett_reduce_128(coeffu.get() + (2 * i), modulus);
+                if (word_index[i])
+                {
+                    reduced = multiply_uint_uint_mod(
+                        reduced, word_powers[word_index[i]], modulus);
+                }
+                destination_ptr[i] = is_negative[i] ?
+                    negate_uint_mod(reduced, modulus) : reduced;
+            }
+        }
+    }
+
+    void CKKSEncoder::compose_scaled(const SEALContext::ContextData &context_data,
+        const uint64_t *plain, double inv_scale, double *destination,
+        MemoryPool &pool) const
+    {
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_mod_count = coeff_modulus.size();
+        size_t coeff_count = parms.poly_modulus_degree();
+
+        auto decryption_modulus = context_data.total_coeff_modulus();
+        auto upper_half_threshold = context_data.upper_half_threshold();
+        auto &inv_coeff_products_mod_coeff_array =
+            context_data.base_converter()->get_inv_coeff_mod_coeff_array();
+        auto coeff_products_array =
+            context_data.base_converter()->get_coeff_products_array();
+
+        // The composition of a coefficient is x = sum_j y_j * (q / q_j) - v * q,
+        // where y_j = x_j * (q / q_j)^(-1) mod q_j and v = round(sum_j y_j / q_j).
+        // We compute v in floating-point and the sum exactly modulo 2^128.
+        auto fraction_sum(allocate<double>(coeff_count, pool, 0));
+        auto composed(allocate_zero_uint(mul_safe(coeff_count, size_t(2)), pool));
+        for (size_t j = 0; j < coeff_mod_count; j++)
+        {
+            auto &modulus = coeff_modulus[j];
+            double inv_modulus = double(1.0) / static_cast<double>(modulus.value());
+            const uint64_t *coeff_product = coeff_products_array + (j * coeff_mod_count);
+            uint64_t coeff_product_high = (coeff_mod_count > 1) ? coeff_product[1] : 0;
+            const uint64_t *plain_ptr = plain + (j * coeff_count);
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                uint64_t y = multiply_uint_uint_mod(plain_ptr[i],
+                    inv_coeff_products_mod_coeff_array[j], modulus);
+                fraction_sum[i] += static_cast<double>(y) * inv_modulus;
+
+                unsigned long long product[2];
+                multiply_uint64(y, coeff_product[0], product);
+                product[1] += y * coeff_product_high;
+                uint64_t *composed_ptr = composed.get() + (2 * i);
+                unsigned char carry = add_uint64(composed_ptr[0], product[0], composed_ptr);
+                composed_ptr[1] += product[1] + carry;
+            }
+        }
+
+        // The rounding error in fraction_sum is at most coeff_mod_count^2 * 2^(-52),
+        // so v is certainly correct unless the fraction is within this margin of 1/2
+        double margin = ldexp(static_cast<double>(coeff_mod_count * coeff_mod_count), -50);
+        uint64_t decryption_modulus_high = (coeff_mod_count > 1) ? decryption_modulus[1] : 0;
+        auto is_negative(allocate_uint(coeff_count, pool));
+        auto needs_slow_path(allocate_uint(coeff_count, pool));
+        for (size_t i = 0; i < coeff_count; i++)
+        {
+            double v = round(fraction_sum[i]);
+            needs_slow_path[i] = (fabs(fraction_sum[i] - v) > 0.5 - margin);
+
+            unsigned long long product[2];
+            uint64_t vu = static_cast<uint64_t>(v);
+            multiply_uint64(vu, decryption_modulus[0], product);
+            product[1] += vu * decryption_modulus_high;
+            uint64_t *composed_ptr = composed.get() + (2 * i);
+            unsigned char borrow = sub_uint64(composed_ptr[0], product[0], composed_ptr);
+            composed_ptr[1] -= product[1] + borrow;
+
+            // Replace by absolute value
+            is_negative[i] = composed_ptr[1] >> (bits_per_uint64 - 1);
+            if (is_negative[i])
+            {
+                negate_uint(composed_ptr, 2, composed_ptr);
+            }
+        }
+
+        // If q is at least 2^127 the result may have overflowed 128 bits; this
+        // is detected by comparing the result to the input modulo each prime
+        if (context_data.total_coeff_modulus_bit_count() >= 127)
         {
             for (size_t j = 0; j < coeff_mod_count; j++)
             {
-                uint64_t tmp = static_cast<uint64_t>(value);
-                tmp %= coeff_modulus[j].value();
-                fill_n(destination.data() + (j * coeff_count), coeff_count, tmp);
+                auto &modulus = coeff_modulus[j];
+                const uint64_t *plain_ptr = plain + (j * coeff_count);
+                for (size_t i = 0; i < coeff_count; i++)
+                {
+                    uint64_t reduced = barrett_reduce_128(composed.get() + (2 * i), modulus);
+                    if (is_negative[i])
+                    {
+                        reduced = negate_uint_mod(reduced, modulus);
+                    }
+                    needs_slow_path[i] |= (reduced != plain_ptr[i]);
+                }
             }
         }
 
-        destination.parms_id() = parms_id;
-        destination.scale() = 1.0;
+        double two_pow_64 = pow(2.0, 64);
+        auto temp(allocate_uint(coeff_mod_count, pool));
+        auto wide_composed(allocate_uint(coeff_mod_count, pool));
+        for (size_t i = 0; i < coeff_count; i++)
+        {
+            if (!needs_slow_path[i])
+            {
+                const uint64_t *composed_ptr = composed.get() + (2 * i);
+                double res = (static_cast<double>(composed_ptr[1]) * two_pow_64 +
+                    static_cast<double>(composed_ptr[0])) * inv_scale;
+                destination[i] = is_negative[i] ? -res : res;
+                continue;
+            }
+
+            // Multi-precision composition
+            set_zero_uint(coeff_mod_count, wide_composed.get());
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                uint64_t tmp = multiply_uint_uint_mod(
+                    plain[(j * coeff_count) + i],
+                    inv_coeff_products_mod_coeff_array[j], // (qi/q * plain[i]) mod qi
+                    coeff_modulus[j]);
+                multiply_uint_uint64(
+                    coeff_products_array + (j * coeff_mod_count),
+                    coeff_mod_count, tmp, coeff_mod_count, temp.get());
+                add_uint_uint_mod(temp.get(), wide_composed.get(),
+                    decryption_modulus, coeff_mod_count, wide_composed.get());
+            }
+
+            double res = 0.0;
+            double scaled_two_pow_64 = inv_scale;
+            if (is_greater_than_or_equal_uint_uint(
+                wide_composed.get(), upper_half_threshold, coeff_mod_count))
+            {
+                for (size_t j = 0; j < coeff_mod_count;
+                    j++, scaled_two_pow_64 *= two_pow_64)
+                {
+                    if (wide_composed[j] > decryption_modulus[j])
+                    {
+                        auto diff = wide_composed[j] - decryption_modulus[j];
+                        res += diff ?
+                            static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
+                    }
+                    else
+                    {
+                        auto diff = decryption_modulus[j] - wide_composed[j];
+                        res -= diff ?
+                            static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
+                    }
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < coeff_mod_count;
+                    j++, scaled_two_pow_64 *= two_pow_64)
+                {
+                    auto curr_coeff = wide_composed[j];
+                    res += curr_coeff ?
+                        static_cast<double>(curr_coeff) * scaled_two_pow_64 : 0.0;
+                }
+            }
+
+            // Scaling instead incorporated above; this can help in cases
+            // where otherwise pow(two_pow_64, j) would overflow due to very
+            // large coeff_mod_count and very large scale
+            destination[i] = res;
+        }
     }
 }
@@ -9,11 +9,15 @@
 #include <cmath>
 #include <vector>
 #include <limits>
+#include <list>
+#include <unordered_map>
 #include "seal/plaintext.h"
 #include "seal/context.h"
 #include "seal/util/common.h"
 #include "seal/util/uintcore.h"
 #include "seal/util/uintarithsmallmod.h"
+#include "seal/util/fft.h"
+#include "seal/util/locks.h"
 
 namespace seal
 {
@@ -95,7 +99,7 @@ namespace seal
             parms_id_type parms_id, double scale, Plaintext &destination,
             MemoryPoolHandle pool = MemoryManager::GetPool())
         {
-            encode_internal(values, parms_id, scale, destination, std::move(pool));
+            encode_internal(values, &parms_id, &scale, &destination, 1, std::move(pool));
         }
 
         /**
@@ -127,6 +131,87 @@ namespace seal
                 destination, std::move(pool));
         }
 
+        /**
+        Encodes double-precision floating-point real or complex numbers into one 
+        plaintext polynomial for each of the given parms_ids and scales. The FFT is 
+        computed only once and shared by all of the resulting plaintexts, which makes 
+        this much faster than encoding the same values separately for each level. 
+        The i-th plaintext is encoded with parms_ids[i] and scales[i], and is equal 
+        (up to floating-point rounding when the scales differ) to the result of 
+        encoding with these parameters separately. Dynamic memory allocations in the 
+        process are allocated from the memory pool pointed to by the given 
+        MemoryPoolHandle.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] values The vector of double-precision floating-point numbers 
+        (of type T) to encode
+        @param[in] parms_ids The parms_ids determining the encryption parameters to be
+        used by the result plaintexts
+        @param[in] scales The scaling parameters for the result plaintexts
+        @param[out] destination The vector of plaintexts to overwrite with the results
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if values has invalid size
+        @throws std::invalid_argument if parms_ids and scales have different sizes
+        @throws std::invalid_argument if any parms_id is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if any scale is not strictly positive
+        @throws std::invalid_argument if encoding is too large for the encryption 
+        parameters
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline void encode(const std::vector<T> &values,
+            const std::vector<parms_id_type> &parms_ids, 
+            const std::vector<double> &scales, std::vector<Plaintext> &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            if (parms_ids.size() != scales.size())
+            {
+                throw std::invalid_argument("parms_ids and scales have different sizes");
+            }
+            destination.resize(parms_ids.size());
+            encode_internal(values, parms_ids.data(), scales.data(), 
+                destination.data(), parms_ids.size(), std::move(pool));
+        }
+
+        /**
+        Encodes double-precision floating-point real or complex numbers into one 
+        plaintext polynomial for each of the given parms_ids, all with the same 
+        scale. The FFT is computed only once and shared by all of the resulting 
+        plaintexts, which makes this much faster than encoding the same values 
+        separately for each level. Dynamic memory allocations in the process are 
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] values The vector of double-precision floating-point numbers 
+        (of type T) to encode
+        @param[in] parms_ids The parms_ids determining the encryption parameters to be
+        used by the result plaintexts
+        @param[in] scale Scaling parameter defining encoding precision
+        @param[out] destination The vector of plaintexts to overwrite with the results
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if values has invalid size
+        @throws std::invalid_argument if any parms_id is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if scale is not strictly positive
+        @throws std::invalid_argument if encoding is too large for the encryption 
+        parameters
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline void encode(const std::vector<T> &values,
+            const std::vector<parms_id_type> &parms_ids, double scale, 
+            std::vector<Plaintext> &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            encode(values, parms_ids, std::vector<double>(parms_ids.size(), scale),
+                destination, std::move(pool));
+        }
+
         /**
         Encodes a double-precision floating-point number into a plaintext polynomial. 
         Dynamic memory allocations in the process are allocated from the memory pool 
@@ -256,6 +341,14 @@ namespace seal
         complex numbers. Dynamic memory allocations in the process are allocated from 
         the memory pool pointed to by the given MemoryPoolHandle.
 
+        The coefficients of the plaintext are reconstructed from their RNS
+        representation without multi-precision arithmetic whenever they fit in
+        127 bits, which is the case for all but extremely large scales. The
+        reconstruction is exact, so the only rounding errors are those of the
+        conversion of each coefficient to double (relative error at most 2^(-52))
+        and of the subsequent FFT. Larger coefficients automatically fall back
+        to exact multi-precision reconstruction with the same error bounds.
+
         @tparam T Vector value type (double or std::complex<double>)
         @param[in] plain The plaintext to decode
         @param[out] destination The vector to be overwritten with the values in the slots
@@ -281,68 +374,70 @@ namespace seal
             return slots_;
         }
 
-    private:
-        // This is the same function as in evaluator.h
-        inline void decompose_single_coeff(
-            const SEALContext::ContextData &context_data, const std::uint64_t *value, 
-            std::uint64_t *destination, util::MemoryPool &pool)
+        /**
+        Enables a cache of encoded plaintexts holding at most the given number of
+        plaintexts. When the cache is enabled, encoding a vector of values with a 
+        parms_id and scale that were recently used for the same values returns a 
+        copy of the cached plaintext instead of encoding again. This is useful 
+        when the same constants (masks, weights, polynomial coefficients) are 
+        encoded repeatedly. When the cache is full, the least recently used 
+        plaintext is evicted. Setting the capacity to zero disables and clears 
+        the cache. The cache is disabled by default.
+
+        The cache uses its own memory pool and is safe to use concurrently from
+        multiple threads, but this function must not be called concurrently with
+        any other member function of the CKKSEncoder.
+
+        @param[in] capacity The maximum number of plaintexts to cache
+        */
+        void set_cache_capacity(std::size_t capacity);
+
+        /**
+        Returns the maximum number of plaintexts held in the cache.
+        */
+        inline std::size_t cache_capacity() const noexcept
         {
-            auto &parms = context_data.parms();
-            auto &coeff_modulus = parms.coeff_modulus();
-            std::size_t coeff_mod_count = coeff_modulus.size();
-#ifdef SEAL_DEBUG
-            if (value == nullptr)
-            {
-                throw std::invalid_argument("value cannot be null");
-            }
-            if (destination == nullptr)
-            {
-                throw std::invalid_argument("destination cannot be null");
-            }
-            if (destination == value)
-            {
-                throw std::invalid_argument("value cannot be the same as destination");
-            }
-#endif
-            if (coeff_mod_count == 1)
-            {
-                util::set_uint_uint(value, coeff_mod_count, destination);
-                return;
-            }
+            return cache_capacity_;
+        }
 
-            auto value_copy(util::allocate_uint(coeff_mod_count, pool));
-            for (std::size_t j = 0; j < coeff_mod_count; j++)
-            {
-                //destination[j] = util::modulo_uint(
-                //    value, coeff_mod_count, coeff_modulus_[j], pool);
+        /**
+        Returns the number of plaintexts currently held in the cache.
+        */
+        std::size_t cache_size();
 
-                // Manually inlined for efficiency
-                // Make a fresh copy of value
-                util::set_uint_uint(value, coeff_mod_count, value_copy.get());
+        /**
+        Removes all plaintexts from the cache.
+        */
+        void clear_cache();
 
-                // Starting from the top, reduce always 128-bit blocks
-                for (std::size_t k = coeff_mod_count - 1; k--; )
-                {
-                    value_copy[k] = util::barrett_reduce_128(
-                        value_copy.get() + k, coeff_modulus[j]);
-                }
-                destination[j] = value_copy[0];
-            }
-        }
+    private:
+        /**
+        Rounds count values to the nearest integers and writes their residues
+        modulo each prime in the coefficient modulus to destination, with the
+        residues modulo the j-th prime starting at destination + j * stride.
+        The magnitudes of the rounded values must fit in max_coeff_bit_count - 1
+        bits. The reduction uses Barrett reduction only and performs no
+        divisions.
+        */
+        void decompose_rounded(const double *values, std::size_t count,
+            const SEALContext::ContextData &context_data, int max_coeff_bit_count,
+            std::uint64_t *destination, std::size_t stride,
+            util::MemoryPool &pool) const;
 
+        /**
+        Encodes values once for each of the count given pairs of parms_id and
+        scale, writing the results to destination[0], ..., destination[count - 1].
+        The FFT is computed only once; plaintexts found in the cache are not
+        recomputed at all.
+        */
         template<typename T,
             typename = std::enable_if_t<std::is_same<T, double>::value ||
             std::is_same<T, std::complex<double>>::value>>
         void encode_internal(const std::vector<T> &values,
-                parms_id_type parms_id, double scale, Plaintext &destination,
-                MemoryPoolHandle pool)
+                const parms_id_type *parms_ids, const double *scales, 
+                Plaintext *destination, std::size_t count, MemoryPoolHandle pool)
         {
             // Verify parameters.
-            auto context_data_ptr = context_->context_data(parms_id);
-            if (!context_data_ptr)
-            {
-                throw std::invalid_argument("parms_id is not valid for encryption parameters");
-            }
             if (values.size() > slots_)
             {
                 throw std::invalid_argument("values has invalid size");
@@ -351,208 +446,148 @@ namespace seal
             {
                 throw std::invalid_argument("pool is uninitialized");
             }
-
-            auto &context_data = *context_data_ptr;
-            auto &parms = context_data.parms();
-            auto &coeff_modulus = parms.coeff_modulus();
-            std::size_t coeff_mod_count = coeff_modulus.size();
-            std::size_t coeff_count = parms.poly_modulus_degree();
-
-            // Quick sanity check
-            if (!util::product_fits_in(coeff_mod_count, coeff_count))
+            for (std::size_t i = 0; i < count; i++)
             {
-                throw std::logic_error("invalid parameters");
-            }
+                auto context_data_ptr = context_->context_data(parms_ids[i]);
+                if (!context_data_ptr)
+                {
+                    throw std::invalid_argument("parms_id is not valid for encryption parameters");
+                }
 
-            // Check that scale is positive and not too large
-            if (scale <= 0 || (static_cast<int>(log2(scale)) + 1 >=
-                context_data.total_coeff_modulus_bit_count()))
-            {
-                throw std::invalid_argument("scale out of bounds");
+                // Check that scale is positive and not too large
+                if (scales[i] <= 0 || (static_cast<int>(log2(scales[i])) + 1 >=
+                    context_data_ptr->total_coeff_modulus_bit_count()))
+                {
+                    throw std::invalid_argument("scale out of bounds");
+                }
             }
 
-            auto &small_ntt_tables = context_data.small_ntt_tables();
-
             // input_size is guaranteed to be no bigger than slots_
             std::size_t input_size = values.size();
-            std::size_t n = util::mul_safe(slots_, std::size_t(2));
 
-            auto conj_values = util::allocate<std::complex<double>>(n, pool, 0);
-            for (std::size_t i = 0; i < input_size; i++)
+            // A std::complex<double> is laid out as two doubles
+            const double *values_data = reinterpret_cast<const double *>(values.data());
+            std::size_t values_double_count = util::mul_safe(input_size, 
+                sizeof(T) / sizeof(double));
+            bool is_complex = std::is_same<T, std::complex<double>>::value;
+
+            // Find the plaintexts that are not already in the cache
+            bool use_cache = (cache_capacity_ > 0);
+            std::uint64_t values_hash = 0;
+            if (use_cache)
             {
-                conj_values[matrix_reps_index_map_[i]] = values[i];
-                conj_values[matrix_reps_index_map_[i + slots_]] = std::conj(values[i]);
+                values_hash = hash_values(values_data, values_double_count);
             }
-
-            int logn = util::get_power_of_two(n);
-            std::size_t tt = 1;
-            for (int i = 0; i < logn; i++)
+            std::vector<std::size_t> missing;
+            for (std::size_t i = 0; i < count; i++)
             {
-                std::size_t mm = std::size_t(1) << (logn - i);
-                std::size_t k_start = 0;
-                std::size_t h = mm / 2;
-
-                for (std::size_t j = 0; j < h; j++)
+                if (!use_cache || !cache_lookup(values_data, values_double_count,
+                    values_hash, is_complex, parms_ids[i], scales[i], destination[i]))
                 {
-                    std::size_t k_end = k_start + tt;
-                    auto s = inv_roots_[h + j];
-
-                    for (std::size_t k = k_start; k < k_end; k++)
-                    {
-                        auto u = conj_values[k];
-                        auto v = conj_values[k + tt];
-                        conj_values[k] = u + v;
-                        conj_values[k + tt] = (u - v) * s;
-                    }
-
-                    k_start += 2 * tt;
+                    missing.push_back(i);
                 }
-                tt *= 2;
             }
-
-            double n_inv = double(1.0) / static_cast<double>(n);
-            
-            // Put the scale in at this point 
-            n_inv *= scale;
-
-            int max_coeff_bit_count = 1;
-            for (std::size_t i = 0; i < n; i++)
+            if (missing.empty())
             {
-                // Multiply by scale and n_inv (see above)
-                conj_values[i] *= n_inv;
-
-                // Verify that the values are not too large to fit in coeff_modulus
-                // Note that we have an extra + 1 for the sign bit
-                max_coeff_bit_count = std::max(max_coeff_bit_count,
-                    static_cast<int>(std::log2(std::fabs(conj_values[i].real()))) + 2);
+                return;
             }
-            if (max_coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
+
+            std::size_t n = util::mul_safe(slots_, std::size_t(2));
+
+            // Real and imaginary parts are kept in separate arrays for the FFT
+            auto conj_values_real = util::allocate<double>(n, pool, 0);
+            auto conj_values_imag = util::allocate<double>(n, pool, 0);
+            for (std::size_t i = 0; i < input_size; i++)
             {
-                throw std::invalid_argument("encoded values are too large");
+                std::complex<double> value(values[i]);
+                conj_values_real[matrix_reps_index_map_[i]] = value.real();
+                conj_values_imag[matrix_reps_index_map_[i]] = value.imag();
+                conj_values_real[matrix_reps_index_map_[i + slots_]] = value.real();
+                conj_values_imag[matrix_reps_index_map_[i + slots_]] = -value.imag();
             }
 
-            double two_pow_64 = std::pow(2.0, 64);
-
-            // Resize destination to appropriate size
-            // Need to first set parms_id to zero, otherwise resize
-            // will throw an exception.
-            destination.parms_id() = parms_id_zero;
-            destination.resize(util::mul_safe(coeff_count, coeff_mod_count));
+            // Transform, multiplying by the first scale and 1/n in the last pass
+            double base_scale = scales[missing[0]];
+            double n_inv = double(1.0) / static_cast<double>(n);
+            util::inverse_fft_negacyclic(conj_values_real.get(),
+                conj_values_imag.get(), *fft_tables_, n_inv * base_scale);
 
-            // Use faster decomposition methods when possible
-            if (max_coeff_bit_count <= 64)
+            // Coefficients for other scales are obtained by rescaling
+            util::Pointer<double> rescaled;
+            for (auto i : missing)
             {
-                for (std::size_t i = 0; i < n; i++)
+                const double *coeffs = conj_values_real.get();
+                if (scales[i] != base_scale)
                 {
-                    double coeffd = std::round(conj_values[i].real());
-                    bool is_negative = std::signbit(coeffd);
-
-                    std::uint64_t coeffu = 
-                        static_cast<std::uint64_t>(std::fabs(coeffd));
-
-                    if (is_negative)
+                    if (!rescaled)
                     {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = util::negate_uint_mod(
-                                coeffu % coeff_modulus[j].value(), coeff_modulus[j]);
-                        }
+                        rescaled = util::allocate<double>(n, pool);
                     }
-                    else
+                    double factor = scales[i] / base_scale;
+                    for (std::size_t j = 0; j < n; j++)
                     {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = 
-                                coeffu % coeff_modulus[j].value();
-                        }
+                        rescaled[j] = conj_values_real[j] * factor;
                     }
+                    coeffs = rescaled.get();
                 }
-            }
-            else if (max_coeff_bit_count <= 128)
-            {
-                for (std::size_t i = 0; i < n; i++)
-                {
-                    double coeffd = std::round(conj_values[i].real());
-                    bool is_negative = std::signbit(coeffd);
-                    coeffd = std::fabs(coeffd);
 
-                    std::uint64_t coeffu[2]{
-                        static_cast<std::uint64_t>(std::fmod(coeffd, two_pow_64)),
-                        static_cast<std::uint64_t>(coeffd / two_pow_64) };
+                encode_coeffs(coeffs, *context_->context_data(parms_ids[i]), 
+                    scales[i], destination[i], pool);
 
-                    if (is_negative)
-                    {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = 
-                                util::negate_uint_mod(util::barrett_reduce_128(
-                                    coeffu, coeff_modulus[j]), coeff_modulus[j]);
-                        }
-                    }
-                    else
-                    {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = 
-                                util::barrett_reduce_128(coeffu, coeff_modulus[j]);
-                        }
-                    }
+                if (use_cache)
+                {
+                    cache_insert(values_data, values_double_count, values_hash,
+                        is_complex, destination[i]);
                 }
             }
-            else
-            {
-                // Slow case
-                auto coeffu(util::allocate_uint(coeff_mod_count, pool));
-                auto decomp_coeffu(util::allocate_uint(coeff_mod_count, pool));
-                for (std::size_t i = 0; i < n; i++)
-                {
-                    double coeffd = std::round(conj_values[i].real());
-                    bool is_negative = std::signbit(coeffd);
-                    coeffd = std::fabs(coeffd);
-
-                    // We are at this point guaranteed to fit in the allocated space
-                    util::set_zero_uint(coeff_mod_count, coeffu.get());
-                    auto coeffu_ptr = coeffu.get();
-                    while (coeffd >= 1)
-                    {
-                        *coeffu_ptr++ = static_cast<std::uint64_t>(
-                            std::fmod(coeffd, two_pow_64));
-                        coeffd /= two_pow_64;
-                    }
+        }
 
-                    // Next decompose this coefficient
-                    decompose_single_coeff(context_data, coeffu.get(), 
-                        decomp_coeffu.get(), pool);
+        /**
+        Rounds the scaled polynomial coefficients coeffs, decomposes them into
+        RNS form for the given level, and writes the result to destination in
+        NTT form.
+        */
+        void encode_coeffs(const double *coeffs, 
+            const SEALContext::ContextData &context_data, double scale,
+            Plaintext &destination, util::MemoryPool &pool) const;
 
-                    // Finally replace the sign if necessary
-                    if (is_negative)
-                    {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = 
-                                util::negate_uint_mod(decomp_coeffu[j], coeff_modulus[j]);
-                        }
-                    }
-                    else
-                    {
-                        for (std::size_t j = 0; j < coeff_mod_count; j++)
-                        {
-                            destination[i + (j * coeff_count)] = decomp_coeffu[j];
-                        }
-                    }
-                }
-            }
+        /**
+        Returns a hash of the given values for use as a cache key.
+        */
+        static std::uint64_t hash_values(const double *values, 
+            std::size_t count) noexcept;
 
-            // Transform to NTT domain
-            for (std::size_t i = 0; i < coeff_mod_count; i++)
-            {
-                util::ntt_negacyclic_harvey(
-                    destination.data(i * coeff_count), small_ntt_tables[i]);
-            }
+        /**
+        Copies the cached plaintext for the given values, parms_id and scale to
+        destination and marks it as most recently used. Returns false if there
+        is no such plaintext in the cache.
+        */
+        bool cache_lookup(const double *values, std::size_t count, 
+            std::uint64_t values_hash, bool is_complex, parms_id_type parms_id, 
+            double scale, Plaintext &destination);
 
-            destination.parms_id() = parms_id;
-            destination.scale() = scale;
-        }
+        /**
+        Adds a copy of plain, encoded from the given values, to the cache and
+        evicts the least recently used plaintexts if the cache is full.
+        */
+        void cache_insert(const double *values, std::size_t count,
+            std::uint64_t values_hash, bool is_complex, const Plaintext &plain);
+
+        struct CacheEntry;
+
+        /**
+        Returns the cached entry with the given key, values, parms_id and
+        scale, or the end of the cache list if there is none. The cache lock
+        must be held.
+        */
+        std::list<CacheEntry>::iterator cache_find(std::uint64_t key,
+            const double *values, std::size_t count, bool is_complex,
+            const parms_id_type &parms_id, double scale);
+
+        /**
+        Removes an entry from the cache. The cache write lock must be held.
+        */
+        void cache_erase(std::list<CacheEntry>::iterator entry);
 
         template<typename T,
             typename = std::enable_if_t<std::is_same<T, double>::value ||
@@ -591,14 +626,6 @@ namespace seal
                 throw std::invalid_argument("scale out of bounds");
             }
 
-            auto decryption_modulus = context_data_ptr->total_coeff_modulus();
-            auto upper_half_threshold = context_data_ptr->upper_half_threshold();
-
-            auto &inv_coeff_products_mod_coeff_array =
-                context_data_ptr->base_converter()->get_inv_coeff_mod_coeff_array();
-            auto coeff_products_array =
-                context_data_ptr->base_converter()->get_coeff_products_array();
-
             int logn = util::get_power_of_two(coeff_count);
 
             // Quick sanity check
@@ -614,12 +641,6 @@ namespace seal
             auto plain_copy = util::allocate_uint(rns_poly_uint64_count, pool);
             util::set_uint_uint(plain.data(), rns_poly_uint64_count, plain_copy.get());
 
-            // Array to keep number bigger than std::uint64_t
-            auto temp(util::allocate_uint(coeff_mod_count, pool));
-
-            // destination mod q
-            auto wide_tmp_dest(util::allocate_zero_uint(rns_poly_uint64_count, pool));
-
             // Transform each polynomial from NTT domain
             for (std::size_t i = 0; i < coeff_mod_count; i++)
             {
@@ -627,98 +648,39 @@ namespace seal
                     plain_copy.get() + (i * coeff_count), small_ntt_tables[i]);
             }
 
-            auto res = util::allocate<std::complex<double>>(coeff_count, pool);
+            // Real and imaginary parts are kept in separate arrays for the FFT
+            auto res_real = util::allocate<double>(coeff_count, pool);
+            auto res_imag = util::allocate<double>(coeff_count, pool, 0);
 
-            double two_pow_64 = std::pow(2.0, 64);
-            for (std::size_t i = 0; i < coeff_count; i++)
-            {
-                for (std::size_t j = 0; j < coeff_mod_count; j++)
-                {
-                    std::uint64_t tmp = util::multiply_uint_uint_mod(
-                        plain_copy[(j * coeff_count) + i],
-                        inv_coeff_products_mod_coeff_array[j], // (qi/q * plain[i]) mod qi
-                        coeff_modulus[j]);
-                    util::multiply_uint_uint64(
-                        coeff_products_array + (j * coeff_mod_count),
-                        coeff_mod_count, tmp, coeff_mod_count, temp.get());
-                    util::add_uint_uint_mod(temp.get(),
-                        wide_tmp_dest.get() + (i * coeff_mod_count),
-                        decryption_modulus, coeff_mod_count,
-                        wide_tmp_dest.get() + (i * coeff_mod_count));
-                }
+            // CRT-compose the coefficients and scale them down
+            compose_scaled(*context_data_ptr, plain_copy.get(), inv_scale,
+                res_real.get(), pool);
 
-                res[i] = 0.0;
-                if (util::is_greater_than_or_equal_uint_uint(
-                    wide_tmp_dest.get() + (i * coeff_mod_count),
-                    upper_half_threshold, coeff_mod_count))
-                {
-                    double scaled_two_pow_64 = inv_scale;
-                    for (std::size_t j = 0; j < coeff_mod_count; 
-                        j++, scaled_two_pow_64 *= two_pow_64)
-                    {
-                        if (wide_tmp_dest[i * coeff_mod_count + j] > decryption_modulus[j])
-                        {
-                            auto diff = wide_tmp_dest[i * coeff_mod_count + j] - decryption_modulus[j];
-                            res[i] += diff ? 
-                                static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
-                        }
-                        else
-                        {
-                            auto diff = decryption_modulus[j] - wide_tmp_dest[i * coeff_mod_count + j];
-                            res[i] -= diff ? 
-                                static_cast<double>(diff) * scaled_two_pow_64 : 0.0;
-                        }
-                    }
-                }
-                else
-                {
-                    double scaled_two_pow_64 = inv_scale;
-                    for (std::size_t j = 0; j < coeff_mod_count; 
-                        j++, scaled_two_pow_64 *= two_pow_64)
-                    {
-                        auto curr_coeff = wide_tmp_dest[i * coeff_mod_count + j];
-                        res[i] += curr_coeff ? 
-                            static_cast<double>(curr_coeff) * scaled_two_pow_64 : 0.0;
-                    }
-                }
-
-                // Scaling instead incorporated above; this can help in cases 
-                // where otherwise pow(two_pow_64, j) would overflow due to very
-                // large coeff_mod_count and very large scale
-                // res[i] = res_accum * inv_scale;
-            }
-
-            std::size_t tt = coeff_count;
-            for (int i = 0; i < logn; i++)
-            {
-                std::size_t mm = std::size_t(1) << i;
-                tt >>= 1;
-
-                for (std::size_t j = 0; j < mm; j++)
-                {
-                    std::size_t j1 = 2 * j * tt;
-                    std::size_t j2 = j1 + tt - 1;
-                    auto s = roots_[mm + j];
-
-                    for (std::size_t k = j1; k < j2 + 1; k++)
-                    {
-                        auto u = res[k];
-                        auto v = res[k + tt] * s;
-                        res[k] = u + v;
-                        res[k + tt] = u - v;
-                    }
-                }
-            }
+            util::fft_negacyclic(res_real.get(), res_imag.get(), *fft_tables_);
 
             destination.clear();
             destination.reserve(slots_);
             for (std::size_t i = 0; i < slots_; i++)
             {
                 destination.emplace_back(
-                    from_complex<T>(res[matrix_reps_index_map_[i]]));
+                    from_complex<T>(std::complex<double>(
+                        res_real[matrix_reps_index_map_[i]], 
+                        res_imag[matrix_reps_index_map_[i]])));
             }
         }
 
+        /**
+        Computes the centered CRT composition of each coefficient of the
+        RNS polynomial plain (in coefficient form), multiplies it by inv_scale,
+        and writes the results to destination. Coefficients are composed in
+        128-bit integer arithmetic using a floating-point estimate of the CRT
+        overflow; coefficients for which this cannot be guaranteed to be exact
+        are composed with multi-precision arithmetic instead.
+        */
+        void compose_scaled(const SEALContext::ContextData &context_data,
+            const std::uint64_t *plain, double inv_scale, double *destination,
+            util::MemoryPool &pool) const;
+
         void encode_internal(double value, parms_id_type parms_id, 
             double scale, Plaintext &destination, MemoryPoolHandle pool);
 
@@ -727,7 +689,7 @@ namespace seal
             MemoryPoolHandle pool)
         {
             encode_internal(std::vector<std::complex<double>>(1, value),
-                parms_id, scale, destination, std::move(pool));
+                &parms_id, &scale, &destination, 1, std::move(pool));
         }
 
         void encode_internal(std::int64_t value,
@@ -735,16 +697,32 @@ namespace seal
 
         MemoryPoolHandle pool_ = MemoryManager::GetPool();
 
-        static constexpr double PI_ = 3.14159265358979323846;
-
         std::shared_ptr<SEALContext> context_{ nullptr };
 
         std::size_t slots_;
 
-        util::Pointer<std::complex<double>> roots_;
-
-        util::Pointer<std::complex<double>> inv_roots_;
+        std::unique_ptr<util::FFTTables> fft_tables_;
 
         util::Pointer<std::uint64_t> matrix_reps_index_map_;
+
+        struct CacheEntry
+        {
+            std::uint64_t key;
+
+            bool is_complex;
+
+            std::vector<double> values;
+
+            Plaintext plain;
+        };
+
+        std::size_t cache_capacity_ = 0;
+
+        std::list<CacheEntry> cache_list_;
+
+        // Different entries can have the same key
+        std::unordered_multimap<std::uint64_t, std::list<CacheEntry>::iterator> cache_map_;
+
+        util::ReaderWriterLocker cache_locker_;
     };
 }
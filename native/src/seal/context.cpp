@@ -7,16 +7,25 @@
 #include "seal/util/uintarith.h"
 #include "seal/util/uintarithsmallmod.h"
 #include "seal/util/numth.h"
+#include "seal/util/serialization.h"
+#include "seal/util/threadpool.h"
+#include "seal/util/globals.h"
 #include "seal/defaultparams.h"
+#include <algorithm>
 #include <utility>
 #include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
-    SEALContext::ContextData SEALContext::validate(EncryptionParameters parms)
+    SEALContext::ContextData SEALContext::validate(EncryptionParameters parms,
+        const SmallNTTTablesGenerator &generate_ntt_tables)
     {
         ContextData context_data(parms, pool_);
         context_data.qualifiers_.parameters_set = true;
@@ -139,8 +148,8 @@ namespace seal
             allocate<SmallNTTTables>(coeff_mod_count, pool_, pool_);
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
-            if (!context_data.small_ntt_tables_[i].generate(coeff_count_power, 
-                coeff_modulus[i]))
+            if (!generate_small_ntt_tables(context_data.small_ntt_tables_[i],
+                coeff_count_power, coeff_modulus[i], generate_ntt_tables))
             {
                 // Parameters are not valid
                 context_data.qualifiers_.using_ntt = false;
@@ -181,7 +190,8 @@ namespace seal
             // Can we use batching? (NTT with plain_modulus)
             context_data.qualifiers_.using_batching = false;
             context_data.plain_ntt_tables_ = allocate<SmallNTTTables>(pool_);
-            if (context_data.plain_ntt_tables_->generate(coeff_count_power, plain_modulus))
+            if (generate_small_ntt_tables(*context_data.plain_ntt_tables_,
+                coeff_count_power, plain_modulus, generate_ntt_tables))
             {
                 context_data.qualifiers_.using_batching = true;
             }
@@ -294,7 +304,7 @@ namespace seal
         // Create BaseConverter
         context_data.base_converter_ = allocate<BaseConverter>(pool_, pool_);
         context_data.base_converter_->generate(coeff_modulus, poly_modulus_degree,
-            plain_modulus);
+            plain_modulus, generate_ntt_tables);
         if (!context_data.base_converter_->is_generated())
         {
             // Parameters are not valid
@@ -302,18 +312,31 @@ namespace seal
             return context_data;
         }
 
+        // The permutation tables only depend on the degree, so all parameter
+        // sets use the same GaloisTool
+        context_data.galois_tool_ = galois_tool_;
+
         // Done with validation and pre-computations
         return context_data;
     }
 
     SEALContext::SEALContext(EncryptionParameters parms, bool expand_mod_chain,
-        MemoryPoolHandle pool) : pool_(move(pool))
+        MemoryPoolHandle pool, size_t thread_count,
+        const SmallNTTTablesGenerator &generate_ntt_tables) : pool_(move(pool))
     {
         if (!pool_)
         {
             throw invalid_argument("pool is uninitialized");
         }
 
+        // The tables and the ContextData of every parameter set are allocated
+        // from pool_ by the threads that compute them, which a thread-local
+        // pool does not allow
+        if (!pool_.is_thread_safe())
+        {
+            thread_count = 1;
+        }
+
         // Set random generator
         if (!parms.random_generator())
         {
@@ -321,10 +344,83 @@ namespace seal
                 UniformRandomGeneratorFactory::default_factory());
         }
 
+        // Unless the tables are given, generate the NTT tables for every prime
+        // that any of the parameter sets can use in parallel up front; every
+        // parameter set then copies the ones it needs. Validation is left to
+        // validate, so this is only skipped for a degree that cannot be valid.
+        auto &coeff_modulus = parms.coeff_modulus();
+        int coeff_count_power = get_power_of_two(parms.poly_modulus_degree());
+        vector<SmallModulus> table_moduli;
+        Pointer<SmallNTTTables> tables;
+        SmallNTTTablesGenerator copy_ntt_tables;
+        if (!generate_ntt_tables &&
+            coeff_count_power >= get_power_of_two(SEAL_POLY_MOD_DEGREE_MIN) &&
+            coeff_count_power <= get_power_of_two(SEAL_POLY_MOD_DEGREE_MAX) &&
+            coeff_modulus.size() <= SEAL_COEFF_MOD_COUNT_MAX)
+        {
+            auto add_modulus = [&table_moduli](const SmallModulus &modulus)
+            {
+                if (!modulus.is_zero() && find(table_moduli.cbegin(),
+                    table_moduli.cend(), modulus) == table_moduli.cend())
+                {
+                    table_moduli.push_back(modulus);
+                }
+            };
+            for_each(coeff_modulus.cbegin(), coeff_modulus.cend(), add_modulus);
+            add_modulus(parms.plain_modulus());
+
+            // BaseConverter uses one more auxiliary prime than there are
+            // coefficient moduli at most, followed by m_sk
+            auto &aux_small_mods = global_variables::internal_mods::aux_small_mods;
+            size_t aux_count = min(coeff_modulus.size() + 1, aux_small_mods.size());
+            for_each(aux_small_mods.cbegin(), aux_small_mods.cbegin() +
+                static_cast<ptrdiff_t>(aux_count), add_modulus);
+            add_modulus(global_variables::internal_mods::m_sk);
+
+            tables = allocate<SmallNTTTables>(table_moduli.size(), pool_, pool_);
+            ThreadPool::Global().parallel_for(table_moduli.size(), thread_count,
+                [&](size_t begin, size_t end, size_t)
+                {
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        tables[i].generate(coeff_count_power, table_moduli[i]);
+                    }
+                });
+
+            copy_ntt_tables = [&](SmallNTTTables &destination,
+                int destination_coeff_count_power, const SmallModulus &modulus)
+            {
+                auto it = find(table_moduli.cbegin(), table_moduli.cend(), modulus);
+                if (destination_coeff_count_power != coeff_count_power ||
+                    it == table_moduli.cend())
+                {
+                    return destination.generate(destination_coeff_count_power, modulus);
+                }
+                auto &source = tables[static_cast<size_t>(it - table_moduli.cbegin())];
+                if (!source.is_generated())
+                {
+                    return false;
+                }
+                destination.copy_from(source);
+                return true;
+            };
+        }
+        auto &level_ntt_tables = generate_ntt_tables ? generate_ntt_tables : copy_ntt_tables;
+
+        // Tables for Galois automorphisms are computed when first used
+        if (coeff_count_power >= get_power_of_two(SEAL_POLY_MOD_DEGREE_MIN) &&
+            coeff_count_power <= get_power_of_two(SEAL_POLY_MOD_DEGREE_MAX))
+        {
+            // Any thread may compute them, so they need a thread-safe pool
+            galois_tool_ = make_shared<GaloisTool>(coeff_count_power,
+                pool_.is_thread_safe() ? pool_ :
+                MemoryManager::GetPool(mm_prof_opt::FORCE_GLOBAL));
+        }
+
         // Validate parameters and add new ContextData to the map 
         // Note that this happens even if parameters are not valid
         context_data_map_.emplace(make_pair(parms.parms_id(), 
-            make_shared<const ContextData>(validate(parms))));
+            make_shared<const ContextData>(validate(parms, level_ntt_tables))));
 
         first_parms_id_ = parms.parms_id();
         last_parms_id_ = first_parms_id_;
@@ -334,34 +430,50 @@ namespace seal
         if (expand_mod_chain &&
             context_data_map_.at(first_parms_id_)->qualifiers_.parameters_set)
         {
-            auto prev_parms_id = first_parms_id_;
-            while (context_data_map_.at(prev_parms_id)->parms().coeff_modulus().size() > 1)
+            // Create the next sets of parameters by removing the last modulus
+            // one at a time
+            vector<EncryptionParameters> next_parms_list;
+            auto next_parms = parms;
+            while (next_parms.coeff_modulus().size() > 1)
             {
-                // Create the next set of parameters by removing last modulus
-                auto next_parms = context_data_map_.at(prev_parms_id)->parms_;
                 auto next_coeff_modulus = next_parms.coeff_modulus();
                 next_coeff_modulus.pop_back();
                 next_parms.set_coeff_modulus(next_coeff_modulus);
-                auto next_parms_id = next_parms.parms_id();
+                next_parms_list.push_back(next_parms);
+            }
 
-                // Validate next parameters
-                auto next_context_data = validate(next_parms);
+            // Validate them all in parallel; the chain ends before the first
+            // invalid one, so the rest is discarded afterwards
+            vector<shared_ptr<const ContextData>> next_context_data_list(
+                next_parms_list.size());
+            ThreadPool::Global().parallel_for(next_parms_list.size(), thread_count,
+                [&](size_t begin, size_t end, size_t)
+                {
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        next_context_data_list[i] = make_shared<const ContextData>(
+                            validate(next_parms_list[i], level_ntt_tables));
+                    }
+                });
 
+            auto prev_parms_id = first_parms_id_;
+            for (auto &next_context_data : next_context_data_list)
+            {
                 // If not valid then break
-                if (!next_context_data.qualifiers_.parameters_set)
+                if (!next_context_data->qualifiers_.parameters_set)
                 {
                     break;
                 }
 
                 // Add them to the context_data_map_
-                context_data_map_.emplace(make_pair(next_parms_id,
-                    make_shared<const ContextData>(move(next_context_data))));
-                
+                auto next_parms_id = next_context_data->parms().parms_id();
+                context_data_map_.emplace(make_pair(next_parms_id, next_context_data));
+
                 // Add pointer to next context_data to the previous one (linked list)
                 // We need to remove constness first to modify this
                 const_pointer_cast<ContextData>(
                     context_data_map_.at(prev_parms_id))->next_context_data_ = 
-                    context_data_map_.at(next_parms_id);
+                    next_context_data;
                 prev_parms_id = next_parms_id;
                 last_parms_id_ = prev_parms_id;
             }
@@ -378,4 +490,219 @@ namespace seal
             context_data_ptr = context_data_ptr->next_context_data_;
         }
     }
+
+    void SEALContext::save(ostream &stream, compr_mode_type compr_mode) const
+    {
+        if (!parameters_set())
+        {
+            throw logic_error("encryption parameters are not set correctly");
+        }
+
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            save_versioned(stream, compr_mode,
+                [this](ostream &members_stream) { save_members(members_stream); });
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
+
+        stream.exceptions(old_except_mask);
+    }
+
+    size_t SEALContext::save_size(compr_mode_type compr_mode) const
+    {
+        return compute_save_size(
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t SEALContext::save(SEAL_BYTE *out, size_t size, compr_mode_type compr_mode) const
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    void SEALContext::save_members(ostream &stream) const
+    {
+        EncryptionParameters::Save(context_data()->parms(), stream);
+
+        // The parms_id of every parameter set in the chain
+        uint64_t chain_size = safe_cast<uint64_t>(context_data_map_.size());
+        stream.write(reinterpret_cast<const char*>(&chain_size), sizeof(uint64_t));
+        vector<const SmallNTTTables*> tables;
+        auto add_table = [&tables](const SmallNTTTables &table)
+        {
+            if (!table.is_generated())
+            {
+                return;
+            }
+            for (auto saved_table : tables)
+            {
+                if (saved_table->modulus() == table.modulus())
+                {
+                    return;
+                }
+            }
+            tables.push_back(&table);
+        };
+        for (auto data = context_data(); data; data = data->next_context_data_)
+        {
+            stream.write(reinterpret_cast<const char*>(&data->parms().parms_id()),
+                sizeof(parms_id_type));
+
+            size_t coeff_mod_count = data->parms().coeff_modulus().size();
+            for (size_t i = 0; i < coeff_mod_count; i++)
+            {
+                add_table(data->small_ntt_tables_[i]);
+            }
+            if (data->plain_ntt_tables_)
+            {
+                add_table(*data->plain_ntt_tables_);
+            }
+            auto &bsk_tables = data->base_converter_->get_bsk_small_ntt_tables();
+            for (size_t i = 0; i < data->base_converter_->bsk_base_mod_count(); i++)
+            {
+                add_table(bsk_tables[i]);
+            }
+        }
+
+        // The tables only depend on the prime, so every one is saved once
+        uint64_t table_count = safe_cast<uint64_t>(tables.size());
+        stream.write(reinterpret_cast<const char*>(&table_count), sizeof(uint64_t));
+        for (auto table : tables)
+        {
+            ostringstream table_stream(ios_base::out | ios_base::binary);
+            table->save(table_stream);
+            string table_data = table_stream.str();
+            uint64_t modulus_value = table->modulus().value();
+            stream.write(reinterpret_cast<const char*>(&modulus_value), sizeof(uint64_t));
+            uint64_t table_size = safe_cast<uint64_t>(table_data.size());
+            stream.write(reinterpret_cast<const char*>(&table_size), sizeof(uint64_t));
+            stream.write(table_data.data(), safe_cast<streamsize>(table_data.size()));
+        }
+    }
+
+    shared_ptr<SEALContext> SEALContext::Load(istream &stream)
+    {
+        shared_ptr<SEALContext> context;
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic != serialization_magic)
+            {
+                throw invalid_argument("context data is invalid");
+            }
+            load_versioned(stream, [&context](istream &members_stream)
+            {
+                auto parms = EncryptionParameters::Load(members_stream);
+
+                uint64_t chain_size = 0;
+                members_stream.read(reinterpret_cast<char*>(&chain_size), sizeof(uint64_t));
+                if (chain_size < 1 || chain_size > parms.coeff_modulus().size())
+                {
+                    throw invalid_argument("context data is invalid");
+                }
+                vector<parms_id_type> parms_ids(safe_cast<size_t>(chain_size));
+                members_stream.read(reinterpret_cast<char*>(parms_ids.data()),
+                    safe_cast<streamsize>(mul_safe(parms_ids.size(), sizeof(parms_id_type))));
+
+                // There is one table for each coefficient modulus prime, the
+                // plain modulus, and the primes of the base Bsk
+                uint64_t table_count = 0;
+                members_stream.read(reinterpret_cast<char*>(&table_count), sizeof(uint64_t));
+                if (table_count > 2 * parms.coeff_modulus().size() + 3)
+                {
+                    throw invalid_argument("context data is invalid");
+                }
+                size_t max_table_size = sizeof(int32_t) + 3 * sizeof(uint64_t) +
+                    6 * parms.poly_modulus_degree() * sizeof(uint64_t);
+                unordered_map<uint64_t, string> tables;
+                for (uint64_t i = 0; i < table_count; i++)
+                {
+                    uint64_t modulus_value = 0;
+                    members_stream.read(reinterpret_cast<char*>(&modulus_value),
+                        sizeof(uint64_t));
+                    uint64_t table_size = 0;
+                    members_stream.read(reinterpret_cast<char*>(&table_size),
+                        sizeof(uint64_t));
+                    if (table_size > max_table_size)
+                    {
+                        throw invalid_argument("context data is invalid");
+                    }
+                    string table_data(safe_cast<size_t>(table_size), '\0');
+                    members_stream.read(&table_data[0], safe_cast<streamsize>(table_size));
+                    tables[modulus_value] = move(table_data);
+                }
+
+                // Tables for primes that are not in the data are generated
+                auto generate_ntt_tables = [&tables](SmallNTTTables &table,
+                    int coeff_count_power, const SmallModulus &modulus)
+                {
+                    auto table_data = tables.find(modulus.value());
+                    if (table_data == tables.end())
+                    {
+                        return table.generate(coeff_count_power, modulus);
+                    }
+                    ArrayGetBuffer table_buffer(table_data->second.data(),
+                        table_data->second.size());
+                    istream table_stream(&table_buffer);
+                    table.load(table_stream);
+                    if (table.coeff_count_power() != coeff_count_power ||
+                        !(table.modulus() == modulus))
+                    {
+                        throw invalid_argument("context data is invalid");
+                    }
+                    return true;
+                };
+                context = shared_ptr<SEALContext>(new SEALContext(parms,
+                    chain_size > 1, MemoryManager::GetPool(), 0, generate_ntt_tables));
+
+                // The restored chain must hash to the saved parms_ids
+                if (!context->parameters_set() ||
+                    context->context_data_map_.size() != parms_ids.size())
+                {
+                    throw invalid_argument("context data does not match its parameters");
+                }
+                auto data = context->context_data();
+                for (auto &parms_id : parms_ids)
+                {
+                    if (data->parms().parms_id() != parms_id)
+                    {
+                        throw invalid_argument("context data does not match its parameters");
+                    }
+                    data = data->next_context_data_;
+                }
+            });
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
+
+        stream.exceptions(old_except_mask);
+        return context;
+    }
+
+    shared_ptr<SEALContext> SEALContext::Load(const SEAL_BYTE *in, size_t size)
+    {
+        if (!in && size)
+        {
+            throw invalid_argument("in cannot be null");
+        }
+        ArrayGetBuffer buffer(reinterpret_cast<const char*>(in), size);
+        istream stream(&buffer);
+        return Load(stream);
+    }
 }
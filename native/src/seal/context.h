@@ -7,9 +7,11 @@
 #include <functional>
 #include <memory>
 #include "seal/encryptionparams.h"
+#include "seal/serialization.h"
 #include "seal/memorymanager.h"
 #include "seal/util/smallntt.h"
 #include "seal/util/baseconverter.h"
+#include "seal/util/galois.h"
 #include "seal/util/pointer.h"
 
 namespace seal
@@ -197,6 +199,16 @@ namespace seal
                 return plain_ntt_tables_;
             }
 
+            /**
+            Returns a const reference to the GaloisTool, which keeps the
+            permutation tables for the Galois automorphisms. It is shared by
+            all parameter sets in the modulus switching chain.
+            */
+            inline auto &galois_tool() const
+            {
+                return galois_tool_;
+            }
+
             /**
             Return a pointer to BFV "Delta", i.e. coefficient modulus divided by
             plaintext modulus.
@@ -292,6 +304,8 @@ namespace seal
 
             util::Pointer<util::SmallNTTTables> plain_ntt_tables_;
 
+            std::shared_ptr<util::GaloisTool> galois_tool_{ nullptr };
+
             util::Pointer<std::uint64_t> total_coeff_modulus_;
 
             int total_coeff_modulus_bit_count_;
@@ -315,20 +329,98 @@ namespace seal
 
         /**
         Creates an instance of SEALContext, and performs several pre-computations
-        on the given EncryptionParameters. 
+        on the given EncryptionParameters. The NTT tables are generated once for
+        every prime in parallel, and the parameter sets in the modulus switching
+        chain are then set up in parallel, copying the tables they share. If the
+        memory manager profile gives a thread-local memory pool, which only one
+        thread can allocate from, all of the work is done by the calling thread.
 
         @param[in] parms The encryption parameters
         @param[in] expand_mod_chain Determines whether the modulus switching chain 
         should be created
+        @param[in] thread_count The maximum number of threads to use; zero means
+        all hardware threads
         */
         static auto Create(const EncryptionParameters &parms, 
-            bool expand_mod_chain = true)
+            bool expand_mod_chain = true, std::size_t thread_count = 0)
         {
             return std::shared_ptr<SEALContext>(
                 new SEALContext(parms, expand_mod_chain, 
-                MemoryManager::GetPool()));
+                MemoryManager::GetPool(), thread_count));
         }
 
+        /**
+        Saves the SEALContext to an output stream, so that it can be restored
+        with Load without redoing the most expensive pre-computations. The NTT
+        tables are stored once for every prime, together with the encryption
+        parameters and the parms_id of every parameter set in the modulus
+        switching chain. The output is in binary format and not human-readable.
+        The output stream must have the "binary" flag set.
+
+        @param[out] stream The stream to save the SEALContext to
+        @param[in] compr_mode The compression mode
+        @throws std::logic_error if the encryption parameters are not valid
+        @throws std::invalid_argument if compr_mode is not valid
+        @throws std::exception if the SEALContext could not be written to stream
+        */
+        void save(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Returns the number of bytes save writes for the SEALContext with the
+        given compression mode.
+
+        @param[in] compr_mode The compression mode
+        @throws std::logic_error if the encryption parameters are not valid
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save_size(
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Saves the SEALContext to a buffer in the format that save writes to a
+        stream, and returns the number of bytes written.
+
+        @param[out] out The buffer to save the SEALContext to
+        @param[in] size The size of the buffer in bytes
+        @param[in] compr_mode The compression mode
+        @throws std::logic_error if the encryption parameters are not valid
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the SEALContext does not fit in size
+        bytes
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save(SEAL_BYTE *out, std::size_t size,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Restores a SEALContext saved with save. The encryption parameters are
+        validated as in Create, except that the NTT tables are copied from the
+        saved data instead of being computed. The data is checked against its
+        stored checksum, and the parms_id of every parameter set in the restored
+        modulus switching chain must match the saved one.
+
+        @param[in] stream The stream to load the SEALContext from
+        @throws std::invalid_argument if the data is corrupted or does not match
+        the parameters it was saved with
+        @throws std::exception if a valid SEALContext could not be read from
+        stream
+        */
+        static std::shared_ptr<SEALContext> Load(std::istream &stream);
+
+        /**
+        Restores a SEALContext saved with save from a buffer.
+
+        @param[in] in The buffer to load the SEALContext from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::invalid_argument if the data is corrupted or does not match
+        the parameters it was saved with
+        @throws std::exception if a valid SEALContext could not be read from in
+        */
+        static std::shared_ptr<SEALContext> Load(const SEAL_BYTE *in,
+            std::size_t size);
+
         /**
         Returns a const reference to ContextData class corresponding to the
         encryption parameters. This is the first set of parameters in a chain
@@ -396,15 +488,25 @@ namespace seal
         @param[in] expand_mod_chain Determines whether the modulus switching chain 
         should be created
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @param[in] thread_count The maximum number of threads to use; zero means
+        all hardware threads
+        @param[in] generate_ntt_tables If given, sets up the NTT tables in place
+        of generating them
         @throws std::invalid_argument if pool is uninitialized
         */
         SEALContext(EncryptionParameters parms, bool expand_mod_chain,
-            MemoryPoolHandle pool);
+            MemoryPoolHandle pool, std::size_t thread_count,
+            const util::SmallNTTTablesGenerator &generate_ntt_tables = nullptr);
+
+        ContextData validate(EncryptionParameters parms,
+            const util::SmallNTTTablesGenerator &generate_ntt_tables);
 
-        ContextData validate(EncryptionParameters parms);
+        void save_members(std::ostream &stream) const;
 
         MemoryPoolHandle pool_;
 
+        std::shared_ptr<util::GaloisTool> galois_tool_{ nullptr };
+
         parms_id_type first_parms_id_;
 
         parms_id_type last_parms_id_;
@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include "seal/decryptor.h"
 #include "seal/util/common.h"
 #include "seal/util/uintcore.h"
@@ -12,6 +15,7 @@
 #include "seal/util/polycore.h"
 #include "seal/util/polyarithmod.h"
 #include "seal/util/polyarithsmallmod.h"
+#include "seal/util/threadpool.h"
 
 using namespace std;
 using namespace seal::util;
@@ -53,12 +57,22 @@ namespace seal
     }
 
     void Decryptor::decrypt(const Ciphertext &encrypted, Plaintext &destination)
+    {
+        decrypt(encrypted, destination, pool_);
+    }
+
+    void Decryptor::decrypt(const Ciphertext &encrypted, Plaintext &destination,
+        MemoryPoolHandle pool)
     {
         // Verify that encrypted is valid.
         if (!encrypted.is_valid_for(context_))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
 
         auto &context_data = *context_->context_data();
         auto &parms = context_data.parms();
@@ -66,11 +80,11 @@ namespace seal
         switch (parms.scheme())
         {
         case scheme_type::BFV:
-            bfv_decrypt(encrypted, destination, pool_);
+            bfv_decrypt(encrypted, destination, move(pool));
             return;
 
         case scheme_type::CKKS:
-            ckks_decrypt(encrypted, destination, pool_);
+            ckks_decrypt(encrypted, destination, move(pool));
             return;
 
         default:
@@ -78,14 +92,79 @@ namespace seal
         }
     }
 
-    void Decryptor::bfv_decrypt(const Ciphertext &encrypted, 
-        Plaintext &destination, MemoryPoolHandle pool)
+    double Decryptor::decrypt_batch(const vector<Ciphertext> &encrypted,
+        vector<Plaintext> &destination, size_t thread_count)
     {
-        if (encrypted.is_ntt_form())
+        // Existing plaintexts are reused to avoid reallocations
+        destination.resize(encrypted.size());
+        return decrypt_batch_internal(encrypted,
+            [&destination](size_t index, const Plaintext &plain, MemoryPoolHandle)
+            {
+                destination[index] = plain;
+            }, thread_count);
+    }
+
+    double Decryptor::decrypt_batch(BatchEncoder &encoder, 
+        const vector<Ciphertext> &encrypted, 
+        vector<vector<uint64_t>> &destination, size_t thread_count)
+    {
+        destination.resize(encrypted.size());
+        return decrypt_batch_internal(encrypted,
+            [&encoder, &destination](size_t index, const Plaintext &plain, 
+                MemoryPoolHandle pool)
+            {
+                encoder.decode(plain, destination[index], move(pool));
+            }, thread_count);
+    }
+
+    double Decryptor::decrypt_batch(BatchEncoder &encoder, 
+        const vector<Ciphertext> &encrypted, 
+        vector<vector<int64_t>> &destination, size_t thread_count)
+    {
+        destination.resize(encrypted.size());
+        return decrypt_batch_internal(encrypted,
+            [&encoder, &destination](size_t index, const Plaintext &plain, 
+                MemoryPoolHandle pool)
+            {
+                encoder.decode(plain, destination[index], move(pool));
+            }, thread_count);
+    }
+
+    double Decryptor::decrypt_batch_internal(const vector<Ciphertext> &encrypted,
+        const plain_sink_type &plain_sink, size_t thread_count)
+    {
+        auto time_start = chrono::steady_clock::now();
+
+        // Compute the secret key powers once, before any thread needs them
+        size_t max_size = 2;
+        for (auto &ct : encrypted)
         {
-            throw invalid_argument("encrypted cannot be in NTT form");
+            max_size = max(max_size, ct.size());
         }
+        compute_secret_key_array(max_size - 1);
+
+        ThreadPool::Global().parallel_for(encrypted.size(), thread_count,
+            [&](size_t begin, size_t end, size_t)
+            {
+                // Per-thread memory pool that is cleared when released, and a
+                // plaintext buffer reused for every ciphertext
+                auto pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW, true);
+                Plaintext buffer(pool);
+                for (size_t i = begin; i < end; i++)
+                {
+                    decrypt(encrypted[i], buffer, pool);
+                    plain_sink(i, buffer, pool);
+                }
+            });
+
+        chrono::duration<double> seconds = chrono::steady_clock::now() - time_start;
+        return (seconds.count() > 0) ? 
+            static_cast<double>(encrypted.size()) / seconds.count() : 0.0;
+    }
 
+    void Decryptor::dot_product_ct_sk_array(const Ciphertext &encrypted, 
+        bool ntt_transform, uint64_t *destination, MemoryPoolHandle pool)
+    {
         auto &context_data = *context_->context_data(encrypted.parms_id());
         auto &parms = context_data.parms();
         auto &coeff_modulus = parms.coeff_modulus();
@@ -97,40 +176,26 @@ namespace seal
         size_t encrypted_size = encrypted.size();
 
         auto &small_ntt_tables = context_data.small_ntt_tables();
-        auto &base_converter = context_data.base_converter();
-        auto &plain_gamma_product = base_converter->get_plain_gamma_product();
-        auto &plain_gamma_array = base_converter->get_plain_gamma_array();
-        auto &neg_inv_coeff = base_converter->get_neg_inv_coeff();
-        auto inv_gamma = base_converter->get_inv_gamma();
-
-        // The number of uint64 count for plain_modulus and gamma together
-        size_t plain_gamma_uint64_count = 2;
-
-        // Allocate a full size destination to write to
-        auto wide_destination(allocate_uint(coeff_count, pool));
 
         // Make sure we have enough secret key powers computed
         compute_secret_key_array(encrypted_size - 1);
 
-        /*
-        Firstly find c_0 + c_1 *s + ... + c_{count-1} * s^{count-1} mod q
-        This is equal to Delta m + v where ||v|| < Delta/2.
-        So, add Delta / 2 and now we have something which is Delta * (m + epsilon) where epsilon < 1
-        Therefore, we can (integer) divide by Delta and the answer will round down to m.
-        */
-
-        // Make a temp destination for all the arithmetic mod qi before calling FastBConverse
-        auto tmp_dest_modq(allocate_zero_poly(coeff_count, coeff_mod_count, pool));
+        // Hold a reader lock so that another thread extending the array cannot 
+        // release it while we use it
+        ReaderLock reader_lock(secret_key_array_locker_.acquire_read());
 
         // put < (c_1 , c_2, ... , c_{count-1}) , (s,s^2,...,s^{count-1}) > mod q in destination
 
-        // Now do the dot product of encrypted_copy and the secret key array using NTT.
+        // Now do the dot product of encrypted and the secret key array using NTT.
         // The secret key powers are already NTT transformed.
+        set_zero_uint(rns_poly_uint64_count, destination);
         auto copy_operand1(allocate_uint(coeff_count, pool));
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
             // Initialize pointers for multiplication
+            // c_1 mod qi
             const uint64_t *current_array1 = encrypted.data(1) + (i * coeff_count);
+            // s mod qi
             const uint64_t *current_array2 = secret_key_array_.get() + (i * coeff_count);
 
             for (size_t j = 0; j < encrypted_size - 1; j++)
@@ -138,24 +203,71 @@ namespace seal
                 // Perform the dyadic product.
                 set_uint_uint(current_array1, coeff_count, copy_operand1.get());
 
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables[i]);
+                if (ntt_transform)
+                {
+                    // Lazy reduction
+                    ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables[i]);
+                }
 
                 dyadic_product_coeffmod(copy_operand1.get(), current_array2, coeff_count,
                     coeff_modulus[i], copy_operand1.get());
-                add_poly_poly_coeffmod(tmp_dest_modq.get() + (i * coeff_count),
+                add_poly_poly_coeffmod(destination + (i * coeff_count),
                     copy_operand1.get(), coeff_count, coeff_modulus[i],
-                    tmp_dest_modq.get() + (i * coeff_count));
+                    destination + (i * coeff_count));
 
+                // go to c_{1+j+1} and s^{1+j+1} mod qi
                 current_array1 += rns_poly_uint64_count;
                 current_array2 += first_rns_poly_uint64_count;
             }
 
-            // Perform inverse NTT
-            inverse_ntt_negacyclic_harvey(tmp_dest_modq.get() + (i * coeff_count),
-                small_ntt_tables[i]);
+            if (ntt_transform)
+            {
+                // Perform inverse NTT
+                inverse_ntt_negacyclic_harvey(destination + (i * coeff_count),
+                    small_ntt_tables[i]);
+            }
+        }
+    }
+
+    void Decryptor::bfv_decrypt(const Ciphertext &encrypted, 
+        Plaintext &destination, MemoryPoolHandle pool)
+    {
+        if (encrypted.is_ntt_form())
+        {
+            throw invalid_argument("encrypted cannot be in NTT form");
         }
 
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+
+        auto &base_converter = context_data.base_converter();
+        auto &plain_gamma_product = base_converter->get_plain_gamma_product();
+        auto &plain_gamma_array = base_converter->get_plain_gamma_array();
+        auto &neg_inv_coeff = base_converter->get_neg_inv_coeff();
+        auto inv_gamma = base_converter->get_inv_gamma();
+
+        // The number of uint64 count for plain_modulus and gamma together
+        size_t plain_gamma_uint64_count = 2;
+
+        // Allocate a full size destination to write to
+        auto wide_destination(allocate_uint(coeff_count, pool));
+
+        /*
+        Firstly find c_0 + c_1 *s + ... + c_{count-1} * s^{count-1} mod q
+        This is equal to Delta m + v where ||v|| < Delta/2.
+        So, add Delta / 2 and now we have something which is Delta * (m + epsilon) where epsilon < 1
+        Therefore, we can (integer) divide by Delta and the answer will round down to m.
+        */
+
+        // Make a temp destination for all the arithmetic mod qi before calling FastBConverse
+        auto tmp_dest_modq(allocate_poly(coeff_count, coeff_mod_count, pool));
+
+        // put < (c_1 , c_2, ... , c_{count-1}) , (s,s^2,...,s^{count-1}) > mod q in destination
+        dot_product_ct_sk_array(encrypted, true, tmp_dest_modq.get(), pool);
+
         // add c_0 into destination
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
@@ -243,12 +355,6 @@ namespace seal
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_mod_count = coeff_modulus.size();
         size_t rns_poly_uint64_count = mul_safe(coeff_count, coeff_mod_count);
-        size_t first_rns_poly_uint64_count = mul_safe(coeff_count,
-            context_->context_data()->parms().coeff_modulus().size());
-        size_t encrypted_size = encrypted.size();
-
-        // Make sure we have enough secret key powers computed
-        compute_secret_key_array(encrypted_size - 1);
 
         /*
         Decryption consists in finding c_0 + c_1 *s + ... + c_{count-1} * s^{count-1} mod q_1 * q_2 * q_3
@@ -263,44 +369,12 @@ namespace seal
         // Resize destination to appropriate size
         destination.resize(rns_poly_uint64_count);
 
-        // Make a temp destination for all the arithmetic mod q1, q2, q3
-        //auto tmp_dest_modq(allocate_zero_poly(coeff_count, decryption_coeff_mod_count, pool));
-
         // put < (c_1 , c_2, ... , c_{count-1}) , (s,s^2,...,s^{count-1}) > mod q in destination
+        dot_product_ct_sk_array(encrypted, false, destination.data(), pool);
 
-        // Now do the dot product of encrypted_copy and the secret key array using NTT.
-        // The secret key powers are already NTT transformed.
-
-        auto copy_operand1(allocate_uint(coeff_count, pool));
+        // add c_0 into destination
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
-            // Initialize pointers for multiplication
-            // c_1 mod qi
-            const uint64_t *current_array1 = encrypted.data(1) + (i * coeff_count);
-            // s mod qi
-            const uint64_t *current_array2 = secret_key_array_.get() + (i * coeff_count);
-            // set destination coefficients to zero modulo q_i
-            set_zero_uint(coeff_count, destination.data() + (i * coeff_count));
-
-            for (size_t j = 0; j < encrypted_size - 1; j++)
-            {
-                // Perform the dyadic product.
-                set_uint_uint(current_array1, coeff_count, copy_operand1.get());
-
-                // Lazy reduction
-                //ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables[i]);
-                dyadic_product_coeffmod(copy_operand1.get(), current_array2, coeff_count,
-                    coeff_modulus[i], copy_operand1.get());
-                add_poly_poly_coeffmod(destination.data() + (i * coeff_count),
-                    copy_operand1.get(), coeff_count, coeff_modulus[i],
-                    destination.data() + (i * coeff_count));
-
-                // go to c_{1+j+1} and s^{1+j+1} mod qi
-                current_array1 += rns_poly_uint64_count;
-                current_array2 += first_rns_poly_uint64_count;
-            }
-
-            // add c_0 into destination
             add_poly_poly_coeffmod(destination.data() + (i * coeff_count),
                 encrypted.data() + (i * coeff_count), coeff_count,
                 coeff_modulus[i], destination.data() + (i * coeff_count));
@@ -338,8 +412,6 @@ namespace seal
             return;
         }
 
-        reader_lock.unlock();
-
         // Need to extend the array
         // Compute powers of secret key until max_power
         auto new_secret_key_array(allocate_poly(mul_safe(new_size, coeff_count),
@@ -347,6 +419,9 @@ namespace seal
         set_poly_poly(secret_key_array_.get(), mul_safe(old_size, coeff_count), 
             coeff_mod_count, new_secret_key_array.get());
 
+        // The old array is copied, so another thread may now replace it
+        reader_lock.unlock();
+
         uint64_t *prev_poly_ptr = new_secret_key_array.get() +
             mul_safe(old_size - 1, rns_poly_uint64_count);
         uint64_t *next_poly_ptr = prev_poly_ptr + rns_poly_uint64_count;
@@ -385,8 +460,8 @@ namespace seal
         secret_key_array_.acquire(new_secret_key_array);
     }
 
-    void Decryptor::compose(
-        const SEALContext::ContextData &context_data, uint64_t *value)
+    void Decryptor::compose(const SEALContext::ContextData &context_data, 
+        uint64_t *value, MemoryPoolHandle pool)
     {
 #ifdef SEAL_DEBUG
         if (value == nullptr)
@@ -406,7 +481,7 @@ namespace seal
 
         // Set temporary coefficients_ptr pointer to point to either an existing
         // allocation given as parameter, or else to a new allocation from the memory pool.
-        auto coefficients(allocate_uint(rns_poly_uint64_count, pool_));
+        auto coefficients(allocate_uint(rns_poly_uint64_count, pool));
         uint64_t *coefficients_ptr = coefficients.get();
 
         // Re-merge the coefficients first
@@ -418,7 +493,7 @@ namespace seal
             }
         }
 
-        auto temp(allocate_uint(coeff_mod_count, pool_));
+        auto temp(allocate_uint(coeff_mod_count, pool));
         set_zero_uint(rns_poly_uint64_count, value);
 
         for (size_t i = 0; i < coeff_count; i++)
@@ -439,16 +514,26 @@ namespace seal
     }
 
     int Decryptor::invariant_noise_budget(const Ciphertext &encrypted)
+    {
+        return invariant_noise_budget(encrypted, pool_);
+    }
+
+    int Decryptor::invariant_noise_budget(const Ciphertext &encrypted,
+        MemoryPoolHandle pool)
     {
         // Verify that encrypted is valid.
         if (!encrypted.is_valid_for(context_))
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
 
         if (context_->context_data()->parms().scheme() != scheme_type::BFV)
         {
-            throw logic_error("unsupported scheme");
+            throw invalid_argument("unsupported scheme");
         }
         if (encrypted.is_ntt_form())
         {
@@ -460,69 +545,95 @@ namespace seal
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_mod_count = coeff_modulus.size();
-        size_t rns_poly_uint64_count = mul_safe(coeff_count, coeff_mod_count);
-        size_t encrypted_size = encrypted.size();
         uint64_t plain_modulus = parms.plain_modulus().value();
 
-        auto &small_ntt_tables = context_data.small_ntt_tables();
-
         // Storage for noise uint
-        auto destination(allocate_uint(coeff_mod_count, pool_));
+        auto destination(allocate_uint(coeff_mod_count, pool));
 
         // Storage for noise poly
-        auto noise_poly(allocate_zero_poly(coeff_count, coeff_mod_count, pool_));
+        auto noise_poly(allocate_poly(coeff_count, coeff_mod_count, pool));
 
         // Now need to compute c(s) - Delta*m (mod q)
 
-        // Make sure we have enough secret keys computed
-        compute_secret_key_array(encrypted_size - 1);
-
         /*
         Firstly find c_0 + c_1 *s + ... + c_{count-1} * s^{count-1} mod q
         This is equal to Delta m + v where ||v|| < Delta/2.
         */
         // put < (c_1 , c_2, ... , c_{count-1}) , (s,s^2,...,s^{count-1}) > mod q
-        // in destination_poly.
-        // Make a copy of the encryption for NTT (except the first polynomial is 
-        // not needed).
-        auto encrypted_copy(allocate_poly(
-            mul_safe(encrypted_size - 1, coeff_count), coeff_mod_count, pool_));
-        set_poly_poly(encrypted.data(1), mul_safe(encrypted_size - 1, coeff_count),
-            coeff_mod_count, encrypted_copy.get());
-
-        // Now do the dot product of encrypted_copy and the secret key array using NTT.
-        // The secret key powers are already NTT transformed.
-        auto copy_operand1(allocate_uint(coeff_count, pool_));
+        // in noise_poly.
+        dot_product_ct_sk_array(encrypted, true, noise_poly.get(), pool);
+
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
-            // Initialize pointers for multiplication
-            const uint64_t *current_array1 = encrypted.data(1) + (i * coeff_count);
-            const uint64_t *current_array2 = secret_key_array_.get() + (i * coeff_count);
+            // add c_0 into noise_poly
+            add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count),
+                encrypted.data() + (i * coeff_count), coeff_count, coeff_modulus[i],
+                noise_poly.get() + (i * coeff_count));
 
-            for (size_t j = 0; j < encrypted_size - 1; j++)
-            {
-                // Perform the dyadic product.
-                set_uint_uint(current_array1, coeff_count, copy_operand1.get());
+            // Multiply by parms.plain_modulus() and reduce mod parms.coeff_modulus() to get
+            // parms.coeff_modulus()*noise
+            multiply_poly_scalar_coeffmod(noise_poly.get() + (i * coeff_count),
+                coeff_count, plain_modulus, coeff_modulus[i],
+                noise_poly.get() + (i * coeff_count));
+        }
 
-                // Lazy reduction
-                ntt_negacyclic_harvey_lazy(copy_operand1.get(), small_ntt_tables[i]);
+        // Compose the noise
+        compose(context_data, noise_poly.get(), pool);
 
-                dyadic_product_coeffmod(copy_operand1.get(), current_array2, coeff_count,
-                    coeff_modulus[i], copy_operand1.get());
-                add_poly_poly_coeffmod(noise_poly.get() + (i * coeff_count), 
-                    copy_operand1.get(),
-                    coeff_count, coeff_modulus[i],
-                    noise_poly.get() + (i * coeff_count));
+        // Next we compute the infinity norm mod parms.coeff_modulus()
+        poly_infty_norm_coeffmod(noise_poly.get(), coeff_count, coeff_mod_count,
+            context_data.total_coeff_modulus(), destination.get(), pool);
 
-                current_array1 += rns_poly_uint64_count;
-                current_array2 += rns_poly_uint64_count;
-            }
+        // The -1 accounts for scaling the invariant noise by 2
+        int bit_count_diff = context_data.total_coeff_modulus_bit_count() -
+            get_significant_bit_count_uint(destination.get(), coeff_mod_count) - 1;
+        return max(0, bit_count_diff);
+    }
+
+    int Decryptor::estimate_noise_budget(const Ciphertext &encrypted)
+    {
+        return estimate_noise_budget(encrypted, pool_);
+    }
+
+    int Decryptor::estimate_noise_budget(const Ciphertext &encrypted,
+        MemoryPoolHandle pool)
+    {
+        // Verify that encrypted is valid.
+        if (!encrypted.is_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
 
-            // Perform inverse NTT
-            inverse_ntt_negacyclic_harvey(noise_poly.get() + (i * coeff_count),
-                small_ntt_tables[i]);
+        if (context_->context_data()->parms().scheme() != scheme_type::BFV)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+        if (encrypted.is_ntt_form())
+        {
+            throw invalid_argument("encrypted cannot be in NTT form");
         }
 
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+        uint64_t plain_modulus = parms.plain_modulus().value();
+
+        auto &inv_coeff_mod_coeff_array = 
+            context_data.base_converter()->get_inv_coeff_mod_coeff_array();
+
+        // Storage for noise poly
+        auto noise_poly(allocate_poly(coeff_count, coeff_mod_count, pool));
+
+        // put < (c_1 , c_2, ... , c_{count-1}) , (s,s^2,...,s^{count-1}) > mod q
+        // in noise_poly.
+        dot_product_ct_sk_array(encrypted, true, noise_poly.get(), pool);
+
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
             // add c_0 into noise_poly
@@ -530,23 +641,171 @@ namespace seal
                 encrypted.data() + (i * coeff_count), coeff_count, coeff_modulus[i],
                 noise_poly.get() + (i * coeff_count));
 
-            // Multiply by parms.plain_modulus() and reduce mod parms.coeff_modulus() to get
-            // parms.coeff_modulus()*noise
+            // Multiply by parms.plain_modulus() as in invariant_noise_budget, and 
+            // by the CRT coefficient (q/q_i)^(-1) mod q_i in the same pass
+            uint64_t scalar = multiply_uint_uint_mod(
+                plain_modulus % coeff_modulus[i].value(),
+                inv_coeff_mod_coeff_array[i], coeff_modulus[i]);
             multiply_poly_scalar_coeffmod(noise_poly.get() + (i * coeff_count),
-                coeff_count, plain_modulus, coeff_modulus[i],
+                coeff_count, scalar, coeff_modulus[i],
                 noise_poly.get() + (i * coeff_count));
         }
 
-        // Compose the noise
-        compose(context_data, noise_poly.get());
+        // Two words of precision resolve the noise well as long as there is 
+        // little noise budget left. Otherwise we need enough words for the 
+        // accumulated error to stay well below 1/q, so that also the smallest 
+        // possible noise is resolved.
+        size_t word_count = 2;
+        double fraction_log2 = max_centered_fraction_log2(
+            context_data, noise_poly.get(), word_count, pool);
+        size_t full_word_count = static_cast<size_t>(divide_round_up(
+            context_data.total_coeff_modulus_bit_count() + 
+            get_significant_bit_count(static_cast<uint64_t>(coeff_mod_count)) + 66,
+            bits_per_uint64));
+        if (fraction_log2 < -50.0 && full_word_count > word_count)
+        {
+            word_count = full_word_count;
+            fraction_log2 = max_centered_fraction_log2(
+                context_data, noise_poly.get(), word_count, pool);
+        }
 
-        // Next we compute the infinity norm mod parms.coeff_modulus()
-        poly_infty_norm_coeffmod(noise_poly.get(), coeff_count, coeff_mod_count,
-            context_data.total_coeff_modulus(), destination.get(), pool_);
+        // Bit count of the infinity norm of the noise
+        int noise_bit_count = 0;
+        if (fraction_log2 > -numeric_limits<double>::infinity())
+        {
+            double coeff_modulus_log2 = 0;
+            for (auto &mod : coeff_modulus)
+            {
+                coeff_modulus_log2 += log2(static_cast<double>(mod.value()));
+            }
+            noise_bit_count = max(0, static_cast<int>(
+                floor(coeff_modulus_log2 + fraction_log2)) + 1);
+        }
 
         // The -1 accounts for scaling the invariant noise by 2
         int bit_count_diff = context_data.total_coeff_modulus_bit_count() -
-            get_significant_bit_count_uint(destination.get(), coeff_mod_count) - 1;
+            noise_bit_count - 1;
         return max(0, bit_count_diff);
     }
+
+    double Decryptor::estimate_noise_budget_batch(
+        const vector<Ciphertext> &encrypted, vector<int> &destination, 
+        size_t thread_count)
+    {
+        auto time_start = chrono::steady_clock::now();
+
+        // Compute the secret key powers once, before any thread needs them
+        size_t max_size = 2;
+        for (auto &ct : encrypted)
+        {
+            max_size = max(max_size, ct.size());
+        }
+        compute_secret_key_array(max_size - 1);
+
+        destination.resize(encrypted.size());
+        ThreadPool::Global().parallel_for(encrypted.size(), thread_count,
+            [&](size_t begin, size_t end, size_t)
+            {
+                auto pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW, true);
+                for (size_t i = begin; i < end; i++)
+                {
+                    destination[i] = estimate_noise_budget(encrypted[i], pool);
+                }
+            });
+
+        chrono::duration<double> seconds = chrono::steady_clock::now() - time_start;
+        return (seconds.count() > 0) ? 
+            static_cast<double>(encrypted.size()) / seconds.count() : 0.0;
+    }
+
+    double Decryptor::max_centered_fraction_log2(
+        const SEALContext::ContextData &context_data, const uint64_t *value,
+        size_t word_count, MemoryPoolHandle pool)
+    {
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+
+        /*
+        Given y_j = [x * (q/q_j)^(-1)]_{q_j}, the CRT composition of x satisfies
+        x/q = y_1/q_1 + ... + y_k/q_k (mod 1). We compute this fractional part in 
+        fixed-point arithmetic with word_count words after the binary point, so 
+        that the wrap-around of the word_count-word addition performs the mod 1.
+        Each term has an error of less than 2^(-64*word_count) * q_j.
+        */
+
+        // Fixed-point reciprocals floor(2^(64*word_count) / q_j)
+        auto reciprocals(allocate_uint(mul_safe(coeff_mod_count, word_count), pool));
+        {
+            size_t wide_count = word_count + 1;
+            auto numerator(allocate_uint(wide_count, pool));
+            auto denominator(allocate_zero_uint(wide_count, pool));
+            auto quotient(allocate_uint(wide_count, pool));
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                set_zero_uint(word_count, numerator.get());
+                numerator[word_count] = 1;
+                denominator[0] = coeff_modulus[j].value();
+                divide_uint_uint_inplace(numerator.get(), denominator.get(), 
+                    wide_count, quotient.get(), pool);
+                set_uint_uint(quotient.get(), word_count, 
+                    reciprocals.get() + (j * word_count));
+            }
+        }
+
+        auto fraction(allocate_uint(word_count, pool));
+        auto max_fraction(allocate_zero_uint(word_count, pool));
+        for (size_t i = 0; i < coeff_count; i++)
+        {
+            set_zero_uint(word_count, fraction.get());
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                // Multiply-accumulate y_j * floor(2^(64*word_count) / q_j); the
+                // carry out of the top word is dropped
+                uint64_t y = value[(j * coeff_count) + i];
+                const uint64_t *reciprocal = reciprocals.get() + (j * word_count);
+                unsigned long long carry = 0;
+                for (size_t k = 0; k < word_count; k++)
+                {
+                    unsigned long long product[2];
+                    multiply_uint64(reciprocal[k], y, product);
+                    unsigned long long sum;
+                    product[1] += add_uint64(fraction[k], product[0], &sum);
+                    product[1] += add_uint64(sum, carry, &sum);
+                    fraction[k] = sum;
+                    carry = product[1];
+                }
+            }
+
+            // Fractions of at least 1/2 represent negative values
+            if (fraction[word_count - 1] >> 63)
+            {
+                negate_uint(fraction.get(), word_count, fraction.get());
+            }
+            if (is_greater_than_uint_uint(fraction.get(), max_fraction.get(), word_count))
+            {
+                set_uint_uint(fraction.get(), word_count, max_fraction.get());
+            }
+        }
+
+        // Find the most significant word of the maximum
+        size_t top_index = word_count;
+        while (top_index && !max_fraction[top_index - 1])
+        {
+            top_index--;
+        }
+        if (!top_index)
+        {
+            return -numeric_limits<double>::infinity();
+        }
+        top_index--;
+        double top = static_cast<double>(max_fraction[top_index]);
+        if (top_index)
+        {
+            top += ldexp(static_cast<double>(max_fraction[top_index - 1]), -64);
+        }
+        return log2(top) + 64.0 * static_cast<double>(top_index) - 
+            64.0 * static_cast<double>(word_count);
+    }
 }
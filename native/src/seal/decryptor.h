@@ -4,6 +4,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <complex>
+#include <functional>
+#include <type_traits>
 #include "seal/randomgen.h"
 #include "seal/encryptionparams.h"
 #include "seal/context.h"
@@ -15,6 +19,8 @@
 #include "seal/util/baseconverter.h"
 #include "seal/smallmodulus.h"
 #include "seal/util/locks.h"
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
 
 namespace seal
 {
@@ -34,8 +40,22 @@ namespace seal
     one can share one single Decryptor across any number of threads, but in each 
     thread call the decrypt function by giving it a thread-local MemoryPoolHandle 
     to use. It is important for a developer to understand how this works to avoid 
-    unnecessary performance bottlenecks.
+    unnecessary performance bottlenecks. The overloads without a MemoryPoolHandle 
+    use a memory pool owned by the Decryptor that is cleared when the Decryptor 
+    is destroyed.
 
+    @par Thread Safety
+    All member functions of Decryptor can be called concurrently from several 
+    threads. Powers of the secret key needed for decrypting ciphertexts of size 
+    larger than two are computed on demand and shared between threads.
+
+    @par Batch Decryption
+    The decrypt_batch functions decrypt (and optionally decode) many ciphertexts 
+    in parallel on a shared thread pool. Each participating thread decrypts into 
+    its own plaintext buffer, which is reused for all of its ciphertexts and 
+    decoded directly into the output vectors, so no plaintexts are allocated 
+    per ciphertext. Temporary allocations are made from fresh memory pools that 
+    are cleared when the operation completes.
 
     @par NTT form
     When using the BFV scheme (scheme_type::BFV), all plaintext and ciphertexts 
@@ -71,6 +91,110 @@ namespace seal
         */
         void decrypt(const Ciphertext &encrypted, Plaintext &destination);
 
+        /*
+        Decrypts a Ciphertext and stores the result in the destination parameter. 
+        Dynamic memory allocations in the process are allocated from the memory 
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to decrypt
+        @param[out] destination The plaintext to overwrite with the decrypted ciphertext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void decrypt(const Ciphertext &encrypted, Plaintext &destination,
+            MemoryPoolHandle pool);
+
+        /*
+        Decrypts a batch of ciphertexts in parallel and stores the results in the 
+        destination vector, which is resized to the number of ciphertexts.
+
+        @param[in] encrypted The ciphertexts to decrypt
+        @param[out] destination The plaintexts to overwrite with the decrypted 
+        ciphertexts
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the ciphertexts is not valid for 
+        the encryption parameters or not in the default NTT form
+        */
+        double decrypt_batch(const std::vector<Ciphertext> &encrypted,
+            std::vector<Plaintext> &destination, std::size_t thread_count = 0);
+
+        /*
+        Decrypts a batch of BFV ciphertexts in parallel and decodes the results 
+        with the given BatchEncoder into matrices of integers modulo the plaintext 
+        modulus. The destination vector is resized to the number of ciphertexts.
+
+        @param[in] encoder The BatchEncoder to use
+        @param[in] encrypted The ciphertexts to decrypt
+        @param[out] destination The matrices to overwrite with the decrypted and 
+        decoded values
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the ciphertexts is not valid for 
+        the encryption parameters or not in the default NTT form
+        */
+        double decrypt_batch(BatchEncoder &encoder, 
+            const std::vector<Ciphertext> &encrypted,
+            std::vector<std::vector<std::uint64_t>> &destination, 
+            std::size_t thread_count = 0);
+
+        /*
+        Decrypts a batch of BFV ciphertexts in parallel and decodes the results 
+        with the given BatchEncoder into matrices of signed integers. The 
+        destination vector is resized to the number of ciphertexts.
+
+        @param[in] encoder The BatchEncoder to use
+        @param[in] encrypted The ciphertexts to decrypt
+        @param[out] destination The matrices to overwrite with the decrypted and 
+        decoded values
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the ciphertexts is not valid for 
+        the encryption parameters or not in the default NTT form
+        */
+        double decrypt_batch(BatchEncoder &encoder, 
+            const std::vector<Ciphertext> &encrypted,
+            std::vector<std::vector<std::int64_t>> &destination, 
+            std::size_t thread_count = 0);
+
+        /*
+        Decrypts a batch of CKKS ciphertexts in parallel and decodes the results 
+        with the given CKKSEncoder into vectors of real or complex numbers. The 
+        destination vector is resized to the number of ciphertexts.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] encoder The CKKSEncoder to use
+        @param[in] encrypted The ciphertexts to decrypt
+        @param[out] destination The vectors to overwrite with the decrypted and 
+        decoded values
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the ciphertexts is not valid for 
+        the encryption parameters or not in the default NTT form
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline double decrypt_batch(CKKSEncoder &encoder, 
+            const std::vector<Ciphertext> &encrypted,
+            std::vector<std::vector<T>> &destination, 
+            std::size_t thread_count = 0)
+        {
+            destination.resize(encrypted.size());
+            return decrypt_batch_internal(encrypted,
+                [&](std::size_t index, const Plaintext &plain, 
+                    MemoryPoolHandle pool)
+                {
+                    encoder.decode(plain, destination[index], std::move(pool));
+                }, thread_count);
+        }
+
         /*
         Computes the invariant noise budget (in bits) of a ciphertext. The invariant 
         noise budget measures the amount of room there is for the noise to grow while 
@@ -95,7 +219,88 @@ namespace seal
         */
         int invariant_noise_budget(const Ciphertext &encrypted);
 
+        /*
+        Computes the invariant noise budget (in bits) of a ciphertext as by 
+        invariant_noise_budget(const Ciphertext &). Dynamic memory allocations 
+        in the process are allocated from the memory pool pointed to by the given 
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the scheme is not BFV
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        int invariant_noise_budget(const Ciphertext &encrypted, 
+            MemoryPoolHandle pool);
+
+        /*
+        Estimates the invariant noise budget (in bits) of a ciphertext. This 
+        function works only with the BFV scheme and returns the same value as 
+        invariant_noise_budget, except that it may differ by one bit when the 
+        infinity norm of the noise is very close to a power of two.
+
+        @par Fast Estimation
+        Instead of composing every coefficient of the noise polynomial into a 
+        multi-precision integer modulo the full coefficient modulus, the estimate 
+        computes the fractional part of noise/coeff_modulus from the RNS residues 
+        in fixed-point arithmetic. Two 64-bit words of precision are enough to 
+        resolve noise budgets of up to about 48 bits; only ciphertexts with a 
+        larger noise budget are recomputed with enough words to cover the full 
+        coefficient modulus.
+
+        @param[in] encrypted The ciphertext
+        @throws std::invalid_argument if the scheme is not BFV
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        */
+        int estimate_noise_budget(const Ciphertext &encrypted);
+
+        /*
+        Estimates the invariant noise budget (in bits) of a ciphertext as by 
+        estimate_noise_budget(const Ciphertext &). Dynamic memory allocations 
+        in the process are allocated from the memory pool pointed to by the given 
+        MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if the scheme is not BFV
+        @throws std::invalid_argument if encrypted is not valid for the encryption parameters
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        int estimate_noise_budget(const Ciphertext &encrypted, 
+            MemoryPoolHandle pool);
+
+        /*
+        Estimates the invariant noise budgets of a batch of ciphertexts in 
+        parallel as by estimate_noise_budget(const Ciphertext &), and stores 
+        them in the destination vector, which is resized to the number of 
+        ciphertexts.
+
+        @param[in] encrypted The ciphertexts
+        @param[out] destination The vector to overwrite with the noise budgets
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if the scheme is not BFV
+        @throws std::invalid_argument if any of the ciphertexts is not valid for 
+        the encryption parameters or is in NTT form
+        */
+        double estimate_noise_budget_batch(const std::vector<Ciphertext> &encrypted,
+            std::vector<int> &destination, std::size_t thread_count = 0);
+
     private:
+        using plain_sink_type = std::function<void(std::size_t index, 
+            const Plaintext &plain, MemoryPoolHandle pool)>;
+
+        double decrypt_batch_internal(const std::vector<Ciphertext> &encrypted,
+            const plain_sink_type &plain_sink, std::size_t thread_count);
+
+        void dot_product_ct_sk_array(const Ciphertext &encrypted, 
+            bool ntt_transform, std::uint64_t *destination, MemoryPoolHandle pool);
+
         void bfv_decrypt(const Ciphertext &encrypted, Plaintext &destination,
             MemoryPoolHandle pool);
 
@@ -113,7 +318,11 @@ namespace seal
         void compute_secret_key_array(std::size_t max_power);
 
         void compose(const SEALContext::ContextData &context_data, 
-            std::uint64_t *value);
+            std::uint64_t *value, MemoryPoolHandle pool);
+
+        double max_centered_fraction_log2(
+            const SEALContext::ContextData &context_data, const std::uint64_t *value,
+            std::size_t word_count, MemoryPoolHandle pool);
 
         /**
         We use a fresh memory pool with `clear_on_destruction' enabled
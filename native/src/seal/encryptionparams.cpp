@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "seal/encryptionparams.h"
+#include "seal/util/serialization.h"
 #include <limits>
 
 using namespace std;
@@ -160,4 +161,23 @@ namespace seal
             throw logic_error("parms_id cannot be zero");
         }
     }
+
+    size_t EncryptionParameters::SaveSize(const EncryptionParameters &parms)
+    {
+        return compute_save_size([&](ostream &stream) { Save(parms, stream); });
+    }
+
+    size_t EncryptionParameters::Save(const EncryptionParameters &parms,
+        SEAL_BYTE *out, size_t size)
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { Save(parms, stream); });
+    }
+
+    size_t EncryptionParameters::Load(EncryptionParameters &parms,
+        const SEAL_BYTE *in, size_t size)
+    {
+        return load_from_buffer(in, size,
+            [&](istream &stream) { parms = Load(stream); });
+    }
 }
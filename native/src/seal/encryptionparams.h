@@ -372,6 +372,42 @@ namespace seal
         */
         static EncryptionParameters Load(std::istream &stream);
 
+        /**
+        Returns the exact number of bytes that Save writes for the given
+        EncryptionParameters.
+
+        @param[in] parms The EncryptionParameters to measure
+        */
+        static std::size_t SaveSize(const EncryptionParameters &parms);
+
+        /**
+        Saves EncryptionParameters to a buffer in the format that Save writes to
+        a stream, and returns the number of bytes written.
+
+        @param[in] parms The EncryptionParameters to save
+        @param[out] out The buffer to save the EncryptionParameters to
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the EncryptionParameters do not fit in
+        size bytes
+        */
+        static std::size_t Save(const EncryptionParameters &parms,
+            SEAL_BYTE *out, std::size_t size);
+
+        /**
+        Loads EncryptionParameters from a buffer in the format that Save writes
+        to a stream, and returns the number of bytes read.
+
+        @param[out] parms The EncryptionParameters to load to
+        @param[in] in The buffer to load the EncryptionParameters from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if valid EncryptionParameters could not be read
+        from in
+        */
+        static std::size_t Load(EncryptionParameters &parms, const SEAL_BYTE *in,
+            std::size_t size);
+
     private:
         void compute_parms_id();
 
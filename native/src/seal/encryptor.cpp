@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <chrono>
 #include "seal/encryptor.h"
 #include "seal/randomgen.h"
 #include "seal/randomtostd.h"
@@ -12,6 +13,7 @@
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/clipnormal.h"
 #include "seal/util/smallntt.h"
+#include "seal/util/threadpool.h"
 
 using namespace std;
 using namespace seal::util;
@@ -52,15 +54,41 @@ namespace seal
             public_key_.get());
     }
 
+    Encryptor::~Encryptor()
+    {
+        disable_zero_pool();
+    }
+
     void Encryptor::encrypt(const Plaintext &plain, 
         Ciphertext &destination, MemoryPoolHandle pool)
+    {
+        // BFV encrypts at the first level; CKKS at the level of the plaintext
+        auto &parms = context_->context_data()->parms();
+        auto parms_id = (parms.scheme() == scheme_type::CKKS) ?
+            plain.parms_id() : context_->first_parms_id();
+        encrypt(plain, parms_id, destination, move(pool));
+    }
+
+    void Encryptor::encrypt(const Plaintext &plain, parms_id_type parms_id,
+        Ciphertext &destination, MemoryPoolHandle pool)
     {
         // Verify parameters.
         if (!pool)
         {
             throw invalid_argument("pool is uninitialized");
         }
+        if (!context_->context_data(parms_id))
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
 
+        encrypt_internal(plain, parms_id, destination, move(pool), nullptr);
+    }
+
+    void Encryptor::encrypt_internal(const Plaintext &plain, parms_id_type parms_id,
+        Ciphertext &destination, MemoryPoolHandle pool, 
+        shared_ptr<UniformRandomGenerator> random)
+    {
         // Verify that plain is valid.
         if (!plain.is_valid_for(context_))
         {
@@ -73,11 +101,11 @@ namespace seal
         switch (parms.scheme())
         {
         case scheme_type::BFV:
-            bfv_encrypt(plain, destination, move(pool));
+            bfv_encrypt(plain, parms_id, destination, move(pool), move(random));
             return;
 
         case scheme_type::CKKS:
-            ckks_encrypt(plain, destination, move(pool));
+            ckks_encrypt(plain, parms_id, destination, move(pool), move(random));
             return;
 
         default:
@@ -85,15 +113,136 @@ namespace seal
         }
     }
 
-    void Encryptor::bfv_encrypt(const Plaintext &plain, 
+    double Encryptor::encrypt_batch(const vector<Plaintext> &plains,
+        vector<Ciphertext> &destination, size_t thread_count)
+    {
+        return encrypt_batch_internal(plains.size(), nullptr,
+            [&plains](size_t index, Plaintext &, MemoryPoolHandle) 
+                -> const Plaintext & { return plains[index]; }, 
+            destination, thread_count);
+    }
+
+    double Encryptor::encrypt_batch(const vector<Plaintext> &plains,
+        parms_id_type parms_id, vector<Ciphertext> &destination, 
+        size_t thread_count)
+    {
+        return encrypt_batch_internal(plains.size(), &parms_id,
+            [&plains](size_t index, Plaintext &, MemoryPoolHandle) 
+                -> const Plaintext & { return plains[index]; }, 
+            destination, thread_count);
+    }
+
+    double Encryptor::encrypt_batch(BatchEncoder &encoder, 
+        const vector<vector<uint64_t>> &values, vector<Ciphertext> &destination, 
+        size_t thread_count)
+    {
+        return encrypt_batch_internal(values.size(), nullptr,
+            [&encoder, &values](size_t index, Plaintext &buffer, MemoryPoolHandle) 
+                -> const Plaintext & 
+            { 
+                encoder.encode(values[index], buffer);
+                return buffer;
+            }, destination, thread_count);
+    }
+
+    double Encryptor::encrypt_batch(BatchEncoder &encoder, 
+        const vector<vector<int64_t>> &values, vector<Ciphertext> &destination, 
+        size_t thread_count)
+    {
+        return encrypt_batch_internal(values.size(), nullptr,
+            [&encoder, &values](size_t index, Plaintext &buffer, MemoryPoolHandle) 
+                -> const Plaintext & 
+            { 
+                encoder.encode(values[index], buffer);
+                return buffer;
+            }, destination, thread_count);
+    }
+
+    double Encryptor::encrypt_batch_internal(size_t count, 
+        const parms_id_type *parms_id, const plain_source_type &plain_source, 
+        vector<Ciphertext> &destination, size_t thread_count)
+    {
+        if (parms_id && !context_->context_data(*parms_id))
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+
+        auto time_start = chrono::steady_clock::now();
+
+        // Existing ciphertexts are reused to avoid reallocations. New ones use
+        // the global memory pool, since they are allocated by several threads.
+        if (destination.size() > count)
+        {
+            destination.erase(destination.begin() + static_cast<ptrdiff_t>(count),
+                destination.end());
+        }
+        destination.reserve(count);
+        while (destination.size() < count)
+        {
+            destination.emplace_back(MemoryManager::GetPool(mm_prof_opt::FORCE_GLOBAL));
+        }
+
+        auto &parms = context_->context_data()->parms();
+        bool is_ckks = (parms.scheme() == scheme_type::CKKS);
+
+        // Per-thread random number generator, memory pool, and plaintext
+        // buffer, created by each thread when it gets its first indices. The
+        // pools are new thread-safe pools, so that the buffers can be released
+        // by the calling thread afterwards.
+        auto &thread_pool = ThreadPool::Global();
+        size_t max_thread_count = thread_pool.max_thread_count();
+        vector<shared_ptr<UniformRandomGenerator>> randoms(max_thread_count);
+        vector<MemoryPoolHandle> pools(max_thread_count);
+        vector<Plaintext> buffers(max_thread_count);
+        thread_pool.parallel_for(count, thread_count,
+            [&](size_t begin, size_t end, size_t thread_index)
+            {
+                auto &random = randoms[thread_index];
+                auto &pool = pools[thread_index];
+                auto &buffer = buffers[thread_index];
+                if (!random)
+                {
+                    random = parms.random_generator()->create();
+                    pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW);
+                    buffer = Plaintext(pool);
+                }
+                for (size_t i = begin; i < end; i++)
+                {
+                    auto &plain = plain_source(i, buffer, pool);
+                    auto curr_parms_id = parms_id ? *parms_id : 
+                        (is_ckks ? plain.parms_id() : context_->first_parms_id());
+                    encrypt_internal(plain, curr_parms_id, destination[i], pool, random);
+                }
+            });
+
+        chrono::duration<double> seconds = chrono::steady_clock::now() - time_start;
+        return (seconds.count() > 0) ? 
+            static_cast<double>(count) / seconds.count() : 0.0;
+    }
+
+    void Encryptor::encrypt_zero(parms_id_type parms_id, 
         Ciphertext &destination, MemoryPoolHandle pool)
     {
-        if (plain.is_ntt_form())
+        // Verify parameters.
+        if (!pool)
         {
-            throw invalid_argument("plain cannot be in NTT form");
+            throw invalid_argument("pool is uninitialized");
+        }
+        if (!context_->context_data(parms_id))
+        {
+            throw invalid_argument("parms_id is not valid for encryption parameters");
         }
 
-        auto &context_data = *context_->context_data();
+        bool is_ntt_form = 
+            (context_->context_data()->parms().scheme() == scheme_type::CKKS);
+        encrypt_zero_internal(parms_id, is_ntt_form, destination, move(pool));
+    }
+
+    void Encryptor::encrypt_zero_internal(parms_id_type parms_id, 
+        bool is_ntt_form, Ciphertext &destination, MemoryPoolHandle pool,
+        shared_ptr<UniformRandomGenerator> random)
+    {
+        auto &context_data = *context_->context_data(parms_id);
         auto &parms = context_data.parms();
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
@@ -104,19 +253,26 @@ namespace seal
         auto &small_ntt_tables = context_data.small_ntt_tables();
 
         // Make destination have right size and parms_id
-        destination.resize(context_, parms.parms_id(), 2);
-        destination.is_ntt_form() = false;
+        destination.resize(context_, parms_id, 2);
+        destination.is_ntt_form() = is_ntt_form;
+        destination.scale() = 1.0;
 
         /*
         Ciphertext (c_0,c_1)
-        c_0 = Delta * m + public_key_[0] * u + e_1 where u sampled from R_3 and e_1 sampled from chi.
+        c_0 = public_key_[0] * u + e_1 where u sampled from R_3 and e_1 sampled from chi.
         c_1 = public_key_[1] * u + e_2 where e_2 sampled from chi.
+
+        The public key is stored at the first level; at lower levels we use its 
+        first coeff_mod_count components.
         */
 
         // Generate u 
         auto u(allocate_poly(coeff_count, coeff_mod_count, pool));
-        shared_ptr<UniformRandomGenerator> random(parms.random_generator()->create());
-        
+        if (!random)
+        {
+            random = parms.random_generator()->create();
+        }
+
         set_poly_coeffs_zero_one_negone(u.get(), random, context_data);
 
         // Multiply both u * public_key_[0] and u * public_key_[1] using the same FFT
@@ -127,125 +283,252 @@ namespace seal
             dyadic_product_coeffmod(u.get() + (i * coeff_count), 
                 public_key_.get() + (i * coeff_count), coeff_count, 
                 coeff_modulus[i], destination.data() + (i * coeff_count));
-            inverse_ntt_negacyclic_harvey(destination.data() + (i * coeff_count), 
-                small_ntt_tables[i]);
-
             dyadic_product_coeffmod(u.get() + (i * coeff_count), 
                 public_key_.get() + (coeff_count * first_coeff_mod_count) + (i * coeff_count), 
                 coeff_count, coeff_modulus[i], destination.data(1) + (i * coeff_count));
-            inverse_ntt_negacyclic_harvey(destination.data(1) + (i * coeff_count), 
-                small_ntt_tables[i]);
+            if (!is_ntt_form)
+            {
+                inverse_ntt_negacyclic_harvey(destination.data() + (i * coeff_count), 
+                    small_ntt_tables[i]);
+                inverse_ntt_negacyclic_harvey(destination.data(1) + (i * coeff_count), 
+                    small_ntt_tables[i]);
+            }
         }
 
-        // Multiply plain by scalar coeff_div_plaintext and reposition if in upper-half.
-        // Result gets added into the c_0 term of ciphertext (c_0,c_1).
-        preencrypt(plain.data(), plain.coeff_count(), context_data, destination.data());
-
         // Generate e_0, add this value into destination[0].
-        set_poly_coeffs_normal(u.get(), random, context_data);
-        for (size_t i = 0; i < coeff_mod_count; i++)
+        // Generate e_1, add this value into destination[1].
+        for (size_t j = 0; j < 2; j++)
         {
-            add_poly_poly_coeffmod(u.get() + (i * coeff_count), 
-                destination.data() + (i * coeff_count), coeff_count, 
-                coeff_modulus[i], destination.data() + (i * coeff_count));
+            set_poly_coeffs_normal(u.get(), random, context_data);
+            for (size_t i = 0; i < coeff_mod_count; i++)
+            {
+                if (is_ntt_form)
+                {
+                    ntt_negacyclic_harvey(u.get() + (i * coeff_count), small_ntt_tables[i]);
+                }
+                add_poly_poly_coeffmod(u.get() + (i * coeff_count), 
+                    destination.data(j) + (i * coeff_count), coeff_count, 
+                    coeff_modulus[i], destination.data(j) + (i * coeff_count));
+            }
         }
-        // Generate e_1, add this value into destination[1].
-        set_poly_coeffs_normal(u.get(), random, context_data);
-        for (size_t i = 0; i < coeff_mod_count; i++)
+    }
+
+    void Encryptor::bfv_encrypt(const Plaintext &plain, parms_id_type parms_id,
+        Ciphertext &destination, MemoryPoolHandle pool,
+        shared_ptr<UniformRandomGenerator> random)
+    {
+        if (plain.is_ntt_form())
+        {
+            throw invalid_argument("plain cannot be in NTT form");
+        }
+
+        if (!try_take_zero(parms_id, destination))
         {
-            add_poly_poly_coeffmod(u.get() + (i * coeff_count), 
-                destination.data(1) + (i * coeff_count), coeff_count, 
-                coeff_modulus[i], destination.data(1) + (i * coeff_count));
+            encrypt_zero_internal(parms_id, false, destination, move(pool), 
+                move(random));
         }
+
+        // Multiply plain by scalar coeff_div_plaintext and reposition if in upper-half.
+        // Result gets added into the c_0 term of ciphertext (c_0,c_1). Note that
+        // coeff_div_plaintext is computed for the coefficient modulus at parms_id.
+        preencrypt(plain.data(), plain.coeff_count(), 
+            *context_->context_data(parms_id), destination.data());
     }
 
-    void Encryptor::ckks_encrypt(const Plaintext &plain, 
-        Ciphertext &destination, MemoryPoolHandle pool)
+    void Encryptor::ckks_encrypt(const Plaintext &plain, parms_id_type parms_id,
+        Ciphertext &destination, MemoryPoolHandle pool,
+        shared_ptr<UniformRandomGenerator> random)
     {
         if (!plain.is_ntt_form())
         {
             throw invalid_argument("plain must be in NTT form");
         }
 
-        auto context_data_ptr = context_->context_data(plain.parms_id());
-        if (!context_data_ptr)
+        auto plain_context_data_ptr = context_->context_data(plain.parms_id());
+        if (!plain_context_data_ptr)
         {
             throw invalid_argument("plain is not valid for encryption parameters");
         }
 
-        auto &context_data = *context_data_ptr;
+        auto &context_data = *context_->context_data(parms_id);
+        if (plain_context_data_ptr->chain_index() < context_data.chain_index())
+        {
+            throw invalid_argument("plain is at a lower level than parms_id");
+        }
+
         auto &parms = context_data.parms();
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
-        size_t first_coeff_mod_count = 
-            context_->context_data()->parms().coeff_modulus().size();
         size_t coeff_mod_count = coeff_modulus.size();
 
-        auto &small_ntt_tables = context_data.small_ntt_tables();
-
-        // Make destination have right size and hash block
-        destination.resize(context_, parms.parms_id(), 2);
-        destination.is_ntt_form() = true;
-        destination.scale() = plain.scale();
-
-        /*
-            Ciphertext (c_0,c_1)
-            c_0 = m + public_key_[0] * u + e_1 where u sampled from R_3 and e_1 sampled from chi.
-            c_1 = public_key_[1] * u + e_2 where e_2 sampled from chi.
-        */
-
-        // Generate u 
-        auto u(allocate_poly(coeff_count, coeff_mod_count, pool));
-        shared_ptr<UniformRandomGenerator> random(parms.random_generator()->create());
-
-        set_poly_coeffs_zero_one_negone(u.get(), random, context_data);
-        
-        // Multiply both u * public_key_[0] and u * public_key_[1] using the same FFT
-        for (size_t i = 0; i < coeff_mod_count; i++)
+        if (!try_take_zero(parms_id, destination))
         {
-            ntt_negacyclic_harvey(u.get() + (i * coeff_count), small_ntt_tables[i]);
-            dyadic_product_coeffmod(
-                u.get() + (i * coeff_count), 
-                public_key_.get() + (i * coeff_count), 
-                coeff_count,
-                coeff_modulus[i], 
-                destination.data() + (i * coeff_count));
-            dyadic_product_coeffmod(
-                u.get() + (i * coeff_count), 
-                public_key_.get() + (coeff_count * first_coeff_mod_count) + (i * coeff_count),
-                coeff_count,
-                coeff_modulus[i], 
-                destination.data(1) + (i * coeff_count));
-        }
-
-        auto tmp(allocate_uint(coeff_count, pool));
+            encrypt_zero_internal(parms_id, true, destination, move(pool), 
+                move(random));
+        }
+
         // The plaintext gets added into the c_0 term of ciphertext (c_0,c_1).
+        // If plain is at a higher level, its first coeff_mod_count components
+        // are exactly the plaintext at parms_id.
         for (size_t i = 0; i < coeff_mod_count; i++)
         {
             add_poly_poly_coeffmod(destination.data() + (i * coeff_count),
                 plain.data() + (i * coeff_count), coeff_count,
                 coeff_modulus[i], destination.data() + (i * coeff_count));
         }
-        
-        // Generate e_0, add this value into destination[0].
-        set_poly_coeffs_normal(u.get(), random, context_data);
+        destination.scale() = plain.scale();
+    }
 
-        for (size_t i = 0; i < coeff_mod_count; i++)
+    void Encryptor::enable_zero_pool(parms_id_type parms_id, 
+        size_t capacity, bool background_refill)
+    {
+        if (!context_->context_data(parms_id))
         {
-            ntt_negacyclic_harvey(u.get() + (i * coeff_count), small_ntt_tables[i]);
-            add_poly_poly_coeffmod(u.get() + (i * coeff_count),
-                destination.data() + (i * coeff_count), coeff_count,
-                coeff_modulus[i], destination.data() + (i * coeff_count));
+            throw invalid_argument("parms_id is not valid for encryption parameters");
+        }
+        if (!capacity)
+        {
+            throw invalid_argument("capacity must be positive");
         }
-        // Generate e_1, add this value into destination[1].
-        set_poly_coeffs_normal(u.get(), random, context_data);
 
-        for (size_t i = 0; i < coeff_mod_count; i++)
+        disable_zero_pool();
+
+        lock_guard<mutex> lock(zero_pool_mutex_);
+
+        // The precomputed encryptions of zero are allocated in one thread and
+        // released in another, so they need a thread-safe memory pool
+        zero_pool_memory_ = pool_.is_thread_safe() ? 
+            pool_ : MemoryManager::GetPool(mm_prof_opt::FORCE_NEW);
+        zero_pool_parms_id_ = parms_id;
+        zero_pool_metrics_ = ZeroPoolMetrics();
+        zero_pool_metrics_.capacity = capacity;
+        zero_pool_stop_ = false;
+        if (background_refill)
+        {
+            zero_pool_thread_ = thread(&Encryptor::zero_pool_worker, this);
+        }
+    }
+
+    void Encryptor::disable_zero_pool()
+    {
+        {
+            lock_guard<mutex> lock(zero_pool_mutex_);
+            zero_pool_stop_ = true;
+        }
+        zero_pool_cv_.notify_all();
+        if (zero_pool_thread_.joinable())
         {
-            ntt_negacyclic_harvey(u.get() + (i * coeff_count), small_ntt_tables[i]);
-            add_poly_poly_coeffmod(u.get() + (i * coeff_count),
-                destination.data(1) + (i * coeff_count), coeff_count,
-                coeff_modulus[i], destination.data(1) + (i * coeff_count));
+            zero_pool_thread_.join();
+        }
+
+        lock_guard<mutex> lock(zero_pool_mutex_);
+        zero_pool_.clear();
+        zero_pool_memory_ = MemoryPoolHandle();
+        zero_pool_parms_id_ = parms_id_zero;
+        zero_pool_metrics_.capacity = 0;
+    }
+
+    void Encryptor::refill_zero_pool(MemoryPoolHandle pool)
+    {
+        if (!pool)
+        {
+            throw invalid_argument("pool is uninitialized");
+        }
+
+        unique_lock<mutex> lock(zero_pool_mutex_);
+        if (!zero_pool_metrics_.capacity)
+        {
+            throw logic_error("zero pool is not enabled");
+        }
+        bool is_ntt_form = 
+            (context_->context_data()->parms().scheme() == scheme_type::CKKS);
+        while (zero_pool_.size() < zero_pool_metrics_.capacity)
+        {
+            // Compute the encryption of zero without holding the lock
+            auto parms_id = zero_pool_parms_id_;
+            Ciphertext zero(zero_pool_memory_);
+            lock.unlock();
+            encrypt_zero_internal(parms_id, is_ntt_form, zero, pool);
+            lock.lock();
+
+            // The pool may have been reconfigured in the meantime
+            if (parms_id != zero_pool_parms_id_ || !zero_pool_metrics_.capacity)
+            {
+                return;
+            }
+            if (zero_pool_.size() < zero_pool_metrics_.capacity)
+            {
+                zero_pool_.emplace_back(move(zero));
+                zero_pool_metrics_.generated++;
+            }
+        }
+    }
+
+    Encryptor::ZeroPoolMetrics Encryptor::zero_pool_metrics() const
+    {
+        lock_guard<mutex> lock(zero_pool_mutex_);
+        ZeroPoolMetrics metrics = zero_pool_metrics_;
+        metrics.size = zero_pool_.size();
+        return metrics;
+    }
+
+    bool Encryptor::try_take_zero(parms_id_type parms_id, Ciphertext &destination)
+    {
+        unique_lock<mutex> lock(zero_pool_mutex_);
+        if (!zero_pool_metrics_.capacity || parms_id != zero_pool_parms_id_)
+        {
+            return false;
+        }
+        if (zero_pool_.empty())
+        {
+            zero_pool_metrics_.misses++;
+            return false;
+        }
+
+        // Remove the entry from the pool so that it can never be used again
+        Ciphertext zero(move(zero_pool_.front()));
+        zero_pool_.pop_front();
+        zero_pool_metrics_.hits++;
+        lock.unlock();
+
+        // Wake up the background refill thread
+        zero_pool_cv_.notify_one();
+
+        // Copy into the allocation of destination so that it keeps its own
+        // memory pool
+        destination = zero;
+        return true;
+    }
+
+    void Encryptor::zero_pool_worker()
+    {
+        auto pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW);
+        bool is_ntt_form = 
+            (context_->context_data()->parms().scheme() == scheme_type::CKKS);
+
+        unique_lock<mutex> lock(zero_pool_mutex_);
+        while (true)
+        {
+            zero_pool_cv_.wait(lock, [this]() {
+                return zero_pool_stop_ || 
+                    (zero_pool_.size() < zero_pool_metrics_.capacity); });
+            if (zero_pool_stop_)
+            {
+                return;
+            }
+
+            // Compute the encryption of zero without holding the lock
+            auto parms_id = zero_pool_parms_id_;
+            Ciphertext zero(zero_pool_memory_);
+            lock.unlock();
+            encrypt_zero_internal(parms_id, is_ntt_form, zero, pool);
+            lock.lock();
+
+            if (!zero_pool_stop_ && (zero_pool_.size() < zero_pool_metrics_.capacity))
+            {
+                zero_pool_.emplace_back(move(zero));
+                zero_pool_metrics_.generated++;
+            }
         }
     }
 
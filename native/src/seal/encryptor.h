@@ -5,12 +5,19 @@
 
 #include <vector>
 #include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
 #include "seal/encryptionparams.h"
 #include "seal/plaintext.h"
 #include "seal/ciphertext.h"
 #include "seal/memorymanager.h"
 #include "seal/context.h"
 #include "seal/publickey.h"
+#include "seal/batchencoder.h"
+#include "seal/ckks.h"
 #include "seal/util/smallntt.h"
 
 namespace seal
@@ -38,10 +45,64 @@ namespace seal
     should remain by default in NTT form. We call these scheme-specific NTT states 
     the "default NTT form". Decryption requires the input ciphertexts to be in 
     the default NTT form, and will throw an exception if this is not the case.
+
+    @par Precomputed Encryptions of Zero
+    Every encryption consists of an expensive part that does not depend on the 
+    plaintext (sampling, NTTs, and multiplication with the public key), and of 
+    a cheap part that adds the (scaled) plaintext into the result. The Encryptor 
+    can optionally maintain a bounded pool of fresh encryptions of zero at a given 
+    parms_id, filled either explicitly by calling refill_zero_pool, or by a 
+    background thread. When the pool is enabled, the encrypt function takes an 
+    encryption of zero from the pool when one is available and only performs the 
+    cheap online part. Each precomputed encryption of zero is removed from the pool 
+    when it is taken, so it is used at most once.
+
+    @par Batch Encryption
+    The encrypt_batch functions encrypt (and optionally first encode) many 
+    plaintexts in parallel on a shared thread pool. Each participating thread 
+    uses its own random number generator and its own memory pool for temporary 
+    allocations, both created once for the whole batch. The output ciphertexts 
+    are reused, so no allocations are needed for them when they already have 
+    the right size, e.g. from a previous call. Ciphertexts that are added to
+    the output use the global memory pool, and ciphertexts that are reused must
+    use a thread-safe memory pool, since they are resized by different threads.
     */
     class Encryptor
     {
     public:
+        /**
+        Stores a snapshot of the state of the pool of precomputed encryptions 
+        of zero.
+        */
+        struct ZeroPoolMetrics
+        {
+            /**
+            The number of encryptions of zero currently in the pool.
+            */
+            std::size_t size = 0;
+
+            /**
+            The maximum number of encryptions of zero held by the pool.
+            */
+            std::size_t capacity = 0;
+
+            /**
+            The number of encryptions that used a precomputed encryption of zero.
+            */
+            std::uint64_t hits = 0;
+
+            /**
+            The number of encryptions at the pool parms_id that found the pool
+            empty and had to compute the encryption of zero online.
+            */
+            std::uint64_t misses = 0;
+
+            /**
+            The total number of encryptions of zero added to the pool.
+            */
+            std::uint64_t generated = 0;
+        };
+
         /**
         Creates an Encryptor instance initialized with the specified SEALContext 
         and public key.
@@ -69,6 +130,248 @@ namespace seal
         void encrypt(const Plaintext &plain, Ciphertext &destination, 
             MemoryPoolHandle pool = MemoryManager::GetPool());
 
+        /**
+        Encrypts a Plaintext directly at the level of the modulus switching chain 
+        given by parms_id, and stores the result in the destination parameter. 
+        This is equivalent to, but much faster than, encrypting at the highest 
+        level and then calling Evaluator::mod_switch_to, and produces the same 
+        smaller ciphertext. For BFV the plaintext is given in the usual form 
+        modulo the plaintext modulus (e.g. from BatchEncoder). For CKKS the 
+        plaintext must be at parms_id or at a higher level (e.g. from CKKSEncoder 
+        called with parms_id); in the latter case the surplus primes of the 
+        plaintext are dropped. Dynamic memory allocations in the process are 
+        allocated from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] plain The plaintext to encrypt
+        @param[in] parms_id The parms_id for the resulting ciphertext
+        @param[out] destination The ciphertext to overwrite with the encrypted plaintext 
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if plain is not valid for the encryption parameters
+        @throws std::invalid_argument if plain is not in default NTT form
+        @throws std::invalid_argument if parms_id is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if plain is at a lower level than parms_id
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void encrypt(const Plaintext &plain, parms_id_type parms_id, 
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Encrypts a batch of plaintexts in parallel and stores the results in the 
+        destination vector, which is resized to the number of plaintexts. Each 
+        plaintext is encrypted as by encrypt(const Plaintext &, Ciphertext &).
+
+        @param[in] plains The plaintexts to encrypt
+        @param[out] destination The ciphertexts to overwrite with the encrypted 
+        plaintexts
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the plaintexts is not valid for 
+        the encryption parameters or not in default NTT form
+        */
+        double encrypt_batch(const std::vector<Plaintext> &plains,
+            std::vector<Ciphertext> &destination, std::size_t thread_count = 0);
+
+        /**
+        Encrypts a batch of plaintexts in parallel at the level given by parms_id
+        and stores the results in the destination vector, which is resized to the 
+        number of plaintexts. Each plaintext is encrypted as by 
+        encrypt(const Plaintext &, parms_id_type, Ciphertext &).
+
+        @param[in] plains The plaintexts to encrypt
+        @param[in] parms_id The parms_id for the resulting ciphertexts
+        @param[out] destination The ciphertexts to overwrite with the encrypted 
+        plaintexts
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if any of the plaintexts is not valid for 
+        the encryption parameters or not in default NTT form
+        @throws std::invalid_argument if parms_id is not valid for the encryption 
+        parameters
+        */
+        double encrypt_batch(const std::vector<Plaintext> &plains, 
+            parms_id_type parms_id, std::vector<Ciphertext> &destination, 
+            std::size_t thread_count = 0);
+
+        /**
+        Encodes a batch of integer matrices with the given BatchEncoder and 
+        encrypts the results in parallel. The destination vector is resized to 
+        the number of matrices.
+
+        @param[in] encoder The BatchEncoder to use
+        @param[in] values The matrices of integers modulo the plaintext modulus
+        @param[out] destination The ciphertexts to overwrite with the encrypted 
+        matrices
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if the encoder fails to encode the values
+        */
+        double encrypt_batch(BatchEncoder &encoder, 
+            const std::vector<std::vector<std::uint64_t>> &values,
+            std::vector<Ciphertext> &destination, std::size_t thread_count = 0);
+
+        /**
+        Encodes a batch of signed integer matrices with the given BatchEncoder and 
+        encrypts the results in parallel. The destination vector is resized to 
+        the number of matrices.
+
+        @param[in] encoder The BatchEncoder to use
+        @param[in] values The matrices of signed integers
+        @param[out] destination The ciphertexts to overwrite with the encrypted 
+        matrices
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if the encoder fails to encode the values
+        */
+        double encrypt_batch(BatchEncoder &encoder, 
+            const std::vector<std::vector<std::int64_t>> &values,
+            std::vector<Ciphertext> &destination, std::size_t thread_count = 0);
+
+        /**
+        Encodes a batch of vectors of real or complex numbers with the given 
+        CKKSEncoder at the level given by parms_id, and encrypts the results in 
+        parallel. The destination vector is resized to the number of input 
+        vectors.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] encoder The CKKSEncoder to use
+        @param[in] values The vectors of numbers to encode
+        @param[in] parms_id The parms_id for the resulting ciphertexts
+        @param[in] scale Scaling parameter defining encoding precision
+        @param[out] destination The ciphertexts to overwrite with the encrypted 
+        vectors
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @return The throughput of the operation in ciphertexts per second
+        @throws std::invalid_argument if the encoder fails to encode the values
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline double encrypt_batch(CKKSEncoder &encoder, 
+            const std::vector<std::vector<T>> &values, parms_id_type parms_id, 
+            double scale, std::vector<Ciphertext> &destination, 
+            std::size_t thread_count = 0)
+        {
+            return encrypt_batch_internal(values.size(), &parms_id,
+                [&](std::size_t index, Plaintext &buffer, 
+                    MemoryPoolHandle pool) -> const Plaintext &
+                {
+                    encoder.encode(values[index], parms_id, scale, buffer, 
+                        std::move(pool));
+                    return buffer;
+                }, destination, thread_count);
+        }
+
+        /**
+        Encrypts a zero plaintext with the public key and stores the result in 
+        destination. The encryption parameters for the resulting ciphertext 
+        correspond to the given parms_id. Dynamic memory allocations in the 
+        process are allocated from the memory pool pointed to by the given 
+        MemoryPoolHandle.
+
+        @param[in] parms_id The parms_id for the resulting ciphertext
+        @param[out] destination The ciphertext to overwrite with the encrypted 
+        plaintext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if parms_id is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void encrypt_zero(parms_id_type parms_id, Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Encrypts a zero plaintext with the public key and stores the result in 
+        destination. The encryption parameters for the resulting ciphertext 
+        correspond to the highest (data) level in the modulus switching chain. 
+        Dynamic memory allocations in the process are allocated from the memory 
+        pool pointed to by the given MemoryPoolHandle.
+
+        @param[out] destination The ciphertext to overwrite with the encrypted 
+        plaintext
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        inline void encrypt_zero(Ciphertext &destination,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            encrypt_zero(context_->first_parms_id(), destination, std::move(pool));
+        }
+
+        /**
+        Enables the pool of precomputed encryptions of zero. Subsequent calls to 
+        encrypt producing a ciphertext at the given parms_id use an encryption 
+        of zero from the pool when one is available. Any previously enabled pool 
+        is discarded. If background_refill is true, a background thread keeps 
+        the pool filled up to its capacity; otherwise the pool is only filled by 
+        calls to refill_zero_pool. The precomputed encryptions of zero are held 
+        in the memory pool of the Encryptor if it is thread-safe, and otherwise 
+        in a new thread-safe memory pool. When one is used, it is copied into 
+        the destination ciphertext, which keeps its own memory pool.
+
+        @param[in] parms_id The parms_id of the precomputed encryptions of zero
+        @param[in] capacity The maximum number of encryptions of zero to hold
+        @param[in] background_refill Whether to refill the pool in a background 
+        thread
+        @throws std::invalid_argument if parms_id is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if capacity is zero
+        */
+        void enable_zero_pool(parms_id_type parms_id, std::size_t capacity,
+            bool background_refill = true);
+
+        /**
+        Enables the pool of precomputed encryptions of zero at the highest (data) 
+        level in the modulus switching chain.
+
+        @param[in] capacity The maximum number of encryptions of zero to hold
+        @param[in] background_refill Whether to refill the pool in a background 
+        thread
+        @throws std::invalid_argument if capacity is zero
+        */
+        inline void enable_zero_pool(std::size_t capacity,
+            bool background_refill = true)
+        {
+            enable_zero_pool(context_->first_parms_id(), capacity, 
+                background_refill);
+        }
+
+        /**
+        Stops the background refill thread (if any) and discards all precomputed 
+        encryptions of zero.
+        */
+        void disable_zero_pool();
+
+        /**
+        Fills the pool of precomputed encryptions of zero up to its capacity in 
+        the calling thread. This can be used to make use of idle time without 
+        running a background thread. Dynamic memory allocations needed during the 
+        computation are allocated from the memory pool pointed to by the given
+        MemoryPoolHandle.
+
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if the pool of precomputed encryptions of zero 
+        is not enabled
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        void refill_zero_pool(MemoryPoolHandle pool = MemoryManager::GetPool());
+
+        /**
+        Returns a snapshot of the state of the pool of precomputed encryptions
+        of zero.
+        */
+        ZeroPoolMetrics zero_pool_metrics() const;
+
+        /**
+        Destroys the Encryptor and stops the background refill thread (if any).
+        */
+        ~Encryptor();
+
     private:
         Encryptor(const Encryptor &copy) = delete;
 
@@ -93,16 +396,53 @@ namespace seal
             std::shared_ptr<UniformRandomGenerator> random,
             const SEALContext::ContextData &context_data) const;
 
-        void bfv_encrypt(const Plaintext &plain, Ciphertext &destination,
-            MemoryPoolHandle pool);
+        using plain_source_type = std::function<const Plaintext &(
+            std::size_t index, Plaintext &buffer, MemoryPoolHandle pool)>;
+
+        double encrypt_batch_internal(std::size_t count, 
+            const parms_id_type *parms_id, const plain_source_type &plain_source, 
+            std::vector<Ciphertext> &destination, std::size_t thread_count);
+
+        void encrypt_internal(const Plaintext &plain, parms_id_type parms_id,
+            Ciphertext &destination, MemoryPoolHandle pool,
+            std::shared_ptr<UniformRandomGenerator> random);
+
+        void encrypt_zero_internal(parms_id_type parms_id, bool is_ntt_form, 
+            Ciphertext &destination, MemoryPoolHandle pool,
+            std::shared_ptr<UniformRandomGenerator> random = nullptr);
 
-        void ckks_encrypt(const Plaintext &plain, Ciphertext &destination,
-            MemoryPoolHandle pool);
+        bool try_take_zero(parms_id_type parms_id, Ciphertext &destination);
+
+        void zero_pool_worker();
+
+        void bfv_encrypt(const Plaintext &plain, parms_id_type parms_id, 
+            Ciphertext &destination, MemoryPoolHandle pool,
+            std::shared_ptr<UniformRandomGenerator> random);
+
+        void ckks_encrypt(const Plaintext &plain, parms_id_type parms_id, 
+            Ciphertext &destination, MemoryPoolHandle pool,
+            std::shared_ptr<UniformRandomGenerator> random);
 
         MemoryPoolHandle pool_ = MemoryManager::GetPool();
 
         std::shared_ptr<SEALContext> context_{ nullptr };
 
         util::Pointer<std::uint64_t> public_key_;
+
+        mutable std::mutex zero_pool_mutex_;
+
+        std::condition_variable zero_pool_cv_;
+
+        std::deque<Ciphertext> zero_pool_;
+
+        MemoryPoolHandle zero_pool_memory_;
+
+        parms_id_type zero_pool_parms_id_ = parms_id_zero;
+
+        ZeroPoolMetrics zero_pool_metrics_;
+
+        bool zero_pool_stop_ = false;
+
+        std::thread zero_pool_thread_;
     };
 }
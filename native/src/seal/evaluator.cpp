@@ -24,6 +24,84 @@ namespace seal
         {
             return util::are_close<double>(value1.scale(), value2.scale());
         }
+
+        // Writes the residues of the integer-valued value modulo each prime
+        void decompose_scalar(double value, const vector<SmallModulus> &coeff_modulus,
+            uint64_t *destination)
+        {
+            bool is_negative = signbit(value);
+            value = fabs(value);
+            double two_pow_64 = pow(2.0, 64);
+            for (size_t j = 0; j < coeff_modulus.size(); j++)
+            {
+                uint64_t residue;
+                if (value < two_pow_64)
+                {
+                    residue = barrett_reduce_64(static_cast<uint64_t>(value), 
+                        coeff_modulus[j]);
+                }
+                else
+                {
+                    // value is a 53-bit integer times a power of two
+                    int exponent;
+                    double mantissa = frexp(value, &exponent);
+                    uint64_t mantissa_int = static_cast<uint64_t>(ldexp(mantissa, 53));
+                    residue = multiply_uint_uint_mod(
+                        barrett_reduce_64(mantissa_int, coeff_modulus[j]),
+                        exponentiate_uint_mod(2, static_cast<uint64_t>(exponent - 53),
+                            coeff_modulus[j]), coeff_modulus[j]);
+                }
+                destination[j] = is_negative ? 
+                    negate_uint_mod(residue, coeff_modulus[j]) : residue;
+            }
+        }
+
+        void decompose_scalar(int64_t value, const vector<SmallModulus> &coeff_modulus,
+            uint64_t *destination)
+        {
+            uint64_t abs_value = (value < 0) ? 
+                (uint64_t(0) - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+            for (size_t j = 0; j < coeff_modulus.size(); j++)
+            {
+                uint64_t residue = barrett_reduce_64(abs_value, coeff_modulus[j]);
+                destination[j] = (value < 0) ? 
+                    negate_uint_mod(residue, coeff_modulus[j]) : residue;
+            }
+        }
+
+        // Rounds value * scale and checks that it fits in the coefficient modulus
+        double scale_scalar(double value, double scale, 
+            const SEALContext::ContextData &context_data)
+        {
+            double scaled_value = round(value * scale);
+            if (!isfinite(scaled_value))
+            {
+                throw invalid_argument("encoded values are too large");
+            }
+            int coeff_bit_count = (scaled_value == 0) ? 1 : 
+                max(1, static_cast<int>(log2(fabs(scaled_value))) + 2);
+            if (coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
+            {
+                throw invalid_argument("encoded values are too large");
+            }
+            return scaled_value;
+        }
+
+        // Reduces value modulo plain_modulus into the centered range
+        int64_t center_plain_scalar(int64_t value, const SmallModulus &plain_modulus)
+        {
+            int64_t modulus = static_cast<int64_t>(plain_modulus.value());
+            int64_t result = value % modulus;
+            if (result > (modulus >> 1))
+            {
+                result -= modulus;
+            }
+            else if (result < -(modulus >> 1))
+            {
+                result += modulus;
+            }
+            return result;
+        }
     }
 
     Evaluator::Evaluator(shared_ptr<SEALContext> context) : context_(move(context))
@@ -1307,23 +1385,21 @@ namespace seal
                     // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
                     ntt_negacyclic_harvey_lazy(temp_decomp_coeff_ptr, coeff_small_ntt_tables[j]);
 
-                    // Lazy reduction
+                    // Lazy reduction; both key components are accumulated in
+                    // one pass over the decomposed coefficients
                     unsigned long long wide_innerproduct[2];
                     unsigned long long temp;
-                    for (size_t m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2)
+                    for (size_t m = 0; m < coeff_count; m++, temp_decomp_coeff_ptr++,
+                        wide_innerresult0_ptr += 2, wide_innerresult1_ptr += 2)
                     {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_0++, wide_innerproduct);
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_0++, wide_innerproduct);
                         unsigned char carry = add_uint64(wide_innerresult0_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult0_ptr[0] = temp;
                         wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
-                    }
 
-                    temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    for (size_t m = 0; m < coeff_count; m++, wide_innerresult1_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_1++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult1_ptr[0],
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_1++, wide_innerproduct);
+                        carry = add_uint64(wide_innerresult1_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult1_ptr[0] = temp;
                         wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
@@ -1473,23 +1549,21 @@ namespace seal
                     // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
                     ntt_negacyclic_harvey_lazy(temp_decomp_coeff_ptr, coeff_small_ntt_tables[j]);
 
-                    // Lazy reduction
+                    // Lazy reduction; both key components are accumulated in
+                    // one pass over the decomposed coefficients
                     unsigned long long wide_innerproduct[2];
                     unsigned long long temp;
-                    for (size_t m = 0; m < coeff_count; m++, wide_innerresult0_ptr += 2)
+                    for (size_t m = 0; m < coeff_count; m++, temp_decomp_coeff_ptr++,
+                        wide_innerresult0_ptr += 2, wide_innerresult1_ptr += 2)
                     {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_0++, wide_innerproduct);
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_0++, wide_innerproduct);
                         unsigned char carry = add_uint64(wide_innerresult0_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult0_ptr[0] = temp;
                         wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
-                    }
 
-                    temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    for (size_t m = 0; m < coeff_count; m++, wide_innerresult1_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_1++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult1_ptr[0],
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_1++, wide_innerproduct);
+                        carry = add_uint64(wide_innerresult1_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult1_ptr[0] = temp;
                         wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
@@ -2285,7 +2359,11 @@ namespace seal
         {
             throw invalid_argument("encrypted is not valid for encryption parameters");
         }
-        if (encrypted.is_ntt_form() != plain.is_ntt_form())
+        // BFV ciphertexts can be multiplied with NTT-form plaintexts
+        bool is_bfv_ntt_plain = !encrypted.is_ntt_form() && plain.is_ntt_form() &&
+            (context_->context_data(encrypted.parms_id())->parms().scheme() == 
+                scheme_type::BFV);
+        if ((encrypted.is_ntt_form() != plain.is_ntt_form()) && !is_bfv_ntt_plain)
         {
             throw invalid_argument("NTT form mismatch");
         }
@@ -2298,6 +2376,10 @@ namespace seal
         {
             multiply_plain_ntt(encrypted, plain);
         }
+        else if (is_bfv_ntt_plain)
+        {
+            multiply_plain_normal_ntt(encrypted, plain);
+        }
         else
         {
             multiply_plain_normal(encrypted, plain, move(pool));
@@ -2548,6 +2630,263 @@ namespace seal
         encrypted_ntt.scale() = new_scale;
     }
 
+    void Evaluator::multiply_plain_normal_ntt(Ciphertext &encrypted, 
+        const Plaintext &plain_ntt)
+    {
+        // Verify parameters.
+        if (!plain_ntt.is_ntt_form())
+        {
+            throw invalid_argument("plain_ntt is not in NTT form");
+        }
+
+        // Extract encryption parameters.
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+        size_t encrypted_size = encrypted.size();
+        auto &coeff_small_ntt_tables = context_data.small_ntt_tables();
+
+        // The coefficient moduli at lower levels are a prefix of those at higher
+        // levels, so a plaintext at a higher level contains the NTT of the same
+        // polynomial at every lower level.
+        auto plain_context_data_ptr = context_->context_data(plain_ntt.parms_id());
+        if (!plain_context_data_ptr || 
+            (plain_context_data_ptr->chain_index() < context_data.chain_index()))
+        {
+            throw invalid_argument("plain_ntt is at a lower level than encrypted");
+        }
+
+        // Size check
+        if (!product_fits_in(encrypted_size, coeff_count, coeff_mod_count))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        double new_scale = encrypted.scale() * plain_ntt.scale();
+
+        // Check that scale is positive and not too large
+        if (new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
+            context_data.total_coeff_modulus_bit_count()))
+        {
+            throw invalid_argument("scale out of bounds");
+        }
+
+        for (size_t i = 0; i < encrypted_size; i++)
+        {
+            uint64_t *encrypted_ptr = encrypted.data(i);
+            for (size_t j = 0; j < coeff_mod_count; j++, encrypted_ptr += coeff_count)
+            {
+                // Lazy reduction
+                ntt_negacyclic_harvey_lazy(encrypted_ptr, coeff_small_ntt_tables[j]);
+                dyadic_product_coeffmod(encrypted_ptr, plain_ntt.data() + (j * coeff_count),
+                    coeff_count, coeff_modulus[j], encrypted_ptr);
+                inverse_ntt_negacyclic_harvey(encrypted_ptr, coeff_small_ntt_tables[j]);
+            }
+        }
+
+        // Set the scale
+        encrypted.scale() = new_scale;
+    }
+
+    void Evaluator::add_scalar_inplace(Ciphertext &encrypted, double value)
+    {
+        // Verify parameters.
+        if (!encrypted.is_metadata_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        if (parms.scheme() != scheme_type::CKKS)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+        if (!encrypted.is_ntt_form())
+        {
+            throw invalid_argument("CKKS encrypted must be in NTT form");
+        }
+
+        // The encoding of a real number at a given scale is a constant polynomial
+        auto &coeff_modulus = parms.coeff_modulus();
+        vector<uint64_t> residues(coeff_modulus.size());
+        decompose_scalar(scale_scalar(value, encrypted.scale(), context_data),
+            coeff_modulus, residues.data());
+        add_scalar_residues(encrypted, residues.data());
+    }
+
+    void Evaluator::add_scalar_inplace(Ciphertext &encrypted, int64_t value)
+    {
+        // Verify parameters.
+        if (!encrypted.is_metadata_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_mod_count = coeff_modulus.size();
+        vector<uint64_t> residues(coeff_mod_count);
+
+        switch (parms.scheme())
+        {
+        case scheme_type::BFV:
+        {
+            // Scale by Delta = floor(q / t) as in Encryptor::preencrypt
+            auto coeff_div_plain_modulus = context_data.coeff_div_plain_modulus();
+            auto plain_upper_half_threshold = context_data.plain_upper_half_threshold();
+            auto upper_half_increment = context_data.upper_half_increment();
+            int64_t centered_value = center_plain_scalar(value, parms.plain_modulus());
+            uint64_t plain_value = (centered_value < 0) ?
+                (parms.plain_modulus().value() - static_cast<uint64_t>(-centered_value)) :
+                static_cast<uint64_t>(centered_value);
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                unsigned long long temp[2]{ 0, 0 };
+                multiply_uint64(coeff_div_plain_modulus[j], plain_value, temp);
+                if (plain_value >= plain_upper_half_threshold)
+                {
+                    temp[1] += add_uint64(temp[0], upper_half_increment[j], temp);
+                }
+                residues[j] = barrett_reduce_128(temp, coeff_modulus[j]);
+            }
+            add_scalar_residues(encrypted, residues.data());
+            break;
+        }
+
+        case scheme_type::CKKS:
+            add_scalar_inplace(encrypted, static_cast<double>(value));
+            break;
+
+        default:
+            throw invalid_argument("unsupported scheme");
+        }
+    }
+
+    void Evaluator::multiply_scalar_inplace(Ciphertext &encrypted, double value, 
+        double scale)
+    {
+        // Verify parameters.
+        if (!encrypted.is_metadata_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        if (parms.scheme() != scheme_type::CKKS)
+        {
+            throw invalid_argument("unsupported scheme");
+        }
+
+        // Check that scale is positive and not too large
+        double new_scale = encrypted.scale() * scale;
+        if (scale <= 0 || new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
+            context_data.total_coeff_modulus_bit_count()))
+        {
+            throw invalid_argument("scale out of bounds");
+        }
+
+        auto &coeff_modulus = parms.coeff_modulus();
+        vector<uint64_t> residues(coeff_modulus.size());
+        decompose_scalar(scale_scalar(value, scale, context_data),
+            coeff_modulus, residues.data());
+        multiply_scalar_residues(encrypted, residues.data());
+
+        // Set the scale
+        encrypted.scale() = new_scale;
+    }
+
+    void Evaluator::multiply_scalar_inplace(Ciphertext &encrypted, int64_t value)
+    {
+        // Verify parameters.
+        if (!encrypted.is_metadata_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        vector<uint64_t> residues(coeff_modulus.size());
+
+        switch (parms.scheme())
+        {
+        case scheme_type::BFV:
+            // Use the representative of smallest magnitude to minimize noise growth
+            decompose_scalar(center_plain_scalar(value, parms.plain_modulus()),
+                coeff_modulus, residues.data());
+            break;
+
+        case scheme_type::CKKS:
+            decompose_scalar(value, coeff_modulus, residues.data());
+            break;
+
+        default:
+            throw invalid_argument("unsupported scheme");
+        }
+        multiply_scalar_residues(encrypted, residues.data());
+    }
+
+    void Evaluator::add_scalar_residues(Ciphertext &encrypted, 
+        const uint64_t *residues)
+    {
+        auto &parms = context_->context_data(encrypted.parms_id())->parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+
+        // A constant polynomial only has a constant coefficient, and in NTT form
+        // it has the same value at every evaluation point
+        size_t touched_count = encrypted.is_ntt_form() ? coeff_count : 1;
+        for (size_t j = 0; j < coeff_mod_count; j++)
+        {
+            uint64_t *encrypted_ptr = encrypted.data() + (j * coeff_count);
+            for (size_t i = 0; i < touched_count; i++)
+            {
+                encrypted_ptr[i] = add_uint_uint_mod(encrypted_ptr[i], 
+                    residues[j], coeff_modulus[j]);
+            }
+        }
+#ifndef SEAL_ALLOW_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
+    void Evaluator::multiply_scalar_residues(Ciphertext &encrypted, 
+        const uint64_t *residues)
+    {
+        auto &parms = context_->context_data(encrypted.parms_id())->parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+        size_t encrypted_size = encrypted.size();
+
+        for (size_t i = 0; i < encrypted_size; i++)
+        {
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                multiply_poly_scalar_coeffmod(encrypted.data(i) + (j * coeff_count),
+                    coeff_count, residues[j], coeff_modulus[j], 
+                    encrypted.data(i) + (j * coeff_count));
+            }
+        }
+#ifndef SEAL_ALLOW_TRANSPARENT_CIPHERTEXT
+        // Transparent ciphertext output is not allowed.
+        if (encrypted.is_transparent())
+        {
+            throw logic_error("result ciphertext is transparent");
+        }
+#endif
+    }
+
     void Evaluator::transform_to_ntt_inplace(Plaintext &plain, 
         parms_id_type parms_id, MemoryPoolHandle pool)
     {
@@ -2800,7 +3139,6 @@ namespace seal
 
         uint64_t m = mul_safe(static_cast<uint64_t>(coeff_count), uint64_t(2));
         uint64_t subgroup_size = static_cast<uint64_t>(coeff_count >> 1);
-        int n_power_of_two = get_power_of_two(static_cast<uint64_t>(coeff_count));
 
         // Verify parameters
         if (!(galois_elt & 1) || unsigned_geq(galois_elt, m))
@@ -2868,20 +3206,22 @@ namespace seal
             }
         }
 
-        auto temp0(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
-        auto temp1(allocate_zero_uint(coeff_count * coeff_mod_count, pool));
+        // The automorphism writes every coefficient, so no zeroing is needed
+        auto temp0(allocate_uint(coeff_count * coeff_mod_count, pool));
+        auto temp1(allocate_uint(coeff_count * coeff_mod_count, pool));
+        auto &galois_tool = *context_data.galois_tool();
 
         if (parms.scheme() == scheme_type::BFV)
         {
             // Apply Galois for each ciphertext
             for (size_t i = 0; i < coeff_mod_count; i++)
             {
-                util::apply_galois(encrypted.data() + (i * coeff_count), n_power_of_two,
+                galois_tool.apply_galois(encrypted.data() + (i * coeff_count),
                     galois_elt, coeff_modulus[i], temp0.get() + (i * coeff_count));
             }
             for (size_t i = 0; i < coeff_mod_count; i++)
             {
-                util::apply_galois(encrypted.data(1) + (i * coeff_count), n_power_of_two,
+                galois_tool.apply_galois(encrypted.data(1) + (i * coeff_count),
                     galois_elt, coeff_modulus[i], temp1.get() + (i * coeff_count));
             }
         }
@@ -2890,12 +3230,12 @@ namespace seal
             // Apply Galois for each ciphertext
             for (size_t i = 0; i < coeff_mod_count; i++)
             {
-                util::apply_galois_ntt(encrypted.data() + (i * coeff_count), n_power_of_two,
+                galois_tool.apply_galois_ntt(encrypted.data() + (i * coeff_count),
                     galois_elt, temp0.get() + (i * coeff_count));
             }
             for (size_t i = 0; i < coeff_mod_count; i++)
             {
-                util::apply_galois_ntt(encrypted.data(1) + (i * coeff_count), n_power_of_two,
+                galois_tool.apply_galois_ntt(encrypted.data(1) + (i * coeff_count),
                     galois_elt, temp1.get() + (i * coeff_count));
             }
 
@@ -2970,23 +3310,21 @@ namespace seal
                     // We don't reduce here, so might get up to two extra bits. Thus 62 bits at most.
                     ntt_negacyclic_harvey_lazy(temp_decomp_coeff_ptr, coeff_small_ntt_tables[j]);
 
-                    // Lazy reduction
+                    // Lazy reduction; both key components are accumulated in
+                    // one pass over the decomposed coefficients
                     unsigned long long wide_innerproduct[2];
                     unsigned long long temp;
-                    for (size_t l = 0; l < coeff_count; l++, wide_innerresult0_ptr += 2)
+                    for (size_t l = 0; l < coeff_count; l++, temp_decomp_coeff_ptr++,
+                        wide_innerresult0_ptr += 2, wide_innerresult1_ptr += 2)
                     {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_0++, wide_innerproduct);
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_0++, wide_innerproduct);
                         unsigned char carry = add_uint64(wide_innerresult0_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult0_ptr[0] = temp;
                         wide_innerresult0_ptr[1] += wide_innerproduct[1] + carry;
-                    }
 
-                    temp_decomp_coeff_ptr = temp_decomp_coeff.get();
-                    for (size_t l = 0; l < coeff_count; l++, wide_innerresult1_ptr += 2)
-                    {
-                        multiply_uint64(*temp_decomp_coeff_ptr++, *key_ptr_1++, wide_innerproduct);
-                        unsigned char carry = add_uint64(wide_innerresult1_ptr[0],
+                        multiply_uint64(*temp_decomp_coeff_ptr, *key_ptr_1++, wide_innerproduct);
+                        carry = add_uint64(wide_innerresult1_ptr[0],
                             wide_innerproduct[0], &temp);
                         wide_innerresult1_ptr[0] = temp;
                         wide_innerresult1_ptr[1] += wide_innerproduct[1] + carry;
@@ -3083,4 +3421,35 @@ namespace seal
             steps_to_galois_elt(steps, coeff_count), 
             galois_keys, move(pool));
     }
+
+    void Evaluator::rotate_internal(Ciphertext &encrypted, int steps,
+        const RotationPlan &plan, const GaloisKeys &galois_keys, 
+        MemoryPoolHandle pool)
+    {
+        // Verify parameters.
+        if (!encrypted.is_metadata_valid_for(context_))
+        {
+            throw invalid_argument("encrypted is not valid for encryption parameters");
+        }
+
+        auto &context_data = *context_->context_data(encrypted.parms_id());
+        if (!context_data.qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+        if (plan.parms_id() != context_->first_parms_id())
+        {
+            throw invalid_argument("parameter mismatch");
+        }
+
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+
+        // Perform the rotation one key at a time
+        for (auto key_steps : plan.decomposition(steps))
+        {
+            apply_galois_inplace(encrypted, 
+                steps_to_galois_elt(key_steps, coeff_count), 
+                galois_keys, pool);
+        }
+    }
 }
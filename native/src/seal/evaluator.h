@@ -6,13 +6,17 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <complex>
+#include <type_traits>
 #include "seal/context.h"
 #include "seal/relinkeys.h"
 #include "seal/smallmodulus.h"
 #include "seal/memorymanager.h"
 #include "seal/ciphertext.h"
 #include "seal/plaintext.h"
+#include "seal/ckks.h"
 #include "seal/galoiskeys.h"
+#include "seal/rotationplan.h"
 #include "seal/util/pointer.h"
 #include "seal/secretkey.h"
 #include "seal/util/uintarithsmallmod.h"
@@ -802,12 +806,20 @@ namespace seal
         allocations in the process are allocated from the memory pool pointed to by 
         the given MemoryPoolHandle.
 
+        When using scheme_type::BFV, the plaintext can also be in NTT form, e.g. as
+        produced by transform_to_ntt_inplace or BatchEncoder::encode with a parms_id,
+        in which case it is not transformed again. Such a plaintext can be used with
+        ciphertexts at its own level or at any level below it.
+
         @param[in] encrypted The ciphertext to multiply
         @param[in] plain The plaintext to multiply
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if the encrypted or plain is not valid for 
         the encryption parameters
-        @throws std::invalid_argument if encrypted and plain are in different NTT forms
+        @throws std::invalid_argument if encrypted and plain are in different NTT forms,
+        unless encrypted is a BFV ciphertext and plain is in NTT form
+        @throws std::invalid_argument if plain is in NTT form at a lower level than
+        encrypted
         @throws std::invalid_argument if, when using scheme_type::CKKS, the output 
         scale is too large for the encryption parameters
         @throws std::invalid_argument if pool is uninitialized
@@ -823,13 +835,21 @@ namespace seal
         and cannot be identially 0. Dynamic memory allocations in the process are 
         allocated from the memory pool pointed to by the given MemoryPoolHandle.
 
+        When using scheme_type::BFV, the plaintext can also be in NTT form, e.g. as
+        produced by transform_to_ntt_inplace or BatchEncoder::encode with a parms_id,
+        in which case it is not transformed again. Such a plaintext can be used with
+        ciphertexts at its own level or at any level below it.
+
         @param[in] encrypted The ciphertext to multiply
         @param[in] plain The plaintext to multiply
         @param[out] destination The ciphertext to overwrite with the multiplication result
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::invalid_argument if the encrypted or plain is not valid for 
         the encryption parameters
-        @throws std::invalid_argument if encrypted and plain are in different NTT forms
+        @throws std::invalid_argument if encrypted and plain are in different NTT forms,
+        unless encrypted is a BFV ciphertext and plain is in NTT form
+        @throws std::invalid_argument if plain is in NTT form at a lower level than
+        encrypted
         @throws std::invalid_argument if plain is zero
         @throws std::invalid_argument if, when using scheme_type::CKKS, the output 
         scale is too large for the encryption parameters
@@ -844,6 +864,258 @@ namespace seal
             multiply_plain_inplace(destination, plain, std::move(pool));
         }
 
+        /**
+        Adds a vector of real or complex numbers to a CKKS ciphertext. The values
+        are encoded with the given CKKSEncoder at the level and scale of encrypted,
+        so when the encoder's cache is enabled, constants that were encoded before
+        at that level and scale are taken from the cache instead of being encoded
+        again. Dynamic memory allocations in the process are allocated from the 
+        memory pool pointed to by the given MemoryPoolHandle.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] encrypted The ciphertext to add to
+        @param[in] values The values to add
+        @param[in] encoder The CKKSEncoder to encode the values with
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if values cannot be encoded at the level and
+        scale of encrypted
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline void add_plain_inplace(Ciphertext &encrypted,
+            const std::vector<T> &values, CKKSEncoder &encoder,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            Plaintext plain(pool);
+            encoder.encode(values, encrypted.parms_id(), encrypted.scale(), plain, pool);
+            add_plain_inplace(encrypted, plain);
+        }
+
+        /**
+        Subtracts a vector of real or complex numbers from a CKKS ciphertext. The
+        values are encoded as by add_plain_inplace with a CKKSEncoder, and taken
+        from the encoder's cache when possible.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] encrypted The ciphertext to subtract from
+        @param[in] values The values to subtract
+        @param[in] encoder The CKKSEncoder to encode the values with
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if values cannot be encoded at the level and
+        scale of encrypted
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline void sub_plain_inplace(Ciphertext &encrypted,
+            const std::vector<T> &values, CKKSEncoder &encoder,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            Plaintext plain(pool);
+            encoder.encode(values, encrypted.parms_id(), encrypted.scale(), plain, pool);
+            sub_plain_inplace(encrypted, plain);
+        }
+
+        /**
+        Multiplies a CKKS ciphertext with a vector of real or complex numbers. The
+        values are encoded with the given CKKSEncoder at the level of encrypted and
+        the given scale, and taken from the encoder's cache when it is enabled and
+        holds them. Dynamic memory allocations in the process are allocated from
+        the memory pool pointed to by the given MemoryPoolHandle.
+
+        @tparam T Vector value type (double or std::complex<double>)
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] values The values to multiply with
+        @param[in] scale The scale to encode the values at
+        @param[in] encoder The CKKSEncoder to encode the values with
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if encrypted is not valid for the encryption
+        parameters
+        @throws std::invalid_argument if values cannot be encoded at the level of
+        encrypted and the given scale
+        @throws std::invalid_argument if the output scale is too large for the
+        encryption parameters
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        template<typename T,
+            typename = std::enable_if_t<std::is_same<T, double>::value ||
+            std::is_same<T, std::complex<double>>::value>>
+        inline void multiply_plain_inplace(Ciphertext &encrypted,
+            const std::vector<T> &values, double scale, CKKSEncoder &encoder,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            Plaintext plain(pool);
+            encoder.encode(values, encrypted.parms_id(), scale, plain, pool);
+            multiply_plain_inplace(encrypted, plain, std::move(pool));
+        }
+
+        /**
+        Adds a real number to a ciphertext. The number is scaled by the scale of the 
+        ciphertext and added directly to the RNS representation of the ciphertext, 
+        without encoding a full plaintext polynomial. The result is the same as that of 
+        add_plain with the number encoded by CKKSEncoder at the scale of encrypted.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The real number to add
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is not a CKKS ciphertext in NTT form
+        @throws std::invalid_argument if the scaled value is too large for the 
+        encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_scalar_inplace(Ciphertext &encrypted, double value);
+
+        /**
+        Adds a real number to a ciphertext. This function adds the number, scaled by 
+        the scale of the ciphertext, to the ciphertext and stores the result in the 
+        destination parameter.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The real number to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is not a CKKS ciphertext in NTT form
+        @throws std::invalid_argument if the scaled value is too large for the 
+        encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_scalar(const Ciphertext &encrypted, double value,
+            Ciphertext &destination)
+        {
+            destination = encrypted;
+            add_scalar_inplace(destination, value);
+        }
+
+        /**
+        Adds an integer to a ciphertext without encoding a full plaintext polynomial.
+        When using scheme_type::BFV, the integer is reduced modulo the plaintext 
+        modulus and only the constant coefficient of the ciphertext is modified (or, 
+        in NTT form, every coefficient by the same amount). When using 
+        scheme_type::CKKS, the integer is scaled by the scale of the ciphertext as 
+        in add_scalar_inplace for real numbers.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The integer to add
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is a CKKS ciphertext not in NTT form
+        @throws std::invalid_argument if, when using scheme_type::CKKS, the scaled 
+        value is too large for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void add_scalar_inplace(Ciphertext &encrypted, std::int64_t value);
+
+        /**
+        Adds an integer to a ciphertext. This function adds the integer to the
+        ciphertext and stores the result in the destination parameter.
+
+        @param[in] encrypted The ciphertext to add to
+        @param[in] value The integer to add
+        @param[out] destination The ciphertext to overwrite with the addition result
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is a CKKS ciphertext not in NTT form
+        @throws std::invalid_argument if, when using scheme_type::CKKS, the scaled 
+        value is too large for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void add_scalar(const Ciphertext &encrypted, std::int64_t value,
+            Ciphertext &destination)
+        {
+            destination = encrypted;
+            add_scalar_inplace(destination, value);
+        }
+
+        /**
+        Multiplies a ciphertext with a real number. The number is scaled by the given 
+        scale, rounded, and multiplied directly with each RNS component of the 
+        ciphertext, without encoding a full plaintext polynomial. The scale of the 
+        result is the product of the scales of encrypted and the given scale. This 
+        has the same effect as multiply_plain with the number encoded by CKKSEncoder 
+        at the given scale.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The real number to multiply with
+        @param[in] scale Scaling parameter defining the precision of value
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is not a CKKS ciphertext
+        @throws std::invalid_argument if the scaled value or the output scale is too 
+        large for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_scalar_inplace(Ciphertext &encrypted, double value, double scale);
+
+        /**
+        Multiplies a ciphertext with a real number. This function multiplies the 
+        ciphertext with the number scaled by the given scale, and stores the result 
+        in the destination parameter.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The real number to multiply with
+        @param[in] scale Scaling parameter defining the precision of value
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::invalid_argument if encrypted is not a CKKS ciphertext
+        @throws std::invalid_argument if the scaled value or the output scale is too 
+        large for the encryption parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_scalar(const Ciphertext &encrypted, double value, 
+            double scale, Ciphertext &destination)
+        {
+            destination = encrypted;
+            multiply_scalar_inplace(destination, value, scale);
+        }
+
+        /**
+        Multiplies a ciphertext with an integer without encoding a full plaintext
+        polynomial. Each RNS component of the ciphertext is multiplied with the
+        integer, so the ciphertext can be in either NTT or coefficient form. When 
+        using scheme_type::BFV, the integer is first reduced modulo the plaintext 
+        modulus. When using scheme_type::CKKS, the integer is not scaled and the 
+        scale of the ciphertext does not change.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The integer to multiply with
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        void multiply_scalar_inplace(Ciphertext &encrypted, std::int64_t value);
+
+        /**
+        Multiplies a ciphertext with an integer. This function multiplies the 
+        ciphertext with the integer and stores the result in the destination 
+        parameter.
+
+        @param[in] encrypted The ciphertext to multiply
+        @param[in] value The integer to multiply with
+        @param[out] destination The ciphertext to overwrite with the multiplication result
+        @throws std::invalid_argument if encrypted is not valid for the encryption 
+        parameters
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void multiply_scalar(const Ciphertext &encrypted, std::int64_t value,
+            Ciphertext &destination)
+        {
+            destination = encrypted;
+            multiply_scalar_inplace(destination, value);
+        }
+
         /**
         Transforms a plaintext to NTT domain. This functions applies the Number 
         Theoretic Transform to a plaintext by first embedding integers modulo the 
@@ -1047,7 +1319,7 @@ namespace seal
 
 
         @param[in] encrypted The ciphertext to rotate
-        @param[in] steps The number of steps to rotate (negative left, positive right)
+        @param[in] steps The number of steps to rotate (positive left, negative right)
         @param[in] galois_keys The Galois keys
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::logic_error if scheme is not scheme_type::BFV
@@ -1085,7 +1357,7 @@ namespace seal
         to by the given MemoryPoolHandle.
 
         @param[in] encrypted The ciphertext to rotate
-        @param[in] steps The number of steps to rotate (negative left, positive right)
+        @param[in] steps The number of steps to rotate (positive left, negative right)
         @param[in] galois_keys The Galois keys
         @param[out] destination The ciphertext to overwrite with the rotated result
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
@@ -1110,6 +1382,76 @@ namespace seal
             rotate_rows_inplace(destination, steps, galois_keys, std::move(pool));
         }
 
+        /**
+        Rotates plaintext matrix rows cyclically as rotate_rows_inplace does, by
+        applying the keys that the given RotationPlan chose for the rotation, one
+        after another. Dynamic memory allocations in the process are allocated 
+        from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @param[in] plan The RotationPlan the Galois keys were generated for
+        @param[in] galois_keys The Galois keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::BFV
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for 
+        the encryption parameters
+        @throws std::invalid_argument if plan or galois_keys do not correspond to 
+        the top level parameters in the current context
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the keys
+        of the plan
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_rows_inplace(Ciphertext &encrypted, int steps,
+            const RotationPlan &plan, const GaloisKeys &galois_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            if (context_->context_data()->parms().scheme() != scheme_type::BFV)
+            {
+                throw std::logic_error("unsupported scheme");
+            }
+            rotate_internal(encrypted, steps, plan, galois_keys, std::move(pool));
+        }
+
+        /**
+        Rotates plaintext matrix rows cyclically as rotate_rows_inplace does with 
+        the given RotationPlan, and writes the result to the destination parameter.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @param[in] plan The RotationPlan the Galois keys were generated for
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the rotated result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::BFV
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for 
+        the encryption parameters
+        @throws std::invalid_argument if plan or galois_keys do not correspond to 
+        the top level parameters in the current context
+        @throws std::invalid_argument if encrypted is in NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the keys
+        of the plan
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_rows(const Ciphertext &encrypted, int steps,
+            const RotationPlan &plan, const GaloisKeys &galois_keys, 
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            destination = encrypted;
+            rotate_rows_inplace(destination, steps, plan, galois_keys, std::move(pool));
+        }
+
         /**
         Rotates plaintext matrix columns cyclically. When batching is used with 
         the BFV scheme, this function rotates the encrypted plaintext matrix 
@@ -1189,7 +1531,7 @@ namespace seal
         by the given MemoryPoolHandle. 
 
         @param[in] encrypted The ciphertext to rotate
-        @param[in] steps The number of steps to rotate (negative left, positive right)
+        @param[in] steps The number of steps to rotate (positive left, negative right)
         @param[in] galois_keys The Galois keys
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
         @throws std::logic_error if scheme is not scheme_type::CKKS
@@ -1225,7 +1567,7 @@ namespace seal
         from the memory pool pointed to by the given MemoryPoolHandle.
 
         @param[in] encrypted The ciphertext to rotate
-        @param[in] steps The number of steps to rotate (negative left, positive right)
+        @param[in] steps The number of steps to rotate (positive left, negative right)
         @param[in] galois_keys The Galois keys
         @param[out] destination The ciphertext to overwrite with the rotated result
         @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
@@ -1249,6 +1591,74 @@ namespace seal
             rotate_vector_inplace(destination, steps, galois_keys, std::move(pool));
         }
 
+        /**
+        Rotates plaintext vector cyclically as rotate_vector_inplace does, by
+        applying the keys that the given RotationPlan chose for the rotation, one
+        after another. Dynamic memory allocations in the process are allocated 
+        from the memory pool pointed to by the given MemoryPoolHandle.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @param[in] plan The RotationPlan the Galois keys were generated for
+        @param[in] galois_keys The Galois keys
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::CKKS
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for 
+        the encryption parameters
+        @throws std::invalid_argument if plan or galois_keys do not correspond to 
+        the top level parameters in the current context
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the keys
+        of the plan
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_vector_inplace(Ciphertext &encrypted, int steps,
+            const RotationPlan &plan, const GaloisKeys &galois_keys,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            if (context_->context_data()->parms().scheme() != scheme_type::CKKS)
+            {
+                throw std::logic_error("unsupported scheme");
+            }
+            rotate_internal(encrypted, steps, plan, galois_keys, std::move(pool));
+        }
+
+        /**
+        Rotates plaintext vector cyclically as rotate_vector_inplace does with the
+        given RotationPlan, and writes the result to the destination parameter.
+
+        @param[in] encrypted The ciphertext to rotate
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @param[in] plan The RotationPlan the Galois keys were generated for
+        @param[in] galois_keys The Galois keys
+        @param[out] destination The ciphertext to overwrite with the rotated result
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::logic_error if scheme is not scheme_type::CKKS
+        @throws std::invalid_argument if encrypted or galois_keys is not valid for 
+        the encryption parameters
+        @throws std::invalid_argument if plan or galois_keys do not correspond to 
+        the top level parameters in the current context
+        @throws std::invalid_argument if encrypted is not in the default NTT form
+        @throws std::invalid_argument if encrypted has size larger than 2
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the keys
+        of the plan
+        @throws std::invalid_argument if necessary Galois keys are not present
+        @throws std::invalid_argument if pool is uninitialized
+        @throws std::logic_error if result ciphertext is transparent
+        */
+        inline void rotate_vector(const Ciphertext &encrypted, int steps,
+            const RotationPlan &plan, const GaloisKeys &galois_keys, 
+            Ciphertext &destination, MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            destination = encrypted;
+            rotate_vector_inplace(destination, steps, plan, galois_keys, std::move(pool));
+        }
+
         /**
         Complex conjugates plaintext slot values. When using the CKKS scheme, this 
         function complex conjugates all values in the underlying plaintext. Dynamic 
@@ -1344,6 +1754,10 @@ namespace seal
         void rotate_internal(Ciphertext &encrypted, int steps,
             const GaloisKeys &galois_keys, MemoryPoolHandle pool);
 
+        void rotate_internal(Ciphertext &encrypted, int steps,
+            const RotationPlan &plan, const GaloisKeys &galois_keys, 
+            MemoryPoolHandle pool);
+
         inline void conjugate_internal(Ciphertext &encrypted,
             const GaloisKeys &galois_keys, MemoryPoolHandle pool)
         {
@@ -1482,6 +1896,21 @@ namespace seal
 
         void multiply_plain_ntt(Ciphertext &encrypted_ntt, const Plaintext &plain_ntt);
 
+        void multiply_plain_normal_ntt(Ciphertext &encrypted, const Plaintext &plain_ntt);
+
+        /**
+        Adds the constant with the given residues modulo each prime in the 
+        coefficient modulus to the first component of encrypted.
+        */
+        void add_scalar_residues(Ciphertext &encrypted, const std::uint64_t *residues);
+
+        /**
+        Multiplies every component of encrypted with the constant with the given
+        residues modulo each prime in the coefficient modulus.
+        */
+        void multiply_scalar_residues(Ciphertext &encrypted, 
+            const std::uint64_t *residues);
+
         void populate_Zmstar_to_generator();
 
         std::shared_ptr<SEALContext> context_{ nullptr };
@@ -1,15 +1,25 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include <algorithm>
+#include <iterator>
 #include "seal/galoiskeys.h"
 #include "seal/util/common.h"
 #include <stdexcept>
+#include "seal/util/serialization.h"
+#include "seal/util/mappedkeys.h"
+#include "seal/util/uintarithsmallmod.h"
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
+    GaloisKeys::GaloisKeys(const GaloisKeys &copy) : pool_(copy.pool_)
+    {
+        *this = copy;
+    }
+
     GaloisKeys &GaloisKeys::operator =(const GaloisKeys &assign)
     {
         // Check for self-assignment
@@ -24,6 +34,8 @@ namespace seal
 
         // Then copy over keys
         keys_.clear();
+        mapping_.reset();
+        storage_.clear();
         size_t keys_dim1 = assign.keys_.size();
         keys_.reserve(keys_dim1);
         for (size_t i = 0; i < keys_dim1; i++)
@@ -36,6 +48,10 @@ namespace seal
                 keys_[i].emplace_back(pool_);
                 keys_[i][j] = assign.keys_[i][j];
             }
+            if (keys_dim2)
+            {
+                storage_.emplace_back(Ciphertext::make_contiguous(keys_[i], pool_));
+            }
         }
 
         return *this;
@@ -92,7 +108,7 @@ namespace seal
         return true;
     }
 
-    void GaloisKeys::save(std::ostream &stream) const
+    void GaloisKeys::save(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -100,35 +116,80 @@ namespace seal
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            int32_t decomposition_bit_count32 =
-                safe_cast<int32_t>(decomposition_bit_count_);
+            save_versioned(stream, compr_mode,
+                [this](ostream &members_stream) { save_members(members_stream); });
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
 
-            // Save the parms_id
-            stream.write(reinterpret_cast<const char*>(&parms_id_),
-                sizeof(parms_id_type));
+        stream.exceptions(old_except_mask);
+    }
 
-            // Save the decomposition bit count
-            stream.write(reinterpret_cast<const char*>(&decomposition_bit_count32),
-                sizeof(int32_t));
+    void GaloisKeys::unsafe_load(istream &stream)
+    {
+        load_checked(stream);
+    }
 
-            // Save the size of keys_
-            uint64_t keys_dim1 = static_cast<uint64_t>(keys_.size());
-            stream.write(reinterpret_cast<const char*>(&keys_dim1), sizeof(uint64_t));
+    size_t GaloisKeys::save_size(compr_mode_type compr_mode) const
+    {
+        if (compr_mode == compr_mode_type::none)
+        {
+            return versioned_save_size(members_save_size());
+        }
+        return compute_save_size(
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
 
-            // Now loop again over keys_dim1
-            for (size_t index = 0; index < keys_dim1; index++)
-            {
-                // Save second dimension of keys_
-                uint64_t keys_dim2 = static_cast<uint64_t>(keys_[index].size());
-                stream.write(reinterpret_cast<const char*>(&keys_dim2), sizeof(uint64_t));
+    size_t GaloisKeys::save(SEAL_BYTE *out, size_t size, compr_mode_type compr_mode) const
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
 
-                // Loop over keys_dim2 and save all (or none)
-                for (size_t j = 0; j < keys_dim2; j++)
+    size_t GaloisKeys::unsafe_load(const SEAL_BYTE *in, size_t size)
+    {
+        return load_from_buffer(in, size,
+            [this](istream &stream) { unsafe_load(stream); });
+    }
+
+    bool GaloisKeys::load_checked(istream &stream)
+    {
+        bool verified = false;
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            // Keys saved before the versioned format was introduced start
+            // directly with the parms_id
+            auto start = stream.tellg();
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic == indexed_serialization_magic)
+            {
+                load_indexed(stream, start, nullptr);
+                verified = true;
+            }
+            else if (magic == serialization_magic)
+            {
+                load_versioned(stream, [this](istream &members_stream)
                 {
-                    // Save the key
-                    keys_[index][j].save(stream);
-                }
+                    uint64_t parms_id_word = 0;
+                    members_stream.read(reinterpret_cast<char*>(&parms_id_word),
+                        sizeof(uint64_t));
+                    load_members(members_stream, parms_id_word);
+                });
+                verified = true;
             }
+            else
+            {
+                load_members(stream, magic);
+            }
+            make_contiguous();
         }
         catch (const exception &)
         {
@@ -137,9 +198,123 @@ namespace seal
         }
 
         stream.exceptions(old_except_mask);
+        return verified;
     }
 
-    void GaloisKeys::unsafe_load(std::istream &stream)
+    size_t GaloisKeys::members_save_size() const
+    {
+        size_t members_size = sizeof(parms_id_type) + sizeof(int32_t) + sizeof(uint64_t);
+        for (auto &key : keys_)
+        {
+            members_size = add_safe(members_size, sizeof(uint64_t));
+            for (auto &key_component : key)
+            {
+                members_size = add_safe(members_size, key_component.save_size());
+            }
+        }
+        return members_size;
+    }
+
+    void GaloisKeys::save_members(ostream &stream) const
+    {
+        int32_t decomposition_bit_count32 =
+            safe_cast<int32_t>(decomposition_bit_count_);
+
+        // Save the parms_id
+        stream.write(reinterpret_cast<const char*>(&parms_id_),
+            sizeof(parms_id_type));
+
+        // Save the decomposition bit count
+        stream.write(reinterpret_cast<const char*>(&decomposition_bit_count32),
+            sizeof(int32_t));
+
+        // Save the size of keys_
+        uint64_t keys_dim1 = static_cast<uint64_t>(keys_.size());
+        stream.write(reinterpret_cast<const char*>(&keys_dim1), sizeof(uint64_t));
+
+        // Now loop again over keys_dim1
+        for (size_t index = 0; index < keys_dim1; index++)
+        {
+            // Save second dimension of keys_
+            uint64_t keys_dim2 = static_cast<uint64_t>(keys_[index].size());
+            stream.write(reinterpret_cast<const char*>(&keys_dim2), sizeof(uint64_t));
+
+            // Loop over keys_dim2 and save all (or none)
+            for (size_t j = 0; j < keys_dim2; j++)
+            {
+                // Save the key
+                keys_[index][j].save(stream);
+            }
+        }
+    }
+
+    void GaloisKeys::load_members(istream &stream, uint64_t parms_id_word)
+    {
+        // Clear current keys
+        keys_.clear();
+        mapping_.reset();
+        storage_.clear();
+
+        // Read the rest of the parms_id
+        parms_id_[0] = parms_id_word;
+        stream.read(reinterpret_cast<char*>(parms_id_.data() + 1),
+            sizeof(parms_id_type) - sizeof(uint64_t));
+
+        // Read the decomposition_bit_count
+        int32_t decomposition_bit_count32 = 0;
+        stream.read(reinterpret_cast<char*>(&decomposition_bit_count32),
+            sizeof(int32_t));
+        decomposition_bit_count_ = safe_cast<int>(decomposition_bit_count32);
+
+        // Read in the size of keys_
+        uint64_t keys_dim1 = 0;
+        stream.read(reinterpret_cast<char*>(&keys_dim1), sizeof(uint64_t));
+
+        // Reserve first for dimension of keys_
+        keys_.reserve(keys_dim1);
+
+        // Loop over the first dimension of keys_
+        for (size_t index = 0; index < keys_dim1; index++)
+        {
+            // Read the size of the second dimension
+            uint64_t keys_dim2 = 0;
+            stream.read(reinterpret_cast<char*>(&keys_dim2), sizeof(uint64_t));
+
+            // Don't resize; only reserve
+            keys_.emplace_back();
+            keys_.back().reserve(keys_dim2);
+            for (size_t j = 0; j < keys_dim2; j++)
+            {
+                Ciphertext new_key(pool_);
+                new_key.unsafe_load(stream);
+                keys_[index].emplace_back(move(new_key));
+            }
+        }
+    }
+
+    void GaloisKeys::save_mappable(ostream &stream) const
+    {
+        MappedKeys::save(stream, parms_id_, decomposition_bit_count_, keys_);
+    }
+
+    void GaloisKeys::unsafe_load_mapped(const string &path)
+    {
+        auto mapping = make_shared<MappedFile>(path);
+        parms_id_type parms_id;
+        int decomposition_bit_count;
+        vector<vector<Ciphertext>> new_keys;
+        MappedKeys::load(*mapping, pool_, parms_id, decomposition_bit_count,
+            new_keys);
+
+        // Set values; the old keys are released before their mapping
+        parms_id_ = parms_id;
+        decomposition_bit_count_ = decomposition_bit_count;
+        keys_ = move(new_keys);
+        mapping_ = move(mapping);
+        storage_.clear();
+    }
+
+    void GaloisKeys::save_indexed(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -147,43 +322,117 @@ namespace seal
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            // Clear current keys
-            keys_.clear();
+            // The header holds the total size and the offset of every key
+            // relative to start; both are filled in once the keys are written
+            auto start = stream.tellp();
+            vector<uint64_t> header{ indexed_serialization_magic,
+                indexed_serialization_version, 0 };
+            header.insert(header.end(), parms_id_.cbegin(), parms_id_.cend());
+            header.push_back(static_cast<uint64_t>(decomposition_bit_count_));
+            header.push_back(safe_cast<uint64_t>(keys_.size()));
+            size_t index_offset = header.size();
+            header.resize(add_safe(header.size(), keys_.size()), 0);
+            stream.write(reinterpret_cast<const char*>(header.data()),
+                safe_cast<streamsize>(mul_safe(header.size(), sizeof(uint64_t))));
 
-            // Read the parms_id
-            stream.read(reinterpret_cast<char*>(&parms_id_),
-                sizeof(parms_id_type));
+            for (size_t index = 0; index < keys_.size(); index++)
+            {
+                // Missing keys keep offset zero
+                auto &key = keys_[index];
+                if (key.empty())
+                {
+                    continue;
+                }
+                header[index_offset + index] =
+                    safe_cast<uint64_t>(stream.tellp() - start);
+                save_versioned(stream, compr_mode, [&key](ostream &key_stream)
+                {
+                    uint64_t keys_dim2 = static_cast<uint64_t>(key.size());
+                    key_stream.write(reinterpret_cast<const char*>(&keys_dim2),
+                        sizeof(uint64_t));
+                    for (auto &key_component : key)
+                    {
+                        key_component.save(key_stream);
+                    }
+                });
+            }
+            auto end = stream.tellp();
+            header[2] = safe_cast<uint64_t>(end - start);
 
-            // Read the decomposition_bit_count
-            int32_t decomposition_bit_count32 = 0;
-            stream.read(reinterpret_cast<char*>(&decomposition_bit_count32),
-                sizeof(int32_t));
-            decomposition_bit_count_ = safe_cast<int>(decomposition_bit_count32);
+            stream.seekp(start);
+            stream.write(reinterpret_cast<const char*>(header.data()),
+                safe_cast<streamsize>(mul_safe(header.size(), sizeof(uint64_t))));
+            stream.seekp(end);
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
 
-            // Read in the size of keys_
-            uint64_t keys_dim1 = 0;
-            stream.read(reinterpret_cast<char*>(&keys_dim1), sizeof(uint64_t));
+        stream.exceptions(old_except_mask);
+    }
+
+    void GaloisKeys::unsafe_load(istream &stream, const vector<uint64_t> &galois_elts)
+    {
+        for (auto galois_elt : galois_elts)
+        {
+            if (!(galois_elt & 1))
+            {
+                throw invalid_argument("galois element is not valid");
+            }
+        }
 
-            // Reserve first for dimension of keys_
-            keys_.reserve(keys_dim1);
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            // Loop over the first dimension of keys_
-            for (size_t index = 0; index < keys_dim1; index++)
+            auto start = stream.tellg();
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic == indexed_serialization_magic)
             {
-                // Read the size of the second dimension
-                uint64_t keys_dim2 = 0;
-                stream.read(reinterpret_cast<char*>(&keys_dim2), sizeof(uint64_t));
+                load_indexed(stream, start, &galois_elts);
+            }
+            else
+            {
+                // Without an index all keys are read, and the ones that were
+                // not requested are dropped
+                if (magic == serialization_magic)
+                {
+                    load_versioned(stream, [this](istream &members_stream)
+                    {
+                        uint64_t parms_id_word = 0;
+                        members_stream.read(reinterpret_cast<char*>(&parms_id_word),
+                            sizeof(uint64_t));
+                        load_members(members_stream, parms_id_word);
+                    });
+                }
+                else
+                {
+                    load_members(stream, magic);
+                }
 
-                // Don't resize; only reserve
-                keys_.emplace_back();
-                keys_.back().reserve(keys_dim2);
-                for (size_t j = 0; j < keys_dim2; j++)
+                vector<bool> requested(keys_.size(), false);
+                for (auto galois_elt : galois_elts)
                 {
-                    Ciphertext new_key(pool_);
-                    new_key.unsafe_load(stream);
-                    keys_[index].emplace_back(move(new_key));
+                    if (!has_key(galois_elt))
+                    {
+                        throw invalid_argument("requested key does not exist");
+                    }
+                    requested[static_cast<size_t>((galois_elt - 1) >> 1)] = true;
+                }
+                for (size_t index = 0; index < keys_.size(); index++)
+                {
+                    if (!requested[index])
+                    {
+                        vector<Ciphertext>().swap(keys_[index]);
+                    }
                 }
             }
+            make_contiguous();
         }
         catch (const exception &)
         {
@@ -193,4 +442,143 @@ namespace seal
 
         stream.exceptions(old_except_mask);
     }
+
+    void GaloisKeys::load(shared_ptr<SEALContext> context, istream &stream,
+        const vector<int> &steps)
+    {
+        // Verify parameters
+        if (!context)
+        {
+            throw invalid_argument("invalid context");
+        }
+        if (!context->parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        auto &context_data = *context->context_data();
+        if (!context_data.qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        vector<uint64_t> galois_elts;
+        transform(steps.begin(), steps.end(), back_inserter(galois_elts),
+            [&](auto s) { return steps_to_galois_elt(s, coeff_count); });
+
+        load(move(context), stream, galois_elts);
+    }
+
+    void GaloisKeys::load_indexed(istream &stream, streampos start,
+        const vector<uint64_t> *galois_elts)
+    {
+        uint64_t version = 0;
+        stream.read(reinterpret_cast<char*>(&version), sizeof(uint64_t));
+        if (version != indexed_serialization_version)
+        {
+            throw invalid_argument("unsupported serialization version");
+        }
+        uint64_t total_size = 0;
+        stream.read(reinterpret_cast<char*>(&total_size), sizeof(uint64_t));
+        parms_id_type parms_id;
+        stream.read(reinterpret_cast<char*>(parms_id.data()), sizeof(parms_id_type));
+        uint64_t decomposition_bit_count64 = 0;
+        stream.read(reinterpret_cast<char*>(&decomposition_bit_count64),
+            sizeof(uint64_t));
+        int decomposition_bit_count = static_cast<int>(
+            static_cast<int64_t>(decomposition_bit_count64));
+
+        // The index cannot be larger than the whole object
+        uint64_t keys_dim1 = 0;
+        stream.read(reinterpret_cast<char*>(&keys_dim1), sizeof(uint64_t));
+        if (keys_dim1 > total_size / sizeof(uint64_t))
+        {
+            throw invalid_argument("GaloisKeys index is invalid");
+        }
+        vector<uint64_t> offsets(safe_cast<size_t>(keys_dim1));
+        stream.read(reinterpret_cast<char*>(offsets.data()),
+            safe_cast<streamsize>(mul_safe(offsets.size(), sizeof(uint64_t))));
+
+        vector<size_t> indices;
+        if (galois_elts)
+        {
+            for (auto galois_elt : *galois_elts)
+            {
+                uint64_t index = (galois_elt - 1) >> 1;
+                if (index >= keys_dim1 || !offsets[static_cast<size_t>(index)])
+                {
+                    throw invalid_argument("requested key does not exist");
+                }
+                indices.push_back(static_cast<size_t>(index));
+            }
+        }
+        else
+        {
+            for (size_t index = 0; index < offsets.size(); index++)
+            {
+                if (offsets[index])
+                {
+                    indices.push_back(index);
+                }
+            }
+        }
+
+        // Read each requested key from its own position
+        vector<vector<Ciphertext>> new_keys(offsets.size());
+        for (auto index : indices)
+        {
+            auto &key = new_keys[index];
+            if (!key.empty())
+            {
+                continue;
+            }
+            if (offsets[index] >= total_size)
+            {
+                throw invalid_argument("GaloisKeys index is invalid");
+            }
+            stream.seekg(start + static_cast<streamoff>(offsets[index]));
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic != serialization_magic)
+            {
+                throw invalid_argument("GaloisKeys index is invalid");
+            }
+            load_versioned(stream,
+                [this, &key, total_size](istream &key_stream)
+            {
+                uint64_t keys_dim2 = 0;
+                key_stream.read(reinterpret_cast<char*>(&keys_dim2), sizeof(uint64_t));
+                if (!keys_dim2 || keys_dim2 > total_size)
+                {
+                    throw invalid_argument("GaloisKeys data is invalid");
+                }
+                key.reserve(safe_cast<size_t>(keys_dim2));
+                for (uint64_t j = 0; j < keys_dim2; j++)
+                {
+                    Ciphertext new_key(pool_);
+                    new_key.unsafe_load(key_stream);
+                    key.emplace_back(move(new_key));
+                }
+            });
+        }
+        stream.seekg(start + static_cast<streamoff>(total_size));
+
+        // Set values; the old keys are released before their mapping
+        parms_id_ = parms_id;
+        decomposition_bit_count_ = decomposition_bit_count;
+        keys_ = move(new_keys);
+        mapping_.reset();
+        storage_.clear();
+    }
+
+    void GaloisKeys::make_contiguous()
+    {
+        for (auto &key : keys_)
+        {
+            if (!key.empty())
+            {
+                storage_.emplace_back(Ciphertext::make_contiguous(key, pool_));
+            }
+        }
+    }
 }
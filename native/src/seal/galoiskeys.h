@@ -9,6 +9,7 @@
 #include "seal/ciphertext.h"
 #include "seal/memorymanager.h"
 #include "seal/encryptionparams.h"
+#include "seal/util/mappedfile.h"
 
 namespace seal
 {
@@ -59,7 +60,7 @@ namespace seal
 
         @param[in] copy The GaloisKeys to copy from
         */
-        GaloisKeys(const GaloisKeys &copy) = default;
+        GaloisKeys(const GaloisKeys &copy);
 
         /**
         Creates a new GaloisKeys instance by moving a given instance.
@@ -196,12 +197,16 @@ namespace seal
         /**
         Saves the GaloisKeys instance to an output stream. The output is in binary 
         format and not human-readable. The output stream must have the "binary" 
-        flag set.
+        flag set. With compression enabled, the keys are compressed in chunks
+        of bounded size as they are written.
 
         @param[in] stream The stream to save the GaloisKeys to
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
         @throws std::exception if the GaloisKeys could not be written to stream
         */
-        void save(std::ostream &stream) const;
+        void save(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
 
         /**
         Loads a GaloisKeys from an input stream overwriting the current GaloisKeys.
@@ -235,6 +240,227 @@ namespace seal
             }
         }
 
+        /**
+        Loads a GaloisKeys from an input stream overwriting the current GaloisKeys, and
+        verifies it to be valid for the given SEALContext like load does. The
+        data is verified against its stored checksum instead of checking every
+        coefficient, and only the metadata of the GaloisKeys is validated. Data in
+        the layout that preceded the versioned format has no checksum and is
+        validated fully. The checksum detects
+        corrupted data but not deliberately modified data, so this function
+        should only be used for data from trusted storage.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the GaloisKeys from
+        @throws std::invalid_argument if the context is not set or encryption
+        parameters are not valid
+        @throws std::exception if a valid GaloisKeys could not be read from stream
+        @throws std::invalid_argument if the data does not match its checksum
+        @throws std::invalid_argument if the loaded GaloisKeys is invalid for the
+        context
+        */
+        inline void trusted_load(std::shared_ptr<SEALContext> context,
+            std::istream &stream)
+        {
+            bool verified = load_checked(stream);
+            if (verified ? !is_metadata_valid_for(std::move(context)) :
+                !is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("GaloisKeys data is invalid");
+            }
+        }
+
+        /**
+        Returns the exact number of bytes that save writes for the GaloisKeys with the
+        given compression mode, for allocating a buffer to save to. With compression
+        enabled the keys are compressed to determine the size.
+
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save_size(
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Saves the GaloisKeys to a buffer in the format that save writes to a stream,
+        without intermediate copies. Returns the number of bytes written.
+
+        @param[out] out The buffer to save the GaloisKeys to
+        @param[in] size The size of the buffer in bytes
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the GaloisKeys does not fit in size bytes
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save(SEAL_BYTE *out, std::size_t size,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Loads a GaloisKeys from a buffer overwriting the current GaloisKeys, and returns
+        the number of bytes read. No checking of the validity of the GaloisKeys
+        data against encryption parameters is performed. This function should
+        not be used unless the GaloisKeys comes from a fully trusted source.
+
+        @param[in] in The buffer to load the GaloisKeys from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid GaloisKeys could not be read from in
+        */
+        std::size_t unsafe_load(const SEAL_BYTE *in, std::size_t size);
+
+        /**
+        Loads a GaloisKeys from a buffer overwriting the current GaloisKeys, and returns
+        the number of bytes read. The loaded GaloisKeys is verified to be valid
+        for the given SEALContext.
+
+        @param[in] context The SEALContext
+        @param[in] in The buffer to load the GaloisKeys from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid GaloisKeys could not be read from in
+        @throws std::invalid_argument if the loaded GaloisKeys is invalid for the
+        context
+        */
+        inline std::size_t load(std::shared_ptr<SEALContext> context,
+            const SEAL_BYTE *in, std::size_t size)
+        {
+            std::size_t read_count = unsafe_load(in, size);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("GaloisKeys data is invalid");
+            }
+            return read_count;
+        }
+
+        /**
+        Saves the GaloisKeys instance to an output stream in a layout that
+        unsafe_load_mapped can memory-map. The keys are neither bit-packed nor
+        compressed, so the output is larger than that of save. The output stream
+        must have the "binary" flag set.
+
+        @param[in] stream The stream to save the GaloisKeys to
+        @throws std::exception if the GaloisKeys could not be written to stream
+        */
+        void save_mappable(std::ostream &stream) const;
+
+        /**
+        Loads a GaloisKeys from a file written by save_mappable, overwriting the
+        current GaloisKeys. The file is memory-mapped and the keys refer to the
+        mapped data without copying it, so loading takes time proportional only
+        to the number of keys. The mapping is private and copy-on-write, so any
+        number of processes mapping the same file share its pages through the
+        page cache. No checking of the validity of the GaloisKeys data against
+        encryption parameters is performed. This function should not be used
+        unless the file comes from a fully trusted source.
+
+        @param[in] path The path of the file to map
+        @throws std::runtime_error if the file could not be mapped
+        @throws std::invalid_argument if the file does not hold a valid GaloisKeys
+        */
+        void unsafe_load_mapped(const std::string &path);
+
+        /**
+        Loads a GaloisKeys from a file written by save_mappable as unsafe_load_mapped
+        does, and verifies it to be valid for the given SEALContext. This reads
+        through all of the mapped data.
+
+        @param[in] context The SEALContext
+        @param[in] path The path of the file to map
+        @throws std::runtime_error if the file could not be mapped
+        @throws std::invalid_argument if the file does not hold a valid GaloisKeys
+        @throws std::invalid_argument if the loaded GaloisKeys is invalid for the
+        context
+        */
+        inline void load_mapped(std::shared_ptr<SEALContext> context,
+            const std::string &path)
+        {
+            unsafe_load_mapped(path);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("GaloisKeys data is invalid");
+            }
+        }
+
+        /**
+        Saves the GaloisKeys instance to an output stream in an indexed layout:
+        a header with the offset of every key is followed by the keys, each
+        stored (and optionally compressed) on its own. This allows loading a
+        subset of the keys without reading the others. The output stream must
+        have the "binary" flag set and must support seeking.
+
+        @param[in] stream The stream to save the GaloisKeys to
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
+        @throws std::exception if the GaloisKeys could not be written to stream
+        */
+        void save_indexed(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Loads the Galois keys corresponding to the given Galois elements from an
+        input stream, overwriting the current GaloisKeys. If the stream holds
+        keys saved with save_indexed, the stream is positioned directly at each
+        requested key and the others are never read; this requires the stream
+        to support seeking. Keys saved in any other way are read in full, after
+        which the keys that were not requested are discarded. No checking of the
+        validity of the GaloisKeys data against encryption parameters is
+        performed. This function should not be used unless the GaloisKeys comes
+        from a fully trusted source.
+
+        @param[in] stream The stream to load the GaloisKeys from
+        @param[in] galois_elts The Galois elements of the keys to load
+        @throws std::invalid_argument if a Galois element is not valid
+        @throws std::invalid_argument if a requested key does not exist
+        @throws std::exception if a valid GaloisKeys could not be read from stream
+        */
+        void unsafe_load(std::istream &stream,
+            const std::vector<std::uint64_t> &galois_elts);
+
+        /**
+        Loads the Galois keys corresponding to the given Galois elements from an
+        input stream as unsafe_load does, and verifies them to be valid for the
+        given SEALContext.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the GaloisKeys from
+        @param[in] galois_elts The Galois elements of the keys to load
+        @throws std::invalid_argument if a Galois element is not valid
+        @throws std::invalid_argument if a requested key does not exist
+        @throws std::exception if a valid GaloisKeys could not be read from stream
+        @throws std::invalid_argument if the loaded GaloisKeys is invalid for the
+        context
+        */
+        inline void load(std::shared_ptr<SEALContext> context,
+            std::istream &stream, const std::vector<std::uint64_t> &galois_elts)
+        {
+            unsafe_load(stream, galois_elts);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("GaloisKeys data is invalid");
+            }
+        }
+
+        /**
+        Loads the Galois keys needed for rotating batched plaintexts by the given
+        numbers of steps from an input stream, and verifies them to be valid for
+        the given SEALContext. A step count of zero stands for a column rotation,
+        as in KeyGenerator::galois_keys.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the GaloisKeys from
+        @param[in] steps The rotation step counts of the keys to load
+        @throws std::invalid_argument if the context is not set or encryption
+        parameters are not valid
+        @throws std::logic_error if the encryption parameters do not support
+        batching
+        @throws std::invalid_argument if a requested key does not exist
+        @throws std::exception if a valid GaloisKeys could not be read from stream
+        @throws std::invalid_argument if the loaded GaloisKeys is invalid for the
+        context
+        */
+        void load(std::shared_ptr<SEALContext> context, std::istream &stream,
+            const std::vector<int> &steps);
+
         /**
         Returns the currently used MemoryPoolHandle.
         */
@@ -249,10 +475,61 @@ namespace seal
         struct GaloisKeysPrivateHelper;
 
     private:
+        /**
+        Does the work of unsafe_load. Returns true if the data was verified
+        against a stored checksum, which is the case unless it is in the layout
+        that preceded the versioned format.
+        */
+        bool load_checked(std::istream &stream);
+
+        /**
+        Returns the number of bytes save_members writes.
+        */
+        std::size_t members_save_size() const;
+
+        /**
+        Writes the members following the versioned serialization header. The
+        layout is that of the format preceding the versioned one.
+        */
+        void save_members(std::ostream &stream) const;
+
+        /**
+        Reads the members written by save_members. The first word of the
+        parms_id has already been read.
+        */
+        void load_members(std::istream &stream, std::uint64_t parms_id_word);
+
+        /**
+        Moves each key in keys_ to its own buffer in storage_.
+        */
+        void make_contiguous();
+
+        /**
+        Reads keys written by save_indexed, after indexed_serialization_magic
+        has been read from stream at position start. If galois_elts is null,
+        all keys are read. Every key that is read is verified against its
+        stored checksum.
+        */
+        void load_indexed(std::istream &stream, std::streampos start,
+            const std::vector<std::uint64_t> *galois_elts);
+
         MemoryPoolHandle pool_ = MemoryManager::GetPool();
 
         parms_id_type parms_id_ = parms_id_zero;
 
+        /**
+        The file the keys refer to when loaded with unsafe_load_mapped. It is
+        declared before keys_ so that it outlives them.
+        */
+        std::shared_ptr<util::MappedFile> mapping_{};
+
+        /**
+        Buffers holding the keys, one per key, with the components of each key
+        stored in order. The key ciphertexts refer to them instead of owning
+        separate allocations, so key switching reads each key sequentially.
+        */
+        std::vector<util::Pointer<std::uint64_t>> storage_{};
+
         /**
         The vector of Galois keys.
         */
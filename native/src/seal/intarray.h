@@ -132,6 +132,41 @@ namespace seal
         {
         }
 
+        /**
+        Creates a new IntArray that refers to existing memory instead of
+        allocating its own. The IntArray does not take ownership of the memory,
+        which must remain valid for as long as the IntArray refers to it. Any
+        operation that needs more capacity moves the data to a new allocation
+        from the given memory pool.
+
+        @param[in] data The memory to refer to
+        @param[in] size The number of elements at data
+        @param[in] pool The MemoryPoolHandle pointing to a valid memory pool
+        @throws std::invalid_argument if data is null and size is positive
+        @throws std::invalid_argument if pool is uninitialized
+        */
+        static IntArray<T> Aliasing(T *data, size_type size,
+            MemoryPoolHandle pool = MemoryManager::GetPool())
+        {
+            if (!data && size)
+            {
+                throw std::invalid_argument("data cannot be null");
+            }
+            IntArray<T> result(std::move(pool));
+            result.capacity_ = size;
+            result.size_ = size;
+            result.data_ = util::Pointer<T>::Aliasing(data);
+            return result;
+        }
+
+        /**
+        Returns whether the IntArray refers to memory that it does not own.
+        */
+        inline bool is_alias() const noexcept
+        {
+            return data_.is_alias();
+        }
+
         /**
         Returns a pointer to the beginning of the array data.
         */
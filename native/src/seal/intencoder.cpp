@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include "seal/intencoder.h"
 #include "seal/util/common.h"
 #include "seal/util/polyarith.h"
@@ -79,7 +80,7 @@ namespace seal
     {
         if (value < 0)
         {
-            uint64_t pos_value = static_cast<uint64_t>(-value);
+            uint64_t pos_value = uint64_t(0) - static_cast<uint64_t>(value);
             size_t encode_coeff_count = safe_cast<size_t>(
                 get_significant_bit_count(pos_value));
             destination.resize(encode_coeff_count);
@@ -142,14 +143,18 @@ namespace seal
 
     uint64_t IntegerEncoder::decode_uint64(const Plaintext &plain)
     {
-        BigUInt bigvalue = decode_biguint(plain);
-        int bit_count = bigvalue.significant_bit_count();
-        if (bit_count > bits_per_uint64)
+        uint64_t magnitude[2];
+        bool is_negative;
+        if (!decode_fixed(plain, magnitude, is_negative) || magnitude[1])
         {
             // Decoded value has more bits than fit in a 64-bit uint.
             throw invalid_argument("output out of range");
         }
-        return bit_count > 0 ? bigvalue.data()[0] : 0;
+        if (is_negative)
+        {
+            throw invalid_argument("poly must decode to positive value");
+        }
+        return magnitude[0];
     }
 
     int32_t IntegerEncoder::decode_int32(const Plaintext &plain)
@@ -160,61 +165,194 @@ namespace seal
 
     int64_t IntegerEncoder::decode_int64(const Plaintext &plain)
     {
-        int64_t result = 0;
-        for (size_t bit_index = plain.significant_coeff_count(); bit_index--; )
+        uint64_t magnitude[2];
+        bool is_negative;
+        uint64_t max_positive = static_cast<uint64_t>(numeric_limits<int64_t>::max());
+        if (!decode_fixed(plain, magnitude, is_negative) || magnitude[1] ||
+            (magnitude[0] > max_positive + static_cast<uint64_t>(is_negative)))
         {
-            unsigned long long coeff = plain[bit_index];
+            // Decoded value does not fit in a 64-bit int.
+            throw invalid_argument("output out of range");
+        }
+        return is_negative ? static_cast<int64_t>(uint64_t(0) - magnitude[0]) :
+            static_cast<int64_t>(magnitude[0]);
+    }
 
-            // Left shift result.
-            int64_t next_result = result << 1;
-            if ((next_result < 0) != (result < 0))
-            {
-                // Check for overflow.
-                throw invalid_argument("output out of range");
-            }
+    bool IntegerEncoder::decode_fixed(const Plaintext &plain, uint64_t *magnitude,
+        bool &is_negative) const
+    {
+        uint64_t modulus = plain_modulus().value();
 
-            // Get sign/magnitude of coefficient.
-            int coeff_bit_count = get_significant_bit_count(coeff);
-            if (coeff >= plain_modulus().value())
+        // Horner's method on a 192-bit two's complement accumulator. Each partial
+        // result r_k satisfies |r_0| >= 2^k (|r_k| - plain_modulus), so once it 
+        // exceeds 2^189 the result cannot fit in 128 bits.
+        uint64_t result[3]{ 0, 0, 0 };
+        for (size_t bit_index = plain.significant_coeff_count(); bit_index--; )
+        {
+            uint64_t coeff = plain[bit_index];
+            if (coeff >= modulus)
             {
                 // Coefficient is bigger than plaintext modulus
                 throw invalid_argument("plain does not represent a valid plaintext polynomial");
             }
-            bool coeff_is_negative = coeff >= coeff_neg_threshold_;
-            unsigned long long pos_value = coeff;
-            if (coeff_is_negative)
-            {
-                pos_value = plain_modulus().value() - pos_value;
-                coeff_bit_count = get_significant_bit_count(pos_value);
-            }
 
-            if (coeff_bit_count > bits_per_uint64 - 1)
+            int64_t high_bits = static_cast<int64_t>(result[2]) >> 61;
+            if (high_bits != 0 && high_bits != -1)
             {
-                // Absolute value of coefficient is too large to represent in a int64_t, so overflow.
-                throw invalid_argument("output out of range");
+                // Keep checking the remaining coefficients
+                for (; bit_index--; )
+                {
+                    if (plain[bit_index] >= modulus)
+                    {
+                        throw invalid_argument(
+                            "plain does not represent a valid plaintext polynomial");
+                    }
+                }
+                return false;
             }
 
-            int64_t coeff_value = safe_cast<int64_t>(pos_value);
-            if (coeff_is_negative)
-            {
-                coeff_value = -coeff_value;
-            }
-            bool next_result_was_negative = next_result < 0;
-            next_result += coeff_value;
-            bool next_result_is_negative = next_result < 0;
-            if ((next_result_was_negative == coeff_is_negative) && 
-                (next_result_was_negative != next_result_is_negative))
+            // Left shift result
+            result[2] = (result[2] << 1) | (result[1] >> 63);
+            result[1] = (result[1] << 1) | (result[0] >> 63);
+            result[0] <<= 1;
+
+            // Add the sign-extended coefficient in balanced representation
+            uint64_t coeff_value = coeff;
+            uint64_t sign_extension = 0;
+            if (coeff >= coeff_neg_threshold_)
             {
-                // Accumulation and coefficient had same signs, but accumulator changed signs after addition, so must be overflow.
-                throw invalid_argument("output out of range");
+                coeff_value = coeff - modulus;
+                sign_extension = ~uint64_t(0);
             }
-            result = next_result;
+            unsigned long long temp;
+            unsigned char carry = add_uint64(result[0], coeff_value, &temp);
+            result[0] = temp;
+            carry = add_uint64(result[1], sign_extension, carry, &temp);
+            result[1] = temp;
+            add_uint64(result[2], sign_extension, carry, &temp);
+            result[2] = temp;
+        }
+
+        // Take the magnitude
+        is_negative = (static_cast<int64_t>(result[2]) < 0);
+        if (is_negative)
+        {
+            negate_uint(result, 3, result);
+        }
+        magnitude[0] = result[0];
+        magnitude[1] = result[1];
+        return !result[2];
+    }
+
+    void IntegerEncoder::encode(const vector<int64_t> &values, 
+        vector<Plaintext> &destination)
+    {
+        destination.resize(values.size());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            encode(values[i], destination[i]);
+        }
+    }
+
+    void IntegerEncoder::encode(const vector<uint64_t> &values, 
+        vector<Plaintext> &destination)
+    {
+        destination.resize(values.size());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            encode(values[i], destination[i]);
         }
-        return result;
     }
 
+    void IntegerEncoder::decode_int64(const vector<Plaintext> &plains, 
+        vector<int64_t> &destination)
+    {
+        destination.resize(plains.size());
+        for (size_t i = 0; i < plains.size(); i++)
+        {
+            destination[i] = decode_int64(plains[i]);
+        }
+    }
+
+    void IntegerEncoder::decode_uint64(const vector<Plaintext> &plains, 
+        vector<uint64_t> &destination)
+    {
+        destination.resize(plains.size());
+        for (size_t i = 0; i < plains.size(); i++)
+        {
+            destination[i] = decode_uint64(plains[i]);
+        }
+    }
+#ifdef SEAL_USE_MSGSL_SPAN
+    void IntegerEncoder::encode(gsl::span<const int64_t> values, 
+        gsl::span<Plaintext> destination)
+    {
+        if (values.size() != destination.size())
+        {
+            throw invalid_argument("values and destination have different sizes");
+        }
+        for (decltype(values.size()) i = 0; i < values.size(); i++)
+        {
+            encode(values[i], destination[i]);
+        }
+    }
+
+    void IntegerEncoder::encode(gsl::span<const uint64_t> values, 
+        gsl::span<Plaintext> destination)
+    {
+        if (values.size() != destination.size())
+        {
+            throw invalid_argument("values and destination have different sizes");
+        }
+        for (decltype(values.size()) i = 0; i < values.size(); i++)
+        {
+            encode(values[i], destination[i]);
+        }
+    }
+
+    void IntegerEncoder::decode_int64(gsl::span<const Plaintext> plains, 
+        gsl::span<int64_t> destination)
+    {
+        if (plains.size() != destination.size())
+        {
+            throw invalid_argument("plains and destination have different sizes");
+        }
+        for (decltype(plains.size()) i = 0; i < plains.size(); i++)
+        {
+            destination[i] = decode_int64(plains[i]);
+        }
+    }
+
+    void IntegerEncoder::decode_uint64(gsl::span<const Plaintext> plains, 
+        gsl::span<uint64_t> destination)
+    {
+        if (plains.size() != destination.size())
+        {
+            throw invalid_argument("plains and destination have different sizes");
+        }
+        for (decltype(plains.size()) i = 0; i < plains.size(); i++)
+        {
+            destination[i] = decode_uint64(plains[i]);
+        }
+    }
+#endif
     BigUInt IntegerEncoder::decode_biguint(const Plaintext &plain)
     {
+        // Fast path for results of at most 128 bits
+        uint64_t magnitude[2];
+        bool is_negative;
+        if (decode_fixed(plain, magnitude, is_negative))
+        {
+            if (is_negative)
+            {
+                throw invalid_argument("poly must decode to positive value");
+            }
+            int bit_count = magnitude[1] ? 2 * bits_per_uint64 : bits_per_uint64;
+            BigUInt resultint(bit_count);
+            set_uint_uint(magnitude, resultint.uint64_count(), resultint.data());
+            return resultint;
+        }
+
         size_t result_uint64_count = 1;
         size_t bits_per_uint64_sz = safe_cast<size_t>(bits_per_uint64);
         size_t result_bit_capacity = result_uint64_count * bits_per_uint64_sz;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "seal/context.h"
 #include "seal/biguint.h"
 #include "seal/plaintext.h"
@@ -222,6 +223,104 @@ namespace seal
             encode(static_cast<std::uint64_t>(value), destination);
         }
 
+        /**
+        Encodes a vector of signed integers (represented by std::int64_t) into plaintext 
+        polynomials. The destination vector is resized to the size of values, and the 
+        memory of any plaintexts it already contains is reused.
+
+        @param[in] values The signed integers to encode
+        @param[out] destination The plaintexts to overwrite with the encodings
+        */
+        void encode(const std::vector<std::int64_t> &values, 
+            std::vector<Plaintext> &destination);
+
+        /**
+        Encodes a vector of unsigned integers (represented by std::uint64_t) into 
+        plaintext polynomials. The destination vector is resized to the size of values, 
+        and the memory of any plaintexts it already contains is reused.
+
+        @param[in] values The unsigned integers to encode
+        @param[out] destination The plaintexts to overwrite with the encodings
+        */
+        void encode(const std::vector<std::uint64_t> &values, 
+            std::vector<Plaintext> &destination);
+
+        /**
+        Decodes a vector of plaintext polynomials and writes the results as 
+        std::int64_t to the destination vector, which is resized to the size of plains.
+
+        @param[in] plains The plaintexts to be decoded
+        @param[out] destination The vector to overwrite with the decoded values
+        @throws std::invalid_argument if some plaintext does not represent a valid 
+        plaintext polynomial
+        @throws std::invalid_argument if some output does not fit in std::int64_t 
+        */
+        void decode_int64(const std::vector<Plaintext> &plains, 
+            std::vector<std::int64_t> &destination);
+
+        /**
+        Decodes a vector of plaintext polynomials and writes the results as 
+        std::uint64_t to the destination vector, which is resized to the size of plains.
+
+        @param[in] plains The plaintexts to be decoded
+        @param[out] destination The vector to overwrite with the decoded values
+        @throws std::invalid_argument if some plaintext does not represent a valid 
+        plaintext polynomial
+        @throws std::invalid_argument if some output does not fit in std::uint64_t 
+        */
+        void decode_uint64(const std::vector<Plaintext> &plains, 
+            std::vector<std::uint64_t> &destination);
+#ifdef SEAL_USE_MSGSL_SPAN
+        /**
+        Encodes signed integers (represented by std::int64_t) into plaintext 
+        polynomials. The memory of the destination plaintexts is reused.
+
+        @param[in] values The signed integers to encode
+        @param[out] destination The plaintexts to overwrite with the encodings
+        @throws std::invalid_argument if values and destination have different sizes
+        */
+        void encode(gsl::span<const std::int64_t> values, 
+            gsl::span<Plaintext> destination);
+
+        /**
+        Encodes unsigned integers (represented by std::uint64_t) into plaintext 
+        polynomials. The memory of the destination plaintexts is reused.
+
+        @param[in] values The unsigned integers to encode
+        @param[out] destination The plaintexts to overwrite with the encodings
+        @throws std::invalid_argument if values and destination have different sizes
+        */
+        void encode(gsl::span<const std::uint64_t> values, 
+            gsl::span<Plaintext> destination);
+
+        /**
+        Decodes plaintext polynomials and writes the results as std::int64_t to
+        destination.
+
+        @param[in] plains The plaintexts to be decoded
+        @param[out] destination The span to overwrite with the decoded values
+        @throws std::invalid_argument if plains and destination have different sizes
+        @throws std::invalid_argument if some plaintext does not represent a valid 
+        plaintext polynomial
+        @throws std::invalid_argument if some output does not fit in std::int64_t 
+        */
+        void decode_int64(gsl::span<const Plaintext> plains, 
+            gsl::span<std::int64_t> destination);
+
+        /**
+        Decodes plaintext polynomials and writes the results as std::uint64_t to
+        destination.
+
+        @param[in] plains The plaintexts to be decoded
+        @param[out] destination The span to overwrite with the decoded values
+        @throws std::invalid_argument if plains and destination have different sizes
+        @throws std::invalid_argument if some plaintext does not represent a valid 
+        plaintext polynomial
+        @throws std::invalid_argument if some output does not fit in std::uint64_t 
+        */
+        void decode_uint64(gsl::span<const Plaintext> plains, 
+            gsl::span<std::uint64_t> destination);
+#endif
         /**
         Returns a reference to the plaintext modulus.
         */
@@ -236,6 +335,14 @@ namespace seal
 
         IntegerEncoder &operator =(IntegerEncoder &&assign) = delete;
 
+        /**
+        Evaluates plain at x=2 in fixed-width 192-bit signed arithmetic and writes 
+        the magnitude of the result to the two words of magnitude and its sign to 
+        is_negative. Returns false if the magnitude does not fit in 128 bits.
+        */
+        bool decode_fixed(const Plaintext &plain, std::uint64_t *magnitude, 
+            bool &is_negative) const;
+
         std::shared_ptr<SEALContext> context_{ nullptr };
 
         std::uint64_t coeff_neg_threshold_;
@@ -12,6 +12,8 @@
 #include "seal/util/clipnormal.h"
 #include "seal/util/polycore.h"
 #include "seal/util/smallntt.h"
+#include "seal/util/threadpool.h"
+#include "seal/util/serialization.h"
 
 using namespace std;
 using namespace seal::util;
@@ -231,7 +233,8 @@ namespace seal
         pk_generated_ = true;
     }
 
-    RelinKeys KeyGenerator::relin_keys(int decomposition_bit_count, size_t count)
+    RelinKeys KeyGenerator::relin_keys(int decomposition_bit_count, size_t count,
+        size_t thread_count)
     {
         // Check to see if secret key and public key have been generated
         if (!sk_generated_)
@@ -259,7 +262,6 @@ namespace seal
         auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
         size_t coeff_mod_count = coeff_modulus.size();
-        auto &small_ntt_tables = context_data.small_ntt_tables();
 
         // Size check
         if (!product_fits_in(coeff_count, coeff_mod_count))
@@ -279,87 +281,45 @@ namespace seal
         relin_keys.data().resize(count);
         for (size_t i = 0; i < count; i++)
         {
-            relin_keys.data()[i].reserve(coeff_mod_count);
-
-            for (size_t j = 0; j < coeff_mod_count; j++)
-            {
-                relin_keys.data()[i].emplace_back(
-                    context_, parms.parms_id(),
-                    2 * decomposition_factors[j].size(),
-                    relin_keys.pool());
-
-                // Resize to right size too (above only allocated)
-                // This is slightly odd use of Ciphertext as a container
-                relin_keys.data()[i].back().resize(
-                    2 * decomposition_factors[j].size());
-
-                // The keys are in NTT form
-                relin_keys.data()[i].back().is_ntt_form() = true;
-            }
+            allocate_key(context_data, decomposition_factors, 
+                relin_keys.data()[i], relin_keys.pool());
         }
 
-        shared_ptr<UniformRandomGenerator> random(parms.random_generator()->create());
-
-        // Create relinearization keys.
-        auto noise(allocate_poly(coeff_count, coeff_mod_count, pool_));
-        auto temp(allocate_uint(coeff_count, pool_));
-
         // Make sure we have enough secret keys computed
         compute_secret_key_array(context_data, count + 1);
 
+        // Each component of each key is generated independently; the secret 
+        // key powers are only read from here on.
         // assume the secret key is already transformed into NTT form. 
-        for (size_t k = 0; k < count; k++)
-        {
-            for (size_t l = 0; l < coeff_mod_count; l++)
+        // Per-thread random number generator and memory pool for temporary
+        // allocations, created by each thread when it gets its first indices.
+        auto &thread_pool = ThreadPool::Global();
+        vector<shared_ptr<UniformRandomGenerator>> randoms(
+            thread_pool.max_thread_count());
+        vector<MemoryPoolHandle> pools(thread_pool.max_thread_count());
+        thread_pool.parallel_for(
+            mul_safe(count, coeff_mod_count), thread_count,
+            [&](size_t begin, size_t end, size_t thread_index)
             {
-                // populate evaluate_keys_[k]
-                for (size_t i = 0; i < decomposition_factors[l].size(); i++)
+                auto &random = randoms[thread_index];
+                auto &pool = pools[thread_index];
+                if (!random)
                 {
-                    // generate NTT(a_i) and store in relin_keys_[k][l].second[i]
-                    uint64_t *eval_keys_first = relin_keys.data()[k][l].data(2 * i);
-                    uint64_t *eval_keys_second = relin_keys.data()[k][l].data(2 * i + 1);
-
-                    // We sample a_i directly in NTT form
-                    set_poly_coeffs_uniform(context_data, eval_keys_second, random);
-
-                    for (size_t j = 0; j < coeff_mod_count; j++)
-                    {
-                        // calculate a_i*s and store in relin_keys_[k].first[i]
-                        dyadic_product_coeffmod(eval_keys_second + (j * coeff_count), 
-                            secret_key_.data().data() + (j * coeff_count), 
-                            coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
-                    }
-
-                    // generate NTT(e_i) 
-                    set_poly_coeffs_normal(context_data, noise.get(), random);
-                    for (size_t j = 0; j < coeff_mod_count; j++)
-                    {
-                        ntt_negacyclic_harvey(noise.get() + (j * coeff_count), small_ntt_tables[j]);
-
-                        // add e_i into relin_keys_[k].first[i]
-                        add_poly_poly_coeffmod(
-                            noise.get() + (j * coeff_count), eval_keys_first + (j * coeff_count), 
-                            coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
-
-                        // negate value in relin_keys_[k].first[i]
-                        negate_poly_coeffmod(
-                            eval_keys_first + (j * coeff_count), coeff_count, coeff_modulus[j],
-                            eval_keys_first + (j * coeff_count));
-
-                        // multiply w^i * s^(k+2)
-                        uint64_t decomposition_factor_mod = decomposition_factors[l][i] & 
-                            static_cast<uint64_t>(-static_cast<int64_t>(l == j));
-                        multiply_poly_scalar_coeffmod(
-                            secret_key_array_.get() + (k + 1) * coeff_count * coeff_mod_count + (j * coeff_count), 
-                            coeff_count, decomposition_factor_mod, coeff_modulus[j], temp.get());
-
-                        // add w^i . s^(k+2) into relin_keys_[k].first[i]
-                        add_poly_poly_coeffmod(eval_keys_first + (j * coeff_count), temp.get(), coeff_count, 
-                            coeff_modulus[j], eval_keys_first + (j * coeff_count));
-                    }
+                    random = parms.random_generator()->create();
+                    pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW, true);
                 }
-            }
-        }
+                for (size_t i = begin; i < end; i++)
+                {
+                    size_t k = i / coeff_mod_count;
+                    size_t l = i % coeff_mod_count;
+
+                    // The k-th key switches from s^(k+2)
+                    generate_key_component(context_data, decomposition_factors[l], 
+                        l, secret_key_array_.get() + 
+                        (k + 1) * coeff_count * coeff_mod_count,
+                        relin_keys.data()[k][l], random, pool);
+                }
+            });
 
         // Set decomposition_bit_count
         relin_keys.decomposition_bit_count_ = decomposition_bit_count;
@@ -367,11 +327,14 @@ namespace seal
         // Set the parms_id
         relin_keys.parms_id() = parms.parms_id();
 
+        // Store each key in one buffer
+        relin_keys.make_contiguous();
+
         return relin_keys;
     }
 
     GaloisKeys KeyGenerator::galois_keys(int decomposition_bit_count, 
-        const vector<uint64_t> &galois_elts)
+        const vector<uint64_t> &galois_elts, size_t thread_count)
     {
         // Check to see if secret key and public key have been generated
         if (!sk_generated_)
@@ -389,11 +352,8 @@ namespace seal
         // Extract encryption parameters.
         auto &context_data = *context_->context_data();
         auto &parms = context_data.parms();
-        auto &coeff_modulus = parms.coeff_modulus();
         size_t coeff_count = parms.poly_modulus_degree();
-        size_t coeff_mod_count = coeff_modulus.size();
-        int coeff_count_power = get_power_of_two(coeff_count);
-        auto &small_ntt_tables = context_data.small_ntt_tables();
+        size_t coeff_mod_count = parms.coeff_modulus().size();
 
         // Size check
         if (!product_fits_in(coeff_count, coeff_mod_count, size_t(2)))
@@ -412,108 +372,15 @@ namespace seal
         populate_decomposition_factors(context_data, decomposition_bit_count,
             decomposition_factors);
 
-        for (uint64_t galois_elt : galois_elts)
+        // Generate all keys at once, each directly into its place
+        auto unique_galois_elts = validate_galois_elts(context_data, galois_elts);
+        vector<vector<Ciphertext>*> keys;
+        for (auto galois_elt : unique_galois_elts)
         {
-            // Verify coprime conditions.
-            if (!(galois_elt & 1) || (galois_elt >= 2 * coeff_count))
-            {
-                throw invalid_argument("galois element is not valid");
-            }
-
-            // Do we already have the key?
-            if (galois_keys.has_key(galois_elt))
-            {
-                continue;
-            }
-
-            // Rotate secret key for each coeff_modulus
-            auto rotated_secret_key(allocate_poly(coeff_count, coeff_mod_count, pool_));
-            for (size_t i = 0; i < coeff_mod_count; i++)
-            {
-                apply_galois_ntt(secret_key_.data().data() + (i * coeff_count),
-                    coeff_count_power, galois_elt,
-                    rotated_secret_key.get() + (i * coeff_count));
-            }
-
-            // Initialize galois key
-            // This is the location in the galois_keys vector
-            uint64_t index = (galois_elt - 1) >> 1;
-            galois_keys.data()[index].reserve(coeff_mod_count);
-
-            for (size_t i = 0; i < coeff_mod_count; i++)
-            {
-                galois_keys.data()[index].emplace_back(
-                    context_, parms.parms_id(),
-                    2 * decomposition_factors[i].size(),
-                    galois_keys.pool());
-
-                // Resize to right size too (above only allocated)
-                // This is slightly odd use of Ciphertext as a container
-                galois_keys.data()[index].back().resize(
-                    2 * decomposition_factors[i].size());
-
-                // The Galois keys are in NTT form
-                galois_keys.data()[index].back().is_ntt_form() = true;
-            }
-
-            shared_ptr<UniformRandomGenerator> random(parms.random_generator()->create());
-
-            // Create Galois keys.
-            auto noise(allocate_poly(coeff_count, coeff_mod_count, pool_));
-            auto temp(allocate_uint(coeff_count, pool_));
-
-            for (size_t l = 0; l < coeff_mod_count; l++)
-            {
-                // populate galois_keys_[k]
-                for (size_t i = 0; i < decomposition_factors[l].size(); i++)
-                {
-                    // generate NTT(a_i) and store in galois_keys_[k][l].second[i]
-                    uint64_t *eval_keys_first = galois_keys.data()[index][l].data(2 * i);
-                    uint64_t *eval_keys_second = galois_keys.data()[index][l].data(2 * i + 1);
-
-                    // We sample a_i in NTT form directly
-                    set_poly_coeffs_uniform(context_data, eval_keys_second, random);
-                    for (size_t j = 0; j < coeff_mod_count; j++)
-                    {
-                        // calculate a_i*s and store in galois_keys_[k].first[i]
-                        dyadic_product_coeffmod(eval_keys_second + (j * coeff_count), 
-                            secret_key_.data().data() + (j * coeff_count), 
-                            coeff_count, coeff_modulus[j], 
-                            eval_keys_first + (j * coeff_count));
-                    }
-
-                    // generate NTT(e_i) 
-                    set_poly_coeffs_normal(context_data, noise.get(), random);
-                    for (size_t j = 0; j < coeff_mod_count; j++)
-                    {
-                        ntt_negacyclic_harvey(
-                            noise.get() + (j * coeff_count), small_ntt_tables[j]);
-
-                        // add NTT(e_i) into galois_keys_[k].first[i]
-                        add_poly_poly_coeffmod(noise.get() + (j * coeff_count), 
-                            eval_keys_first + (j * coeff_count), 
-                            coeff_count, coeff_modulus[j],
-                            eval_keys_first + (j * coeff_count));
-
-                        // negate value in galois_keys_[k].first[i]
-                        negate_poly_coeffmod(
-                            eval_keys_first + (j * coeff_count), coeff_count, 
-                            coeff_modulus[j], eval_keys_first + (j * coeff_count));
-
-                        // multiply w^i * rotated_secret_key
-                        uint64_t decomposition_factor_mod = decomposition_factors[l][i] & 
-                            static_cast<uint64_t>(-static_cast<int64_t>(l == j));
-                        multiply_poly_scalar_coeffmod(rotated_secret_key.get() + (j * coeff_count), 
-                            coeff_count, decomposition_factor_mod, 
-                            coeff_modulus[j], temp.get());
-
-                        // add w^i * rotated_secret_key into galois_keys_[k].first[i]
-                        add_poly_poly_coeffmod(eval_keys_first + (j * coeff_count), temp.get(), 
-                            coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
-                    }
-                }
-            }
+            keys.push_back(&galois_keys.data()[(galois_elt - 1) >> 1]);
         }
+        generate_galois_keys(context_data, decomposition_factors, 
+            unique_galois_elts, keys, galois_keys.pool(), thread_count);
 
         // Set decomposition_bit_count
         galois_keys.decomposition_bit_count_ = decomposition_bit_count;
@@ -521,11 +388,29 @@ namespace seal
         // Set the parms_id
         galois_keys.parms_id_ = parms.parms_id();
 
+        // Store each key in one buffer
+        galois_keys.make_contiguous();
+
         return galois_keys;
     }
 
     GaloisKeys KeyGenerator::galois_keys(int decomposition_bit_count, 
-        const vector<int> &steps)
+        const vector<int> &steps, size_t thread_count)
+    {
+        return galois_keys(decomposition_bit_count, 
+            steps_to_galois_elts(steps), thread_count);
+    }
+
+    GaloisKeys KeyGenerator::galois_keys(int decomposition_bit_count, 
+        size_t thread_count)
+    {
+        return galois_keys(decomposition_bit_count, 
+            default_galois_elts(), thread_count);
+    }
+
+    void KeyGenerator::save_galois_keys(ostream &stream, 
+        int decomposition_bit_count, const vector<uint64_t> &galois_elts, 
+        size_t thread_count)
     {
         // Check to see if secret key and public key have been generated
         if (!sk_generated_)
@@ -540,6 +425,130 @@ namespace seal
             throw invalid_argument("decomposition_bit_count is not on the valid range");
         }
 
+        // Extract encryption parameters.
+        auto &context_data = *context_->context_data();
+        auto &parms = context_data.parms();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = parms.coeff_modulus().size();
+
+        // Size check
+        if (!product_fits_in(coeff_count, coeff_mod_count, size_t(2)))
+        {
+            throw logic_error("invalid parameters");
+        }
+
+        // Initialize decomposition_factors
+        vector<vector<uint64_t>> decomposition_factors;
+        populate_decomposition_factors(context_data, decomposition_bit_count,
+            decomposition_factors);
+
+        // The keys must be written in the order of their index
+        auto unique_galois_elts = validate_galois_elts(context_data, galois_elts);
+        sort(unique_galois_elts.begin(), unique_galois_elts.end());
+
+        // Generate as many keys at a time as there are threads to use
+        auto &thread_pool = ThreadPool::Global();
+        size_t batch_size = thread_pool.max_thread_count();
+        if (thread_count)
+        {
+            batch_size = min(batch_size, thread_count);
+        }
+
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+            // Write the same members as GaloisKeys::save
+            save_versioned(stream, compr_mode_type::none, [&](ostream &members_stream)
+            {
+                auto parms_id = parms.parms_id();
+                members_stream.write(reinterpret_cast<const char*>(&parms_id),
+                    sizeof(parms_id_type));
+                int32_t decomposition_bit_count32 =
+                    safe_cast<int32_t>(decomposition_bit_count);
+                members_stream.write(reinterpret_cast<const char*>(
+                    &decomposition_bit_count32), sizeof(int32_t));
+                uint64_t keys_dim1 = static_cast<uint64_t>(coeff_count);
+                members_stream.write(reinterpret_cast<const char*>(&keys_dim1), 
+                    sizeof(uint64_t));
+
+                vector<vector<Ciphertext>> batch(batch_size);
+                vector<vector<Ciphertext>*> keys;
+                vector<uint64_t> batch_galois_elts;
+                size_t next_index = 0;
+                for (size_t i = 0; i < unique_galois_elts.size(); i += batch_size)
+                {
+                    batch_galois_elts.assign(unique_galois_elts.begin() + i, 
+                        unique_galois_elts.begin() + 
+                        min(i + batch_size, unique_galois_elts.size()));
+                    keys.clear();
+                    for (size_t j = 0; j < batch_galois_elts.size(); j++)
+                    {
+                        batch[j].clear();
+                        keys.push_back(&batch[j]);
+                    }
+                    generate_galois_keys(context_data, decomposition_factors, 
+                        batch_galois_elts, keys, pool_, thread_count);
+
+                    for (size_t j = 0; j < batch_galois_elts.size(); j++)
+                    {
+                        // Missing keys are saved as empty
+                        size_t index = static_cast<size_t>(
+                            (batch_galois_elts[j] - 1) >> 1);
+                        uint64_t keys_dim2 = 0;
+                        for (; next_index < index; next_index++)
+                        {
+                            members_stream.write(reinterpret_cast<const char*>(
+                                &keys_dim2), sizeof(uint64_t));
+                        }
+                        keys_dim2 = static_cast<uint64_t>(batch[j].size());
+                        members_stream.write(reinterpret_cast<const char*>(
+                            &keys_dim2), sizeof(uint64_t));
+                        for (auto &key_component : batch[j])
+                        {
+                            key_component.save(members_stream);
+                        }
+                        next_index++;
+                    }
+                }
+
+                uint64_t keys_dim2 = 0;
+                for (; next_index < coeff_count; next_index++)
+                {
+                    members_stream.write(reinterpret_cast<const char*>(&keys_dim2), 
+                        sizeof(uint64_t));
+                }
+            });
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
+
+        stream.exceptions(old_except_mask);
+    }
+
+    void KeyGenerator::save_galois_keys(ostream &stream, 
+        int decomposition_bit_count, const vector<int> &steps, 
+        size_t thread_count)
+    {
+        save_galois_keys(stream, decomposition_bit_count, 
+            steps_to_galois_elts(steps), thread_count);
+    }
+
+    void KeyGenerator::save_galois_keys(ostream &stream, 
+        int decomposition_bit_count, size_t thread_count)
+    {
+        save_galois_keys(stream, decomposition_bit_count, 
+            default_galois_elts(), thread_count);
+    }
+
+    vector<uint64_t> KeyGenerator::steps_to_galois_elts(
+        const vector<int> &steps) const
+    {
         // Extract encryption parameters.
         auto &context_data = *context_->context_data();
         if (!context_data.qualifiers().using_batching)
@@ -553,25 +562,11 @@ namespace seal
         vector<uint64_t> galois_elts;
         transform(steps.begin(), steps.end(), back_inserter(galois_elts),
             [&](auto s) { return steps_to_galois_elt(s, coeff_count); });
-
-        return galois_keys(decomposition_bit_count, galois_elts);
+        return galois_elts;
     }
 
-    GaloisKeys KeyGenerator::galois_keys(int decomposition_bit_count)
+    vector<uint64_t> KeyGenerator::default_galois_elts() const
     {
-        // Check to see if secret key and public key have been generated
-        if (!sk_generated_)
-        {
-            throw logic_error("cannot generate galois keys for unspecified secret key");
-        }
-
-        // Check that decomposition_bit_count is in correct interval
-        if (decomposition_bit_count < SEAL_DBC_MIN || 
-            decomposition_bit_count > SEAL_DBC_MAX)
-        {
-            throw invalid_argument("decomposition_bit_count is not in the valid range");
-        }
-
         size_t coeff_count = context_->context_data()->parms().poly_modulus_degree();
         uint64_t m = coeff_count << 1;
         int logn = get_power_of_two(static_cast<uint64_t>(coeff_count));
@@ -597,7 +592,172 @@ namespace seal
             neg_two_power_of_three &= (m - 1);
         }
 
-        return galois_keys(decomposition_bit_count, logn_galois_keys);
+        return logn_galois_keys;
+    }
+
+    vector<uint64_t> KeyGenerator::validate_galois_elts(
+        const SEALContext::ContextData &context_data,
+        const vector<uint64_t> &galois_elts) const
+    {
+        size_t coeff_count = context_data.parms().poly_modulus_degree();
+        vector<uint64_t> unique_galois_elts;
+        for (uint64_t galois_elt : galois_elts)
+        {
+            // Verify coprime conditions.
+            if (!(galois_elt & 1) || (galois_elt >= 2 * coeff_count))
+            {
+                throw invalid_argument("galois element is not valid");
+            }
+
+            // Do we already have the key?
+            if (find(unique_galois_elts.begin(), unique_galois_elts.end(), 
+                galois_elt) == unique_galois_elts.end())
+            {
+                unique_galois_elts.push_back(galois_elt);
+            }
+        }
+        return unique_galois_elts;
+    }
+
+    void KeyGenerator::allocate_key(const SEALContext::ContextData &context_data,
+        const vector<vector<uint64_t>> &decomposition_factors,
+        vector<Ciphertext> &destination, MemoryPoolHandle pool) const
+    {
+        auto &parms = context_data.parms();
+        size_t coeff_mod_count = parms.coeff_modulus().size();
+
+        destination.reserve(coeff_mod_count);
+        for (size_t i = 0; i < coeff_mod_count; i++)
+        {
+            destination.emplace_back(
+                context_, parms.parms_id(),
+                2 * decomposition_factors[i].size(), pool);
+
+            // Resize to right size too (above only allocated)
+            // This is slightly odd use of Ciphertext as a container
+            destination.back().resize(2 * decomposition_factors[i].size());
+
+            // The keys are in NTT form
+            destination.back().is_ntt_form() = true;
+        }
+    }
+
+    void KeyGenerator::generate_galois_keys(
+        const SEALContext::ContextData &context_data,
+        const vector<vector<uint64_t>> &decomposition_factors,
+        const vector<uint64_t> &galois_elts, 
+        const vector<vector<Ciphertext>*> &destination,
+        MemoryPoolHandle pool, size_t thread_count) const
+    {
+        auto &parms = context_data.parms();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = parms.coeff_modulus().size();
+        size_t key_uint64_count = coeff_count * coeff_mod_count;
+
+        // Rotate secret key for each coeff_modulus
+        auto &galois_tool = *context_data.galois_tool();
+        auto rotated_secret_keys(allocate_poly(
+            mul_safe(galois_elts.size(), coeff_count), coeff_mod_count, pool_));
+        for (size_t k = 0; k < galois_elts.size(); k++)
+        {
+            for (size_t i = 0; i < coeff_mod_count; i++)
+            {
+                galois_tool.apply_galois_ntt(secret_key_.data().data() + (i * coeff_count),
+                    galois_elts[k],
+                    rotated_secret_keys.get() + k * key_uint64_count + 
+                    (i * coeff_count));
+            }
+            allocate_key(context_data, decomposition_factors, *destination[k], pool);
+        }
+
+        // Components of all keys are generated in parallel so that even a 
+        // single key uses several threads. Each thread creates its own random
+        // number generator and memory pool when it gets its first indices.
+        auto &thread_pool = ThreadPool::Global();
+        vector<shared_ptr<UniformRandomGenerator>> randoms(
+            thread_pool.max_thread_count());
+        vector<MemoryPoolHandle> pools(thread_pool.max_thread_count());
+        thread_pool.parallel_for(
+            galois_elts.size() * coeff_mod_count, thread_count,
+            [&](size_t begin, size_t end, size_t thread_index)
+            {
+                auto &random = randoms[thread_index];
+                auto &temp_pool = pools[thread_index];
+                if (!random)
+                {
+                    random = parms.random_generator()->create();
+                    temp_pool = MemoryManager::GetPool(mm_prof_opt::FORCE_NEW, true);
+                }
+                for (size_t i = begin; i < end; i++)
+                {
+                    size_t k = i / coeff_mod_count;
+                    size_t l = i % coeff_mod_count;
+                    generate_key_component(context_data, decomposition_factors[l], 
+                        l, rotated_secret_keys.get() + k * key_uint64_count,
+                        (*destination[k])[l], random, temp_pool);
+                }
+            });
+    }
+
+    void KeyGenerator::generate_key_component(
+        const SEALContext::ContextData &context_data,
+        const vector<uint64_t> &decomposition_factors, size_t decomposition_index,
+        const uint64_t *new_key, Ciphertext &destination,
+        shared_ptr<UniformRandomGenerator> random, MemoryPoolHandle pool) const
+    {
+        // Extract encryption parameters.
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        size_t coeff_count = parms.poly_modulus_degree();
+        size_t coeff_mod_count = coeff_modulus.size();
+        auto &small_ntt_tables = context_data.small_ntt_tables();
+
+        auto noise(allocate_poly(coeff_count, coeff_mod_count, pool));
+        auto temp(allocate_uint(coeff_count, pool));
+
+        for (size_t i = 0; i < decomposition_factors.size(); i++)
+        {
+            // generate NTT(a_i) and store in destination.second[i]
+            uint64_t *eval_keys_first = destination.data(2 * i);
+            uint64_t *eval_keys_second = destination.data(2 * i + 1);
+
+            // We sample a_i directly in NTT form
+            set_poly_coeffs_uniform(context_data, eval_keys_second, random);
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                // calculate a_i*s and store in destination.first[i]
+                dyadic_product_coeffmod(eval_keys_second + (j * coeff_count), 
+                    secret_key_.data().data() + (j * coeff_count), 
+                    coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
+            }
+
+            // generate NTT(e_i) 
+            set_poly_coeffs_normal(context_data, noise.get(), random);
+            for (size_t j = 0; j < coeff_mod_count; j++)
+            {
+                ntt_negacyclic_harvey(noise.get() + (j * coeff_count), small_ntt_tables[j]);
+
+                // add e_i into destination.first[i]
+                add_poly_poly_coeffmod(
+                    noise.get() + (j * coeff_count), eval_keys_first + (j * coeff_count), 
+                    coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
+
+                // negate value in destination.first[i]
+                negate_poly_coeffmod(
+                    eval_keys_first + (j * coeff_count), coeff_count, coeff_modulus[j],
+                    eval_keys_first + (j * coeff_count));
+
+                // multiply w^i * new_key
+                uint64_t decomposition_factor_mod = decomposition_factors[i] & 
+                    static_cast<uint64_t>(-static_cast<int64_t>(decomposition_index == j));
+                multiply_poly_scalar_coeffmod(new_key + (j * coeff_count), 
+                    coeff_count, decomposition_factor_mod, coeff_modulus[j], temp.get());
+
+                // add w^i * new_key into destination.first[i]
+                add_poly_poly_coeffmod(eval_keys_first + (j * coeff_count), temp.get(), 
+                    coeff_count, coeff_modulus[j], eval_keys_first + (j * coeff_count));
+            }
+        }
     }
 
     void KeyGenerator::set_poly_coeffs_zero_one_negone(
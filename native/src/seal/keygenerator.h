@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <iostream>
 #include <random>
 #include "seal/context.h"
 #include "seal/util/smallntt.h"
@@ -85,12 +86,19 @@ namespace seal
         /**
         Generates and returns the specified number of relinearization keys.
 
+        The components of the keys are generated in parallel, each thread 
+        sampling from its own random number generator and using its own memory
+        pool for temporary values.
+
         @param[in] decomposition_bit_count The decomposition bit count
         @param[in] count The number of relinearization keys to generate
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
         @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
         @throws std::invalid_argument if count is zero or too large
         */
-        RelinKeys relin_keys(int decomposition_bit_count, std::size_t count = 1);
+        RelinKeys relin_keys(int decomposition_bit_count, std::size_t count = 1,
+            std::size_t thread_count = 0);
 
         /**
         Generates and returns Galois keys. This function creates specific Galois 
@@ -107,13 +115,20 @@ namespace seal
         (not batching), a Galois automorphism by a Galois element p changes Enc(plain(x)) 
         to Enc(plain(x^p)). 
         
+        The keys are generated in parallel, each thread sampling from its own 
+        random number generator and using its own memory pool for temporary
+        values.
+
         @param[in] decomposition_bit_count The decomposition bit count
         @param[in] galois_elts The Galois elements for which to generate keys
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
         @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
         @throws std::invalid_argument if the Galois elements are not valid
         */
         GaloisKeys galois_keys(int decomposition_bit_count,
-            const std::vector<std::uint64_t> &galois_elts);
+            const std::vector<std::uint64_t> &galois_elts, 
+            std::size_t thread_count = 0);
 
         /**
         Generates and returns Galois keys. This function creates specific Galois 
@@ -126,13 +141,15 @@ namespace seal
 
         @param[in] decomposition_bit_count The decomposition bit count
         @param[in] galois_elts The rotation step counts for which to generate keys
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
         @throws std::logic_error if the encryption parameters do not support batching
         and scheme is scheme_type::BFV
         @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
         @throws std::invalid_argument if the step counts are not valid
         */
         GaloisKeys galois_keys(int decomposition_bit_count,
-            const std::vector<int> &steps);
+            const std::vector<int> &steps, std::size_t thread_count = 0);
 
         /**
         Generates and returns Galois keys. This function creates logarithmically 
@@ -141,9 +158,65 @@ namespace seal
         users will want to use this overload of the function. 
 
         @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        */
+        GaloisKeys galois_keys(int decomposition_bit_count, 
+            std::size_t thread_count = 0);
+
+        /**
+        Generates Galois keys for the given Galois elements as galois_keys does, 
+        and saves them to an output stream as GaloisKeys::save would save them. 
+        Each key is written as soon as it has been generated, so only as many 
+        keys as there are threads are held in memory at a time, rather than all 
+        of them. The result can be loaded with GaloisKeys::load. The output 
+        stream must have the "binary" flag set.
+
+        @param[out] stream The stream to save the Galois keys to
+        @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] galois_elts The Galois elements for which to generate keys
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::invalid_argument if the Galois elements are not valid
+        @throws std::exception if the keys could not be written to stream
+        */
+        void save_galois_keys(std::ostream &stream, int decomposition_bit_count,
+            const std::vector<std::uint64_t> &galois_elts, 
+            std::size_t thread_count = 0);
+
+        /**
+        Generates Galois keys for the given rotation step counts and saves them to 
+        an output stream as they are generated, as save_galois_keys does for 
+        Galois elements.
+
+        @param[out] stream The stream to save the Galois keys to
+        @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] steps The rotation step counts for which to generate keys
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::invalid_argument if the step counts are not valid
+        @throws std::exception if the keys could not be written to stream
+        */
+        void save_galois_keys(std::ostream &stream, int decomposition_bit_count,
+            const std::vector<int> &steps, std::size_t thread_count = 0);
+
+        /**
+        Generates the logarithmically many Galois keys that galois_keys creates 
+        by default and saves them to an output stream as they are generated.
+
+        @param[out] stream The stream to save the Galois keys to
+        @param[in] decomposition_bit_count The decomposition bit count
+        @param[in] thread_count The maximum number of threads to use; zero means 
+        all hardware threads
         @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::exception if the keys could not be written to stream
         */
-        GaloisKeys galois_keys(int decomposition_bit_count);
+        void save_galois_keys(std::ostream &stream, int decomposition_bit_count, 
+            std::size_t thread_count = 0);
 
     private:
         KeyGenerator(const KeyGenerator &copy) = delete;
@@ -175,6 +248,56 @@ namespace seal
             int decomposition_bit_count,
             std::vector<std::vector<std::uint64_t>> &decomposition_factors) const;
 
+        /**
+        Returns the Galois elements for the given rotation step counts.
+        */
+        std::vector<std::uint64_t> steps_to_galois_elts(
+            const std::vector<int> &steps) const;
+
+        /**
+        Returns the Galois elements of the keys that galois_keys generates by 
+        default.
+        */
+        std::vector<std::uint64_t> default_galois_elts() const;
+
+        /**
+        Checks that the Galois elements are valid and returns them with 
+        duplicates removed.
+        */
+        std::vector<std::uint64_t> validate_galois_elts(
+            const SEALContext::ContextData &context_data,
+            const std::vector<std::uint64_t> &galois_elts) const;
+
+        /**
+        Allocates the components of a key-switching key in destination.
+        */
+        void allocate_key(const SEALContext::ContextData &context_data,
+            const std::vector<std::vector<std::uint64_t>> &decomposition_factors,
+            std::vector<Ciphertext> &destination, MemoryPoolHandle pool) const;
+
+        /**
+        Allocates and generates the Galois key for galois_elts[i] in 
+        *destination[i], using up to thread_count threads for all keys together.
+        */
+        void generate_galois_keys(const SEALContext::ContextData &context_data,
+            const std::vector<std::vector<std::uint64_t>> &decomposition_factors,
+            const std::vector<std::uint64_t> &galois_elts,
+            const std::vector<std::vector<Ciphertext>*> &destination,
+            MemoryPoolHandle pool, std::size_t thread_count) const;
+
+        /**
+        Generates the component of a key switching to the secret key from 
+        new_key that belongs to the decomposition_index-th coefficient modulus.
+        The destination must already have the right size. Temporary values are
+        allocated from pool.
+        */
+        void generate_key_component(const SEALContext::ContextData &context_data,
+            const std::vector<std::uint64_t> &decomposition_factors,
+            std::size_t decomposition_index, const std::uint64_t *new_key,
+            Ciphertext &destination,
+            std::shared_ptr<UniformRandomGenerator> random,
+            MemoryPoolHandle pool) const;
+
         /**
         Generates new secret key.
         */
@@ -225,6 +225,22 @@ namespace seal
             return pool_->alloc_byte_count();
         }
 
+        /**
+        Returns whether the memory pool pointed to by the current MemoryPoolHandle
+        can be used by several threads at the same time. This is false only for
+        the thread-local memory pools.
+
+        @throws std::logic_error if the MemoryPoolHandle is uninitialized
+        */
+        inline bool is_thread_safe() const
+        {
+            if (!pool_)
+            {
+                throw std::logic_error("pool not initialized");
+            }
+            return pool_->is_thread_safe();
+        }
+
         /**
         Returns whether the MemoryPoolHandle is initialized.
         */
@@ -3,6 +3,8 @@
 
 #include "seal/plaintext.h"
 #include "seal/util/common.h"
+#include "seal/util/polycore.h"
+#include "seal/util/serialization.h"
 
 using namespace std;
 using namespace seal::util;
@@ -221,15 +223,12 @@ namespace seal
             size_t poly_modulus_degree = parms.poly_modulus_degree();
 
             const pt_coeff_type *ptr = data();
-            for (size_t j = 0; j < coeff_mod_count; j++)
+            for (size_t j = 0; j < coeff_mod_count; j++, ptr += poly_modulus_degree)
             {
-                uint64_t modulus = coeff_modulus[j].value();
-                for (size_t k = 0; k < poly_modulus_degree; k++, ptr++)
+                if (!are_poly_coefficients_less_than(ptr, poly_modulus_degree,
+                    coeff_modulus[j].value()))
                 {
-                    if (*ptr >= modulus)
-                    {
-                        return false;
-                    }
+                    return false;
                 }
             }
         }
@@ -237,13 +236,9 @@ namespace seal
         {
             auto &parms = context->context_data()->parms();
             uint64_t modulus = parms.plain_modulus().value(); 
-            const pt_coeff_type *ptr = data();
-            for (size_t k = 0; k < data_.size(); k++, ptr++)
+            if (!are_poly_coefficients_less_than(data(), data_.size(), modulus))
             {
-                if (*ptr >= modulus)
-                {
-                    return false;
-                }
+                return false;
             }
         }
 
@@ -292,7 +287,7 @@ namespace seal
         return true;
     }
 
-    void Plaintext::save(ostream &stream) const
+    void Plaintext::save(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -300,9 +295,8 @@ namespace seal
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            stream.write(reinterpret_cast<const char*>(&parms_id_), sizeof(parms_id_type));
-            stream.write(reinterpret_cast<const char*>(&scale_), sizeof(double));
-            data_.save(stream);
+            save_versioned(stream, compr_mode,
+                [this](ostream &members_stream) { save_members(members_stream); });
         }
         catch (const exception &)
         {
@@ -315,30 +309,54 @@ namespace seal
 
     void Plaintext::unsafe_load(istream &stream)
     {
+        load_checked(stream);
+    }
+
+    size_t Plaintext::save_size(compr_mode_type compr_mode) const
+    {
+        if (compr_mode == compr_mode_type::none)
+        {
+            return versioned_save_size(members_save_size());
+        }
+        return compute_save_size(
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t Plaintext::save(SEAL_BYTE *out, size_t size, compr_mode_type compr_mode) const
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t Plaintext::unsafe_load(const SEAL_BYTE *in, size_t size)
+    {
+        return load_from_buffer(in, size,
+            [this](istream &stream) { unsafe_load(stream); });
+    }
+
+    bool Plaintext::load_checked(istream &stream)
+    {
+        bool verified = false;
         auto old_except_mask = stream.exceptions();
         try
         {
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            parms_id_type parms_id{};
-            stream.read(reinterpret_cast<char*>(&parms_id), sizeof(parms_id_type));
-
-            double scale = 0;
-            stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
-
-            // Load the data
-            IntArray<pt_coeff_type> new_data(data_.pool());
-            new_data.load(stream);
-
-            // Set the parms_id
-            parms_id_ = parms_id;
-
-            // Set the scale
-            scale_ = scale;
-
-            // Set the data
-            data_.swap_with(new_data);
+            // Plaintexts saved before the versioned format was introduced start
+            // directly with the parms_id
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic == serialization_magic)
+            {
+                load_versioned(stream,
+                    [this](istream &members_stream) { load_members(members_stream); });
+                verified = true;
+            }
+            else
+            {
+                load_legacy(stream, magic);
+            }
         }
         catch (const exception &)
         {
@@ -347,5 +365,76 @@ namespace seal
         }
 
         stream.exceptions(old_except_mask);
+        return verified;
+    }
+
+    size_t Plaintext::members_save_size() const
+    {
+        int bit_count = get_max_significant_bit_count(data_.cbegin(), data_.size());
+        return add_safe(sizeof(parms_id_type) + sizeof(double) + sizeof(uint64_t) +
+            sizeof(SEAL_BYTE), packed_uint_save_size(data_.size(), bit_count));
+    }
+
+    void Plaintext::save_members(ostream &stream) const
+    {
+        stream.write(reinterpret_cast<const char*>(&parms_id_), sizeof(parms_id_type));
+        stream.write(reinterpret_cast<const char*>(&scale_), sizeof(double));
+
+        // The coefficients are packed to the bit count of the largest one
+        uint64_t coeff_count64 = safe_cast<uint64_t>(data_.size());
+        stream.write(reinterpret_cast<const char*>(&coeff_count64), sizeof(uint64_t));
+        SEAL_BYTE bit_count = static_cast<SEAL_BYTE>(
+            get_max_significant_bit_count(data_.cbegin(), data_.size()));
+        stream.write(reinterpret_cast<const char*>(&bit_count), sizeof(SEAL_BYTE));
+        save_packed_uint(data_.cbegin(), data_.size(), static_cast<int>(bit_count), stream);
+    }
+
+    void Plaintext::load_members(istream &stream)
+    {
+        parms_id_type parms_id{};
+        stream.read(reinterpret_cast<char*>(&parms_id), sizeof(parms_id_type));
+        double scale = 0;
+        stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
+
+        // Load the data
+        uint64_t coeff_count64 = 0;
+        stream.read(reinterpret_cast<char*>(&coeff_count64), sizeof(uint64_t));
+        SEAL_BYTE bit_count;
+        stream.read(reinterpret_cast<char*>(&bit_count), sizeof(SEAL_BYTE));
+        IntArray<pt_coeff_type> new_data(safe_cast<size_type>(coeff_count64), data_.pool());
+        load_packed_uint(stream, new_data.size(), static_cast<int>(bit_count),
+            new_data.begin());
+
+        // Set the parms_id
+        parms_id_ = parms_id;
+
+        // Set the scale
+        scale_ = scale;
+
+        // Set the data
+        data_.swap_with(new_data);
+    }
+
+    void Plaintext::load_legacy(istream &stream, uint64_t parms_id_word)
+    {
+        parms_id_type parms_id{};
+        parms_id[0] = parms_id_word;
+        stream.read(reinterpret_cast<char*>(parms_id.data() + 1),
+            sizeof(parms_id_type) - sizeof(uint64_t));
+        double scale = 0;
+        stream.read(reinterpret_cast<char*>(&scale), sizeof(double));
+
+        // Load the data
+        IntArray<pt_coeff_type> new_data(data_.pool());
+        new_data.load(stream);
+
+        // Set the parms_id
+        parms_id_ = parms_id;
+
+        // Set the scale
+        scale_ = scale;
+
+        // Set the data
+        data_.swap_with(new_data);
     }
 }
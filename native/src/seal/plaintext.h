@@ -15,6 +15,7 @@
 #include "seal/encryptionparams.h"
 #include "seal/intarray.h"
 #include "seal/context.h"
+#include "seal/serialization.h"
 
 namespace seal
 {
@@ -527,13 +528,19 @@ namespace seal
         bool is_metadata_valid_for(std::shared_ptr<const SEALContext> context) const;
 
         /**
-        Saves the plaintext to an output stream. The output is in binary format 
+        Saves the plaintext to an output stream. The output is in binary format
         and not human-readable. The output stream must have the "binary" flag set.
+        The coefficients are bit-packed to the number of bits they actually use,
+        and plaintexts saved in the older unpacked format can still be loaded.
+        The output can optionally be compressed; load detects this automatically.
 
         @param[in] stream The stream to save the plaintext to
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
         @throws std::exception if the plaintext could not be written to stream
         */
-        void save(std::ostream &stream) const;
+        void save(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
 
         /**
         Loads a plaintext from an input stream overwriting the current plaintext.
@@ -568,6 +575,98 @@ namespace seal
             }
         }
 
+        /**
+        Loads a plaintext from an input stream overwriting the current plaintext, and
+        verifies it to be valid for the given SEALContext like load does. The
+        data is verified against its stored checksum instead of checking every
+        coefficient, and only the metadata of the plaintext is validated. Data in
+        the layout that preceded the versioned format has no checksum and is
+        validated fully. The checksum detects
+        corrupted data but not deliberately modified data, so this function
+        should only be used for data from trusted storage.
+
+        @param[in] context The SEALContext
+        @param[in] stream The stream to load the plaintext from
+        @throws std::invalid_argument if the context is not set or encryption
+        parameters are not valid
+        @throws std::exception if a valid plaintext could not be read from stream
+        @throws std::invalid_argument if the data does not match its checksum
+        @throws std::invalid_argument if the loaded plaintext is invalid for the
+        context
+        */
+        inline void trusted_load(std::shared_ptr<SEALContext> context,
+            std::istream &stream)
+        {
+            bool verified = load_checked(stream);
+            if (verified ? !is_metadata_valid_for(std::move(context)) :
+                !is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("Plaintext data is invalid");
+            }
+        }
+
+        /**
+        Returns the exact number of bytes that save writes for the plaintext with the
+        given compression mode, for allocating a buffer to save to. With compression
+        enabled the plaintext is compressed to determine the size.
+
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save_size(
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Saves the plaintext to a buffer in the format that save writes to a stream,
+        without intermediate copies. Returns the number of bytes written.
+
+        @param[out] out The buffer to save the plaintext to
+        @param[in] size The size of the buffer in bytes
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the plaintext does not fit in size bytes
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        std::size_t save(SEAL_BYTE *out, std::size_t size,
+            compr_mode_type compr_mode = compr_mode_type::none) const;
+
+        /**
+        Loads a plaintext from a buffer overwriting the current plaintext, and returns
+        the number of bytes read. No checking of the validity of the plaintext
+        data against encryption parameters is performed. This function should
+        not be used unless the plaintext comes from a fully trusted source.
+
+        @param[in] in The buffer to load the plaintext from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid plaintext could not be read from in
+        */
+        std::size_t unsafe_load(const SEAL_BYTE *in, std::size_t size);
+
+        /**
+        Loads a plaintext from a buffer overwriting the current plaintext, and returns
+        the number of bytes read. The loaded plaintext is verified to be valid
+        for the given SEALContext.
+
+        @param[in] context The SEALContext
+        @param[in] in The buffer to load the plaintext from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid plaintext could not be read from in
+        @throws std::invalid_argument if the loaded plaintext is invalid for the
+        context
+        */
+        inline std::size_t load(std::shared_ptr<SEALContext> context,
+            const SEAL_BYTE *in, std::size_t size)
+        {
+            std::size_t read_count = unsafe_load(in, size);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("Plaintext data is invalid");
+            }
+            return read_count;
+        }
+
         /**
         Returns whether the plaintext is in NTT form.
         */
@@ -631,6 +730,34 @@ namespace seal
         struct PlaintextPrivateHelper;
 
     private:
+        /**
+        Does the work of unsafe_load. Returns true if the data was verified
+        against a stored checksum, which is the case unless it is in the layout
+        that preceded the versioned format.
+        */
+        bool load_checked(std::istream &stream);
+
+        /**
+        Returns the number of bytes save_members writes.
+        */
+        std::size_t members_save_size() const;
+
+        /**
+        Writes the members following the versioned serialization header.
+        */
+        void save_members(std::ostream &stream) const;
+
+        /**
+        Reads the members written by save_members.
+        */
+        void load_members(std::istream &stream);
+
+        /**
+        Reads a plaintext saved in the format preceding the versioned one. The
+        first word of the parms_id has already been read.
+        */
+        void load_legacy(std::istream &stream, std::uint64_t parms_id_word);
+
         parms_id_type parms_id_ = parms_id_zero;
 
         double scale_ = 1.0;
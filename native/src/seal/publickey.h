@@ -121,13 +121,17 @@ namespace seal
         /**
         Saves the PublicKey to an output stream. The output is in binary format
         and not human-readable. The output stream must have the "binary" flag set.
+        Compression is selected with compr_mode and is undone by load.
 
         @param[in] stream The stream to save the PublicKey to
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
         @throws std::exception if the PublicKey could not be written to stream
         */
-        inline void save(std::ostream &stream) const
+        inline void save(std::ostream &stream,
+            compr_mode_type compr_mode = compr_mode_type::none) const
         {
-            pk_.save(stream);
+            pk_.save(stream, compr_mode);
         }
 
         /**
@@ -166,6 +170,76 @@ namespace seal
             }
         }
 
+        /**
+        Returns the exact number of bytes that save writes for the PublicKey with
+        the given compression mode.
+
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        inline std::size_t save_size(
+            compr_mode_type compr_mode = compr_mode_type::none) const
+        {
+            return pk_.save_size(compr_mode);
+        }
+
+        /**
+        Saves the PublicKey to a buffer in the format that save writes to a stream,
+        and returns the number of bytes written.
+
+        @param[out] out The buffer to save the PublicKey to
+        @param[in] size The size of the buffer in bytes
+        @param[in] compr_mode The compression mode
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the PublicKey does not fit in size bytes
+        @throws std::invalid_argument if compr_mode is not valid
+        */
+        inline std::size_t save(SEAL_BYTE *out, std::size_t size,
+            compr_mode_type compr_mode = compr_mode_type::none) const
+        {
+            return pk_.save(out, size, compr_mode);
+        }
+
+        /**
+        Loads a PublicKey from a buffer overwriting the current PublicKey, and returns
+        the number of bytes read. No checking of the validity of the PublicKey data
+        against encryption parameters is performed. This function should not be
+        used unless the PublicKey comes from a fully trusted source.
+
+        @param[in] in The buffer to load the PublicKey from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid PublicKey could not be read from in
+        */
+        inline std::size_t unsafe_load(const SEAL_BYTE *in, std::size_t size)
+        {
+            return pk_.unsafe_load(in, size);
+        }
+
+        /**
+        Loads a PublicKey from a buffer overwriting the current PublicKey, and returns
+        the number of bytes read. The loaded PublicKey is verified to be valid for
+        the given SEALContext.
+
+        @param[in] context The SEALContext
+        @param[in] in The buffer to load the PublicKey from
+        @param[in] size The size of the buffer in bytes
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if a valid PublicKey could not be read from in
+        @throws std::invalid_argument if the loaded PublicKey is invalid for the
+        context
+        */
+        inline std::size_t load(std::shared_ptr<SEALContext> context,
+            const SEAL_BYTE *in, std::size_t size)
+        {
+            std::size_t read_count = unsafe_load(in, size);
+            if (!is_valid_for(std::move(context)))
+            {
+                throw std::invalid_argument("PublicKey data is invalid");
+            }
+            return read_count;
+        }
+
         /**
         Returns a reference to parms_id.
         */
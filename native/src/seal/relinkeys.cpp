@@ -4,12 +4,19 @@
 #include "seal/relinkeys.h"
 #include "seal/util/defines.h"
 #include <stdexcept>
+#include "seal/util/serialization.h"
+#include "seal/util/mappedkeys.h"
 
 using namespace std;
 using namespace seal::util;
 
 namespace seal
 {
+    RelinKeys::RelinKeys(const RelinKeys &copy) : pool_(copy.pool_)
+    {
+        *this = copy;
+    }
+
     RelinKeys &RelinKeys::operator =(const RelinKeys &assign)
     {
         // Check for self-assignment
@@ -24,6 +31,8 @@ namespace seal
 
         // Then copy over keys
         keys_.clear();
+        mapping_.reset();
+        storage_.clear();
         size_t keys_dim1 = assign.keys_.size();
         keys_.reserve(keys_dim1);
         for (size_t i = 0; i < keys_dim1; i++)
@@ -36,6 +45,10 @@ namespace seal
                 keys_[i].emplace_back(pool_);
                 keys_[i][j] = assign.keys_[i][j];
             }
+            if (keys_dim2)
+            {
+                storage_.emplace_back(Ciphertext::make_contiguous(keys_[i], pool_));
+            }
         }
 
         return *this;
@@ -92,7 +105,7 @@ namespace seal
         return true;
     }
 
-    void RelinKeys::save(std::ostream &stream) const
+    void RelinKeys::save(ostream &stream, compr_mode_type compr_mode) const
     {
         auto old_except_mask = stream.exceptions();
         try
@@ -100,117 +113,236 @@ namespace seal
             // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
             stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            uint64_t keys_dim1 = static_cast<uint64_t>(keys_.size());
+            save_versioned(stream, compr_mode,
+                [this](ostream &members_stream) { save_members(members_stream); });
+        }
+        catch (const exception &)
+        {
+            stream.exceptions(old_except_mask);
+            throw;
+        }
 
-            // Validate keys_dim1 (relinearization key count)
-            if (keys_dim1 < SEAL_RELIN_KEY_COUNT_MIN ||
-                keys_dim1 > SEAL_RELIN_KEY_COUNT_MAX)
-            {
-                throw invalid_argument("count out of bounds");
-            }
+        stream.exceptions(old_except_mask);
+    }
 
-            int32_t decomposition_bit_count32 =
-                safe_cast<int32_t>(decomposition_bit_count_);
+    void RelinKeys::unsafe_load(istream &stream)
+    {
+        load_checked(stream);
+    }
 
-            // Save the parms_id
-            stream.write(reinterpret_cast<const char*>(&parms_id_),
-                sizeof(parms_id_type));
+    size_t RelinKeys::save_size(compr_mode_type compr_mode) const
+    {
+        if (compr_mode == compr_mode_type::none)
+        {
+            return versioned_save_size(members_save_size());
+        }
+        return compute_save_size(
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
+
+    size_t RelinKeys::save(SEAL_BYTE *out, size_t size, compr_mode_type compr_mode) const
+    {
+        return save_to_buffer(out, size,
+            [&](ostream &stream) { save(stream, compr_mode); });
+    }
 
-            // Save the decomposition bit count
-            stream.write(reinterpret_cast<const char*>(&decomposition_bit_count32),
-                sizeof(int32_t));
+    size_t RelinKeys::unsafe_load(const SEAL_BYTE *in, size_t size)
+    {
+        return load_from_buffer(in, size,
+            [this](istream &stream) { unsafe_load(stream); });
+    }
 
-            // Save the size of keys_
-            stream.write(reinterpret_cast<const char*>(&keys_dim1), sizeof(uint64_t));
+    bool RelinKeys::load_checked(istream &stream)
+    {
+        bool verified = false;
+        auto old_except_mask = stream.exceptions();
+        try
+        {
+            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+            stream.exceptions(ios_base::badbit | ios_base::failbit);
 
-            // Now loop again over keys_dim1
-            for (size_t index = 0; index < keys_dim1; index++)
+            // Keys saved before the versioned format was introduced start
+            // directly with the parms_id
+            uint64_t magic = 0;
+            stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+            if (magic == serialization_magic)
             {
-                // Save second dimension of keys_
-                uint64_t keys_dim2 = static_cast<uint64_t>(keys_[index].size());
-                stream.write(reinterpret_cast<const char*>(&keys_dim2), sizeof(uint64_t));
-
-                // Loop over keys_dim2 and save all (or none)
-                for (size_t j = 0; j < keys_dim2; j++)
+                load_versioned(stream, [this](istream &members_stream)
                 {
-                    // Save the key
-                    keys_[index][j].save(stream);
-                }
+                    uint64_t parms_id_word = 0;
+                    members_stream.read(reinterpret_cast<char*>(&parms_id_word),
+                        sizeof(uint64_t));
+                    load_members(members_stream, parms_id_word);
+                });
+                verified = true;
             }
+            else
+            {
+                load_members(stream, magic);
+            }
+            make_contiguous();
         }
-        catch (const std::exception &)
+        catch (const exception &)
         {
             stream.exceptions(old_except_mask);
             throw;
         }
 
         stream.exceptions(old_except_mask);
+        return verified;
     }
 
-    void RelinKeys::unsafe_load(std::istream &stream)
+    size_t RelinKeys::members_save_size() const
     {
-        auto old_except_mask = stream.exceptions();
-        try
+        size_t members_size = sizeof(parms_id_type) + sizeof(int32_t) + sizeof(uint64_t);
+        for (auto &key : keys_)
         {
-            // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
-            stream.exceptions(ios_base::badbit | ios_base::failbit);
+            members_size = add_safe(members_size, sizeof(uint64_t));
+            for (auto &key_component : key)
+            {
+                members_size = add_safe(members_size, key_component.save_size());
+            }
+        }
+        return members_size;
+    }
+
+    void RelinKeys::save_members(ostream &stream) const
+    {
+        uint64_t keys_dim1 = static_cast<uint64_t>(keys_.size());
+
+        // Validate keys_dim1 (relinearization key count)
+        if (keys_dim1 < SEAL_RELIN_KEY_COUNT_MIN ||
+            keys_dim1 > SEAL_RELIN_KEY_COUNT_MAX)
+        {
+            throw invalid_argument("count out of bounds");
+        }
 
-            // Clear current keys
-            keys_.clear();
+        int32_t decomposition_bit_count32 =
+            safe_cast<int32_t>(decomposition_bit_count_);
 
-            // Read the parms_id
-            stream.read(reinterpret_cast<char*>(&parms_id_),
-                sizeof(parms_id_type));
+        // Save the parms_id
+        stream.write(reinterpret_cast<const char*>(&parms_id_),
+            sizeof(parms_id_type));
 
-            // Read and validate the decomposition_bit_count
-            int32_t decomposition_bit_count32 = 0;
-            stream.read(reinterpret_cast<char*>(&decomposition_bit_count32),
-                sizeof(int32_t));
-            if (decomposition_bit_count32 < SEAL_DBC_MIN ||
-                decomposition_bit_count32 > SEAL_DBC_MAX)
-            {
-                throw logic_error("decomposition bit count out of bounds");
-            }
-            decomposition_bit_count_ = safe_cast<int>(decomposition_bit_count32);
+        // Save the decomposition bit count
+        stream.write(reinterpret_cast<const char*>(&decomposition_bit_count32),
+            sizeof(int32_t));
 
-            // Read in the size of keys_
-            uint64_t keys_dim1 = 0;
-            stream.read(reinterpret_cast<char*>(&keys_dim1), sizeof(uint64_t));
+        // Save the size of keys_
+        stream.write(reinterpret_cast<const char*>(&keys_dim1), sizeof(uint64_t));
 
-            // Validate keys_dim1 (relinearization key count)
-            if (keys_dim1 < SEAL_RELIN_KEY_COUNT_MIN ||
-                keys_dim1 > SEAL_RELIN_KEY_COUNT_MAX)
+        // Now loop again over keys_dim1
+        for (size_t index = 0; index < keys_dim1; index++)
+        {
+            // Save second dimension of keys_
+            uint64_t keys_dim2 = static_cast<uint64_t>(keys_[index].size());
+            stream.write(reinterpret_cast<const char*>(&keys_dim2), sizeof(uint64_t));
+
+            // Loop over keys_dim2 and save all (or none)
+            for (size_t j = 0; j < keys_dim2; j++)
             {
-                throw invalid_argument("count out of bounds");
+                // Save the key
+                keys_[index][j].save(stream);
             }
+        }
+    }
 
-            // Reserve first for dimension of keys_
-            keys_.reserve(safe_cast<size_t>(keys_dim1));
+    void RelinKeys::load_members(istream &stream, uint64_t parms_id_word)
+    {
+        // Clear current keys
+        keys_.clear();
+        mapping_.reset();
+        storage_.clear();
+
+        // Read the rest of the parms_id
+        parms_id_[0] = parms_id_word;
+        stream.read(reinterpret_cast<char*>(parms_id_.data() + 1),
+            sizeof(parms_id_type) - sizeof(uint64_t));
+
+        // Read and validate the decomposition_bit_count
+        int32_t decomposition_bit_count32 = 0;
+        stream.read(reinterpret_cast<char*>(&decomposition_bit_count32),
+            sizeof(int32_t));
+        if (decomposition_bit_count32 < SEAL_DBC_MIN ||
+            decomposition_bit_count32 > SEAL_DBC_MAX)
+        {
+            throw logic_error("decomposition bit count out of bounds");
+        }
+        decomposition_bit_count_ = safe_cast<int>(decomposition_bit_count32);
+
+        // Read in the size of keys_
+        uint64_t keys_dim1 = 0;
+        stream.read(reinterpret_cast<char*>(&keys_dim1), sizeof(uint64_t));
+
+        // Validate keys_dim1 (relinearization key count)
+        if (keys_dim1 < SEAL_RELIN_KEY_COUNT_MIN ||
+            keys_dim1 > SEAL_RELIN_KEY_COUNT_MAX)
+        {
+            throw invalid_argument("count out of bounds");
+        }
+
+        // Reserve first for dimension of keys_
+        keys_.reserve(safe_cast<size_t>(keys_dim1));
+
+        // Loop over the first dimension of keys_
+        for (size_t index = 0; index < keys_dim1; index++)
+        {
+            // Read the size of the second dimension
+            uint64_t keys_dim2 = 0;
+            stream.read(reinterpret_cast<char*>(&keys_dim2), sizeof(uint64_t));
 
-            // Loop over the first dimension of keys_
-            for (size_t index = 0; index < keys_dim1; index++)
+            // Don't resize; only reserve
+            keys_.emplace_back();
+            keys_.back().reserve(safe_cast<size_t>(keys_dim2));
+            for (size_t j = 0; j < keys_dim2; j++)
             {
-                // Read the size of the second dimension
-                uint64_t keys_dim2 = 0;
-                stream.read(reinterpret_cast<char*>(&keys_dim2), sizeof(uint64_t));
-
-                // Don't resize; only reserve
-                keys_.emplace_back();
-                keys_.back().reserve(safe_cast<size_t>(keys_dim2));
-                for (size_t j = 0; j < keys_dim2; j++)
-                {
-                    Ciphertext new_key(pool_);
-                    new_key.unsafe_load(stream);
-                    keys_[index].emplace_back(move(new_key));
-                }
+                Ciphertext new_key(pool_);
+                new_key.unsafe_load(stream);
+                keys_[index].emplace_back(move(new_key));
             }
         }
-        catch (const std::exception &)
+    }
+
+    void RelinKeys::save_mappable(ostream &stream) const
+    {
+        MappedKeys::save(stream, parms_id_, decomposition_bit_count_, keys_);
+    }
+
+    void RelinKeys::unsafe_load_mapped(const string &path)
+    {
+        auto mapping = make_shared<MappedFile>(path);
+        parms_id_type parms_id;
+        int decomposition_bit_count;
+        vector<vector<Ciphertext>> new_keys;
+        MappedKeys::load(*mapping, pool_, parms_id, decomposition_bit_count,
+            new_keys);
+        if (decomposition_bit_count < SEAL_DBC_MIN ||
+            decomposition_bit_count > SEAL_DBC_MAX)
         {
-            stream.exceptions(old_except_mask);
-            throw;
+            throw logic_error("decomposition bit count out of bounds");
+        }
+        if (new_keys.size() < SEAL_RELIN_KEY_COUNT_MIN ||
+            new_keys.size() > SEAL_RELIN_KEY_COUNT_MAX)
+        {
+            throw invalid_argument("count out of bounds");
         }
 
-        stream.exceptions(old_except_mask);
+        // Set values; the old keys are released before their mapping
+        parms_id_ = parms_id;
+        decomposition_bit_count_ = decomposition_bit_count;
+        keys_ = move(new_keys);
+        mapping_ = move(mapping);
+        storage_.clear();
+    }
+
+    void RelinKeys::make_contiguous()
+    {
+        for (auto &key : keys_)
+        {
+            if (!key.empty())
+            {
+                storage_.emplace_back(Ciphertext::make_contiguous(key, pool_));
+            }
+        }
     }
 }
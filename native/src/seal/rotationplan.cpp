@@ -0,0 +1,375 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "seal/rotationplan.h"
+#include "seal/util/common.h"
+#include "seal/util/defines.h"
+#include "seal/util/uintarithsmallmod.h"
+
+using namespace std;
+using namespace seal::util;
+
+namespace seal
+{
+    namespace
+    {
+        constexpr size_t unreachable = numeric_limits<size_t>::max();
+    }
+
+    RotationPlan::RotationPlan(shared_ptr<SEALContext> context,
+        const map<int, double> &step_frequencies, size_t memory_budget,
+        int decomposition_bit_count)
+    {
+        // Verify parameters
+        if (!context)
+        {
+            throw invalid_argument("invalid context");
+        }
+        if (!context->parameters_set())
+        {
+            throw invalid_argument("encryption parameters are not set correctly");
+        }
+        auto &context_data = *context->context_data();
+        if (!context_data.qualifiers().using_batching)
+        {
+            throw logic_error("encryption parameters do not support batching");
+        }
+        if (decomposition_bit_count < SEAL_DBC_MIN ||
+            decomposition_bit_count > SEAL_DBC_MAX)
+        {
+            throw invalid_argument("decomposition_bit_count is not in the valid range");
+        }
+
+        auto &parms = context_data.parms();
+        auto &coeff_modulus = parms.coeff_modulus();
+        parms_id_ = parms.parms_id();
+        coeff_count_ = parms.poly_modulus_degree();
+        row_size_ = coeff_count_ >> 1;
+        decomposition_bit_count_ = decomposition_bit_count;
+
+        // A key has two polynomials for each decomposition factor, which are
+        // as many as there are decomposition_bit_count-bit words in each prime
+        size_t key_poly_count = 0;
+        for (auto &mod : coeff_modulus)
+        {
+            key_poly_count = add_safe(key_poly_count, size_t(2) *
+                static_cast<size_t>(divide_round_up(mod.bit_count(),
+                decomposition_bit_count)));
+        }
+        key_byte_count_ = mul_safe(key_poly_count, coeff_count_,
+            coeff_modulus.size(), sizeof(uint64_t));
+        size_t max_key_count = memory_budget / key_byte_count_;
+
+        // Collect the rotations as left rotations; rotations by zero steps
+        // need no keys
+        map<size_t, double> weights;
+        for (auto &step_frequency : step_frequencies)
+        {
+            if (!isfinite(step_frequency.second) || step_frequency.second < 0)
+            {
+                throw invalid_argument("frequency is not valid");
+            }
+            size_t rotation = normalize_steps(step_frequency.first);
+            if (rotation)
+            {
+                weights[rotation] += step_frequency.second;
+            }
+        }
+        vector<size_t> rotations;
+        vector<double> rotation_weights;
+        for (auto &weight : weights)
+        {
+            rotations.push_back(weight.first);
+            rotation_weights.push_back(weight.second);
+        }
+
+        // Extends a base key set with keys for single rotations while the
+        // budget allows, the largest savings first, and keeps the result if it
+        // is better than the best one so far
+        double best_cost = numeric_limits<double>::infinity();
+        vector<size_t> best_keys;
+        vector<char> in_base(row_size_, 0);
+        auto consider = [&](const vector<size_t> &base, vector<size_t> costs)
+        {
+            if (base.size() > max_key_count)
+            {
+                return;
+            }
+            vector<size_t> keys(base);
+            for (auto key : keys)
+            {
+                in_base[key] = 1;
+            }
+            vector<size_t> candidates;
+            for (size_t i = 0; i < rotations.size(); i++)
+            {
+                if (costs[i] > 1 && !in_base[rotations[i]])
+                {
+                    candidates.push_back(i);
+                }
+            }
+            for (auto key : keys)
+            {
+                in_base[key] = 0;
+            }
+            stable_sort(candidates.begin(), candidates.end(),
+                [&](size_t a, size_t b)
+                {
+                    return rotation_weights[a] * static_cast<double>(costs[a] - 1) >
+                        rotation_weights[b] * static_cast<double>(costs[b] - 1);
+                });
+            for (size_t i = 0; i < candidates.size() && keys.size() < max_key_count; i++)
+            {
+                keys.push_back(rotations[candidates[i]]);
+                costs[candidates[i]] = 1;
+            }
+
+            double cost = 0;
+            for (size_t i = 0; i < rotations.size(); i++)
+            {
+                cost += rotation_weights[i] * static_cast<double>(costs[i]);
+            }
+            if (cost < best_cost || (cost == best_cost && keys.size() < best_keys.size()))
+            {
+                best_cost = cost;
+                best_keys = move(keys);
+            }
+        };
+
+        // Baby-step/giant-step bases: with base b, a rotation by r steps is
+        // done by r mod b steps and r - (r mod b) steps, or on more levels by
+        // the digits of r in base b. Rotations may instead go right by the
+        // steps that remain to a full row: either all of them, or those that
+        // take fewer keys that way. With b larger than every rotation, this
+        // gives one key per rotation.
+        auto find_terms = [&](size_t value, size_t b, bool all_digits,
+            vector<size_t> &terms)
+        {
+            terms.clear();
+            if (!all_digits)
+            {
+                for (auto term : { value % b, value - value % b })
+                {
+                    if (term)
+                    {
+                        terms.push_back(term);
+                    }
+                }
+                return;
+            }
+            for (size_t power = 1; value; value /= b, power *= b)
+            {
+                if (value % b)
+                {
+                    terms.push_back((value % b) * power);
+                }
+            }
+        };
+        if (rotations.empty())
+        {
+            consider({}, {});
+        }
+        size_t max_value = 0;
+        for (auto rotation : rotations)
+        {
+            max_value = max(max_value, min(rotation, row_size_ - rotation));
+        }
+        vector<char> in_keys(row_size_, 0);
+        vector<size_t> left_terms;
+        vector<size_t> right_terms;
+        for (size_t b = 2; b <= max_value + 1; b++)
+        {
+            for (bool all_digits : { false, true })
+            {
+                // On two levels the digits are the same
+                if (all_digits && b * b > max_value)
+                {
+                    continue;
+                }
+
+                // Rotations go left, right, or whichever takes fewer keys
+                for (int direction = 0; direction < 3; direction++)
+                {
+                    vector<size_t> base;
+                    vector<size_t> costs(rotations.size(), 0);
+                    for (size_t i = 0; i < rotations.size(); i++)
+                    {
+                        find_terms(rotations[i], b, all_digits, left_terms);
+                        find_terms(row_size_ - rotations[i], b, all_digits, right_terms);
+                        bool right = (direction == 1) ||
+                            (direction == 2 && right_terms.size() < left_terms.size());
+                        for (auto term : right ? right_terms : left_terms)
+                        {
+                            size_t key = right ? row_size_ - term : term;
+                            if (!in_keys[key])
+                            {
+                                in_keys[key] = 1;
+                                base.push_back(key);
+                            }
+                        }
+                        costs[i] = right ? right_terms.size() : left_terms.size();
+                    }
+                    for (auto key : base)
+                    {
+                        in_keys[key] = 0;
+                    }
+                    consider(base, move(costs));
+                }
+            }
+        }
+
+        // The power-of-two keys reach every rotation
+        {
+            key_steps_.clear();
+            for (size_t power = 1; power < row_size_; power <<= 1)
+            {
+                key_steps_.push_back(safe_cast<int>(power));
+                if (row_size_ - power != power)
+                {
+                    key_steps_.push_back(safe_cast<int>(row_size_ - power));
+                }
+            }
+            auto counts = find_decompositions();
+            vector<size_t> base;
+            for (auto key : key_steps_)
+            {
+                base.push_back(static_cast<size_t>(key));
+            }
+            vector<size_t> costs;
+            for (auto rotation : rotations)
+            {
+                costs.push_back(counts[rotation]);
+            }
+            consider(base, move(costs));
+        }
+
+        if (best_cost == numeric_limits<double>::infinity())
+        {
+            throw invalid_argument("memory_budget is too small for the rotations");
+        }
+
+        // Rotations may take fewer keys than estimated by combining keys in
+        // other ways. Keys that are not used by any rotation are dropped.
+        key_steps_.clear();
+        for (auto key : best_keys)
+        {
+            key_steps_.push_back(safe_cast<int>(key));
+        }
+        sort(key_steps_.begin(), key_steps_.end());
+        find_decompositions();
+        vector<char> used(row_size_, 0);
+        for (auto rotation : rotations)
+        {
+            for (size_t step = rotation; step; )
+            {
+                size_t key = static_cast<size_t>(last_key_step_[step]);
+                used[key] = 1;
+                step = (step + row_size_ - key) % row_size_;
+            }
+        }
+        key_steps_.erase(remove_if(key_steps_.begin(), key_steps_.end(),
+            [&](int key) { return !used[static_cast<size_t>(key)]; }), key_steps_.end());
+        auto counts = find_decompositions();
+
+        double total_weight = 0;
+        double total_cost = 0;
+        for (size_t i = 0; i < rotations.size(); i++)
+        {
+            total_weight += rotation_weights[i];
+            total_cost += rotation_weights[i] * static_cast<double>(counts[rotations[i]]);
+        }
+        expected_key_switch_count_ = (total_weight > 0) ? total_cost / total_weight : 0;
+    }
+
+    vector<uint64_t> RotationPlan::galois_elts() const
+    {
+        vector<uint64_t> result;
+        for (auto key : key_steps_)
+        {
+            result.push_back(steps_to_galois_elt(key, coeff_count_));
+        }
+        return result;
+    }
+
+    vector<int> RotationPlan::decomposition(int steps) const
+    {
+        size_t rotation = normalize_steps(steps);
+        if (rotation && !last_key_step_[rotation])
+        {
+            throw invalid_argument("rotation is not possible with the chosen keys");
+        }
+        vector<int> result;
+        while (rotation)
+        {
+            int key = last_key_step_[rotation];
+            result.push_back(key);
+            rotation = (rotation + row_size_ - static_cast<size_t>(key)) % row_size_;
+        }
+        return result;
+    }
+
+    size_t RotationPlan::key_switch_count(int steps) const
+    {
+        return decomposition(steps).size();
+    }
+
+    GaloisKeys RotationPlan::generate_keys(KeyGenerator &keygen,
+        size_t thread_count) const
+    {
+        if (keygen.secret_key().parms_id() != parms_id_)
+        {
+            throw invalid_argument("keygen is not valid for encryption parameters");
+        }
+        return keygen.galois_keys(decomposition_bit_count_, galois_elts(), thread_count);
+    }
+
+    void RotationPlan::save_keys(KeyGenerator &keygen, ostream &stream,
+        size_t thread_count) const
+    {
+        if (keygen.secret_key().parms_id() != parms_id_)
+        {
+            throw invalid_argument("keygen is not valid for encryption parameters");
+        }
+        keygen.save_galois_keys(stream, decomposition_bit_count_, galois_elts(),
+            thread_count);
+    }
+
+    size_t RotationPlan::normalize_steps(int steps) const
+    {
+        size_t abs_steps = static_cast<size_t>(
+            steps < 0 ? -static_cast<int64_t>(steps) : static_cast<int64_t>(steps));
+        if (abs_steps >= row_size_)
+        {
+            throw invalid_argument("step count too large");
+        }
+        return (steps < 0) ? (row_size_ - abs_steps) % row_size_ : abs_steps;
+    }
+
+    vector<size_t> RotationPlan::find_decompositions()
+    {
+        // Breadth-first search over the rotations, with one edge per key
+        vector<size_t> counts(row_size_, unreachable);
+        last_key_step_.assign(row_size_, 0);
+        vector<size_t> queue{ 0 };
+        counts[0] = 0;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            size_t rotation = queue[head];
+            for (auto key : key_steps_)
+            {
+                size_t next = (rotation + static_cast<size_t>(key)) % row_size_;
+                if (counts[next] == unreachable)
+                {
+                    counts[next] = counts[rotation] + 1;
+                    last_key_step_[next] = key;
+                    queue.push_back(next);
+                }
+            }
+        }
+        return counts;
+    }
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+#include "seal/context.h"
+#include "seal/galoiskeys.h"
+#include "seal/keygenerator.h"
+
+namespace seal
+{
+    /**
+    Chooses the Galois keys to generate for a workload of rotations, and the
+    keys to apply for each of the rotations. Every Galois key costs a lot of
+    memory, and every key that is applied costs a key switching, so a circuit
+    that needs many different rotations has to trade one for the other.
+
+    A RotationPlan is created from the rotation step counts the circuit uses,
+    together with how often each of them is used, and a budget for the memory
+    of the keys. It picks a set of keys that fits in the budget, and among the
+    sets it considers, one that minimizes the expected number of key switchings
+    per rotation. The sets considered are baby-step/giant-step bases for the
+    given steps, the power-of-two keys that KeyGenerator::galois_keys generates
+    by default, and either of these extended with keys for the most frequent
+    steps while the budget allows. Each rotation is then done with the fewest
+    keys possible from the chosen set.
+
+    The keys are generated with generate_keys or save_keys, and the rotations
+    are done by passing the RotationPlan to Evaluator::rotate_rows or
+    Evaluator::rotate_vector.
+
+    @par Step Counts
+    Step counts are those of Evaluator::rotate_rows for BFV and
+    Evaluator::rotate_vector for CKKS. Since rotations are cyclic, the steps
+    of the chosen keys are given as left rotations in [1, N/2), where N is
+    the degree of the polynomial modulus. Column rotations and complex
+    conjugation are not planned.
+    */
+    class RotationPlan
+    {
+    public:
+        /**
+        Creates a RotationPlan for the given rotation step counts.
+
+        @param[in] context The SEALContext
+        @param[in] step_frequencies The rotation step counts the circuit uses,
+        mapped to how often each of them is used
+        @param[in] memory_budget The maximum number of bytes of key data
+        @param[in] decomposition_bit_count The decomposition bit count of the keys
+        @throws std::invalid_argument if the context is not set or encryption
+        parameters are not valid
+        @throws std::logic_error if the encryption parameters do not support batching
+        @throws std::invalid_argument if decomposition_bit_count is not within [1, 60]
+        @throws std::invalid_argument if a step count has too big absolute value
+        @throws std::invalid_argument if a frequency is negative or not finite
+        @throws std::invalid_argument if memory_budget is too small for any of the
+        key sets considered
+        */
+        RotationPlan(std::shared_ptr<SEALContext> context,
+            const std::map<int, double> &step_frequencies,
+            std::size_t memory_budget, int decomposition_bit_count);
+
+        /**
+        Returns the rotation steps of the chosen keys, as left rotations in
+        increasing order.
+        */
+        inline auto &key_steps() const noexcept
+        {
+            return key_steps_;
+        }
+
+        /**
+        Returns the Galois elements of the chosen keys.
+        */
+        std::vector<std::uint64_t> galois_elts() const;
+
+        /**
+        Returns the rotation steps of the keys to apply, one after another, to
+        rotate by the given number of steps. The result is empty for a rotation
+        by zero steps.
+
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the
+        chosen keys
+        */
+        std::vector<int> decomposition(int steps) const;
+
+        /**
+        Returns the number of key switchings a rotation by the given number of
+        steps takes with the chosen keys.
+
+        @param[in] steps The number of steps to rotate (positive left, negative right)
+        @throws std::invalid_argument if steps has too big absolute value
+        @throws std::invalid_argument if the rotation cannot be done with the
+        chosen keys
+        */
+        std::size_t key_switch_count(int steps) const;
+
+        /**
+        Returns the average number of key switchings per rotation in the workload,
+        weighted by the frequencies.
+        */
+        inline double expected_key_switch_count() const noexcept
+        {
+            return expected_key_switch_count_;
+        }
+
+        /**
+        Returns the number of bytes of key data in one Galois key.
+        */
+        inline std::size_t key_byte_count() const noexcept
+        {
+            return key_byte_count_;
+        }
+
+        /**
+        Returns the decomposition bit count of the keys.
+        */
+        inline int decomposition_bit_count() const noexcept
+        {
+            return decomposition_bit_count_;
+        }
+
+        /**
+        Returns a reference to parms_id of the encryption parameters the plan
+        was made for.
+        */
+        inline auto &parms_id() const noexcept
+        {
+            return parms_id_;
+        }
+
+        /**
+        Generates the chosen Galois keys with the given KeyGenerator.
+
+        @param[in] keygen The KeyGenerator to use
+        @param[in] thread_count The maximum number of threads to use; zero means
+        all hardware threads
+        @throws std::invalid_argument if keygen is for different encryption
+        parameters
+        */
+        GaloisKeys generate_keys(KeyGenerator &keygen,
+            std::size_t thread_count = 0) const;
+
+        /**
+        Generates the chosen Galois keys with the given KeyGenerator and saves
+        them to an output stream as they are generated, as
+        KeyGenerator::save_galois_keys does.
+
+        @param[in] keygen The KeyGenerator to use
+        @param[out] stream The stream to save the Galois keys to
+        @param[in] thread_count The maximum number of threads to use; zero means
+        all hardware threads
+        @throws std::invalid_argument if keygen is for different encryption
+        parameters
+        @throws std::exception if the keys could not be written to stream
+        */
+        void save_keys(KeyGenerator &keygen, std::ostream &stream,
+            std::size_t thread_count = 0) const;
+
+    private:
+        /**
+        Returns steps as a left rotation in [0, row_size_).
+        */
+        std::size_t normalize_steps(int steps) const;
+
+        /**
+        Finds the fewest keys to apply for every rotation with the keys in
+        key_steps_, and stores the last of them in last_key_step_. Returns the
+        number of keys for every rotation, which is the largest std::size_t
+        value if the rotation cannot be done.
+        */
+        std::vector<std::size_t> find_decompositions();
+
+        parms_id_type parms_id_ = parms_id_zero;
+
+        std::size_t coeff_count_ = 0;
+
+        std::size_t row_size_ = 0;
+
+        int decomposition_bit_count_ = 0;
+
+        std::size_t key_byte_count_ = 0;
+
+        std::vector<int> key_steps_{};
+
+        /**
+        For each left rotation in [0, row_size_), the step of the last key on a
+        shortest way to it, or zero if there is none.
+        */
+        std::vector<int> last_key_step_{};
+
+        double expected_key_switch_count_ = 0;
+    };
+}
@@ -22,5 +22,7 @@
 #include "seal/randomgen.h"
 #include "seal/randomtostd.h"
 #include "seal/relinkeys.h"
+#include "seal/rotationplan.h"
 #include "seal/secretkey.h"
+#include "seal/serialization.h"
 #include "seal/smallmodulus.h"
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include "seal/util/defines.h"
+
+namespace seal
+{
+    /**
+    Selects how the save functions of Ciphertext, Plaintext, PublicKey,
+    SecretKey, RelinKeys, and GaloisKeys compress their output. The mode is
+    recorded in the saved header, so load detects it automatically.
+
+    The mode lz is a built-in LZ77-style codec that is always available and is
+    very fast, but compresses only long repeated runs such as zero coefficients.
+    The mode deflate uses zlib and gives better ratios at lower speed; if
+    Microsoft SEAL was built without zlib (see SEAL_USE_ZLIB), saving with
+    deflate falls back to lz, and loading deflate-compressed data fails.
+    */
+    enum class compr_mode_type : std::uint8_t
+    {
+        none = 0,
+        lz = 1,
+        deflate = 2
+    };
+
+    inline bool is_valid_compr_mode(compr_mode_type compr_mode) noexcept
+    {
+        return (compr_mode == compr_mode_type::none) ||
+            (compr_mode == compr_mode_type::lz) ||
+            (compr_mode == compr_mode_type::deflate);
+    }
+
+    /**
+    Returns whether the given compression mode is available in this build of
+    Microsoft SEAL, i.e., whether saving with it will not fall back to another
+    mode and loading data compressed with it will succeed.
+    */
+    inline bool is_supported_compr_mode(compr_mode_type compr_mode) noexcept
+    {
+#ifdef SEAL_USE_ZLIB
+        return is_valid_compr_mode(compr_mode);
+#else
+        return (compr_mode == compr_mode_type::none) ||
+            (compr_mode == compr_mode_type::lz);
+#endif
+    }
+}
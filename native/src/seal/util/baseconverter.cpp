@@ -36,7 +36,8 @@ namespace seal
         }
 
         void BaseConverter::generate(const std::vector<SmallModulus> &coeff_base,
-            size_t coeff_count, const SmallModulus &small_plain_mod)
+            size_t coeff_count, const SmallModulus &small_plain_mod,
+            const SmallNTTTablesGenerator &generate_ntt_tables)
         {
 #ifdef SEAL_DEBUG
             if (get_power_of_two(coeff_count) < 0)
@@ -120,7 +121,8 @@ namespace seal
             bsk_small_ntt_tables_ = allocate<SmallNTTTables>(bsk_base_mod_count_, pool_);
             for (size_t i = 0; i < bsk_base_mod_count_; i++)
             {
-                if (!bsk_small_ntt_tables_[i].generate(coeff_count_power, bsk_base_array_[i]))
+                if (!generate_small_ntt_tables(bsk_small_ntt_tables_[i], coeff_count_power,
+                    bsk_base_array_[i], generate_ntt_tables))
                 {
                     reset();
                     return;
@@ -32,10 +32,12 @@ namespace seal
                 MemoryPoolHandle pool);
 
             /**
-            Generates the pre-computations for the given parameters.
+            Generates the pre-computations for the given parameters. The NTT
+            tables for Bsk are set up with generate_ntt_tables if it is given.
             */
             void generate(const std::vector<SmallModulus> &coeff_base, 
-                std::size_t coeff_count, const SmallModulus &small_plain_mod);
+                std::size_t coeff_count, const SmallModulus &small_plain_mod,
+                const SmallNTTTablesGenerator &generate_ntt_tables = nullptr);
 
             /**
             Fast base converter from q to Bsk
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cstring>
+#include "seal/util/checksum.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+            constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+            constexpr uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+            constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ULL;
+            constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ULL;
+
+            inline uint64_t rotate_left(uint64_t value, int shift)
+            {
+                return (value << shift) | (value >> (64 - shift));
+            }
+
+            // The hash is defined on little-endian words
+            inline uint64_t read_uint64(const SEAL_BYTE *ptr)
+            {
+                uint64_t value = 0;
+                for (int i = 7; i >= 0; i--)
+                {
+                    value = (value << 8) | static_cast<uint64_t>(ptr[i]);
+                }
+                return value;
+            }
+
+            inline uint64_t read_uint32(const SEAL_BYTE *ptr)
+            {
+                uint64_t value = 0;
+                for (int i = 3; i >= 0; i--)
+                {
+                    value = (value << 8) | static_cast<uint64_t>(ptr[i]);
+                }
+                return value;
+            }
+
+            inline uint64_t round(uint64_t acc, uint64_t input)
+            {
+                acc += input * prime64_2;
+                acc = rotate_left(acc, 31);
+                return acc * prime64_1;
+            }
+
+            inline uint64_t merge_round(uint64_t acc, uint64_t value)
+            {
+                acc ^= round(0, value);
+                return acc * prime64_1 + prime64_4;
+            }
+        }
+
+        Checksum::Checksum() noexcept :
+            acc_{ prime64_1 + prime64_2, prime64_2, 0, 0 - prime64_1 }
+        {
+        }
+
+        void Checksum::update(const SEAL_BYTE *data, size_t size) noexcept
+        {
+            total_size_ += static_cast<uint64_t>(size);
+
+            // Complete a partially filled stripe first
+            if (buffer_size_)
+            {
+                size_t fill_size = min(size, stripe_size - buffer_size_);
+                memcpy(buffer_ + buffer_size_, data, fill_size);
+                buffer_size_ += fill_size;
+                data += fill_size;
+                size -= fill_size;
+                if (buffer_size_ < stripe_size)
+                {
+                    return;
+                }
+                for (size_t i = 0; i < 4; i++)
+                {
+                    acc_[i] = round(acc_[i], read_uint64(buffer_ + 8 * i));
+                }
+                buffer_size_ = 0;
+            }
+
+            // The four lanes are independent, so this loop runs at several
+            // bytes per cycle
+            uint64_t acc0 = acc_[0];
+            uint64_t acc1 = acc_[1];
+            uint64_t acc2 = acc_[2];
+            uint64_t acc3 = acc_[3];
+            for (; size >= stripe_size; data += stripe_size, size -= stripe_size)
+            {
+                acc0 = round(acc0, read_uint64(data));
+                acc1 = round(acc1, read_uint64(data + 8));
+                acc2 = round(acc2, read_uint64(data + 16));
+                acc3 = round(acc3, read_uint64(data + 24));
+            }
+            acc_[0] = acc0;
+            acc_[1] = acc1;
+            acc_[2] = acc2;
+            acc_[3] = acc3;
+
+            memcpy(buffer_, data, size);
+            buffer_size_ = size;
+        }
+
+        uint64_t Checksum::digest() const noexcept
+        {
+            uint64_t hash;
+            if (total_size_ >= stripe_size)
+            {
+                hash = rotate_left(acc_[0], 1) + rotate_left(acc_[1], 7) +
+                    rotate_left(acc_[2], 12) + rotate_left(acc_[3], 18);
+                for (size_t i = 0; i < 4; i++)
+                {
+                    hash = merge_round(hash, acc_[i]);
+                }
+            }
+            else
+            {
+                hash = prime64_5;
+            }
+            hash += total_size_;
+
+            const SEAL_BYTE *ptr = buffer_;
+            size_t size = buffer_size_;
+            for (; size >= 8; ptr += 8, size -= 8)
+            {
+                hash ^= round(0, read_uint64(ptr));
+                hash = rotate_left(hash, 27) * prime64_1 + prime64_4;
+            }
+            if (size >= 4)
+            {
+                hash ^= read_uint32(ptr) * prime64_1;
+                hash = rotate_left(hash, 23) * prime64_2 + prime64_3;
+                ptr += 4;
+                size -= 4;
+            }
+            for (; size; ptr++, size--)
+            {
+                hash ^= static_cast<uint64_t>(*ptr) * prime64_5;
+                hash = rotate_left(hash, 11) * prime64_1;
+            }
+
+            hash ^= hash >> 33;
+            hash *= prime64_2;
+            hash ^= hash >> 29;
+            hash *= prime64_3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+    }
+}
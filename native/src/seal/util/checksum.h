@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "seal/util/defines.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Computes the 64-bit xxHash (XXH64 with seed zero) of a sequence of bytes
+        that is given in any number of pieces. This is a fast non-cryptographic
+        hash used to detect corruption of serialized data; it offers no
+        protection against deliberate modification.
+        */
+        class Checksum
+        {
+        public:
+            Checksum() noexcept;
+
+            /**
+            Appends size bytes from data to the hashed sequence.
+            */
+            void update(const SEAL_BYTE *data, std::size_t size) noexcept;
+
+            /**
+            Returns the hash of the bytes appended so far.
+            */
+            std::uint64_t digest() const noexcept;
+
+        private:
+            static constexpr std::size_t stripe_size = 32;
+
+            std::uint64_t acc_[4];
+
+            std::uint64_t total_size_ = 0;
+
+            SEAL_BYTE buffer_[stripe_size];
+
+            std::size_t buffer_size_ = 0;
+        };
+    }
+}
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "seal/util/compression.h"
+#include "seal/util/common.h"
+#ifdef SEAL_USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // The lz codec writes a sequence of blocks, each consisting of a
+            // token byte, literal bytes, and a back-reference. The high nibble of
+            // the token holds the literal count and the low nibble holds the
+            // match length minus lz_min_match; a nibble value of 15 means the
+            // count continues in following bytes, each adding up to 255. The
+            // back-reference is a 16-bit little-endian offset. The final block
+            // has literals only.
+            constexpr size_t lz_min_match = 4;
+
+            constexpr size_t lz_max_offset = 0xFFFF;
+
+            constexpr int lz_hash_bit_count = 14;
+
+            // Skip faster through data that does not compress
+            constexpr int lz_skip_shift = 6;
+
+            inline uint32_t lz_read32(const SEAL_BYTE *ptr)
+            {
+                uint32_t value;
+                memcpy(&value, ptr, sizeof(uint32_t));
+                return value;
+            }
+
+            inline size_t lz_hash(uint32_t value)
+            {
+                return static_cast<size_t>((value * 2654435761U) >>
+                    (32 - lz_hash_bit_count));
+            }
+
+            inline void lz_write_count(size_t count, vector<SEAL_BYTE> &destination)
+            {
+                for (; count >= 255; count -= 255)
+                {
+                    destination.push_back(static_cast<SEAL_BYTE>(255));
+                }
+                destination.push_back(static_cast<SEAL_BYTE>(count));
+            }
+
+            void lz_write_block(const SEAL_BYTE *literals, size_t literal_count,
+                size_t offset, size_t match_length, vector<SEAL_BYTE> &destination)
+            {
+                size_t match_code = match_length ? match_length - lz_min_match : 0;
+                SEAL_BYTE token = static_cast<SEAL_BYTE>(
+                    (min<size_t>(literal_count, 15) << 4) | min<size_t>(match_code, 15));
+                destination.push_back(token);
+                if (literal_count >= 15)
+                {
+                    lz_write_count(literal_count - 15, destination);
+                }
+                destination.insert(destination.end(), literals, literals + literal_count);
+                if (!match_length)
+                {
+                    return;
+                }
+                destination.push_back(static_cast<SEAL_BYTE>(offset & 0xFF));
+                destination.push_back(static_cast<SEAL_BYTE>(offset >> 8));
+                if (match_code >= 15)
+                {
+                    lz_write_count(match_code - 15, destination);
+                }
+            }
+
+            void lz_compress(const SEAL_BYTE *input, size_t size,
+                vector<SEAL_BYTE> &destination)
+            {
+                destination.clear();
+                destination.reserve(size + size / 255 + 16);
+
+                // Positions are stored off by one so that zero means empty
+                vector<size_t> table(size_t(1) << lz_hash_bit_count, 0);
+                size_t anchor = 0;
+                size_t pos = 0;
+                size_t miss_count = 0;
+                while (size >= lz_min_match && pos <= size - lz_min_match)
+                {
+                    uint32_t value = lz_read32(input + pos);
+                    size_t &entry = table[lz_hash(value)];
+                    size_t candidate = entry;
+                    entry = pos + 1;
+                    if (!candidate || pos - (candidate - 1) > lz_max_offset ||
+                        lz_read32(input + candidate - 1) != value)
+                    {
+                        pos += 1 + (miss_count++ >> lz_skip_shift);
+                        continue;
+                    }
+                    candidate--;
+
+                    size_t match_length = lz_min_match;
+                    while (pos + match_length < size &&
+                        input[candidate + match_length] == input[pos + match_length])
+                    {
+                        match_length++;
+                    }
+                    lz_write_block(input + anchor, pos - anchor, pos - candidate,
+                        match_length, destination);
+                    pos += match_length;
+                    anchor = pos;
+                    miss_count = 0;
+                }
+                lz_write_block(input + anchor, size - anchor, 0, 0, destination);
+            }
+
+            inline size_t lz_read_count(const SEAL_BYTE *input, size_t size,
+                size_t &pos)
+            {
+                size_t count = 0;
+                SEAL_BYTE next;
+                do
+                {
+                    if (pos >= size)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+                    next = input[pos++];
+                    count = add_safe(count, static_cast<size_t>(next));
+                } while (next == static_cast<SEAL_BYTE>(255));
+                return count;
+            }
+
+            void lz_decompress(const SEAL_BYTE *input, size_t size,
+                SEAL_BYTE *destination, size_t destination_size)
+            {
+                size_t pos = 0;
+                size_t out = 0;
+                while (true)
+                {
+                    if (pos >= size)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+                    size_t token = static_cast<size_t>(input[pos++]);
+
+                    size_t literal_count = token >> 4;
+                    if (literal_count == 15)
+                    {
+                        literal_count = add_safe(literal_count,
+                            lz_read_count(input, size, pos));
+                    }
+                    if (literal_count > size - pos ||
+                        literal_count > destination_size - out)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+                    copy_n(input + pos, literal_count, destination + out);
+                    pos += literal_count;
+                    out += literal_count;
+                    if (pos == size)
+                    {
+                        break;
+                    }
+
+                    if (size - pos < 2)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+                    size_t offset = static_cast<size_t>(input[pos]) |
+                        (static_cast<size_t>(input[pos + 1]) << 8);
+                    pos += 2;
+                    size_t match_length = token & 15;
+                    if (match_length == 15)
+                    {
+                        match_length = add_safe(match_length,
+                            lz_read_count(input, size, pos));
+                    }
+                    match_length += lz_min_match;
+                    if (!offset || offset > out ||
+                        match_length > destination_size - out)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+
+                    // The source may overlap the destination for short offsets
+                    const SEAL_BYTE *match = destination + out - offset;
+                    SEAL_BYTE *match_end = destination + out + match_length;
+                    for (SEAL_BYTE *dest_ptr = destination + out; dest_ptr != match_end; )
+                    {
+                        *dest_ptr++ = *match++;
+                    }
+                    out += match_length;
+                }
+                if (out != destination_size)
+                {
+                    throw invalid_argument("compressed data is invalid");
+                }
+            }
+#ifdef SEAL_USE_ZLIB
+            void deflate_compress(const SEAL_BYTE *input, size_t size,
+                vector<SEAL_BYTE> &destination)
+            {
+                uLong source_len = safe_cast<uLong>(size);
+                uLongf dest_len = compressBound(source_len);
+                destination.resize(safe_cast<size_t>(dest_len));
+                if (compress2(reinterpret_cast<Bytef*>(destination.data()), &dest_len,
+                    reinterpret_cast<const Bytef*>(input), source_len,
+                    Z_DEFAULT_COMPRESSION) != Z_OK)
+                {
+                    throw logic_error("deflate compression failed");
+                }
+                destination.resize(safe_cast<size_t>(dest_len));
+            }
+
+            void deflate_decompress(const SEAL_BYTE *input, size_t size,
+                SEAL_BYTE *destination, size_t destination_size)
+            {
+                uLongf dest_len = safe_cast<uLongf>(destination_size);
+                if (uncompress(reinterpret_cast<Bytef*>(destination), &dest_len,
+                    reinterpret_cast<const Bytef*>(input), safe_cast<uLong>(size)) != Z_OK ||
+                    unsigned_neq(dest_len, destination_size))
+                {
+                    throw invalid_argument("compressed data is invalid");
+                }
+            }
+#endif
+        }
+
+        compr_mode_type compress(const SEAL_BYTE *input, size_t size,
+            compr_mode_type compr_mode, vector<SEAL_BYTE> &destination)
+        {
+            switch (compr_mode)
+            {
+            case compr_mode_type::none:
+                destination.assign(input, input + size);
+                return compr_mode;
+
+            case compr_mode_type::deflate:
+#ifdef SEAL_USE_ZLIB
+                deflate_compress(input, size, destination);
+                return compr_mode;
+#endif
+                // Fall back to lz when zlib is not available
+            case compr_mode_type::lz:
+                lz_compress(input, size, destination);
+                return compr_mode_type::lz;
+
+            default:
+                throw invalid_argument("unsupported compression mode");
+            }
+        }
+
+        void decompress(const SEAL_BYTE *input, size_t size,
+            compr_mode_type compr_mode, SEAL_BYTE *destination,
+            size_t destination_size)
+        {
+            switch (compr_mode)
+            {
+            case compr_mode_type::none:
+                if (size != destination_size)
+                {
+                    throw invalid_argument("compressed data is invalid");
+                }
+                copy_n(input, size, destination);
+                return;
+
+            case compr_mode_type::lz:
+                lz_decompress(input, size, destination, destination_size);
+                return;
+
+            case compr_mode_type::deflate:
+#ifdef SEAL_USE_ZLIB
+                deflate_decompress(input, size, destination, destination_size);
+                return;
+#else
+                throw logic_error("deflate compression is not supported by this build");
+#endif
+            default:
+                throw invalid_argument("unsupported compression mode");
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "seal/util/defines.h"
+#include "seal/serialization.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Compresses size bytes from input to destination, which is resized to fit
+        the compressed data. Returns the mode that was actually used: deflate
+        falls back to lz when zlib is not available.
+        */
+        compr_mode_type compress(const SEAL_BYTE *input, std::size_t size,
+            compr_mode_type compr_mode, std::vector<SEAL_BYTE> &destination);
+
+        /**
+        Decompresses size bytes from input to destination, which must hold exactly
+        destination_size bytes of decompressed data.
+
+        @throws std::invalid_argument if the compressed data is invalid
+        @throws std::logic_error if compr_mode is not supported by this build
+        */
+        void decompress(const SEAL_BYTE *input, std::size_t size,
+            compr_mode_type compr_mode, SEAL_BYTE *destination,
+            std::size_t destination_size);
+    }
+}
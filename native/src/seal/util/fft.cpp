@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "seal/util/fft.h"
+#include "seal/util/fftkernels.h"
+#include "seal/util/defines.h"
+#include "seal/util/uintcore.h"
+#if defined(SEAL_USE_AVX_FFT) && (SEAL_COMPILER == SEAL_COMPILER_MSVC)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            constexpr double PI = 3.14159265358979323846;
+
+            void fft_negacyclic_scalar(double *real, double *imag,
+                const double *root_real, const double *root_imag, int logn)
+            {
+                fft_negacyclic_core<ScalarOps>(real, imag, root_real, root_imag, logn);
+            }
+
+            void inverse_fft_negacyclic_scalar(double *real, double *imag,
+                const double *inv_root_real, const double *inv_root_imag, int logn,
+                double scalar)
+            {
+                inverse_fft_negacyclic_core<ScalarOps>(real, imag, inv_root_real,
+                    inv_root_imag, logn, scalar);
+            }
+
+            // The FFT kernels for the widest instruction set that both the build
+            // and the processor support; max_abs is null if there is none
+            struct FFTKernels
+            {
+                void (*forward)(double *, double *, const double *, const double *,
+                    int) = fft_negacyclic_scalar;
+
+                void (*inverse)(double *, double *, const double *, const double *,
+                    int, double) = inverse_fft_negacyclic_scalar;
+
+                double (*max_abs)(const double *, size_t, bool &) = nullptr;
+
+                size_t width = 1;
+            };
+
+#ifdef SEAL_USE_AVX_FFT
+#if SEAL_COMPILER == SEAL_COMPILER_MSVC
+            // Checks the CPUID feature bits and that the operating system saves
+            // the register state given by xcr0_mask
+            bool cpu_supports(int leaf, int reg, int bit, unsigned long long xcr0_mask)
+            {
+                int info[4];
+                __cpuid(info, 1);
+                bool osxsave = (info[2] >> 27) & 1;
+                if (!osxsave || ((_xgetbv(0) & xcr0_mask) != xcr0_mask))
+                {
+                    return false;
+                }
+                __cpuidex(info, leaf, 0);
+                return (info[reg] >> bit) & 1;
+            }
+
+            bool cpu_supports_avx()
+            {
+                return cpu_supports(1, 2, 28, 0x6);
+            }
+
+            bool cpu_supports_avx512f()
+            {
+                return cpu_supports(7, 1, 16, 0xE6);
+            }
+#else
+            bool cpu_supports_avx()
+            {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx");
+            }
+
+            bool cpu_supports_avx512f()
+            {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx512f");
+            }
+#endif
+#endif
+            FFTKernels select_fft_kernels()
+            {
+                FFTKernels kernels;
+#ifdef SEAL_USE_AVX512_FFT
+                if (cpu_supports_avx512f())
+                {
+                    kernels.forward = fft_negacyclic_avx512;
+                    kernels.inverse = inverse_fft_negacyclic_avx512;
+                    kernels.max_abs = get_max_abs_avx512;
+                    kernels.width = 8;
+                    return kernels;
+                }
+#endif
+#ifdef SEAL_USE_AVX_FFT
+                if (cpu_supports_avx())
+                {
+                    kernels.forward = fft_negacyclic_avx;
+                    kernels.inverse = inverse_fft_negacyclic_avx;
+                    kernels.max_abs = get_max_abs_avx;
+                    kernels.width = 4;
+                }
+#endif
+                return kernels;
+            }
+
+            const FFTKernels &fft_kernels()
+            {
+                static const FFTKernels kernels = select_fft_kernels();
+                return kernels;
+            }
+        }
+
+        FFTTables::FFTTables(int coeff_count_power, MemoryPoolHandle pool) :
+            pool_(move(pool))
+        {
+            if (!pool_)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+            if ((coeff_count_power < get_power_of_two(SEAL_POLY_MOD_DEGREE_MIN)) ||
+                coeff_count_power > get_power_of_two(SEAL_POLY_MOD_DEGREE_MAX))
+            {
+                throw invalid_argument("coeff_count_power out of range");
+            }
+
+            coeff_count_power_ = coeff_count_power;
+            coeff_count_ = size_t(1) << coeff_count_power_;
+
+            root_real_ = allocate<double>(coeff_count_, pool_);
+            root_imag_ = allocate<double>(coeff_count_, pool_);
+            inv_root_real_ = allocate<double>(coeff_count_, pool_);
+            inv_root_imag_ = allocate<double>(coeff_count_, pool_);
+
+            // Powers of the primitive 2n-th root of unity in bit-reversed order
+            double m = static_cast<double>(coeff_count_ << 1);
+            complex<double> psi{ cos((2 * PI) / m), sin((2 * PI) / m) };
+            for (size_t i = 0; i < coeff_count_; i++)
+            {
+                complex<double> root = pow(psi,
+                    static_cast<double>(reverse_bits(i, coeff_count_power_)));
+                complex<double> inv_root = 1.0 / root;
+                root_real_[i] = root.real();
+                root_imag_[i] = root.imag();
+                inv_root_real_[i] = inv_root.real();
+                inv_root_imag_[i] = inv_root.imag();
+            }
+        }
+
+        void fft_negacyclic(double *real, double *imag, const FFTTables &tables)
+        {
+#ifdef SEAL_DEBUG
+            if (!real || !imag)
+            {
+                throw invalid_argument("operand");
+            }
+#endif
+            fft_kernels().forward(real, imag, tables.root_real(), tables.root_imag(),
+                tables.coeff_count_power());
+        }
+
+        void inverse_fft_negacyclic(double *real, double *imag,
+            const FFTTables &tables, double scalar)
+        {
+#ifdef SEAL_DEBUG
+            if (!real || !imag)
+            {
+                throw invalid_argument("operand");
+            }
+#endif
+            fft_kernels().inverse(real, imag, tables.inv_root_real(),
+                tables.inv_root_imag(), tables.coeff_count_power(), scalar);
+        }
+
+        double get_max_abs(const double *values, size_t count)
+        {
+#ifdef SEAL_DEBUG
+            if (!values && count > 0)
+            {
+                throw invalid_argument("values");
+            }
+#endif
+            // The maximum drops NaN operands, so they are tracked separately
+            double result = 0;
+            bool has_nan = false;
+            size_t i = 0;
+            auto &kernels = fft_kernels();
+            if (kernels.max_abs && count >= kernels.width)
+            {
+                i = count - count % kernels.width;
+                result = kernels.max_abs(values, i, has_nan);
+            }
+            for (; i < count; i++)
+            {
+                has_nan |= isnan(values[i]);
+                result = max(result, fabs(values[i]));
+            }
+            return has_nan ? numeric_limits<double>::quiet_NaN() : result;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include "seal/util/pointer.h"
+#include "seal/memorymanager.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Precomputed roots of unity for the negacyclic complex FFT used in CKKS
+        encoding and decoding. The powers of a primitive 2n-th root of unity are
+        stored in bit-reversed order, with real and imaginary parts in separate
+        arrays so that the transforms can process several butterflies at a time.
+        */
+        class FFTTables
+        {
+        public:
+            FFTTables(int coeff_count_power,
+                MemoryPoolHandle pool = MemoryManager::GetPool());
+
+            inline int coeff_count_power() const noexcept
+            {
+                return coeff_count_power_;
+            }
+
+            inline std::size_t coeff_count() const noexcept
+            {
+                return coeff_count_;
+            }
+
+            inline const double *root_real() const noexcept
+            {
+                return root_real_.get();
+            }
+
+            inline const double *root_imag() const noexcept
+            {
+                return root_imag_.get();
+            }
+
+            inline const double *inv_root_real() const noexcept
+            {
+                return inv_root_real_.get();
+            }
+
+            inline const double *inv_root_imag() const noexcept
+            {
+                return inv_root_imag_.get();
+            }
+
+        private:
+            FFTTables(const FFTTables &copy) = delete;
+
+            FFTTables &operator =(const FFTTables &assign) = delete;
+
+            MemoryPoolHandle pool_;
+
+            int coeff_count_power_ = 0;
+
+            std::size_t coeff_count_ = 0;
+
+            Pointer<double> root_real_;
+
+            Pointer<double> root_imag_;
+
+            Pointer<double> inv_root_real_;
+
+            Pointer<double> inv_root_imag_;
+        };
+
+        /**
+        Evaluates in place a polynomial given by its coefficients at the primitive
+        2n-th roots of unity, as needed in CKKS decoding. The real and imaginary
+        parts are given in separate arrays of size n. The output is in bit-reversed
+        order.
+
+        Pairs of radix-2 stages are fused into radix-4 passes. When compiled with
+        SEAL_USE_AVX_FFT (and SEAL_USE_AVX512_FFT), four (eight) butterflies are
+        computed at a time on processors that support AVX (AVX-512F), which is
+        detected at run time. All code paths perform the same floating-point
+        operations in the same order, so they produce bitwise identical results
+        unless the compiler contracts multiplications and additions into fused
+        multiply-add instructions, in which case the results can differ by a few
+        units in the last place per stage.
+        */
+        void fft_negacyclic(double *real, double *imag, const FFTTables &tables);
+
+        /**
+        Inverse of fft_negacyclic without the division by n, as needed in CKKS
+        encoding. The input is in bit-reversed order. The output is multiplied by
+        scalar in the last pass; use scalar = 1/n for the exact inverse. See
+        fft_negacyclic for the reproducibility of the results.
+        */
+        void inverse_fft_negacyclic(double *real, double *imag,
+            const FFTTables &tables, double scalar);
+
+        /**
+        Returns the largest absolute value in an array of doubles, zero if the
+        array is empty, or NaN if any of the values is NaN.
+        */
+        double get_max_abs(const double *values, std::size_t count);
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// This file is compiled with AVX enabled and must not include headers that
+// define inline functions shared with other translation units
+#include "seal/util/config.h"
+
+#ifdef SEAL_USE_AVX_FFT
+
+#include <immintrin.h>
+#define SEAL_FFT_KERNELS_AVX
+#include "seal/util/fftkernels.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        void fft_negacyclic_avx(double *real, double *imag,
+            const double *root_real, const double *root_imag, int logn)
+        {
+            fft_negacyclic_core<AVXOps>(real, imag, root_real, root_imag, logn);
+        }
+
+        void inverse_fft_negacyclic_avx(double *real, double *imag,
+            const double *inv_root_real, const double *inv_root_imag, int logn,
+            double scalar)
+        {
+            inverse_fft_negacyclic_core<AVXOps>(real, imag, inv_root_real,
+                inv_root_imag, logn, scalar);
+        }
+
+        double get_max_abs_avx(const double *values, size_t count, bool &has_nan)
+        {
+            // The maximum drops NaN operands, so they are tracked separately
+            const __m256d abs_mask = _mm256_castsi256_pd(
+                _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+            __m256d max_vec = _mm256_setzero_pd();
+            __m256d nan_vec = _mm256_setzero_pd();
+            for (size_t i = 0; i < count; i += 4)
+            {
+                __m256d value_vec = _mm256_loadu_pd(values + i);
+                nan_vec = _mm256_or_pd(nan_vec,
+                    _mm256_cmp_pd(value_vec, value_vec, _CMP_UNORD_Q));
+                max_vec = _mm256_max_pd(max_vec, _mm256_and_pd(value_vec, abs_mask));
+            }
+            has_nan = (_mm256_movemask_pd(nan_vec) != 0);
+
+            // Reduce the four lanes to one
+            __m128d max_half = _mm_max_pd(_mm256_castpd256_pd128(max_vec),
+                _mm256_extractf128_pd(max_vec, 1));
+            return _mm_cvtsd_f64(_mm_max_sd(max_half, _mm_unpackhi_pd(max_half, max_half)));
+        }
+    }
+}
+
+#endif
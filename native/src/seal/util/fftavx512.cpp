@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// This file is compiled with AVX-512 enabled and must not include headers that
+// define inline functions shared with other translation units
+#include "seal/util/config.h"
+
+#ifdef SEAL_USE_AVX512_FFT
+
+#include <immintrin.h>
+#define SEAL_FFT_KERNELS_AVX
+#include "seal/util/fftkernels.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // Arithmetic on eight doubles at a time
+            struct AVX512Ops
+            {
+                using value_type = __m512d;
+
+                using narrower_type = AVXOps;
+
+                static constexpr size_t width = 8;
+
+                static inline value_type load(const double *ptr)
+                {
+                    return _mm512_loadu_pd(ptr);
+                }
+
+                static inline void store(double *ptr, value_type value)
+                {
+                    _mm512_storeu_pd(ptr, value);
+                }
+
+                static inline value_type set1(double value)
+                {
+                    return _mm512_set1_pd(value);
+                }
+
+                static inline value_type add(value_type a, value_type b)
+                {
+                    return _mm512_add_pd(a, b);
+                }
+
+                static inline value_type sub(value_type a, value_type b)
+                {
+                    return _mm512_sub_pd(a, b);
+                }
+
+                static inline value_type mul(value_type a, value_type b)
+                {
+                    return _mm512_mul_pd(a, b);
+                }
+            };
+        }
+
+        void fft_negacyclic_avx512(double *real, double *imag,
+            const double *root_real, const double *root_imag, int logn)
+        {
+            fft_negacyclic_core<AVX512Ops>(real, imag, root_real, root_imag, logn);
+        }
+
+        void inverse_fft_negacyclic_avx512(double *real, double *imag,
+            const double *inv_root_real, const double *inv_root_imag, int logn,
+            double scalar)
+        {
+            inverse_fft_negacyclic_core<AVX512Ops>(real, imag, inv_root_real,
+                inv_root_imag, logn, scalar);
+        }
+
+        double get_max_abs_avx512(const double *values, size_t count, bool &has_nan)
+        {
+            // The maximum drops NaN operands, so they are tracked separately
+            const __m512i abs_mask = _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL);
+            __m512d max_vec = _mm512_setzero_pd();
+            __mmask8 nan_mask = 0;
+            for (size_t i = 0; i < count; i += 8)
+            {
+                __m512d value_vec = _mm512_loadu_pd(values + i);
+                nan_mask |= _mm512_cmp_pd_mask(value_vec, value_vec, _CMP_UNORD_Q);
+                max_vec = _mm512_max_pd(max_vec, _mm512_castsi512_pd(
+                    _mm512_and_epi64(_mm512_castpd_si512(value_vec), abs_mask)));
+            }
+            has_nan = (nan_mask != 0);
+
+            // Reduce the eight lanes to one
+            __m256d max_quarter = _mm256_max_pd(_mm512_castpd512_pd256(max_vec),
+                _mm512_extractf64x4_pd(max_vec, 1));
+            __m128d max_half = _mm_max_pd(_mm256_castpd256_pd128(max_quarter),
+                _mm256_extractf128_pd(max_quarter, 1));
+            return _mm_cvtsd_f64(_mm_max_sd(max_half, _mm_unpackhi_pd(max_half, max_half)));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,401 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+
+namespace seal
+{
+    namespace util
+    {
+        /*
+        Entry points of the FFT kernels compiled for a particular instruction set.
+        These are called from fft.cpp only on processors that support the
+        instruction set. The transforms take the root arrays of FFTTables and
+        its coeff_count_power. The get_max_abs kernels take a count that is a
+        multiple of the vector width, and set has_nan if any value is NaN.
+        */
+        void fft_negacyclic_avx(double *real, double *imag,
+            const double *root_real, const double *root_imag, int logn);
+
+        void inverse_fft_negacyclic_avx(double *real, double *imag,
+            const double *inv_root_real, const double *inv_root_imag, int logn,
+            double scalar);
+
+        double get_max_abs_avx(const double *values, std::size_t count,
+            bool &has_nan);
+
+        void fft_negacyclic_avx512(double *real, double *imag,
+            const double *root_real, const double *root_imag, int logn);
+
+        void inverse_fft_negacyclic_avx512(double *real, double *imag,
+            const double *inv_root_real, const double *inv_root_imag, int logn,
+            double scalar);
+
+        double get_max_abs_avx512(const double *values, std::size_t count,
+            bool &has_nan);
+
+        /*
+        The transforms below are included by fft.cpp and by each translation unit
+        that is compiled for a particular instruction set. They are in an unnamed
+        namespace, and this header includes nothing but <cstddef>, so that every
+        such translation unit gets its own copy and no code compiled for one
+        instruction set can be picked by the linker for another. Each Ops type
+        names in narrower_type the arithmetic used for passes whose length its
+        width does not divide. AVXOps is defined only if SEAL_FFT_KERNELS_AVX is
+        defined and <immintrin.h> is included before this header.
+        */
+        namespace
+        {
+            // Arithmetic on one double at a time
+            struct ScalarOps
+            {
+                using value_type = double;
+
+                using narrower_type = ScalarOps;
+
+                static constexpr std::size_t width = 1;
+
+                static inline value_type load(const double *ptr)
+                {
+                    return *ptr;
+                }
+
+                static inline void store(double *ptr, value_type value)
+                {
+                    *ptr = value;
+                }
+
+                static inline value_type set1(double value)
+                {
+                    return value;
+                }
+
+                static inline value_type add(value_type a, value_type b)
+                {
+                    return a + b;
+                }
+
+                static inline value_type sub(value_type a, value_type b)
+                {
+                    return a - b;
+                }
+
+                static inline value_type mul(value_type a, value_type b)
+                {
+                    return a * b;
+                }
+            };
+
+#ifdef SEAL_FFT_KERNELS_AVX
+            // Arithmetic on four doubles at a time
+            struct AVXOps
+            {
+                using value_type = __m256d;
+
+                using narrower_type = ScalarOps;
+
+                static constexpr std::size_t width = 4;
+
+                static inline value_type load(const double *ptr)
+                {
+                    return _mm256_loadu_pd(ptr);
+                }
+
+                static inline void store(double *ptr, value_type value)
+                {
+                    _mm256_storeu_pd(ptr, value);
+                }
+
+                static inline value_type set1(double value)
+                {
+                    return _mm256_set1_pd(value);
+                }
+
+                static inline value_type add(value_type a, value_type b)
+                {
+                    return _mm256_add_pd(a, b);
+                }
+
+                static inline value_type sub(value_type a, value_type b)
+                {
+                    return _mm256_sub_pd(a, b);
+                }
+
+                static inline value_type mul(value_type a, value_type b)
+                {
+                    return _mm256_mul_pd(a, b);
+                }
+            };
+#endif
+            // A complex number (or a vector of them) held in registers
+            template<typename Ops>
+            struct Complex
+            {
+                typename Ops::value_type re;
+
+                typename Ops::value_type im;
+
+                static inline Complex load(const double *real, const double *imag,
+                    std::size_t index)
+                {
+                    return { Ops::load(real + index), Ops::load(imag + index) };
+                }
+
+                inline void store(double *real, double *imag, std::size_t index) const
+                {
+                    Ops::store(real + index, re);
+                    Ops::store(imag + index, im);
+                }
+
+                inline void scale(typename Ops::value_type scalar)
+                {
+                    re = Ops::mul(re, scalar);
+                    im = Ops::mul(im, scalar);
+                }
+            };
+
+            // The product (a + bi)(c + di) = (ac - bd) + (ad + bc)i, computed as by
+            // std::complex<double>
+            template<typename Ops>
+            inline Complex<Ops> multiply(const Complex<Ops> &x,
+                typename Ops::value_type root_re, typename Ops::value_type root_im)
+            {
+                return { Ops::sub(Ops::mul(x.re, root_re), Ops::mul(x.im, root_im)),
+                    Ops::add(Ops::mul(x.re, root_im), Ops::mul(x.im, root_re)) };
+            }
+
+            // Butterfly of fft_negacyclic: (x, y) <- (x + y * s, x - y * s)
+            template<typename Ops>
+            inline void forward_butterfly(Complex<Ops> &x, Complex<Ops> &y,
+                typename Ops::value_type root_re, typename Ops::value_type root_im)
+            {
+                auto v = multiply<Ops>(y, root_re, root_im);
+                y = { Ops::sub(x.re, v.re), Ops::sub(x.im, v.im) };
+                x = { Ops::add(x.re, v.re), Ops::add(x.im, v.im) };
+            }
+
+            // Butterfly of inverse_fft_negacyclic: (x, y) <- (x + y, (x - y) * s)
+            template<typename Ops>
+            inline void inverse_butterfly(Complex<Ops> &x, Complex<Ops> &y,
+                typename Ops::value_type root_re, typename Ops::value_type root_im)
+            {
+                Complex<Ops> diff{ Ops::sub(x.re, y.re), Ops::sub(x.im, y.im) };
+                x = { Ops::add(x.re, y.re), Ops::add(x.im, y.im) };
+                y = multiply<Ops>(diff, root_re, root_im);
+            }
+
+            // Two consecutive stages of fft_negacyclic on the indices [begin, end)
+            // of a block of size 2 * gap: the first with root index r0 and the
+            // second with root indices r1 and r1 + 1.
+            template<typename Ops>
+            inline void forward_radix4(double *real, double *imag,
+                const double *root_real, const double *root_imag, std::size_t begin,
+                std::size_t end, std::size_t gap, std::size_t r0, std::size_t r1)
+            {
+                auto s0_re = Ops::set1(root_real[r0]);
+                auto s0_im = Ops::set1(root_imag[r0]);
+                auto s1_re = Ops::set1(root_real[r1]);
+                auto s1_im = Ops::set1(root_imag[r1]);
+                auto s2_re = Ops::set1(root_real[r1 + 1]);
+                auto s2_im = Ops::set1(root_imag[r1 + 1]);
+                std::size_t half_gap = gap >> 1;
+                for (std::size_t k = begin; k < end; k += Ops::width)
+                {
+                    auto x0 = Complex<Ops>::load(real, imag, k);
+                    auto x1 = Complex<Ops>::load(real, imag, k + half_gap);
+                    auto x2 = Complex<Ops>::load(real, imag, k + gap);
+                    auto x3 = Complex<Ops>::load(real, imag, k + gap + half_gap);
+                    forward_butterfly<Ops>(x0, x2, s0_re, s0_im);
+                    forward_butterfly<Ops>(x1, x3, s0_re, s0_im);
+                    forward_butterfly<Ops>(x0, x1, s1_re, s1_im);
+                    forward_butterfly<Ops>(x2, x3, s2_re, s2_im);
+                    x0.store(real, imag, k);
+                    x1.store(real, imag, k + half_gap);
+                    x2.store(real, imag, k + gap);
+                    x3.store(real, imag, k + gap + half_gap);
+                }
+            }
+
+            // One stage of fft_negacyclic on the indices [begin, end) with
+            // root index r0
+            template<typename Ops>
+            inline void forward_radix2(double *real, double *imag,
+                const double *root_real, const double *root_imag, std::size_t begin,
+                std::size_t end, std::size_t gap, std::size_t r0)
+            {
+                auto s0_re = Ops::set1(root_real[r0]);
+                auto s0_im = Ops::set1(root_imag[r0]);
+                for (std::size_t k = begin; k < end; k += Ops::width)
+                {
+                    auto x0 = Complex<Ops>::load(real, imag, k);
+                    auto x1 = Complex<Ops>::load(real, imag, k + gap);
+                    forward_butterfly<Ops>(x0, x1, s0_re, s0_im);
+                    x0.store(real, imag, k);
+                    x1.store(real, imag, k + gap);
+                }
+            }
+
+            // Two consecutive stages of inverse_fft_negacyclic on the indices
+            // [begin, end) of a block of size 4 * gap: the first with root indices
+            // r0 and r0 + 1 and the second with root index r1. If scale is set,
+            // the outputs are multiplied by scalar.
+            template<typename Ops>
+            inline void inverse_radix4(double *real, double *imag,
+                const double *inv_root_real, const double *inv_root_imag,
+                std::size_t begin, std::size_t end, std::size_t gap, std::size_t r0,
+                std::size_t r1, bool scale, double scalar)
+            {
+                auto s0_re = Ops::set1(inv_root_real[r0]);
+                auto s0_im = Ops::set1(inv_root_imag[r0]);
+                auto s1_re = Ops::set1(inv_root_real[r0 + 1]);
+                auto s1_im = Ops::set1(inv_root_imag[r0 + 1]);
+                auto s2_re = Ops::set1(inv_root_real[r1]);
+                auto s2_im = Ops::set1(inv_root_imag[r1]);
+                auto scalar_vec = Ops::set1(scalar);
+                for (std::size_t k = begin; k < end; k += Ops::width)
+                {
+                    auto x0 = Complex<Ops>::load(real, imag, k);
+                    auto x1 = Complex<Ops>::load(real, imag, k + gap);
+                    auto x2 = Complex<Ops>::load(real, imag, k + 2 * gap);
+                    auto x3 = Complex<Ops>::load(real, imag, k + 3 * gap);
+                    inverse_butterfly<Ops>(x0, x1, s0_re, s0_im);
+                    inverse_butterfly<Ops>(x2, x3, s1_re, s1_im);
+                    inverse_butterfly<Ops>(x0, x2, s2_re, s2_im);
+                    inverse_butterfly<Ops>(x1, x3, s2_re, s2_im);
+                    if (scale)
+                    {
+                        x0.scale(scalar_vec);
+                        x1.scale(scalar_vec);
+                        x2.scale(scalar_vec);
+                        x3.scale(scalar_vec);
+                    }
+                    x0.store(real, imag, k);
+                    x1.store(real, imag, k + gap);
+                    x2.store(real, imag, k + 2 * gap);
+                    x3.store(real, imag, k + 3 * gap);
+                }
+            }
+
+            // One stage of inverse_fft_negacyclic on the indices [begin, end)
+            // with root index r0. If scale is set, the outputs are multiplied
+            // by scalar.
+            template<typename Ops>
+            inline void inverse_radix2(double *real, double *imag,
+                const double *inv_root_real, const double *inv_root_imag,
+                std::size_t begin, std::size_t end, std::size_t gap, std::size_t r0,
+                bool scale, double scalar)
+            {
+                auto s0_re = Ops::set1(inv_root_real[r0]);
+                auto s0_im = Ops::set1(inv_root_imag[r0]);
+                auto scalar_vec = Ops::set1(scalar);
+                for (std::size_t k = begin; k < end; k += Ops::width)
+                {
+                    auto x0 = Complex<Ops>::load(real, imag, k);
+                    auto x1 = Complex<Ops>::load(real, imag, k + gap);
+                    inverse_butterfly<Ops>(x0, x1, s0_re, s0_im);
+                    if (scale)
+                    {
+                        x0.scale(scalar_vec);
+                        x1.scale(scalar_vec);
+                    }
+                    x0.store(real, imag, k);
+                    x1.store(real, imag, k + gap);
+                }
+            }
+
+            // Runs a pass over a contiguous run of count butterflies with the
+            // widest arithmetic, starting from Ops, whose width divides count
+            template<typename Ops, typename Pass>
+            inline void run_pass(std::size_t begin, std::size_t count, Pass &&pass)
+            {
+                if (count % Ops::width == 0)
+                {
+                    pass(Ops{}, begin, begin + count);
+                }
+                else
+                {
+                    run_pass<typename Ops::narrower_type>(begin, count, pass);
+                }
+            }
+
+            // The body of fft_negacyclic with WideOps as the widest arithmetic
+            template<typename WideOps>
+            inline void fft_negacyclic_core(double *real, double *imag,
+                const double *root_real, const double *root_imag, int logn)
+            {
+                std::size_t gap = std::size_t(1) << logn;
+
+                // Stage i has 2^i blocks of size 2 * gap with gap = n / 2^(i + 1)
+                int i = 0;
+                for (; i + 1 < logn; i += 2)
+                {
+                    std::size_t block_count = std::size_t(1) << i;
+                    gap >>= 1;
+                    for (std::size_t j = 0; j < block_count; j++)
+                    {
+                        run_pass<WideOps>(2 * j * gap, gap >> 1,
+                            [&](auto ops, std::size_t begin, std::size_t end) {
+                            forward_radix4<decltype(ops)>(real, imag, root_real,
+                                root_imag, begin, end, gap, block_count + j,
+                                2 * (block_count + j));
+                        });
+                    }
+                    gap >>= 1;
+                }
+                if (i < logn)
+                {
+                    std::size_t block_count = std::size_t(1) << i;
+                    gap >>= 1;
+                    for (std::size_t j = 0; j < block_count; j++)
+                    {
+                        run_pass<WideOps>(2 * j * gap, gap,
+                            [&](auto ops, std::size_t begin, std::size_t end) {
+                            forward_radix2<decltype(ops)>(real, imag, root_real,
+                                root_imag, begin, end, gap, block_count + j);
+                        });
+                    }
+                }
+            }
+
+            // The body of inverse_fft_negacyclic with WideOps as the widest
+            // arithmetic
+            template<typename WideOps>
+            inline void inverse_fft_negacyclic_core(double *real, double *imag,
+                const double *inv_root_real, const double *inv_root_imag, int logn,
+                double scalar)
+            {
+                std::size_t n = std::size_t(1) << logn;
+
+                // Stage i has n / 2^(i + 1) blocks of size 2 * gap with gap = 2^i
+                std::size_t gap = 1;
+                int i = 0;
+                for (; i + 1 < logn; i += 2)
+                {
+                    std::size_t block_count = n / (2 * gap);
+                    bool scale = (i + 2 == logn);
+                    for (std::size_t j = 0; j < block_count / 2; j++)
+                    {
+                        run_pass<WideOps>(4 * j * gap, gap,
+                            [&](auto ops, std::size_t begin, std::size_t end) {
+                            inverse_radix4<decltype(ops)>(real, imag, inv_root_real,
+                                inv_root_imag, begin, end, gap, block_count + 2 * j,
+                                block_count / 2 + j, scale, scalar);
+                        });
+                    }
+                    gap <<= 2;
+                }
+                if (i < logn)
+                {
+                    // The last stage has a single block
+                    run_pass<WideOps>(0, gap,
+                        [&](auto ops, std::size_t begin, std::size_t end) {
+                        inverse_radix2<decltype(ops)>(real, imag, inv_root_real,
+                            inv_root_imag, begin, end, gap, 1, true, scalar);
+                    });
+                }
+            }
+        }
+    }
+}
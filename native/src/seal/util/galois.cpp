@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <stdexcept>
+#include "seal/util/galois.h"
+#include "seal/util/common.h"
+#include "seal/util/defines.h"
+#include "seal/util/polyarithsmallmod.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        GaloisTool::GaloisTool(int coeff_count_power, MemoryPoolHandle pool) :
+            pool_(move(pool))
+        {
+            if (!pool_)
+            {
+                throw invalid_argument("pool is uninitialized");
+            }
+            if (coeff_count_power < get_power_of_two(SEAL_POLY_MOD_DEGREE_MIN) ||
+                coeff_count_power > get_power_of_two(SEAL_POLY_MOD_DEGREE_MAX))
+            {
+                throw invalid_argument("coeff_count_power out of range");
+            }
+            coeff_count_power_ = coeff_count_power;
+            coeff_count_ = size_t(1) << coeff_count_power;
+        }
+
+        void GaloisTool::apply_galois(const uint64_t *operand, uint64_t galois_elt,
+            const SmallModulus &modulus, uint64_t *result) const
+        {
+#ifdef SEAL_DEBUG
+            if (operand == nullptr)
+            {
+                throw invalid_argument("operand");
+            }
+            if (result == nullptr)
+            {
+                throw invalid_argument("result");
+            }
+            if (operand == result)
+            {
+                throw invalid_argument("result cannot point to the same value as operand");
+            }
+            if (modulus.is_zero())
+            {
+                throw invalid_argument("modulus");
+            }
+#endif
+            // Verify coprime conditions
+            if (!(galois_elt & 1) || (galois_elt >= 2 * uint64_t(coeff_count_)))
+            {
+                throw invalid_argument("galois element is not valid");
+            }
+
+            util::apply_galois(operand, coeff_count_power_, galois_elt, modulus, result);
+        }
+
+        void GaloisTool::apply_galois_ntt(const uint64_t *operand,
+            uint64_t galois_elt, uint64_t *result) const
+        {
+#ifdef SEAL_DEBUG
+            if (operand == nullptr)
+            {
+                throw invalid_argument("operand");
+            }
+            if (result == nullptr)
+            {
+                throw invalid_argument("result");
+            }
+            if (operand == result)
+            {
+                throw invalid_argument("result cannot point to the same value as operand");
+            }
+#endif
+            const uint32_t *table = get_ntt_table(galois_elt);
+            if (!table)
+            {
+                // No more tables are kept, so find the sources directly
+                util::apply_galois_ntt(operand, coeff_count_power_, galois_elt, result);
+                return;
+            }
+            for (size_t i = 0; i < coeff_count_; i++)
+            {
+                result[i] = operand[table[i]];
+            }
+        }
+
+        size_t GaloisTool::table_count() const
+        {
+            ReaderLock reader_lock(tables_locker_.acquire_read());
+            return ntt_tables_.size();
+        }
+
+        const uint32_t *GaloisTool::get_ntt_table(uint64_t galois_elt) const
+        {
+            // Verify coprime conditions
+            if (!(galois_elt & 1) || (galois_elt >= 2 * uint64_t(coeff_count_)))
+            {
+                throw invalid_argument("galois element is not valid");
+            }
+
+            {
+                ReaderLock reader_lock(tables_locker_.acquire_read());
+                auto it = ntt_tables_.find(galois_elt);
+                if (it != ntt_tables_.end())
+                {
+                    return it->second.get();
+                }
+                if (ntt_tables_.size() >= max_table_count)
+                {
+                    return nullptr;
+                }
+            }
+
+            // Compute the table without holding the lock; if another thread
+            // added the same table in the meantime, its table is kept
+            auto table(allocate<uint32_t>(coeff_count_, pool_));
+            uint64_t m_minus_one = 2 * uint64_t(coeff_count_) - 1;
+            for (size_t i = 0; i < coeff_count_; i++)
+            {
+                uint64_t reversed = reverse_bits(static_cast<uint32_t>(i),
+                    coeff_count_power_);
+                uint64_t index_raw = (galois_elt * (2 * reversed + 1)) & m_minus_one;
+                table[i] = reverse_bits(static_cast<uint32_t>((index_raw - 1) >> 1),
+                    coeff_count_power_);
+            }
+
+            WriterLock writer_lock(tables_locker_.acquire_write());
+            auto it = ntt_tables_.find(galois_elt);
+            if (it != ntt_tables_.end())
+            {
+                return it->second.get();
+            }
+            if (ntt_tables_.size() >= max_table_count)
+            {
+                return nullptr;
+            }
+            return ntt_tables_.emplace(galois_elt, move(table)).first->second.get();
+        }
+    }
+}
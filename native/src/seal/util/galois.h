@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include "seal/memorymanager.h"
+#include "seal/smallmodulus.h"
+#include "seal/util/pointer.h"
+#include "seal/util/locks.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Applies Galois automorphisms to polynomials of a fixed degree. In NTT
+        form the automorphism permutes the values, and finding where each value
+        comes from takes two bit reversals. The permutation for a Galois element
+        is therefore computed the first time the element is used and kept for
+        the lifetime of the object, so that later automorphisms are a single
+        gather. At most max_table_count permutations are kept; automorphisms by
+        further Galois elements compute the sources directly every time. In
+        coefficient form the destination of a coefficient and its sign take one
+        multiplication, which is faster than reading them from a table, so the
+        automorphism is left to util::apply_galois.
+
+        The tables do not depend on the coefficient modulus, so one GaloisTool
+        serves every parameter set with the same polynomial modulus degree.
+        All member functions can be called concurrently.
+        */
+        class GaloisTool
+        {
+        public:
+            /**
+            The largest number of permutation tables kept. Key switching keys
+            usually exist for far fewer Galois elements than this.
+            */
+            static constexpr std::size_t max_table_count = 64;
+
+            /**
+            Creates a GaloisTool for polynomials of degree 2^coeff_count_power.
+            No tables are computed yet.
+
+            @param[in] coeff_count_power The base-2 logarithm of the polynomial
+            modulus degree
+            @param[in] pool The MemoryPoolHandle for the tables
+            @throws std::invalid_argument if coeff_count_power is out of range
+            @throws std::invalid_argument if pool is uninitialized
+            */
+            GaloisTool(int coeff_count_power,
+                MemoryPoolHandle pool = MemoryManager::GetPool());
+
+            /**
+            Applies the automorphism x -> x^galois_elt to a polynomial in
+            coefficient form with coefficients reduced modulo modulus. The
+            result must not overlap the operand.
+
+            @throws std::invalid_argument if galois_elt is not an odd number
+            less than twice the degree
+            */
+            void apply_galois(const std::uint64_t *operand, std::uint64_t galois_elt,
+                const SmallModulus &modulus, std::uint64_t *result) const;
+
+            /**
+            Applies the automorphism x -> x^galois_elt to a polynomial in NTT
+            form. The result must not overlap the operand.
+
+            @throws std::invalid_argument if galois_elt is not an odd number
+            less than twice the degree
+            */
+            void apply_galois_ntt(const std::uint64_t *operand,
+                std::uint64_t galois_elt, std::uint64_t *result) const;
+
+            inline int coeff_count_power() const noexcept
+            {
+                return coeff_count_power_;
+            }
+
+            inline std::size_t coeff_count() const noexcept
+            {
+                return coeff_count_;
+            }
+
+            /**
+            Returns the number of permutation tables kept, which is at most
+            max_table_count.
+            */
+            std::size_t table_count() const;
+
+        private:
+            GaloisTool(const GaloisTool &copy) = delete;
+
+            GaloisTool &operator =(const GaloisTool &assign) = delete;
+
+            /**
+            Returns the permutation table for galois_elt, computing it first if
+            needed, or nullptr if max_table_count tables are kept already.
+            Tables are never removed, so the result stays valid without holding
+            the lock.
+            */
+            const std::uint32_t *get_ntt_table(std::uint64_t galois_elt) const;
+
+            MemoryPoolHandle pool_;
+
+            int coeff_count_power_ = 0;
+
+            std::size_t coeff_count_ = 0;
+
+            /**
+            For each Galois element, the index of the source value of each
+            destination value in NTT form.
+            */
+            mutable std::unordered_map<std::uint64_t, Pointer<std::uint32_t>> ntt_tables_;
+
+            mutable ReaderWriterLocker tables_locker_;
+        };
+    }
+}
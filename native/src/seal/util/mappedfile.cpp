@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <stdexcept>
+#include "seal/util/mappedfile.h"
+#include "seal/util/common.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+#ifdef _WIN32
+        MappedFile::MappedFile(const string &path)
+        {
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw runtime_error("failed to open file");
+            }
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size))
+            {
+                CloseHandle(file);
+                throw runtime_error("failed to read file size");
+            }
+            size_ = safe_cast<size_t>(file_size.QuadPart);
+            if (!size_)
+            {
+                CloseHandle(file);
+                return;
+            }
+
+            // The view stays valid after both handles are closed
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (!mapping)
+            {
+                throw runtime_error("failed to map file");
+            }
+            data_ = static_cast<SEAL_BYTE*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+            CloseHandle(mapping);
+            if (!data_)
+            {
+                throw runtime_error("failed to map file");
+            }
+        }
+
+        MappedFile::~MappedFile() noexcept
+        {
+            if (data_)
+            {
+                UnmapViewOfFile(data_);
+            }
+        }
+#else
+        MappedFile::MappedFile(const string &path)
+        {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw runtime_error("failed to open file");
+            }
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) != 0)
+            {
+                close(fd);
+                throw runtime_error("failed to read file size");
+            }
+            size_ = safe_cast<size_t>(file_stat.st_size);
+            if (!size_)
+            {
+                close(fd);
+                return;
+            }
+
+            // The mapping stays valid after the file is closed
+            void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED)
+            {
+                throw runtime_error("failed to map file");
+            }
+            data_ = static_cast<SEAL_BYTE*>(data);
+        }
+
+        MappedFile::~MappedFile() noexcept
+        {
+            if (data_)
+            {
+                munmap(data_, size_);
+            }
+        }
+#endif
+    }
+}
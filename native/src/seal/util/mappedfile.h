@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "seal/util/defines.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        A file mapped into memory. The mapping is private and copy-on-write: as
+        long as the memory is only read, its pages are shared through the page
+        cache with every other process mapping the same file, and writing to it
+        changes only a local copy and never the file.
+        */
+        class MappedFile
+        {
+        public:
+            /**
+            Maps the whole file at the given path.
+
+            @throws std::runtime_error if the file could not be opened or mapped
+            */
+            MappedFile(const std::string &path);
+
+            ~MappedFile() noexcept;
+
+            MappedFile(const MappedFile &copy) = delete;
+
+            MappedFile &operator =(const MappedFile &assign) = delete;
+
+            inline SEAL_BYTE *data() const noexcept
+            {
+                return data_;
+            }
+
+            inline std::size_t size() const noexcept
+            {
+                return size_;
+            }
+
+        private:
+            SEAL_BYTE *data_ = nullptr;
+
+            std::size_t size_ = 0;
+        };
+    }
+}
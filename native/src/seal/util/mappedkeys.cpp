@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <cstring>
+#include <stdexcept>
+#include "seal/util/mappedkeys.h"
+#include "seal/util/common.h"
+#include "seal/util/serialization.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        void MappedKeys::save(ostream &stream, const parms_id_type &parms_id,
+            int decomposition_bit_count, const vector<vector<Ciphertext>> &keys)
+        {
+            auto old_except_mask = stream.exceptions();
+            try
+            {
+                // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+                stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+                // The header consists of 64-bit words so the keys start aligned
+                vector<uint64_t> header{ mapped_serialization_magic,
+                    mapped_serialization_version };
+                header.insert(header.end(), parms_id.cbegin(), parms_id.cend());
+                header.push_back(static_cast<uint64_t>(decomposition_bit_count));
+                header.push_back(safe_cast<uint64_t>(keys.size()));
+                for (auto &key : keys)
+                {
+                    header.push_back(safe_cast<uint64_t>(key.size()));
+                }
+                size_t offset = mul_safe(header.size(), sizeof(uint64_t));
+                stream.write(reinterpret_cast<const char*>(header.data()),
+                    safe_cast<streamsize>(offset));
+
+                for (auto &key : keys)
+                {
+                    for (auto &key_component : key)
+                    {
+                        key_component.save_mappable(stream, offset);
+                    }
+                }
+            }
+            catch (const exception &)
+            {
+                stream.exceptions(old_except_mask);
+                throw;
+            }
+
+            stream.exceptions(old_except_mask);
+        }
+
+        void MappedKeys::load(const MappedFile &mapping, MemoryPoolHandle pool,
+            parms_id_type &parms_id, int &decomposition_bit_count,
+            vector<vector<Ciphertext>> &keys)
+        {
+            SEAL_BYTE *buffer = mapping.data();
+            size_t size = mapping.size();
+            size_t offset = 0;
+            auto read_word = [&]()
+            {
+                if (size - offset < sizeof(uint64_t))
+                {
+                    throw invalid_argument("key file is invalid");
+                }
+                uint64_t word;
+                memcpy(&word, buffer + offset, sizeof(uint64_t));
+                offset += sizeof(uint64_t);
+                return word;
+            };
+
+            if (read_word() != mapped_serialization_magic)
+            {
+                throw invalid_argument("key file is invalid");
+            }
+            if (read_word() != mapped_serialization_version)
+            {
+                throw invalid_argument("unsupported serialization version");
+            }
+            parms_id_type new_parms_id;
+            for (auto &word : new_parms_id)
+            {
+                word = read_word();
+            }
+            int new_decomposition_bit_count = static_cast<int>(
+                static_cast<int64_t>(read_word()));
+
+            uint64_t keys_dim1 = read_word();
+            if (keys_dim1 > (size - offset) / sizeof(uint64_t))
+            {
+                throw invalid_argument("key file is invalid");
+            }
+            vector<uint64_t> keys_dim2(safe_cast<size_t>(keys_dim1));
+            for (auto &dim : keys_dim2)
+            {
+                dim = read_word();
+            }
+
+            // The keys refer to the mapped memory
+            vector<vector<Ciphertext>> new_keys;
+            new_keys.reserve(keys_dim2.size());
+            for (auto dim : keys_dim2)
+            {
+                if (dim > size - offset)
+                {
+                    throw invalid_argument("key file is invalid");
+                }
+                new_keys.emplace_back();
+                new_keys.back().reserve(safe_cast<size_t>(dim));
+                for (uint64_t j = 0; j < dim; j++)
+                {
+                    Ciphertext new_key(pool);
+                    new_key.unsafe_load_mapped(buffer, size, offset);
+                    new_keys.back().emplace_back(move(new_key));
+                }
+            }
+
+            parms_id = new_parms_id;
+            decomposition_bit_count = new_decomposition_bit_count;
+            keys = move(new_keys);
+        }
+    }
+}
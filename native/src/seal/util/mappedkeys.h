@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include "seal/ciphertext.h"
+#include "seal/encryptionparams.h"
+#include "seal/memorymanager.h"
+#include "seal/util/mappedfile.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Writes and reads the layout of key files that can be memory-mapped,
+        which RelinKeys and GaloisKeys share. The file starts with a header of
+        64-bit words: mapped_serialization_magic, mapped_serialization_version,
+        the parms_id, the decomposition bit count, the number of keys, and the
+        number of components of each key. Every key component follows in the
+        layout of Ciphertext::save_mappable.
+        */
+        class MappedKeys
+        {
+        public:
+            MappedKeys() = delete;
+
+            /**
+            Writes keys with the given parms_id and decomposition bit count to
+            stream in the layout that load can map.
+            */
+            static void save(std::ostream &stream, const parms_id_type &parms_id,
+                int decomposition_bit_count,
+                const std::vector<std::vector<Ciphertext>> &keys);
+
+            /**
+            Parses a key file written by save from mapping. The key components
+            are allocated from pool and refer to the mapped data without copying
+            it, so mapping must outlive them. The outputs are only changed if
+            the whole file is valid.
+
+            @throws std::invalid_argument if the file is not a valid key file
+            */
+            static void load(const MappedFile &mapping, MemoryPoolHandle pool,
+                parms_id_type &parms_id, int &decomposition_bit_count,
+                std::vector<std::vector<Ciphertext>> &keys);
+        };
+    }
+}
@@ -232,6 +232,9 @@ namespace seal
             virtual std::size_t pool_count() const = 0;
 
             virtual std::size_t alloc_byte_count() const = 0;
+
+            // Whether several threads can allocate from the pool at the same time
+            virtual bool is_thread_safe() const noexcept = 0;
         };
 
         class MemoryPoolMT : public MemoryPool
@@ -254,6 +257,11 @@ namespace seal
 
             std::size_t alloc_byte_count() const override;
 
+            inline bool is_thread_safe() const noexcept override
+            {
+                return true;
+            }
+
         protected:
             MemoryPoolMT(const MemoryPoolMT &copy) = delete;
 
@@ -284,6 +292,11 @@ namespace seal
             }
 
             std::size_t alloc_byte_count() const override;
+
+            inline bool is_thread_safe() const noexcept override
+            {
+                return false;
+            }
             
         protected:
             MemoryPoolST(const MemoryPoolST &copy) = delete;
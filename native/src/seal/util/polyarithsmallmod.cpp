@@ -34,40 +34,23 @@ namespace seal
                 throw invalid_argument("modulus");
             }
 #endif
-            // Explicit inline
-            //for (int i = 0; i < coeff_count; i++)
-            //{
-            //    *result++ = multiply_uint_uint_mod(*poly++, scalar, modulus);
-            //}
+            // Shoup's method: precompute floor(scalar * 2^64 / modulus) once, 
+            // after which each product needs only two multiplications and one 
+            // conditional subtraction.
             const uint64_t modulus_value = modulus.value();
-            const uint64_t const_ratio_0 = modulus.const_ratio()[0];
-            const uint64_t const_ratio_1 = modulus.const_ratio()[1];
+            scalar = barrett_reduce_64(scalar, modulus);
+            uint64_t wide_scalar[2]{ 0, scalar };
+            uint64_t scalar_shoup[2];
+            divide_uint128_uint64_inplace(wide_scalar, modulus_value, scalar_shoup);
             for (; coeff_count--; poly++, result++)
             {
-                unsigned long long z[2], tmp1, tmp2[2], tmp3, carry;
-                multiply_uint64(*poly, scalar, z);
-            
-                // Reduces z using base 2^64 Barrett reduction
-                
-                // Multiply input and const_ratio
-                // Round 1
-                multiply_uint64_hw64(z[0], const_ratio_0, &carry);
-                multiply_uint64(z[0], const_ratio_1, tmp2);
-                tmp3 = tmp2[1] + add_uint64(tmp2[0], carry, &tmp1);
+                unsigned long long tmp;
+                multiply_uint64_hw64(*poly, scalar_shoup[0], &tmp);
 
-                // Round 2
-                multiply_uint64(z[1], const_ratio_0, tmp2);
-                carry = tmp2[1] + add_uint64(tmp1, tmp2[0], &tmp1);
-
-                // This is all we care about
-                tmp1 = z[1] * const_ratio_1 + tmp3 + carry;
-
-                // Barrett subtraction
-                tmp3 = z[0] - tmp1 * modulus_value;
-
-                // Claim: One more subtraction is enough
-                *result = tmp3 - (modulus_value & static_cast<uint64_t>(
-                    -static_cast<int64_t>(tmp3 >= modulus_value)));
+                // The result is in [0, 2 * modulus)
+                tmp = *poly * scalar - tmp * modulus_value;
+                *result = tmp - (modulus_value & static_cast<uint64_t>(
+                    -static_cast<int64_t>(tmp >= modulus_value)));
             }
         }
 
@@ -354,14 +354,29 @@ namespace seal
             {
                 return true;
             }
-            for (; coeff_count--; poly++)
+            if (compare >> 63)
             {
-                if (*poly >= compare)
+                for (; coeff_count--; poly++)
                 {
-                    return false;
+                    if (*poly >= compare)
+                    {
+                        return false;
+                    }
                 }
+                return true;
             }
-            return true;
+
+            // When both are below 2^63, the top bit of coefficient - compare is
+            // set exactly when the coefficient is less than compare. Combining
+            // these bits without branches lets the compiler vectorize the loop.
+            std::uint64_t less_than_acc = ~std::uint64_t(0);
+            std::uint64_t coeff_acc = 0;
+            for (std::size_t i = 0; i < coeff_count; i++)
+            {
+                less_than_acc &= poly[i] - compare;
+                coeff_acc |= poly[i];
+            }
+            return (less_than_acc >> 63) && !(coeff_acc >> 63);
         }
     }
 }
@@ -0,0 +1,458 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "seal/util/serialization.h"
+#include "seal/util/compression.h"
+#include "seal/util/common.h"
+#include "seal/util/defines.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // Values are packed and written in chunks of this many values. It is
+            // a multiple of 64, so every chunk ends on a word boundary.
+            constexpr size_t packed_chunk_size = 512;
+
+            // Compressed members are written in independently compressed chunks
+            // of at most this many bytes, so that neither saving nor loading has
+            // to hold all of the members in memory at once.
+            constexpr size_t compressed_chunk_size = size_t(1) << 20;
+
+            // Output stream buffer that collects the members in chunks and
+            // writes each chunk compressed to the target stream, preceded by its
+            // size and compressed size. A chunk that does not compress is
+            // stored as it is, with both sizes equal. The compression mode byte
+            // of the header is written with the first chunk: if all members fit
+            // in one chunk that does not compress, they are written with
+            // compr_mode_type::none instead.
+            class CompressPutBuffer : public streambuf
+            {
+            public:
+                CompressPutBuffer(ostream &target, compr_mode_type compr_mode) :
+                    target_(target), compr_mode_(compr_mode),
+                    chunk_(compressed_chunk_size)
+                {
+                    setp(chunk_.data(), chunk_.data() + chunk_.size());
+                }
+
+                // Writes the last chunk, the end marker and the Checksum.
+                void finish()
+                {
+                    if (!header_written_)
+                    {
+                        size_t size = static_cast<size_t>(pptr() - pbase());
+                        compress(reinterpret_cast<const SEAL_BYTE*>(pbase()), size,
+                            compr_mode_, compressed_);
+                        if (compressed_.size() >= size)
+                        {
+                            // Freshly encrypted data is indistinguishable from
+                            // random and does not compress
+                            write_byte(static_cast<SEAL_BYTE>(compr_mode_type::none));
+                            checksum_.update(reinterpret_cast<const SEAL_BYTE*>(pbase()),
+                                size);
+                            target_.write(pbase(), safe_cast<streamsize>(size));
+                            write_word(checksum_.digest());
+                            return;
+                        }
+                    }
+                    write_chunk();
+                    write_word(0);
+                    write_word(checksum_.digest());
+                }
+
+            protected:
+                int_type overflow(int_type ch) override
+                {
+                    write_chunk();
+                    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                    {
+                        *pptr() = traits_type::to_char_type(ch);
+                        pbump(1);
+                    }
+                    return traits_type::not_eof(ch);
+                }
+
+            private:
+                void write_byte(SEAL_BYTE value)
+                {
+                    target_.write(reinterpret_cast<const char*>(&value), sizeof(SEAL_BYTE));
+                }
+
+                void write_word(uint64_t value)
+                {
+                    target_.write(reinterpret_cast<const char*>(&value), sizeof(uint64_t));
+                }
+
+                void write_chunk()
+                {
+                    if (!header_written_)
+                    {
+                        write_byte(static_cast<SEAL_BYTE>(compr_mode_));
+                        header_written_ = true;
+                    }
+                    size_t size = static_cast<size_t>(pptr() - pbase());
+                    if (size)
+                    {
+                        const SEAL_BYTE *data = reinterpret_cast<const SEAL_BYTE*>(pbase());
+                        checksum_.update(data, size);
+                        compress(data, size, compr_mode_, compressed_);
+                        if (compressed_.size() >= size)
+                        {
+                            compressed_.assign(data, data + size);
+                        }
+                        write_word(static_cast<uint64_t>(size));
+                        write_word(static_cast<uint64_t>(compressed_.size()));
+                        target_.write(reinterpret_cast<const char*>(compressed_.data()),
+                            safe_cast<streamsize>(compressed_.size()));
+                    }
+                    setp(chunk_.data(), chunk_.data() + chunk_.size());
+                }
+
+                ostream &target_;
+
+                compr_mode_type compr_mode_;
+
+                vector<char> chunk_;
+
+                vector<SEAL_BYTE> compressed_;
+
+                Checksum checksum_;
+
+                bool header_written_ = false;
+            };
+
+            // Input stream buffer that reads the chunks written by
+            // CompressPutBuffer from the source stream and yields the
+            // decompressed members, one chunk at a time.
+            class DecompressGetBuffer : public streambuf
+            {
+            public:
+                DecompressGetBuffer(istream &source, compr_mode_type compr_mode) :
+                    source_(source), compr_mode_(compr_mode)
+                {
+                }
+
+                // Skips any members that were not read, up to the end marker, and
+                // returns the Checksum of all of the members.
+                uint64_t finish()
+                {
+                    while (read_chunk())
+                    {
+                    }
+                    return checksum_.digest();
+                }
+
+            protected:
+                int_type underflow() override
+                {
+                    if (gptr() == egptr() && !read_chunk())
+                    {
+                        return traits_type::eof();
+                    }
+                    return traits_type::to_int_type(*gptr());
+                }
+
+            private:
+                bool read_chunk()
+                {
+                    if (done_)
+                    {
+                        return false;
+                    }
+                    uint64_t size64 = 0;
+                    source_.read(reinterpret_cast<char*>(&size64), sizeof(uint64_t));
+                    if (!size64)
+                    {
+                        done_ = true;
+                        setg(nullptr, nullptr, nullptr);
+                        return false;
+                    }
+                    uint64_t compressed_size64 = 0;
+                    source_.read(reinterpret_cast<char*>(&compressed_size64),
+                        sizeof(uint64_t));
+                    if (size64 > compressed_chunk_size || compressed_size64 > size64)
+                    {
+                        throw invalid_argument("compressed data is invalid");
+                    }
+                    size_t size = static_cast<size_t>(size64);
+                    compressed_.resize(static_cast<size_t>(compressed_size64));
+                    source_.read(reinterpret_cast<char*>(compressed_.data()),
+                        safe_cast<streamsize>(compressed_.size()));
+                    chunk_.resize(size);
+                    decompress(compressed_.data(), compressed_.size(),
+                        (compressed_size64 == size64) ? compr_mode_type::none : compr_mode_,
+                        reinterpret_cast<SEAL_BYTE*>(chunk_.data()), size);
+                    checksum_.update(reinterpret_cast<const SEAL_BYTE*>(chunk_.data()),
+                        size);
+                    setg(chunk_.data(), chunk_.data(), chunk_.data() + size);
+                    return true;
+                }
+
+                istream &source_;
+
+                compr_mode_type compr_mode_;
+
+                vector<SEAL_BYTE> compressed_;
+
+                vector<char> chunk_;
+
+                Checksum checksum_;
+
+                bool done_ = false;
+            };
+        }
+
+        int get_max_significant_bit_count(const uint64_t *values, size_t count)
+        {
+            uint64_t acc = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                acc |= values[i];
+            }
+            return get_significant_bit_count(acc);
+        }
+
+        void pack_uint(const uint64_t *values, size_t count, int bit_count,
+            uint64_t *destination)
+        {
+#ifdef SEAL_DEBUG
+            if (bit_count < 0 || bit_count > bits_per_uint64)
+            {
+                throw invalid_argument("bit_count");
+            }
+#endif
+            if (bit_count == bits_per_uint64)
+            {
+                copy_n(values, count, destination);
+                return;
+            }
+
+            size_t packed_count = packed_uint64_count(count, bit_count);
+            fill_n(destination, packed_count, uint64_t(0));
+            if (!bit_count)
+            {
+                return;
+            }
+
+            // Every value starts in some word and possibly spills into the next
+            size_t bit_pos = 0;
+            for (size_t i = 0; i < count; i++, bit_pos += static_cast<size_t>(bit_count))
+            {
+                size_t word_index = bit_pos >> 6;
+                unsigned shift = static_cast<unsigned>(bit_pos & 63);
+                destination[word_index] |= values[i] << shift;
+                if (shift + static_cast<unsigned>(bit_count) > 64)
+                {
+                    destination[word_index + 1] |= values[i] >> (64 - shift);
+                }
+            }
+        }
+
+        void unpack_uint(const uint64_t *packed, size_t count, int bit_count,
+            uint64_t *destination)
+        {
+#ifdef SEAL_DEBUG
+            if (bit_count < 0 || bit_count > bits_per_uint64)
+            {
+                throw invalid_argument("bit_count");
+            }
+#endif
+            if (bit_count == bits_per_uint64)
+            {
+                copy_n(packed, count, destination);
+                return;
+            }
+            if (!bit_count)
+            {
+                fill_n(destination, count, uint64_t(0));
+                return;
+            }
+
+            uint64_t mask = (uint64_t(1) << bit_count) - 1;
+            size_t bit_pos = 0;
+            for (size_t i = 0; i < count; i++, bit_pos += static_cast<size_t>(bit_count))
+            {
+                size_t word_index = bit_pos >> 6;
+                unsigned shift = static_cast<unsigned>(bit_pos & 63);
+                uint64_t value = packed[word_index] >> shift;
+                if (shift + static_cast<unsigned>(bit_count) > 64)
+                {
+                    value |= packed[word_index + 1] << (64 - shift);
+                }
+                destination[i] = value & mask;
+            }
+        }
+
+        void save_packed_uint(const uint64_t *values, size_t count, int bit_count,
+            ostream &stream)
+        {
+            uint64_t buffer[packed_chunk_size];
+            while (count)
+            {
+                size_t chunk_count = min(count, packed_chunk_size);
+                size_t packed_count = packed_uint64_count(chunk_count, bit_count);
+                pack_uint(values, chunk_count, bit_count, buffer);
+                stream.write(reinterpret_cast<const char*>(buffer),
+                    safe_cast<streamsize>(mul_safe(packed_count, sizeof(uint64_t))));
+                values += chunk_count;
+                count -= chunk_count;
+            }
+        }
+
+        void load_packed_uint(istream &stream, size_t count, int bit_count,
+            uint64_t *destination)
+        {
+            if (bit_count < 0 || bit_count > bits_per_uint64)
+            {
+                throw invalid_argument("bit_count");
+            }
+
+            uint64_t buffer[packed_chunk_size];
+            while (count)
+            {
+                size_t chunk_count = min(count, packed_chunk_size);
+                size_t packed_count = packed_uint64_count(chunk_count, bit_count);
+                stream.read(reinterpret_cast<char*>(buffer),
+                    safe_cast<streamsize>(mul_safe(packed_count, sizeof(uint64_t))));
+                unpack_uint(buffer, chunk_count, bit_count, destination);
+                destination += chunk_count;
+                count -= chunk_count;
+            }
+        }
+
+        void save_versioned(ostream &stream, compr_mode_type compr_mode,
+            const function<void(ostream &)> &save_members)
+        {
+            if (!is_valid_compr_mode(compr_mode))
+            {
+                throw invalid_argument("unsupported compression mode");
+            }
+
+            uint64_t magic = serialization_magic;
+            stream.write(reinterpret_cast<const char*>(&magic), sizeof(uint64_t));
+            SEAL_BYTE version = static_cast<SEAL_BYTE>(serialization_version);
+            stream.write(reinterpret_cast<const char*>(&version), sizeof(SEAL_BYTE));
+            if (compr_mode == compr_mode_type::none)
+            {
+                SEAL_BYTE compr_mode_byte = static_cast<SEAL_BYTE>(compr_mode);
+                stream.write(reinterpret_cast<const char*>(&compr_mode_byte), sizeof(SEAL_BYTE));
+                ChecksumPutBuffer members_buffer(stream.rdbuf());
+                ostream members_stream(&members_buffer);
+                members_stream.exceptions(ios_base::badbit | ios_base::failbit);
+                save_members(members_stream);
+                uint64_t checksum = members_buffer.digest();
+                stream.write(reinterpret_cast<const char*>(&checksum), sizeof(uint64_t));
+                return;
+            }
+
+            // Compress the members in chunks as they are written; the header
+            // records the mode that is actually used
+            if (!is_supported_compr_mode(compr_mode))
+            {
+                compr_mode = compr_mode_type::lz;
+            }
+            CompressPutBuffer members_buffer(stream, compr_mode);
+            ostream members_stream(&members_buffer);
+            members_stream.exceptions(ios_base::badbit | ios_base::failbit);
+            save_members(members_stream);
+            members_buffer.finish();
+        }
+
+        void load_versioned(istream &stream,
+            const function<void(istream &)> &load_members)
+        {
+            SEAL_BYTE version_byte;
+            stream.read(reinterpret_cast<char*>(&version_byte), sizeof(SEAL_BYTE));
+            if (static_cast<uint8_t>(version_byte) != serialization_version)
+            {
+                throw invalid_argument("unsupported serialization version");
+            }
+            SEAL_BYTE compr_mode_byte;
+            stream.read(reinterpret_cast<char*>(&compr_mode_byte), sizeof(SEAL_BYTE));
+            compr_mode_type compr_mode = static_cast<compr_mode_type>(compr_mode_byte);
+            if (!is_valid_compr_mode(compr_mode))
+            {
+                throw invalid_argument("unsupported compression mode");
+            }
+
+            auto verify = [&](uint64_t computed_checksum)
+            {
+                uint64_t checksum = 0;
+                stream.read(reinterpret_cast<char*>(&checksum), sizeof(uint64_t));
+                if (checksum != computed_checksum)
+                {
+                    throw invalid_argument("data does not match its checksum");
+                }
+            };
+
+            if (compr_mode == compr_mode_type::none)
+            {
+                ChecksumGetBuffer members_buffer(stream.rdbuf());
+                istream members_stream(&members_buffer);
+                members_stream.exceptions(ios_base::badbit | ios_base::failbit);
+                load_members(members_stream);
+                verify(members_buffer.digest());
+                return;
+            }
+
+            DecompressGetBuffer members_buffer(stream, compr_mode);
+            istream members_stream(&members_buffer);
+            members_stream.exceptions(ios_base::badbit | ios_base::failbit);
+            load_members(members_stream);
+            verify(members_buffer.finish());
+        }
+
+        size_t save_to_buffer(SEAL_BYTE *out, size_t size,
+            const function<void(ostream &)> &save)
+        {
+            if (!out && size)
+            {
+                throw invalid_argument("out cannot be null");
+            }
+            ArrayPutBuffer buffer(reinterpret_cast<char*>(out), size);
+            ostream stream(&buffer);
+            try
+            {
+                save(stream);
+            }
+            catch (const exception &)
+            {
+                if (buffer.overflowed())
+                {
+                    throw invalid_argument("out is too small");
+                }
+                throw;
+            }
+            return buffer.write_count();
+        }
+
+        size_t load_from_buffer(const SEAL_BYTE *in, size_t size,
+            const function<void(istream &)> &load)
+        {
+            if (!in && size)
+            {
+                throw invalid_argument("in cannot be null");
+            }
+            ArrayGetBuffer buffer(reinterpret_cast<const char*>(in), size);
+            istream stream(&buffer);
+            load(stream);
+            return buffer.read_count();
+        }
+
+        size_t compute_save_size(const function<void(ostream &)> &save)
+        {
+            CountingPutBuffer buffer;
+            ostream stream(&buffer);
+            save(stream);
+            return buffer.write_count();
+        }
+    }
+}
@@ -0,0 +1,371 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+#include <functional>
+#include "seal/serialization.h"
+#include "seal/util/checksum.h"
+#include "seal/util/common.h"
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        Marks an object saved in the versioned serialization format. The marker
+        takes the place of the first word of the parms_id in the original format,
+        which it is assumed never to equal.
+        */
+        constexpr std::uint64_t serialization_magic = 0x544D524653414553ULL;
+
+        /**
+        Current version of the versioned serialization format. The members are
+        followed by a Checksum of the (uncompressed) members, and compressed
+        members are written in independent chunks of bounded size.
+        */
+        constexpr std::uint8_t serialization_version = 1;
+
+        /**
+        Marks a key file in the layout that can be memory-mapped.
+        */
+        constexpr std::uint64_t mapped_serialization_magic = 0x50414D4B4C414553ULL;
+
+        /**
+        Current version of the layout of key files that can be memory-mapped.
+        */
+        constexpr std::uint64_t mapped_serialization_version = 1;
+
+        /**
+        In key files that can be memory-mapped, the coefficient data of every
+        ciphertext starts at a multiple of this many bytes from the start of the
+        file.
+        */
+        constexpr std::size_t mapped_data_alignment = 64;
+
+        /**
+        Marks a GaloisKeys saved with an index of the offsets of its keys.
+        */
+        constexpr std::uint64_t indexed_serialization_magic = 0x5844494B4C414553ULL;
+
+        /**
+        Current version of the indexed layout of GaloisKeys.
+        */
+        constexpr std::uint64_t indexed_serialization_version = 1;
+
+        /**
+        Read-only stream buffer over an existing array of bytes.
+        */
+        class ArrayGetBuffer : public std::streambuf
+        {
+        public:
+            ArrayGetBuffer(const char *data, std::size_t size)
+            {
+                char *begin = const_cast<char*>(data);
+                setg(begin, begin, begin + size);
+            }
+
+            /**
+            Returns the number of bytes read so far.
+            */
+            inline std::size_t read_count() const noexcept
+            {
+                return static_cast<std::size_t>(gptr() - eback());
+            }
+        };
+
+        /**
+        Stream buffer that writes to an existing array of bytes and fails when
+        the array is full.
+        */
+        class ArrayPutBuffer : public std::streambuf
+        {
+        public:
+            ArrayPutBuffer(char *data, std::size_t size)
+            {
+                setp(data, data + size);
+            }
+
+            /**
+            Returns the number of bytes written so far.
+            */
+            inline std::size_t write_count() const noexcept
+            {
+                return static_cast<std::size_t>(pptr() - pbase());
+            }
+
+            /**
+            Returns whether a write failed because the array was full.
+            */
+            inline bool overflowed() const noexcept
+            {
+                return overflowed_;
+            }
+
+        protected:
+            int_type overflow(int_type ch) override
+            {
+                if (traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    return traits_type::not_eof(ch);
+                }
+                overflowed_ = true;
+                return traits_type::eof();
+            }
+
+        private:
+            bool overflowed_ = false;
+        };
+
+        /**
+        Stream buffer that discards what is written to it and only counts the
+        bytes.
+        */
+        class CountingPutBuffer : public std::streambuf
+        {
+        public:
+            /**
+            Returns the number of bytes written so far.
+            */
+            inline std::size_t write_count() const noexcept
+            {
+                return count_;
+            }
+
+        protected:
+            int_type overflow(int_type ch) override
+            {
+                if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    count_++;
+                }
+                return traits_type::not_eof(ch);
+            }
+
+            std::streamsize xsputn(const char *, std::streamsize count) override
+            {
+                count_ += static_cast<std::size_t>(count);
+                return count;
+            }
+
+        private:
+            std::size_t count_ = 0;
+        };
+
+        /**
+        Calls save on a stream that writes directly to the size bytes at out,
+        and returns the number of bytes written.
+
+        @throws std::invalid_argument if out is null and size is positive
+        @throws std::invalid_argument if the output does not fit in size bytes
+        @throws std::exception if save fails otherwise
+        */
+        std::size_t save_to_buffer(SEAL_BYTE *out, std::size_t size,
+            const std::function<void(std::ostream &)> &save);
+
+        /**
+        Calls load on a stream that reads directly from the size bytes at in,
+        and returns the number of bytes read.
+
+        @throws std::invalid_argument if in is null and size is positive
+        @throws std::exception if load fails
+        */
+        std::size_t load_from_buffer(const SEAL_BYTE *in, std::size_t size,
+            const std::function<void(std::istream &)> &load);
+
+        /**
+        Returns the number of bytes that save writes, without storing them.
+        */
+        std::size_t compute_save_size(
+            const std::function<void(std::ostream &)> &save);
+
+        /**
+        Output stream buffer that passes everything written to it on to another
+        stream buffer and computes a Checksum of it.
+        */
+        class ChecksumPutBuffer : public std::streambuf
+        {
+        public:
+            ChecksumPutBuffer(std::streambuf *target) : target_(target)
+            {
+            }
+
+            inline std::uint64_t digest() const noexcept
+            {
+                return checksum_.digest();
+            }
+
+        protected:
+            int_type overflow(int_type ch) override
+            {
+                if (traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    return traits_type::not_eof(ch);
+                }
+                SEAL_BYTE byte = static_cast<SEAL_BYTE>(traits_type::to_char_type(ch));
+                checksum_.update(&byte, 1);
+                return target_->sputc(traits_type::to_char_type(ch));
+            }
+
+            std::streamsize xsputn(const char *data, std::streamsize count) override
+            {
+                std::streamsize written = target_->sputn(data, count);
+                checksum_.update(reinterpret_cast<const SEAL_BYTE*>(data),
+                    static_cast<std::size_t>(written));
+                return written;
+            }
+
+            int sync() override
+            {
+                return target_->pubsync();
+            }
+
+        private:
+            std::streambuf *target_;
+
+            Checksum checksum_;
+        };
+
+        /**
+        Input stream buffer that reads from another stream buffer and computes a
+        Checksum of what it reads. It reads no further ahead than requested, so
+        the other stream buffer can be used again afterwards.
+        */
+        class ChecksumGetBuffer : public std::streambuf
+        {
+        public:
+            ChecksumGetBuffer(std::streambuf *source) : source_(source)
+            {
+            }
+
+            inline std::uint64_t digest() const noexcept
+            {
+                return checksum_.digest();
+            }
+
+        protected:
+            int_type underflow() override
+            {
+                return source_->sgetc();
+            }
+
+            int_type uflow() override
+            {
+                int_type ch = source_->sbumpc();
+                if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                {
+                    SEAL_BYTE byte = static_cast<SEAL_BYTE>(traits_type::to_char_type(ch));
+                    checksum_.update(&byte, 1);
+                }
+                return ch;
+            }
+
+            std::streamsize xsgetn(char *data, std::streamsize count) override
+            {
+                std::streamsize read = source_->sgetn(data, count);
+                checksum_.update(reinterpret_cast<const SEAL_BYTE*>(data),
+                    static_cast<std::size_t>(read));
+                return read;
+            }
+
+        private:
+            std::streambuf *source_;
+
+            Checksum checksum_;
+        };
+
+        /**
+        Writes the versioned serialization header to stream, followed by the
+        output of save_members and its Checksum. If compr_mode is not
+        compr_mode_type::none, the output of save_members is compressed in
+        chunks of bounded size as it is written. Chunks that do not compress are
+        stored as they are, and if the whole output fits in one such chunk, it
+        is written without compression.
+        */
+        void save_versioned(std::ostream &stream, compr_mode_type compr_mode,
+            const std::function<void(std::ostream &)> &save_members);
+
+        /**
+        Reads the rest of a versioned serialization header from stream, after
+        serialization_magic has already been read, and then calls load_members
+        on a stream that yields the (decompressed) members. Compressed data is
+        decompressed one chunk at a time, and the size of each chunk is checked
+        against the chunk size limit before memory is allocated for it, and the
+        members are verified against the stored Checksum.
+
+        @throws std::invalid_argument if the version or compression mode is not
+        recognized, the compressed data is invalid, or the members do not match
+        the stored Checksum
+        */
+        void load_versioned(std::istream &stream,
+            const std::function<void(std::istream &)> &load_members);
+
+        /**
+        Returns the number of bytes save_versioned writes without compression
+        when save_members writes members_size bytes.
+        */
+        inline std::size_t versioned_save_size(std::size_t members_size)
+        {
+            // Magic, version and compression mode, then the trailing Checksum
+            return add_safe(members_size, sizeof(std::uint64_t) + 2 * sizeof(SEAL_BYTE),
+                sizeof(std::uint64_t));
+        }
+
+        /**
+        Returns the number of bits needed to represent the largest of the given
+        values, or zero if all of them are zero.
+        */
+        int get_max_significant_bit_count(const std::uint64_t *values,
+            std::size_t count);
+
+        /**
+        Returns the number of 64-bit words needed to pack count values of
+        bit_count bits each.
+        */
+        inline std::size_t packed_uint64_count(std::size_t count, int bit_count)
+        {
+            return static_cast<std::size_t>((static_cast<unsigned long long>(count) *
+                static_cast<unsigned long long>(bit_count) + 63) >> 6);
+        }
+
+        /**
+        Packs count values of at most bit_count bits each into
+        packed_uint64_count(count, bit_count) words of destination, starting
+        from the least significant bits of the first word.
+        */
+        void pack_uint(const std::uint64_t *values, std::size_t count,
+            int bit_count, std::uint64_t *destination);
+
+        /**
+        Inverse of pack_uint.
+        */
+        void unpack_uint(const std::uint64_t *packed, std::size_t count,
+            int bit_count, std::uint64_t *destination);
+
+        /**
+        Writes count values of at most bit_count bits each to stream in packed
+        form. Exactly packed_uint64_count(count, bit_count) words are written.
+        */
+        void save_packed_uint(const std::uint64_t *values, std::size_t count,
+            int bit_count, std::ostream &stream);
+
+        /**
+        Returns the number of bytes save_packed_uint writes.
+        */
+        inline std::size_t packed_uint_save_size(std::size_t count, int bit_count)
+        {
+            return mul_safe(packed_uint64_count(count, bit_count), sizeof(std::uint64_t));
+        }
+
+        /**
+        Reads count values of bit_count bits each, written by save_packed_uint,
+        from stream to destination.
+        */
+        void load_packed_uint(std::istream &stream, std::size_t count,
+            int bit_count, std::uint64_t *destination);
+    }
+}
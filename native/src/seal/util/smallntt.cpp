@@ -115,6 +115,140 @@ namespace seal
             return true;
         }
 
+        void SmallNTTTables::copy_from(const SmallNTTTables &source)
+        {
+            if (&source == this)
+            {
+                return;
+            }
+
+            reset();
+            if (!source.generated_)
+            {
+                return;
+            }
+            coeff_count_power_ = source.coeff_count_power_;
+            coeff_count_ = source.coeff_count_;
+            modulus_ = source.modulus_;
+            root_ = source.root_;
+            inv_degree_modulo_ = source.inv_degree_modulo_;
+            auto copy_table = [this](const Pointer<uint64_t> &table)
+            {
+                auto new_table(allocate_uint(coeff_count_, pool_));
+                set_uint_uint(table.get(), coeff_count_, new_table.get());
+                return new_table;
+            };
+            root_powers_ = copy_table(source.root_powers_);
+            scaled_root_powers_ = copy_table(source.scaled_root_powers_);
+            inv_root_powers_div_two_ = copy_table(source.inv_root_powers_div_two_);
+            scaled_inv_root_powers_div_two_ = copy_table(source.scaled_inv_root_powers_div_two_);
+            inv_root_powers_ = copy_table(source.inv_root_powers_);
+            scaled_inv_root_powers_ = copy_table(source.scaled_inv_root_powers_);
+            generated_ = true;
+        }
+
+        void SmallNTTTables::save(ostream &stream) const
+        {
+            if (!generated_)
+            {
+                throw logic_error("tables are not generated");
+            }
+
+            auto old_except_mask = stream.exceptions();
+            try
+            {
+                // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+                stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+                int32_t coeff_count_power32 = static_cast<int32_t>(coeff_count_power_);
+                stream.write(reinterpret_cast<const char*>(&coeff_count_power32),
+                    sizeof(int32_t));
+                uint64_t modulus_value = modulus_.value();
+                stream.write(reinterpret_cast<const char*>(&modulus_value), sizeof(uint64_t));
+                stream.write(reinterpret_cast<const char*>(&root_), sizeof(uint64_t));
+                stream.write(reinterpret_cast<const char*>(&inv_degree_modulo_),
+                    sizeof(uint64_t));
+
+                streamsize table_size = safe_cast<streamsize>(
+                    mul_safe(coeff_count_, sizeof(uint64_t)));
+                for (auto table : { &root_powers_, &scaled_root_powers_,
+                    &inv_root_powers_div_two_, &scaled_inv_root_powers_div_two_,
+                    &inv_root_powers_, &scaled_inv_root_powers_ })
+                {
+                    stream.write(reinterpret_cast<const char*>(table->get()), table_size);
+                }
+            }
+            catch (const exception &)
+            {
+                stream.exceptions(old_except_mask);
+                throw;
+            }
+
+            stream.exceptions(old_except_mask);
+        }
+
+        void SmallNTTTables::load(istream &stream)
+        {
+            reset();
+
+            auto old_except_mask = stream.exceptions();
+            try
+            {
+                // Throw exceptions on std::ios_base::badbit and std::ios_base::failbit
+                stream.exceptions(ios_base::badbit | ios_base::failbit);
+
+                int32_t coeff_count_power32 = 0;
+                stream.read(reinterpret_cast<char*>(&coeff_count_power32), sizeof(int32_t));
+                if ((coeff_count_power32 < get_power_of_two(SEAL_POLY_MOD_DEGREE_MIN)) ||
+                    coeff_count_power32 > get_power_of_two(SEAL_POLY_MOD_DEGREE_MAX))
+                {
+                    throw invalid_argument("coeff_count_power out of range");
+                }
+                uint64_t modulus_value = 0;
+                stream.read(reinterpret_cast<char*>(&modulus_value), sizeof(uint64_t));
+                SmallModulus modulus(modulus_value);
+                uint64_t root = 0;
+                stream.read(reinterpret_cast<char*>(&root), sizeof(uint64_t));
+                uint64_t inv_degree_modulo = 0;
+                stream.read(reinterpret_cast<char*>(&inv_degree_modulo), sizeof(uint64_t));
+
+                // The root must be a primitive 2n-th root of unity, so its n-th
+                // power is -1
+                size_t coeff_count = size_t(1) << coeff_count_power32;
+                if (modulus.value() < 2 || root >= modulus.value() ||
+                    exponentiate_uint_mod(root, coeff_count, modulus) != modulus.value() - 1 ||
+                    multiply_uint_uint_mod(inv_degree_modulo, coeff_count, modulus) != 1)
+                {
+                    throw invalid_argument("tables are invalid");
+                }
+
+                coeff_count_power_ = safe_cast<int>(coeff_count_power32);
+                coeff_count_ = coeff_count;
+                modulus_ = modulus;
+                root_ = root;
+                inv_degree_modulo_ = inv_degree_modulo;
+
+                streamsize table_size = safe_cast<streamsize>(
+                    mul_safe(coeff_count_, sizeof(uint64_t)));
+                for (auto table : { &root_powers_, &scaled_root_powers_,
+                    &inv_root_powers_div_two_, &scaled_inv_root_powers_div_two_,
+                    &inv_root_powers_, &scaled_inv_root_powers_ })
+                {
+                    *table = allocate_uint(coeff_count_, pool_);
+                    stream.read(reinterpret_cast<char*>(table->get()), table_size);
+                }
+                generated_ = true;
+            }
+            catch (const exception &)
+            {
+                reset();
+                stream.exceptions(old_except_mask);
+                throw;
+            }
+
+            stream.exceptions(old_except_mask);
+        }
+
         void SmallNTTTables::ntt_powers_of_primitive_root(uint64_t root, 
             uint64_t *destination) const
         {
@@ -154,8 +288,8 @@ namespace seal
 
         For details, see Michael Naehrig and Patrick Longa.
         */
-        void ntt_negacyclic_harvey_lazy(uint64_t *operand, 
-            const SmallNTTTables &tables)
+        void ntt_negacyclic_harvey_lazy_partial(uint64_t *operand, 
+            const SmallNTTTables &tables, size_t min_gap)
         {
             uint64_t modulus = tables.modulus().value();
             uint64_t two_times_modulus = modulus * 2;
@@ -163,7 +297,7 @@ namespace seal
             // Return the NTT in scrambled order
             size_t n = size_t(1) << tables.coeff_count_power();
             size_t t = n >> 1;
-            for (size_t m = 1; m < n; m <<= 1)
+            for (size_t m = 1; (m < n) && (t >= min_gap); m <<= 1)
             {
                 if (t >= 4)
                 {
@@ -236,16 +370,17 @@ namespace seal
         }
 
         // Inverse negacyclic NTT using Harvey's butterfly. (See Patrick Longa and Michael Naehrig). 
-        void inverse_ntt_negacyclic_harvey_lazy(uint64_t *operand, const SmallNTTTables &tables)
+        void inverse_ntt_negacyclic_harvey_lazy_partial(uint64_t *operand,
+            const SmallNTTTables &tables, size_t min_gap)
         {
             uint64_t modulus = tables.modulus().value();
             uint64_t two_times_modulus = modulus * 2;
 
             // return the bit-reversed order of NTT. 
             size_t n = size_t(1) << tables.coeff_count_power();
-            size_t t = 1;
+            size_t t = min_gap;
 
-            for (size_t m = n; m > 1; m >>= 1)
+            for (size_t m = n / min_gap; m > 1; m >>= 1)
             {
                 size_t j1 = 0;
                 size_t h = m >> 1;
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <stdexcept>
+#include <iostream>
+#include <functional>
 #include "seal/util/pointer.h"
 #include "seal/memorymanager.h"
 #include "seal/smallmodulus.h"
@@ -38,6 +40,32 @@ namespace seal
 
             void reset();
 
+            /**
+            Makes the tables a copy of the given tables, in place of generating
+            the same tables again.
+
+            @param[in] source The tables to copy
+            */
+            void copy_from(const SmallNTTTables &source);
+
+            /**
+            Saves the generated tables to an output stream.
+
+            @throws std::logic_error if the tables are not generated
+            @throws std::exception if the tables could not be written to stream
+            */
+            void save(std::ostream &stream) const;
+
+            /**
+            Loads tables saved with save, in place of generating them. Only the
+            metadata is checked, and that the root is a primitive root of the
+            right degree; the rest is assumed to come from a trusted source.
+
+            @throws std::invalid_argument if the loaded metadata is invalid
+            @throws std::exception if the tables could not be read from stream
+            */
+            void load(std::istream &stream);
+
             inline std::uint64_t get_root() const
             {
 #ifdef SEAL_DEBUG
@@ -220,8 +248,42 @@ namespace seal
 
         };
 
-        void ntt_negacyclic_harvey_lazy(std::uint64_t *operand, 
-            const SmallNTTTables &tables);
+        /**
+        Sets up tables for the given coeff_count_power and modulus in place of
+        SmallNTTTables::generate, and returns whether this succeeded. This allows
+        the tables to come from somewhere other than a fresh computation.
+        */
+        using SmallNTTTablesGenerator = std::function<bool(
+            SmallNTTTables &tables, int coeff_count_power, const SmallModulus &modulus)>;
+
+        /**
+        Sets up tables with generate_tables, or with SmallNTTTables::generate if
+        generate_tables is empty.
+        */
+        inline bool generate_small_ntt_tables(SmallNTTTables &tables,
+            int coeff_count_power, const SmallModulus &modulus,
+            const SmallNTTTablesGenerator &generate_tables)
+        {
+            if (generate_tables)
+            {
+                return generate_tables(tables, coeff_count_power, modulus);
+            }
+            return tables.generate(coeff_count_power, modulus);
+        }
+
+        /**
+        Performs only those butterfly layers of ntt_negacyclic_harvey_lazy whose
+        gap is at least min_gap, which must be a power of two. The omitted final
+        layers can then be fused with further processing of the output.
+        */
+        void ntt_negacyclic_harvey_lazy_partial(std::uint64_t *operand, 
+            const SmallNTTTables &tables, std::size_t min_gap);
+
+        inline void ntt_negacyclic_harvey_lazy(std::uint64_t *operand, 
+            const SmallNTTTables &tables)
+        {
+            ntt_negacyclic_harvey_lazy_partial(operand, tables, 1);
+        }
 
         inline void ntt_negacyclic_harvey(std::uint64_t *operand, 
             const SmallNTTTables &tables)
@@ -248,8 +310,19 @@ namespace seal
             }
         }
 
-        void inverse_ntt_negacyclic_harvey_lazy(std::uint64_t *operand, 
-            const SmallNTTTables &tables);
+        /**
+        Performs only those butterfly layers of inverse_ntt_negacyclic_harvey_lazy
+        whose gap is at least min_gap, which must be a power of two. The omitted
+        initial layers can then be fused with preprocessing of the input.
+        */
+        void inverse_ntt_negacyclic_harvey_lazy_partial(std::uint64_t *operand, 
+            const SmallNTTTables &tables, std::size_t min_gap);
+
+        inline void inverse_ntt_negacyclic_harvey_lazy(std::uint64_t *operand, 
+            const SmallNTTTables &tables)
+        {
+            inverse_ntt_negacyclic_harvey_lazy_partial(operand, tables, 1);
+        }
 
         inline void inverse_ntt_negacyclic_harvey(std::uint64_t *operand, 
             const SmallNTTTables &tables)
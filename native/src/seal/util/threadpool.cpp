@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include "seal/util/threadpool.h"
+
+using namespace std;
+
+namespace seal
+{
+    namespace util
+    {
+        namespace
+        {
+            // Shared state of a single call to parallel_for
+            struct ParallelForState
+            {
+                size_t count = 0;
+
+                size_t block_size = 1;
+
+                const ThreadPool::task_type *task = nullptr;
+
+                atomic<size_t> next_index{ 0 };
+
+                atomic<size_t> next_thread_index{ 0 };
+
+                size_t done_count = 0;
+
+                exception_ptr exception{ nullptr };
+
+                mutex state_mutex;
+
+                condition_variable done_cv;
+
+                void run()
+                {
+                    size_t thread_index = next_thread_index++;
+                    while (true)
+                    {
+                        size_t begin = next_index.fetch_add(block_size);
+                        if (begin >= count)
+                        {
+                            return;
+                        }
+                        size_t end = min(begin + block_size, count);
+
+                        bool skip;
+                        {
+                            lock_guard<mutex> lock(state_mutex);
+                            skip = static_cast<bool>(exception);
+                        }
+                        if (!skip)
+                        {
+                            try
+                            {
+                                (*task)(begin, end, thread_index);
+                            }
+                            catch (...)
+                            {
+                                lock_guard<mutex> lock(state_mutex);
+                                if (!exception)
+                                {
+                                    exception = current_exception();
+                                }
+                            }
+                        }
+
+                        lock_guard<mutex> lock(state_mutex);
+                        done_count += end - begin;
+                        if (done_count == count)
+                        {
+                            done_cv.notify_all();
+                        }
+                    }
+                }
+            };
+        }
+
+        ThreadPool::ThreadPool(size_t worker_count)
+        {
+            workers_.reserve(worker_count);
+            for (size_t i = 0; i < worker_count; i++)
+            {
+                workers_.emplace_back(&ThreadPool::worker_loop, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                lock_guard<mutex> lock(jobs_mutex_);
+                stop_ = true;
+            }
+            jobs_cv_.notify_all();
+            for (auto &worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::worker_loop()
+        {
+            while (true)
+            {
+                function<void()> job;
+                {
+                    unique_lock<mutex> lock(jobs_mutex_);
+                    jobs_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                    if (jobs_.empty())
+                    {
+                        return;
+                    }
+                    job = move(jobs_.front());
+                    jobs_.pop_front();
+                }
+                job();
+            }
+        }
+
+        void ThreadPool::parallel_for(size_t count, size_t thread_count,
+            const task_type &task)
+        {
+            if (!count)
+            {
+                return;
+            }
+            if (!thread_count || thread_count > max_thread_count())
+            {
+                thread_count = max_thread_count();
+            }
+            thread_count = min(thread_count, count);
+            if (thread_count == 1)
+            {
+                task(0, count, 0);
+                return;
+            }
+
+            auto state = make_shared<ParallelForState>();
+            state->count = count;
+            state->task = &task;
+
+            // Use a few blocks per thread for load balancing
+            state->block_size = max<size_t>(1, count / (4 * thread_count));
+
+            // Post helpers; the calling thread is the remaining participant
+            {
+                lock_guard<mutex> lock(jobs_mutex_);
+                for (size_t i = 1; i < thread_count; i++)
+                {
+                    jobs_.emplace_back([state]() { state->run(); });
+                }
+            }
+            jobs_cv_.notify_all();
+
+            state->run();
+
+            // Wait for the helpers to finish their blocks. Helpers that start
+            // only after all blocks are claimed return without calling task.
+            unique_lock<mutex> lock(state->state_mutex);
+            state->done_cv.wait(lock, [&state]() {
+                return state->done_count == state->count; });
+            if (state->exception)
+            {
+                rethrow_exception(state->exception);
+            }
+        }
+
+        ThreadPool &ThreadPool::Global()
+        {
+            static ThreadPool global_pool(max<size_t>(
+                thread::hardware_concurrency(), size_t(1)) - 1);
+            return global_pool;
+        }
+    }
+}
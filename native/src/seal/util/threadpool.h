@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace seal
+{
+    namespace util
+    {
+        /**
+        A simple fixed-size pool of worker threads used to parallelize batch
+        operations. The thread calling parallel_for always participates in the
+        work, so nested calls to parallel_for from within a task cannot deadlock
+        even when all worker threads are busy.
+        */
+        class ThreadPool
+        {
+        public:
+            /**
+            Signature of a task run by parallel_for. The task is called for
+            disjoint ranges [begin, end) covering the full index range, together
+            with the index of the participating thread. Thread indices are in
+            the range [0, thread_count) given to parallel_for, and no two
+            concurrent calls receive the same thread index. This allows tasks
+            to use per-thread state, such as random number generators.
+            */
+            using task_type = std::function<void(
+                std::size_t begin, std::size_t end, std::size_t thread_index)>;
+
+            /**
+            Creates a thread pool with the given number of worker threads.
+
+            @param[in] worker_count The number of worker threads
+            */
+            explicit ThreadPool(std::size_t worker_count);
+
+            /**
+            Waits for all worker threads to finish and destroys the pool.
+            */
+            ~ThreadPool();
+
+            /**
+            Returns the number of worker threads.
+            */
+            inline std::size_t worker_count() const noexcept
+            {
+                return workers_.size();
+            }
+
+            /**
+            Runs task over the index range [0, count) using at most thread_count
+            threads, including the calling thread. If thread_count is zero, all
+            worker threads are used. The function returns when all indices have
+            been processed. If a task throws, the remaining ranges are skipped
+            and the first exception is rethrown in the calling thread.
+
+            @param[in] count The size of the index range
+            @param[in] thread_count The maximum number of threads to use
+            @param[in] task The task to run
+            */
+            void parallel_for(std::size_t count, std::size_t thread_count,
+                const task_type &task);
+
+            /**
+            Returns the number of threads parallel_for uses when thread_count is
+            given as zero.
+            */
+            inline std::size_t max_thread_count() const noexcept
+            {
+                return workers_.size() + 1;
+            }
+
+            /**
+            Returns a reference to a process-wide thread pool with one worker
+            thread less than the number of hardware threads. The pool is created
+            on first use.
+            */
+            static ThreadPool &Global();
+
+        private:
+            ThreadPool(const ThreadPool &copy) = delete;
+
+            ThreadPool &operator =(const ThreadPool &assign) = delete;
+
+            void worker_loop();
+
+            std::vector<std::thread> workers_;
+
+            std::deque<std::function<void()>> jobs_;
+
+            std::mutex jobs_mutex_;
+
+            std::condition_variable jobs_cv_;
+
+            bool stop_ = false;
+        };
+    }
+}
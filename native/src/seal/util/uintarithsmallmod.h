@@ -186,6 +186,29 @@ namespace seal
                     -static_cast<std::int64_t>(tmp3 >= modulus.value())));
         }
 
+        template<typename T, typename = std::enable_if<is_uint64_v<T>>>
+        inline std::uint64_t barrett_reduce_64(T input, const SmallModulus &modulus)
+        {
+#ifdef SEAL_DEBUG
+            if (modulus.is_zero())
+            {
+                throw std::invalid_argument("modulus");
+            }
+#endif
+            // Reduces input using base 2^64 Barrett reduction
+            // The high word of const_ratio is floor(2^64 / modulus)
+            unsigned long long tmp;
+            multiply_uint64_hw64(input, modulus.const_ratio()[1], &tmp);
+
+            // Barrett subtraction
+            tmp = input - tmp * modulus.value();
+
+            // Claim: One more subtraction is enough
+            return static_cast<std::uint64_t>(tmp) -
+                (modulus.value() & static_cast<uint64_t>(
+                    -static_cast<std::int64_t>(tmp >= modulus.value())));
+        }
+
         inline std::uint64_t multiply_uint_uint_mod(std::uint64_t operand1, 
             std::uint64_t operand2, const SmallModulus &modulus)
         {
@@ -6,6 +6,7 @@
 #include "seal/context.h"
 #include "seal/defaultparams.h"
 #include "seal/keygenerator.h"
+#include "seal/evaluator.h"
 #include <vector>
 #include <ctime>
 
@@ -174,4 +175,97 @@ namespace SEALTest
             ASSERT_TRUE(short_plain[i] == 0);
         }
     }
+
+    TEST(BatchEncoderTest, BatchMatchesPolynomialEvaluation)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0) });
+        parms.set_plain_modulus(257);
+
+        auto context = SEALContext::Create(parms);
+        auto &context_data = *context->context_data();
+        BatchEncoder batch_encoder(context);
+        size_t slots = batch_encoder.slot_count();
+        size_t row_size = slots / 2;
+        auto &plain_modulus = parms.plain_modulus();
+        uint64_t root = context_data.plain_ntt_tables()->get_root();
+
+        // Slot i of the first row is the evaluation at root^(3^i), and slot i of 
+        // the second row is the evaluation at root^(-3^i)
+        Plaintext plain(slots);
+        for (size_t i = 0; i < slots; i++)
+        {
+            plain[i] = (i * i + 7) % plain_modulus.value();
+        }
+        vector<uint64_t> values;
+        batch_encoder.decode(plain, values);
+        ASSERT_EQ(slots, values.size());
+
+        uint64_t m = 2 * slots;
+        uint64_t pos = 1;
+        for (size_t i = 0; i < row_size; i++)
+        {
+            uint64_t points[2]{ exponentiate_uint_mod(root, pos, plain_modulus),
+                exponentiate_uint_mod(root, m - pos, plain_modulus) };
+            for (size_t row = 0; row < 2; row++)
+            {
+                uint64_t eval = 0;
+                for (size_t j = slots; j--; )
+                {
+                    eval = add_uint_uint_mod(multiply_uint_uint_mod(
+                        eval, points[row], plain_modulus), plain[j], plain_modulus);
+                }
+                ASSERT_EQ(eval, values[row * row_size + i]);
+            }
+            pos = (pos * 3) % m;
+        }
+
+        // Encoding recovers the polynomial
+        Plaintext plain2;
+        batch_encoder.encode(values, plain2);
+        ASSERT_TRUE(plain == plain2);
+    }
+
+    TEST(BatchEncoderTest, BatchToNTTAtLevel)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        parms.set_plain_modulus(257);
+
+        auto context = SEALContext::Create(parms);
+        BatchEncoder batch_encoder(context);
+        Evaluator evaluator(context);
+        size_t slots = batch_encoder.slot_count();
+
+        vector<int64_t> values(slots);
+        for (size_t i = 0; i < slots; i++)
+        {
+            values[i] = static_cast<int64_t>(i * 5) - 128;
+        }
+
+        // Every level agrees with encoding followed by transform_to_ntt
+        auto context_data_ptr = context->context_data();
+        while (context_data_ptr)
+        {
+            parms_id_type parms_id = context_data_ptr->parms().parms_id();
+            Plaintext expected;
+            batch_encoder.encode(values, expected);
+            evaluator.transform_to_ntt_inplace(expected, parms_id);
+
+            Plaintext plain;
+            batch_encoder.encode(values, parms_id, plain);
+            ASSERT_TRUE(plain.is_ntt_form());
+            ASSERT_TRUE(plain.parms_id() == parms_id);
+            ASSERT_EQ(expected.coeff_count(), plain.coeff_count());
+            ASSERT_TRUE(expected == plain);
+
+            context_data_ptr = context_data_ptr->next_context_data();
+        }
+
+        Plaintext plain;
+        ASSERT_THROW(batch_encoder.encode(values, parms_id_zero, plain), invalid_argument);
+    }
 }
@@ -127,4 +127,197 @@ namespace SEALTest
             parms.poly_modulus_degree() * parms.coeff_modulus().size() * 2));
         ASSERT_TRUE(ctxt.data() != ctxt2.data());
     }
+
+    TEST(CiphertextTest, SaveLoadCompactCiphertext)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_30bit(0),
+            DefaultParams::small_mods_40bit(0) });
+        parms.set_plain_modulus(1 << 6);
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+
+        // Each RNS component is packed to the bit count of its prime
+        Ciphertext ctxt;
+        encryptor.encrypt(Plaintext("1x^10 + 2"), ctxt);
+        size_t data_size = parms.poly_modulus_degree() * 2 * ctxt.size();
+        stringstream stream;
+        ctxt.save(stream);
+        ASSERT_GE(data_size * 70 / 8 + 128, stream.str().size());
+        Ciphertext ctxt2;
+        ctxt2.load(context, stream);
+        ASSERT_TRUE(ctxt.parms_id() == ctxt2.parms_id());
+        ASSERT_EQ(ctxt.size(), ctxt2.size());
+        ASSERT_TRUE(is_equal_uint_uint(ctxt.data(), ctxt2.data(), data_size));
+
+        // Ciphertexts in the original format can still be loaded
+        stringstream legacy_stream;
+        parms_id_type parms_id = ctxt.parms_id();
+        legacy_stream.write(reinterpret_cast<const char*>(&parms_id), sizeof(parms_id_type));
+        SEAL_BYTE is_ntt_form_byte{};
+        legacy_stream.write(reinterpret_cast<const char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
+        uint64_t header[3]{ ctxt.size(), ctxt.poly_modulus_degree(), ctxt.coeff_mod_count() };
+        legacy_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+        double scale = ctxt.scale();
+        legacy_stream.write(reinterpret_cast<const char*>(&scale), sizeof(double));
+        IntArray<uint64_t> legacy_data(data_size);
+        copy_n(ctxt.data(), data_size, legacy_data.begin());
+        legacy_data.save(legacy_stream);
+
+        Ciphertext ctxt3;
+        ctxt3.load(context, legacy_stream);
+        ASSERT_TRUE(ctxt.parms_id() == ctxt3.parms_id());
+        ASSERT_EQ(ctxt.size(), ctxt3.size());
+        ASSERT_TRUE(is_equal_uint_uint(ctxt.data(), ctxt3.data(), data_size));
+    }
+
+    TEST(CiphertextTest, SaveLoadCompressedCiphertext)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(1024));
+        parms.set_plain_modulus(1 << 6);
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+
+        Ciphertext ctxt;
+        encryptor.encrypt(Plaintext("1x^10 + 2"), ctxt);
+        Ciphertext zero_ctxt(context);
+        zero_ctxt.resize(3);
+        size_t zero_data_size = zero_ctxt.uint64_count() * sizeof(uint64_t);
+
+        for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz,
+            compr_mode_type::deflate })
+        {
+            stringstream stream;
+            ctxt.save(stream, compr_mode);
+            Ciphertext ctxt2;
+            ctxt2.load(context, stream);
+            ASSERT_TRUE(ctxt.parms_id() == ctxt2.parms_id());
+            ASSERT_EQ(ctxt.uint64_count(), ctxt2.uint64_count());
+            ASSERT_TRUE(is_equal_uint_uint(ctxt.data(), ctxt2.data(), ctxt.uint64_count()));
+
+            // Zero coefficients pack to nothing and the rest compresses away
+            stringstream zero_stream;
+            zero_ctxt.save(zero_stream, compr_mode);
+            ASSERT_GT(zero_data_size / 100, zero_stream.str().size());
+            ctxt2.load(context, zero_stream);
+            ASSERT_EQ(3ULL, ctxt2.size());
+            ASSERT_TRUE(ctxt2.is_transparent());
+        }
+
+        stringstream stream;
+        ASSERT_THROW(ctxt.save(stream, static_cast<compr_mode_type>(7)), invalid_argument);
+    }
+
+    TEST(CiphertextTest, TrustedLoadCiphertext)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(1024));
+        parms.set_plain_modulus(1 << 6);
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+
+        Ciphertext ctxt;
+        encryptor.encrypt(Plaintext("1x^10 + 2"), ctxt);
+        for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz })
+        {
+            stringstream stream;
+            ctxt.save(stream, compr_mode);
+            string data = stream.str();
+            Ciphertext ctxt2;
+            ctxt2.trusted_load(context, stream);
+            ASSERT_TRUE(is_equal_uint_uint(ctxt.data(), ctxt2.data(), ctxt.uint64_count()));
+
+            // Corruption is detected by every load function
+            data[data.size() / 2] ^= 1;
+            stream.str(data);
+            ASSERT_THROW(ctxt2.trusted_load(context, stream), invalid_argument);
+            stream.str(data);
+            ASSERT_THROW(ctxt2.unsafe_load(stream), invalid_argument);
+        }
+
+        // Only the metadata is validated when the data has a checksum
+        Ciphertext invalid_ctxt = ctxt;
+        invalid_ctxt.data()[0] = parms.coeff_modulus()[0].value();
+        stringstream stream;
+        invalid_ctxt.save(stream);
+        string data = stream.str();
+        Ciphertext ctxt2;
+        ASSERT_THROW(ctxt2.load(context, stream), invalid_argument);
+        stream.str(data);
+        ctxt2.trusted_load(context, stream);
+
+        // Data in the layout that preceded the versioned format has no
+        // checksum and is validated fully
+        stream.str("");
+        stream.write(reinterpret_cast<const char*>(&invalid_ctxt.parms_id()),
+            sizeof(parms_id_type));
+        SEAL_BYTE is_ntt_form_byte = static_cast<SEAL_BYTE>(invalid_ctxt.is_ntt_form());
+        stream.write(reinterpret_cast<const char*>(&is_ntt_form_byte), sizeof(SEAL_BYTE));
+        uint64_t legacy_header[3]{ invalid_ctxt.size(),
+            invalid_ctxt.poly_modulus_degree(), invalid_ctxt.coeff_mod_count() };
+        stream.write(reinterpret_cast<const char*>(legacy_header), sizeof(legacy_header));
+        double scale = invalid_ctxt.scale();
+        stream.write(reinterpret_cast<const char*>(&scale), sizeof(double));
+        uint64_t data_size = invalid_ctxt.uint64_count();
+        stream.write(reinterpret_cast<const char*>(&data_size), sizeof(uint64_t));
+        stream.write(reinterpret_cast<const char*>(invalid_ctxt.data()),
+            static_cast<streamsize>(data_size * sizeof(uint64_t)));
+        data = stream.str();
+        stream.str(data);
+        ASSERT_THROW(ctxt2.trusted_load(context, stream), invalid_argument);
+        stream.str(data);
+        ctxt2.unsafe_load(stream);
+        ASSERT_TRUE(is_equal_uint_uint(invalid_ctxt.data(), ctxt2.data(),
+            ctxt.uint64_count()));
+    }
+
+    TEST(CiphertextTest, SaveLoadCiphertextBuffer)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(1024));
+        parms.set_plain_modulus(1 << 6);
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+
+        Ciphertext ctxt;
+        encryptor.encrypt(Plaintext("1x^10 + 2"), ctxt);
+        Ciphertext ctxt2;
+        encryptor.encrypt(Plaintext("3x^5"), ctxt2);
+        for (auto compr_mode : { compr_mode_type::none, compr_mode_type::deflate })
+        {
+            stringstream stream;
+            ctxt.save(stream, compr_mode);
+            size_t size = ctxt.save_size(compr_mode);
+            ASSERT_EQ(stream.str().size(), size);
+
+            // Two ciphertexts saved back to back
+            vector<SEAL_BYTE> buffer(size + ctxt2.save_size(compr_mode));
+            ASSERT_THROW(ctxt.save(buffer.data(), size - 1, compr_mode), invalid_argument);
+            ASSERT_EQ(size, ctxt.save(buffer.data(), buffer.size(), compr_mode));
+            ASSERT_EQ(buffer.size() - size, ctxt2.save(buffer.data() + size,
+                buffer.size() - size, compr_mode));
+            ASSERT_TRUE(equal(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(size),
+                reinterpret_cast<const SEAL_BYTE*>(stream.str().data())));
+
+            Ciphertext ctxt3;
+            size_t read_count = ctxt3.load(context, buffer.data(), buffer.size());
+            ASSERT_EQ(size, read_count);
+            ASSERT_TRUE(is_equal_uint_uint(ctxt.data(), ctxt3.data(), ctxt.uint64_count()));
+            ASSERT_EQ(buffer.size() - size, ctxt3.load(context,
+                buffer.data() + read_count, buffer.size() - read_count));
+            ASSERT_TRUE(is_equal_uint_uint(ctxt2.data(), ctxt3.data(), ctxt2.uint64_count()));
+            ASSERT_ANY_THROW(ctxt3.unsafe_load(buffer.data(), size - 1));
+        }
+        ASSERT_THROW(ctxt.save(nullptr, 1), invalid_argument);
+        ASSERT_THROW(ctxt2.unsafe_load(nullptr, 1), invalid_argument);
+    }
 }
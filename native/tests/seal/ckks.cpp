@@ -6,8 +6,11 @@
 #include "seal/context.h"
 #include "seal/defaultparams.h"
 #include "seal/keygenerator.h"
+#include "seal/util/uintarithsmallmod.h"
+#include "seal/util/smallntt.h"
 #include <vector>
 #include <ctime>
+#include <limits>
 
 using namespace seal;
 using namespace seal::util;
@@ -366,6 +369,264 @@ namespace SEALTest
                     }
                 }
             }
+            {
+                // The smallest int64_t has no int64_t magnitude
+                Plaintext plain;
+                encoder.encode(numeric_limits<int64_t>::min(), parms.parms_id(), plain);
+                for (size_t j = 0; j < parms.coeff_modulus().size(); j++)
+                {
+                    uint64_t modulus = parms.coeff_modulus()[j].value();
+                    uint64_t expected = (modulus - (uint64_t(1) << 63) % modulus) % modulus;
+                    for (size_t i = 0; i < slots * 2; i++)
+                    {
+                        ASSERT_EQ(expected, plain[j * slots * 2 + i]);
+                    }
+                }
+            }
         }
     }
+
+    TEST(CKKSEncoderTest, CKKSEncoderDecodeCompositionTest)
+    {
+        // Decodes constant polynomials with known large coefficients; every
+        // slot must then hold the coefficient divided by the scale
+        auto test_composition = [](const vector<SmallModulus> &coeff_modulus)
+        {
+            EncryptionParameters parms(scheme_type::CKKS);
+            size_t slots = 32;
+            parms.set_poly_modulus_degree(2 * slots);
+            parms.set_coeff_modulus(coeff_modulus);
+            auto context = SEALContext::Create(parms);
+            auto &context_data = *context->context_data();
+            size_t coeff_mod_count = coeff_modulus.size();
+            size_t coeff_count = 2 * slots;
+            double scale = pow(2.0, 20);
+            auto pool = MemoryManager::GetPool();
+
+            CKKSEncoder encoder(context);
+            vector<double> result;
+
+            // Checks a single coefficient given by its magnitude
+            auto check = [&](const vector<uint64_t> &magnitude, bool is_negative)
+            {
+                Plaintext plain(coeff_count * coeff_mod_count);
+                for (size_t j = 0; j < coeff_mod_count; j++)
+                {
+                    uint64_t residue = modulo_uint(magnitude.data(),
+                        coeff_mod_count, coeff_modulus[j], pool);
+                    plain[j * coeff_count] = is_negative ?
+                        negate_uint_mod(residue, coeff_modulus[j]) : residue;
+                    ntt_negacyclic_harvey(plain.data() + (j * coeff_count),
+                        context_data.small_ntt_tables()[j]);
+                }
+                plain.parms_id() = context_data.parms().parms_id();
+                plain.scale() = scale;
+
+                double expected = 0;
+                for (size_t j = coeff_mod_count; j--; )
+                {
+                    expected = expected * pow(2.0, 64) +
+                        static_cast<double>(magnitude[j]);
+                }
+                expected /= scale;
+                if (is_negative)
+                {
+                    expected = -expected;
+                }
+
+                encoder.decode(plain, result);
+                ASSERT_EQ(slots, result.size());
+                for (size_t i = 0; i < slots; i++)
+                {
+                    ASSERT_NEAR(expected, result[i], fabs(expected) * 1e-15);
+                }
+            };
+
+            vector<vector<uint64_t>> magnitudes;
+            magnitudes.emplace_back(vector<uint64_t>(coeff_mod_count, 0));
+            magnitudes.emplace_back(magnitudes.back());
+            magnitudes.back()[0] = 1;
+            magnitudes.emplace_back(magnitudes.back());
+            magnitudes.back()[0] = 0x123456789ABCDEFULL;
+            if (coeff_mod_count > 1)
+            {
+                // Around 2^64, 2^100 and 2^127
+                magnitudes.emplace_back(vector<uint64_t>(coeff_mod_count, 0));
+                magnitudes.back()[0] = 5;
+                magnitudes.back()[1] = 1;
+                magnitudes.emplace_back(vector<uint64_t>(coeff_mod_count, 0));
+                magnitudes.back()[1] = uint64_t(1) << 36;
+                magnitudes.emplace_back(vector<uint64_t>(coeff_mod_count, 0));
+                magnitudes.back()[0] = 0xFFFFFFFFFFFFFFFFULL;
+                magnitudes.back()[1] = 0x7FFFFFFFFFFFFFFFULL;
+            }
+            if (coeff_mod_count > 2)
+            {
+                // Past 128 bits
+                magnitudes.emplace_back(vector<uint64_t>(coeff_mod_count, 0));
+                magnitudes.back()[1] = 0x8000000000000000ULL;
+                magnitudes.back()[2] = 12345;
+            }
+
+            // The largest magnitude (q - 1) / 2
+            magnitudes.emplace_back(coeff_mod_count);
+            right_shift_uint(context_data.total_coeff_modulus(), 1,
+                coeff_mod_count, magnitudes.back().data());
+
+            for (auto &magnitude : magnitudes)
+            {
+                if (is_greater_than_or_equal_uint_uint(magnitude.data(),
+                    context_data.upper_half_threshold(), coeff_mod_count))
+                {
+                    continue;
+                }
+                check(magnitude, false);
+                check(magnitude, true);
+            }
+        };
+
+        test_composition({ DefaultParams::small_mods_60bit(0) });
+        test_composition({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1) });
+        test_composition({ DefaultParams::small_mods_60bit(0),
+            DefaultParams::small_mods_60bit(1) });
+        test_composition({ DefaultParams::small_mods_60bit(0),
+            DefaultParams::small_mods_60bit(1), DefaultParams::small_mods_60bit(2),
+            DefaultParams::small_mods_60bit(3) });
+    }
+
+    TEST(CKKSEncoderTest, CKKSEncoderEncodeMultiLevelTest)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        size_t slots = 32;
+        parms.set_poly_modulus_degree(2 * slots);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), 
+            DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        CKKSEncoder encoder(context);
+
+        vector<complex<double>> values(slots);
+        for (size_t i = 0; i < slots; i++)
+        {
+            values[i] = complex<double>(static_cast<double>(i) - 7.5, 
+                0.25 * static_cast<double>(i));
+        }
+
+        vector<parms_id_type> parms_ids;
+        auto context_data_ptr = context->context_data();
+        while (context_data_ptr)
+        {
+            parms_ids.push_back(context_data_ptr->parms().parms_id());
+            context_data_ptr = context_data_ptr->next_context_data();
+        }
+        ASSERT_EQ(3ULL, parms_ids.size());
+
+        // Same scale for all levels agrees exactly with separate encoding
+        double scale = pow(2.0, 20);
+        vector<Plaintext> plains;
+        encoder.encode(values, parms_ids, scale, plains);
+        ASSERT_EQ(parms_ids.size(), plains.size());
+        for (size_t i = 0; i < parms_ids.size(); i++)
+        {
+            Plaintext expected;
+            encoder.encode(values, parms_ids[i], scale, expected);
+            ASSERT_TRUE(plains[i].parms_id() == parms_ids[i]);
+            ASSERT_EQ(scale, plains[i].scale());
+            ASSERT_TRUE(expected == plains[i]);
+        }
+
+        // Different scales decode to the same values
+        vector<double> scales{ pow(2.0, 30), pow(2.0, 25), pow(2.0, 20) };
+        encoder.encode(values, parms_ids, scales, plains);
+        for (size_t i = 0; i < parms_ids.size(); i++)
+        {
+            ASSERT_TRUE(plains[i].parms_id() == parms_ids[i]);
+            ASSERT_EQ(scales[i], plains[i].scale());
+
+            vector<complex<double>> result;
+            encoder.decode(plains[i], result);
+            for (size_t j = 0; j < slots; j++)
+            {
+                ASSERT_NEAR(values[j].real(), result[j].real(), 0.01);
+                ASSERT_NEAR(values[j].imag(), result[j].imag(), 0.01);
+            }
+        }
+
+        ASSERT_THROW(encoder.encode(values, parms_ids, vector<double>{ scale }, plains),
+            invalid_argument);
+        parms_ids.push_back(parms_id_zero);
+        ASSERT_THROW(encoder.encode(values, parms_ids, scale, plains),
+            invalid_argument);
+    }
+
+    TEST(CKKSEncoderTest, CKKSEncoderCacheTest)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        size_t slots = 32;
+        parms.set_poly_modulus_degree(2 * slots);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), 
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        CKKSEncoder encoder(context);
+        parms_id_type first_parms_id = context->first_parms_id();
+        parms_id_type last_parms_id = context->last_parms_id();
+        double scale = pow(2.0, 20);
+
+        vector<double> values1(slots, 1.5), values2(slots, -2.5);
+        vector<complex<double>> values3(slots, complex<double>(1.5, 0.0));
+
+        Plaintext plain, expected;
+        ASSERT_EQ(0ULL, encoder.cache_capacity());
+        encoder.encode(values1, scale, plain);
+        ASSERT_EQ(0ULL, encoder.cache_size());
+
+        encoder.set_cache_capacity(2);
+        ASSERT_EQ(2ULL, encoder.cache_capacity());
+        encoder.encode(values1, scale, expected);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        encoder.encode(values1, scale, plain);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        ASSERT_TRUE(expected == plain);
+        ASSERT_TRUE(expected.parms_id() == plain.parms_id());
+        ASSERT_EQ(expected.scale(), plain.scale());
+
+        // The parms_id, scale and value type are part of the key
+        encoder.encode(values1, last_parms_id, scale, plain);
+        ASSERT_TRUE(plain.parms_id() == last_parms_id);
+        ASSERT_EQ(2ULL, encoder.cache_size());
+        encoder.encode(values1, first_parms_id, 2 * scale, plain);
+        ASSERT_EQ(2 * scale, plain.scale());
+        ASSERT_EQ(2ULL, encoder.cache_size());
+        encoder.encode(values3, scale, plain);
+        ASSERT_TRUE(expected == plain);
+
+        // Least recently used entries are evicted
+        encoder.encode(values1, last_parms_id, scale, plain);
+        encoder.encode(values2, scale, plain);
+        encoder.encode(values1, last_parms_id, scale, plain);
+        ASSERT_TRUE(plain.parms_id() == last_parms_id);
+        ASSERT_EQ(2ULL, encoder.cache_size());
+
+        vector<double> result;
+        encoder.decode(plain, result);
+        for (size_t i = 0; i < slots; i++)
+        {
+            ASSERT_NEAR(1.5, result[i], 0.01);
+        }
+        encoder.encode(values2, scale, plain);
+        encoder.decode(plain, result);
+        for (size_t i = 0; i < slots; i++)
+        {
+            ASSERT_NEAR(-2.5, result[i], 0.01);
+        }
+
+        encoder.clear_cache();
+        ASSERT_EQ(0ULL, encoder.cache_size());
+        encoder.encode(values1, scale, plain);
+        encoder.encode(values2, scale, plain);
+        encoder.set_cache_capacity(1);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        encoder.set_cache_capacity(0);
+        ASSERT_EQ(0ULL, encoder.cache_size());
+    }
 }
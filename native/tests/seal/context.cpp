@@ -3,12 +3,45 @@
 
 #include "gtest/gtest.h"
 #include "seal/context.h"
+#include "seal/defaultparams.h"
+#include "seal/keygenerator.h"
+#include "seal/encryptor.h"
+#include "seal/decryptor.h"
+#include <sstream>
 
 using namespace seal;
 using namespace std;
 
 namespace SEALTest
 {
+    namespace
+    {
+        bool tables_equal(const util::SmallNTTTables &tables1,
+            const util::SmallNTTTables &tables2)
+        {
+            if (!(tables1.modulus() == tables2.modulus()) ||
+                tables1.coeff_count() != tables2.coeff_count() ||
+                tables1.get_root() != tables2.get_root() ||
+                *tables1.get_inv_degree_modulo() != *tables2.get_inv_degree_modulo())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < tables1.coeff_count(); i++)
+            {
+                if (tables1.get_from_root_powers(i) != tables2.get_from_root_powers(i) ||
+                    tables1.get_from_scaled_root_powers(i) !=
+                        tables2.get_from_scaled_root_powers(i) ||
+                    tables1.get_from_inv_root_powers(i) != tables2.get_from_inv_root_powers(i) ||
+                    tables1.get_from_scaled_inv_root_powers_div_two(i) !=
+                        tables2.get_from_scaled_inv_root_powers_div_two(i))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
     TEST(ContextTest, ContextConstructor)
     {
         // Nothing set
@@ -225,4 +258,137 @@ namespace SEALTest
             ASSERT_FALSE(!!context->context_data()->next_context_data());
         }
     }
+
+    TEST(ContextTest, ContextSaveLoad)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(4096));
+        parms.set_plain_modulus(12289);
+        auto context = SEALContext::Create(parms);
+
+        stringstream stream;
+        context->save(stream);
+        string data = stream.str();
+        ASSERT_EQ(data.size(), context->save_size());
+        auto context2 = SEALContext::Load(stream);
+        ASSERT_TRUE(context2->parameters_set());
+        ASSERT_TRUE(context->first_parms_id() == context2->first_parms_id());
+        ASSERT_TRUE(context->last_parms_id() == context2->last_parms_id());
+        for (auto data1 = context->context_data(), data2 = context2->context_data();
+            data1; data1 = data1->next_context_data(), data2 = data2->next_context_data())
+        {
+            ASSERT_TRUE(data2 != nullptr);
+            ASSERT_TRUE(data1->parms() == data2->parms());
+            ASSERT_EQ(data1->chain_index(), data2->chain_index());
+            ASSERT_EQ(data1->qualifiers().using_batching, data2->qualifiers().using_batching);
+            for (size_t i = 0; i < data1->parms().coeff_modulus().size(); i++)
+            {
+                ASSERT_TRUE(tables_equal(data1->small_ntt_tables()[i],
+                    data2->small_ntt_tables()[i]));
+            }
+            ASSERT_TRUE(tables_equal(*data1->plain_ntt_tables(), *data2->plain_ntt_tables()));
+            auto &base_converter1 = *data1->base_converter();
+            auto &base_converter2 = *data2->base_converter();
+            ASSERT_EQ(base_converter1.bsk_base_mod_count(), base_converter2.bsk_base_mod_count());
+            for (size_t i = 0; i < base_converter1.bsk_base_mod_count(); i++)
+            {
+                ASSERT_TRUE(tables_equal(base_converter1.get_bsk_small_ntt_tables()[i],
+                    base_converter2.get_bsk_small_ntt_tables()[i]));
+            }
+        }
+
+        // Objects created with either context work with the other
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context2, keygen.public_key());
+        Decryptor decryptor(context2, keygen.secret_key());
+        Ciphertext encrypted;
+        encryptor.encrypt(Plaintext("1x^10 + 2"), encrypted);
+        Plaintext plain;
+        decryptor.decrypt(encrypted, plain);
+        ASSERT_EQ("1x^10 + 2", plain.to_string());
+
+        // Corrupted tables are detected
+        string corrupted = data;
+        corrupted[corrupted.size() / 2] ^= 1;
+        stream.str(corrupted);
+        ASSERT_THROW(SEALContext::Load(stream), invalid_argument);
+
+        // A CKKS context without a modulus switching chain, through a buffer
+        parms = EncryptionParameters(scheme_type::CKKS);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(4096));
+        context = SEALContext::Create(parms, false);
+        vector<SEAL_BYTE> buffer(context->save_size());
+        ASSERT_EQ(buffer.size(), context->save(buffer.data(), buffer.size()));
+        context2 = SEALContext::Load(buffer.data(), buffer.size());
+        ASSERT_TRUE(context2->parameters_set());
+        ASSERT_TRUE(context->first_parms_id() == context2->first_parms_id());
+        ASSERT_TRUE(context2->first_parms_id() == context2->last_parms_id());
+
+        // Invalid parameters cannot be saved
+        parms.set_poly_modulus_degree(1000);
+        context = SEALContext::Create(parms);
+        ASSERT_THROW(context->save(stream), logic_error);
+    }
+
+    TEST(ContextTest, ContextCreateThreadCount)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(1024);
+        parms.set_coeff_modulus(DefaultParams::coeff_modulus_128(4096));
+        parms.set_plain_modulus(12289);
+
+        // The tables are the same however many threads generate them
+        auto context = SEALContext::Create(parms, true, 1);
+        auto context2 = SEALContext::Create(parms, true, 4);
+        ASSERT_TRUE(context->last_parms_id() == context2->last_parms_id());
+        for (auto data1 = context->context_data(), data2 = context2->context_data();
+            data1; data1 = data1->next_context_data(), data2 = data2->next_context_data())
+        {
+            ASSERT_TRUE(data1->parms() == data2->parms());
+            ASSERT_EQ(data1->chain_index(), data2->chain_index());
+            for (size_t i = 0; i < data1->parms().coeff_modulus().size(); i++)
+            {
+                ASSERT_TRUE(tables_equal(data1->small_ntt_tables()[i],
+                    data2->small_ntt_tables()[i]));
+                util::SmallNTTTables generated(util::get_power_of_two(1024),
+                    data1->parms().coeff_modulus()[i]);
+                ASSERT_TRUE(tables_equal(data1->small_ntt_tables()[i], generated));
+            }
+            ASSERT_TRUE(tables_equal(*data1->plain_ntt_tables(), *data2->plain_ntt_tables()));
+            auto &base_converter1 = *data1->base_converter();
+            auto &base_converter2 = *data2->base_converter();
+            for (size_t i = 0; i < base_converter1.bsk_base_mod_count(); i++)
+            {
+                ASSERT_TRUE(tables_equal(base_converter1.get_bsk_small_ntt_tables()[i],
+                    base_converter2.get_bsk_small_ntt_tables()[i]));
+            }
+        }
+
+        // A thread-local memory pool is only used by the calling thread
+        {
+            MMProfGuard guard(new MMProfThreadLocal);
+            auto local_context = SEALContext::Create(parms, true, 4);
+            ASSERT_TRUE(context->last_parms_id() == local_context->last_parms_id());
+            for (auto data1 = context->context_data(),
+                data2 = local_context->context_data(); data1;
+                data1 = data1->next_context_data(), data2 = data2->next_context_data())
+            {
+                for (size_t i = 0; i < data1->parms().coeff_modulus().size(); i++)
+                {
+                    ASSERT_TRUE(tables_equal(data1->small_ntt_tables()[i],
+                        data2->small_ntt_tables()[i]));
+                }
+            }
+        }
+
+        // A plain modulus without NTT tables disables batching as before
+        parms.set_plain_modulus(1 << 6);
+        context = SEALContext::Create(parms, true, 4);
+        ASSERT_TRUE(context->parameters_set());
+        ASSERT_FALSE(context->context_data()->qualifiers().using_batching);
+        ASSERT_FALSE(context->context_data(context->last_parms_id())->
+            qualifiers().using_batching);
+    }
 }
@@ -155,4 +155,32 @@ namespace SEALTest
         ASSERT_TRUE(parms.poly_modulus_degree() == parms2.poly_modulus_degree());
         ASSERT_TRUE(parms == parms2);
     }
+
+    TEST(EncryptionParametersTest, EncryptionParametersSaveLoadBuffer)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_30bit(0),
+            DefaultParams::small_mods_60bit(0) });
+        parms.set_plain_modulus(1 << 6);
+        parms.set_poly_modulus_degree(256);
+
+        stringstream stream;
+        EncryptionParameters::Save(parms, stream);
+        size_t size = EncryptionParameters::SaveSize(parms);
+        ASSERT_EQ(stream.str().size(), size);
+
+        vector<SEAL_BYTE> buffer(size);
+        ASSERT_THROW(EncryptionParameters::Save(parms, buffer.data(), size - 1),
+            invalid_argument);
+        ASSERT_EQ(size, EncryptionParameters::Save(parms, buffer.data(), size));
+        EncryptionParameters parms2(scheme_type::CKKS);
+        ASSERT_EQ(size, EncryptionParameters::Load(parms2, buffer.data(), size));
+        ASSERT_TRUE(parms == parms2);
+        ASSERT_ANY_THROW(EncryptionParameters::Load(parms2, buffer.data(), size - 1));
+
+        // Parameters followed by other data
+        buffer.resize(size + 16);
+        ASSERT_EQ(size, EncryptionParameters::Load(parms2, buffer.data(), buffer.size()));
+        ASSERT_TRUE(parms == parms2);
+    }
 }
@@ -5,6 +5,7 @@
 #include "seal/context.h"
 #include "seal/encryptor.h"
 #include "seal/decryptor.h"
+#include "seal/evaluator.h"
 #include "seal/keygenerator.h"
 #include "seal/batchencoder.h"
 #include "seal/ckks.h"
@@ -13,6 +14,9 @@
 #include <cstdint>
 #include <cstddef>
 #include <ctime>
+#include <chrono>
+#include <thread>
+#include <atomic>
 
 using namespace seal;
 using namespace std;
@@ -397,4 +401,636 @@ namespace SEALTest
             }
         }
     }
+
+    TEST(EncryptorTest, FVZeroPoolEncryptDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        SmallModulus plain_modulus(1 << 6);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        IntegerEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        Ciphertext encrypted;
+        Plaintext plain;
+
+        // Explicit refill
+        encryptor.enable_zero_pool(3, false);
+        auto metrics = encryptor.zero_pool_metrics();
+        ASSERT_EQ(0ULL, metrics.size);
+        ASSERT_EQ(3ULL, metrics.capacity);
+        encryptor.refill_zero_pool();
+        metrics = encryptor.zero_pool_metrics();
+        ASSERT_EQ(3ULL, metrics.size);
+        ASSERT_EQ(3ULL, metrics.generated);
+
+        Ciphertext encrypted_prev;
+        for (int i = 0; i < 4; i++)
+        {
+            encryptor.encrypt(encoder.encode(0x12345 + i), encrypted);
+            decryptor.decrypt(encrypted, plain);
+            ASSERT_EQ(static_cast<uint64_t>(0x12345 + i), encoder.decode_uint64(plain));
+            ASSERT_TRUE(encrypted.parms_id() == parms.parms_id());
+            ASSERT_FALSE(encrypted.is_ntt_form());
+
+            // Each precomputed encryption of zero must be used only once
+            if (i > 0)
+            {
+                ASSERT_FALSE(equal(encrypted.data(1), 
+                    encrypted.data(1) + encrypted.uint64_count() / 2, 
+                    encrypted_prev.data(1)));
+            }
+            encrypted_prev = encrypted;
+        }
+        metrics = encryptor.zero_pool_metrics();
+        ASSERT_EQ(0ULL, metrics.size);
+        ASSERT_EQ(3ULL, metrics.hits);
+        ASSERT_EQ(1ULL, metrics.misses);
+
+        // Background refill
+        encryptor.enable_zero_pool(2);
+        for (int i = 0; i < 1000 && encryptor.zero_pool_metrics().size < 2; i++)
+        {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        ASSERT_EQ(2ULL, encryptor.zero_pool_metrics().size);
+        for (int i = 0; i < 10; i++)
+        {
+            encryptor.encrypt(encoder.encode(i), encrypted);
+            decryptor.decrypt(encrypted, plain);
+            ASSERT_EQ(static_cast<uint64_t>(i), encoder.decode_uint64(plain));
+        }
+        metrics = encryptor.zero_pool_metrics();
+        ASSERT_EQ(10ULL, metrics.hits + metrics.misses);
+        ASSERT_TRUE(metrics.size <= 2);
+
+        // A precomputed encryption of zero is copied into the memory pool of
+        // the destination
+        MemoryPoolHandle own_pool = MemoryPoolHandle::New();
+        Ciphertext encrypted_own(own_pool);
+        encryptor.refill_zero_pool();
+        encryptor.encrypt(encoder.encode(5), encrypted_own);
+        ASSERT_TRUE(encrypted_own.pool() == own_pool);
+        decryptor.decrypt(encrypted_own, plain);
+        ASSERT_EQ(5ULL, encoder.decode_uint64(plain));
+
+        // The background thread does not allocate from a thread-local pool
+        {
+            MMProfGuard guard(new MMProfThreadLocal);
+            Encryptor local_encryptor(context, keygen.public_key());
+            local_encryptor.enable_zero_pool(2);
+            for (int i = 0; i < 10; i++)
+            {
+                local_encryptor.encrypt(encoder.encode(i), encrypted);
+                decryptor.decrypt(encrypted, plain);
+                ASSERT_EQ(static_cast<uint64_t>(i), encoder.decode_uint64(plain));
+            }
+        }
+
+        encryptor.disable_zero_pool();
+        ASSERT_EQ(0ULL, encryptor.zero_pool_metrics().capacity);
+        ASSERT_THROW(encryptor.refill_zero_pool(), logic_error);
+        encryptor.encrypt(encoder.encode(7), encrypted);
+        decryptor.decrypt(encrypted, plain);
+        ASSERT_EQ(7ULL, encoder.decode_uint64(plain));
+    }
+
+    TEST(EncryptorTest, CKKSZeroPoolEncryptDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        parms.set_noise_standard_deviation(3.20);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(2 * slot_size);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        auto next_parms_id = context->context_data()->next_context_data()->parms().parms_id();
+        encryptor.enable_zero_pool(next_parms_id, 2, false);
+        encryptor.refill_zero_pool();
+
+        Ciphertext encrypted;
+        Plaintext plain;
+        Plaintext plainRes;
+        vector<complex<double>> input(slot_size, 3.0);
+        vector<complex<double>> output(slot_size);
+        const double delta = static_cast<double>(1 << 16);
+
+        // Plaintexts at the first level do not use the pool
+        encoder.encode(input, parms.parms_id(), delta, plain);
+        encryptor.encrypt(plain, encrypted);
+        ASSERT_TRUE(encrypted.parms_id() == parms.parms_id());
+        ASSERT_EQ(2ULL, encryptor.zero_pool_metrics().size);
+
+        encoder.encode(input, next_parms_id, delta, plain);
+        for (int i = 0; i < 3; i++)
+        {
+            encryptor.encrypt(plain, encrypted);
+            ASSERT_TRUE(encrypted.parms_id() == next_parms_id);
+            ASSERT_TRUE(encrypted.is_ntt_form());
+            ASSERT_EQ(delta, encrypted.scale());
+
+            decryptor.decrypt(encrypted, plainRes);
+            encoder.decode(plainRes, output);
+            for (size_t j = 0; j < slot_size; j++)
+            {
+                ASSERT_TRUE(abs(input[j].real() - output[j].real()) < 0.5);
+            }
+        }
+        auto metrics = encryptor.zero_pool_metrics();
+        ASSERT_EQ(2ULL, metrics.hits);
+        ASSERT_EQ(1ULL, metrics.misses);
+
+        encryptor.encrypt_zero(next_parms_id, encrypted);
+        ASSERT_TRUE(encrypted.parms_id() == next_parms_id);
+        encrypted.scale() = delta;
+        decryptor.decrypt(encrypted, plainRes);
+        encoder.decode(plainRes, output);
+        for (size_t j = 0; j < slot_size; j++)
+        {
+            ASSERT_TRUE(abs(output[j].real()) < 0.5);
+        }
+    }
+
+    TEST(EncryptorTest, FVEncryptAtLevelDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        vector<uint64_t> values(batch_encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i % 257;
+        }
+        Plaintext plain;
+        batch_encoder.encode(values, plain);
+
+        Ciphertext encrypted;
+        auto context_data = context->context_data();
+        while (context_data)
+        {
+            auto parms_id = context_data->parms().parms_id();
+            encryptor.encrypt(plain, parms_id, encrypted);
+            ASSERT_TRUE(encrypted.parms_id() == parms_id);
+            ASSERT_EQ(context_data->parms().coeff_modulus().size(), 
+                encrypted.coeff_mod_count());
+            ASSERT_TRUE(decryptor.invariant_noise_budget(encrypted) > 0);
+
+            Plaintext plain_res;
+            vector<uint64_t> values_res;
+            decryptor.decrypt(encrypted, plain_res);
+            batch_encoder.decode(plain_res, values_res);
+            ASSERT_TRUE(values == values_res);
+
+            context_data = context_data->next_context_data();
+        }
+
+        ASSERT_THROW(encryptor.encrypt(plain, parms_id_zero, encrypted), 
+            invalid_argument);
+    }
+
+    TEST(EncryptorTest, CKKSEncryptAtLevelDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        parms.set_noise_standard_deviation(3.20);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(2 * slot_size);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        vector<complex<double>> input(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = static_cast<double>(i) - 10.0;
+        }
+        vector<complex<double>> output;
+        const double delta = static_cast<double>(1 << 20);
+        auto last_parms_id = context->last_parms_id();
+
+        // Plaintext encoded at the first level and encrypted at the last level
+        Plaintext plain;
+        Plaintext plain_res;
+        Ciphertext encrypted;
+        encoder.encode(input, delta, plain);
+        encryptor.encrypt(plain, last_parms_id, encrypted);
+        ASSERT_TRUE(encrypted.parms_id() == last_parms_id);
+        ASSERT_EQ(1ULL, encrypted.coeff_mod_count());
+        ASSERT_EQ(delta, encrypted.scale());
+        decryptor.decrypt(encrypted, plain_res);
+        encoder.decode(plain_res, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            ASSERT_TRUE(abs(input[i].real() - output[i].real()) < 0.5);
+        }
+
+        // Plaintext encoded directly at the last level
+        encoder.encode(input, last_parms_id, delta, plain);
+        encryptor.encrypt(plain, last_parms_id, encrypted);
+        ASSERT_TRUE(encrypted.parms_id() == last_parms_id);
+        decryptor.decrypt(encrypted, plain_res);
+        encoder.decode(plain_res, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            ASSERT_TRUE(abs(input[i].real() - output[i].real()) < 0.5);
+        }
+
+        // Cannot encrypt at a higher level than that of the plaintext
+        ASSERT_THROW(encryptor.encrypt(plain, parms.parms_id(), encrypted), 
+            invalid_argument);
+    }
+
+    TEST(EncryptorTest, FVEncryptBatchDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        size_t batch_size = 20;
+        vector<vector<uint64_t>> values(batch_size,
+            vector<uint64_t>(batch_encoder.slot_count()));
+        vector<Plaintext> plains(batch_size);
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            for (size_t i = 0; i < values[j].size(); i++)
+            {
+                values[j][i] = (i + j) % 257;
+            }
+            batch_encoder.encode(values[j], plains[j]);
+        }
+
+        Plaintext plain_res;
+        vector<uint64_t> values_res;
+        for (size_t thread_count : { size_t(0), size_t(1), size_t(4) })
+        {
+            vector<Ciphertext> encrypted;
+            ASSERT_TRUE(encryptor.encrypt_batch(plains, encrypted, thread_count) >= 0);
+            ASSERT_EQ(batch_size, encrypted.size());
+            for (size_t j = 0; j < batch_size; j++)
+            {
+                ASSERT_TRUE(encrypted[j].parms_id() == parms.parms_id());
+                decryptor.decrypt(encrypted[j], plain_res);
+                batch_encoder.decode(plain_res, values_res);
+                ASSERT_TRUE(values[j] == values_res);
+            }
+
+            // Encode and encrypt in one pass
+            ASSERT_TRUE(encryptor.encrypt_batch(
+                batch_encoder, values, encrypted, thread_count) >= 0);
+            ASSERT_EQ(batch_size, encrypted.size());
+            for (size_t j = 0; j < batch_size; j++)
+            {
+                decryptor.decrypt(encrypted[j], plain_res);
+                batch_encoder.decode(plain_res, values_res);
+                ASSERT_TRUE(values[j] == values_res);
+            }
+        }
+
+        // Encrypt at the last level
+        vector<Ciphertext> encrypted;
+        auto last_parms_id = context->last_parms_id();
+        encryptor.encrypt_batch(plains, last_parms_id, encrypted);
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            ASSERT_TRUE(encrypted[j].parms_id() == last_parms_id);
+            decryptor.decrypt(encrypted[j], plain_res);
+            batch_encoder.decode(plain_res, values_res);
+            ASSERT_TRUE(values[j] == values_res);
+        }
+
+        // Empty batch
+        vector<Plaintext> no_plains;
+        encryptor.encrypt_batch(no_plains, encrypted);
+        ASSERT_EQ(0ULL, encrypted.size());
+
+        // Invalid plaintext anywhere in the batch is reported
+        plains[batch_size / 2].resize(parms.poly_modulus_degree() + 1);
+        ASSERT_THROW(encryptor.encrypt_batch(plains, encrypted), invalid_argument);
+    }
+
+    TEST(EncryptorTest, CKKSEncryptBatchDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        parms.set_noise_standard_deviation(3.20);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(2 * slot_size);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        size_t batch_size = 10;
+        vector<vector<double>> input(batch_size, vector<double>(slot_size));
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input[j][i] = static_cast<double>(i) - static_cast<double>(j);
+            }
+        }
+        const double delta = static_cast<double>(1 << 20);
+
+        Plaintext plain_res;
+        vector<double> output;
+        auto context_data = context->context_data();
+        while (context_data)
+        {
+            auto parms_id = context_data->parms().parms_id();
+            vector<Ciphertext> encrypted;
+            ASSERT_TRUE(encryptor.encrypt_batch(
+                encoder, input, parms_id, delta, encrypted) >= 0);
+            ASSERT_EQ(batch_size, encrypted.size());
+            for (size_t j = 0; j < batch_size; j++)
+            {
+                ASSERT_TRUE(encrypted[j].parms_id() == parms_id);
+                ASSERT_EQ(delta, encrypted[j].scale());
+                decryptor.decrypt(encrypted[j], plain_res);
+                encoder.decode(plain_res, output);
+                for (size_t i = 0; i < slot_size; i++)
+                {
+                    ASSERT_TRUE(abs(input[j][i] - output[i]) < 0.5);
+                }
+            }
+            context_data = context_data->next_context_data();
+        }
+    }
+
+    TEST(EncryptorTest, FVDecryptBatch)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+
+        size_t batch_size = 12;
+        vector<vector<uint64_t>> values(batch_size,
+            vector<uint64_t>(batch_encoder.slot_count()));
+        vector<vector<int64_t>> signed_values(batch_size,
+            vector<int64_t>(batch_encoder.slot_count()));
+        vector<Ciphertext> encrypted(batch_size);
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            for (size_t i = 0; i < values[j].size(); i++)
+            {
+                values[j][i] = (i * j) % 257;
+                signed_values[j][i] = static_cast<int64_t>(values[j][i]) - 
+                    (values[j][i] > 128 ? 257 : 0);
+            }
+            Plaintext plain;
+            batch_encoder.encode(values[j], plain);
+            encryptor.encrypt(plain, encrypted[j]);
+        }
+
+        // Mix in ciphertexts of size three at a lower level to exercise the 
+        // secret key powers
+        Plaintext plain_one("1");
+        Ciphertext encrypted_one;
+        encryptor.encrypt(plain_one, encrypted_one);
+        evaluator.mod_switch_to_next_inplace(encrypted_one);
+        for (size_t j = 0; j < batch_size; j += 3)
+        {
+            evaluator.mod_switch_to_next_inplace(encrypted[j]);
+            evaluator.multiply_inplace(encrypted[j], encrypted_one);
+            ASSERT_EQ(3ULL, encrypted[j].size());
+            ASSERT_TRUE(decryptor.invariant_noise_budget(encrypted[j]) > 0);
+        }
+
+        for (size_t thread_count : { size_t(0), size_t(1), size_t(3) })
+        {
+            vector<Plaintext> plains;
+            ASSERT_TRUE(decryptor.decrypt_batch(encrypted, plains, thread_count) >= 0);
+            ASSERT_EQ(batch_size, plains.size());
+            vector<uint64_t> values_res;
+            for (size_t j = 0; j < batch_size; j++)
+            {
+                batch_encoder.decode(plains[j], values_res);
+                ASSERT_TRUE(values[j] == values_res);
+            }
+
+            vector<vector<uint64_t>> values_batch;
+            ASSERT_TRUE(decryptor.decrypt_batch(
+                batch_encoder, encrypted, values_batch, thread_count) >= 0);
+            ASSERT_TRUE(values == values_batch);
+
+            vector<vector<int64_t>> signed_values_batch;
+            ASSERT_TRUE(decryptor.decrypt_batch(
+                batch_encoder, encrypted, signed_values_batch, thread_count) >= 0);
+            ASSERT_TRUE(signed_values == signed_values_batch);
+        }
+
+        // Invalid ciphertext anywhere in the batch is reported
+        vector<Plaintext> plains;
+        encrypted[batch_size / 2].is_ntt_form() = true;
+        ASSERT_THROW(decryptor.decrypt_batch(encrypted, plains), invalid_argument);
+    }
+
+    TEST(EncryptorTest, CKKSDecryptBatch)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        parms.set_noise_standard_deviation(3.20);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(2 * slot_size);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+
+        size_t batch_size = 10;
+        vector<vector<complex<double>>> input(batch_size, 
+            vector<complex<double>>(slot_size));
+        vector<Ciphertext> encrypted(batch_size);
+        const double delta = static_cast<double>(1 << 20);
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                input[j][i] = complex<double>(static_cast<double>(i), 
+                    -static_cast<double>(j));
+            }
+            Plaintext plain;
+            encoder.encode(input[j], (j % 2) ? context->last_parms_id() : 
+                context->first_parms_id(), delta, plain);
+            encryptor.encrypt(plain, encrypted[j]);
+        }
+
+        vector<vector<complex<double>>> output;
+        ASSERT_TRUE(decryptor.decrypt_batch(encoder, encrypted, output) >= 0);
+        ASSERT_EQ(batch_size, output.size());
+        for (size_t j = 0; j < batch_size; j++)
+        {
+            for (size_t i = 0; i < slot_size; i++)
+            {
+                ASSERT_TRUE(abs(input[j][i] - output[j][i]) < 0.5);
+            }
+        }
+    }
+
+    TEST(EncryptorTest, FVConcurrentDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        Encryptor encryptor(context, keygen.public_key());
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+
+        // Ciphertexts of growing size force the secret key powers to be 
+        // extended while other threads decrypt
+        Plaintext plain("1x^1 + 2");
+        vector<Ciphertext> encrypted(4);
+        encryptor.encrypt(plain, encrypted[0]);
+        Plaintext plain_one("1");
+        Ciphertext encrypted_one;
+        encryptor.encrypt(plain_one, encrypted_one);
+        for (size_t j = 1; j < encrypted.size(); j++)
+        {
+            evaluator.multiply(encrypted[j - 1], encrypted_one, encrypted[j]);
+        }
+
+        atomic<bool> failed{ false };
+        vector<thread> threads;
+        for (size_t t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&, t]() {
+                auto pool = MemoryPoolHandle::New();
+                Plaintext plain_res;
+                for (size_t k = 0; k < 20; k++)
+                {
+                    auto &ct = encrypted[(t + k) % encrypted.size()];
+                    if (k % 2)
+                    {
+                        decryptor.decrypt(ct, plain_res, pool);
+                    }
+                    else
+                    {
+                        decryptor.decrypt(ct, plain_res);
+                    }
+                    if (plain_res.to_string() != plain.to_string() || 
+                        decryptor.invariant_noise_budget(ct, pool) <= 0)
+                    {
+                        failed = true;
+                    }
+                }
+            });
+        }
+        for (auto &th : threads)
+        {
+            th.join();
+        }
+        ASSERT_FALSE(failed.load());
+    }
+
+    TEST(EncryptorTest, FVEstimateNoiseBudget)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_poly_modulus_degree(128);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0), DefaultParams::small_mods_50bit(0), DefaultParams::small_mods_40bit(0), DefaultParams::small_mods_30bit(0) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        Encryptor encryptor(context, keygen.public_key());
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+
+        // Collect ciphertexts with noise budgets from large to exhausted, of 
+        // different sizes and at different levels
+        vector<Ciphertext> encrypted;
+        Ciphertext encrypted_zero;
+        encryptor.encrypt(Plaintext("0"), encrypted_zero);
+        encrypted.push_back(encrypted_zero);
+        Ciphertext ct;
+        encryptor.encrypt(Plaintext("1x^127 + 3Fx^5 + 2"), ct);
+        while (decryptor.invariant_noise_budget(ct) > 0)
+        {
+            encrypted.push_back(ct);
+            Ciphertext ct_lower = ct;
+            evaluator.mod_switch_to_next_inplace(ct_lower);
+            encrypted.push_back(ct_lower);
+            Ciphertext ct_squared;
+            evaluator.square(ct, ct_squared);
+            encrypted.push_back(ct_squared);
+            evaluator.relinearize_inplace(ct_squared, keygen.relin_keys(60));
+            ct = ct_squared;
+        }
+        encrypted.push_back(ct);
+
+        for (auto &curr : encrypted)
+        {
+            int exact = decryptor.invariant_noise_budget(curr);
+            int estimate = decryptor.estimate_noise_budget(curr);
+            ASSERT_TRUE(abs(exact - estimate) <= 1);
+        }
+
+        vector<int> estimates;
+        ASSERT_TRUE(decryptor.estimate_noise_budget_batch(encrypted, estimates) >= 0);
+        ASSERT_EQ(encrypted.size(), estimates.size());
+        for (size_t i = 0; i < encrypted.size(); i++)
+        {
+            ASSERT_EQ(decryptor.estimate_noise_budget(encrypted[i]), estimates[i]);
+        }
+
+        // Only BFV is supported
+        EncryptionParameters ckks_parms(scheme_type::CKKS);
+        ckks_parms.set_poly_modulus_degree(64);
+        ckks_parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0) });
+        auto ckks_context = SEALContext::Create(ckks_parms);
+        KeyGenerator ckks_keygen(ckks_context);
+        Decryptor ckks_decryptor(ckks_context, ckks_keygen.secret_key());
+        Encryptor ckks_encryptor(ckks_context, ckks_keygen.public_key());
+        Ciphertext ckks_encrypted;
+        ckks_encryptor.encrypt_zero(ckks_encrypted);
+        ASSERT_THROW(ckks_decryptor.estimate_noise_budget(ckks_encrypted), invalid_argument);
+    }
 }
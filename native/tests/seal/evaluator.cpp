@@ -12,6 +12,7 @@
 #include "seal/intencoder.h"
 #include "seal/defaultparams.h"
 #include <cstdint>
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <ctime>
@@ -3512,6 +3513,288 @@ namespace SEALTest
         ASSERT_TRUE(encrypted.parms_id() == parms.parms_id());
     }
 
+    TEST(EvaluatorTest, FVEncryptMultiplyNTTPlainDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        SmallModulus plain_modulus(257);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), 
+            DefaultParams::small_mods_40bit(1), DefaultParams::small_mods_40bit(2) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+        size_t slots = batch_encoder.slot_count();
+
+        vector<int64_t> values(slots), multiplier(slots), result;
+        for (size_t i = 0; i < slots; i++)
+        {
+            values[i] = static_cast<int64_t>(i % 17) - 8;
+            multiplier[i] = static_cast<int64_t>(i % 5) - 2;
+        }
+
+        Plaintext plain;
+        Plaintext plain_multiplier;
+        Plaintext plain_multiplier_ntt;
+        Ciphertext encrypted;
+        Ciphertext expected;
+
+        batch_encoder.encode(values, plain);
+        batch_encoder.encode(multiplier, plain_multiplier);
+        batch_encoder.encode(multiplier, context->first_parms_id(), plain_multiplier_ntt);
+        encryptor.encrypt(plain, encrypted);
+
+        // Same level; the result matches multiplication with the normal plaintext
+        evaluator.multiply_plain(encrypted, plain_multiplier, expected);
+        evaluator.multiply_plain_inplace(encrypted, plain_multiplier_ntt);
+        ASSERT_FALSE(encrypted.is_ntt_form());
+        ASSERT_TRUE(encrypted.parms_id() == context->first_parms_id());
+        ASSERT_TRUE(encrypted.size() == expected.size());
+        for (size_t i = 0; i < encrypted.uint64_count(); i++)
+        {
+            ASSERT_EQ(expected.data()[i], encrypted.data()[i]);
+        }
+        decryptor.decrypt(encrypted, plain);
+        batch_encoder.decode(plain, result);
+        for (size_t i = 0; i < slots; i++)
+        {
+            ASSERT_EQ(values[i] * multiplier[i], result[i]);
+        }
+
+        // The same plaintext can be used at a lower level
+        encryptor.encrypt(plain, encrypted);
+        evaluator.mod_switch_to_next_inplace(encrypted);
+        evaluator.multiply_plain_inplace(encrypted, plain_multiplier_ntt);
+        decryptor.decrypt(encrypted, plain);
+        batch_encoder.decode(plain, result);
+        for (size_t i = 0; i < slots; i++)
+        {
+            ASSERT_EQ(values[i] * multiplier[i] * multiplier[i], result[i]);
+        }
+
+        // A plaintext at a lower level cannot be used
+        batch_encoder.encode(multiplier, 
+            context->context_data()->next_context_data()->parms().parms_id(),
+            plain_multiplier_ntt);
+        encryptor.encrypt(plain, encrypted);
+        ASSERT_THROW(evaluator.multiply_plain_inplace(encrypted, plain_multiplier_ntt),
+            invalid_argument);
+    }
+
+    TEST(EvaluatorTest, FVEncryptScalarDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        SmallModulus plain_modulus(1 << 6);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(plain_modulus);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0), 
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        Encryptor encryptor(context, keygen.public_key());
+        Evaluator evaluator(context);
+        Decryptor decryptor(context, keygen.secret_key());
+
+        Plaintext plain("Fx^10 + 3x^2 + 1");
+        Ciphertext encrypted;
+        Ciphertext expected;
+        Ciphertext result;
+        encryptor.encrypt(plain, encrypted);
+
+        // Same result as the plaintext operations, for values on both halves 
+        // and outside of [0, plain_modulus)
+        for (int64_t value : { int64_t(5), int64_t(40), int64_t(-3), int64_t(70), 
+            int64_t(-100) })
+        {
+            int64_t reduced = value % 64;
+            Plaintext plain_value;
+            plain_value = static_cast<uint64_t>(reduced < 0 ? reduced + 64 : reduced);
+
+            evaluator.add_plain(encrypted, plain_value, expected);
+            evaluator.add_scalar(encrypted, value, result);
+            ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+                result.data()));
+
+            evaluator.multiply_plain(encrypted, plain_value, expected);
+            evaluator.multiply_scalar(encrypted, value, result);
+            ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+                result.data()));
+        }
+
+        encryptor.encrypt(plain, encrypted);
+        evaluator.add_scalar_inplace(encrypted, int64_t(2));
+        decryptor.decrypt(encrypted, plain);
+        ASSERT_EQ("Fx^10 + 3x^2 + 3", plain.to_string());
+        evaluator.multiply_scalar_inplace(encrypted, int64_t(-2));
+        decryptor.decrypt(encrypted, plain);
+        ASSERT_EQ("22x^10 + 3Ax^2 + 3A", plain.to_string());
+
+        // NTT form ciphertexts
+        encryptor.encrypt(plain, encrypted);
+        evaluator.add_scalar(encrypted, int64_t(7), expected);
+        evaluator.transform_to_ntt_inplace(encrypted);
+        evaluator.add_scalar_inplace(encrypted, int64_t(7));
+        evaluator.multiply_scalar_inplace(encrypted, int64_t(3));
+        evaluator.transform_from_ntt_inplace(encrypted);
+        evaluator.multiply_scalar_inplace(expected, int64_t(3));
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+            encrypted.data()));
+
+        ASSERT_THROW(evaluator.add_scalar_inplace(encrypted, 1.5), invalid_argument);
+        ASSERT_THROW(evaluator.multiply_scalar_inplace(encrypted, 1.5, 1.0), 
+            invalid_argument);
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptScalarDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0), 
+            DefaultParams::small_mods_60bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+
+        vector<double> input(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = static_cast<double>(i) * 0.5 - 3.0;
+        }
+        double delta = pow(2.0, 40);
+
+        Plaintext plain;
+        Ciphertext encrypted;
+        Ciphertext expected;
+        Ciphertext result;
+        encoder.encode(input, parms.parms_id(), delta, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        // Same result as the plaintext operations, including values that do
+        // not fit in 64 bits after scaling
+        for (double value : { 1.25, -7.5, 0.0, 3.0e8 })
+        {
+            Plaintext plain_value;
+            encoder.encode(value, parms.parms_id(), delta, plain_value);
+            evaluator.add_plain(encrypted, plain_value, expected);
+            evaluator.add_scalar(encrypted, value, result);
+            ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+                result.data()));
+            if (value == 0.0)
+            {
+                // Multiplication by zero gives a transparent ciphertext
+                continue;
+            }
+
+            evaluator.multiply_plain(encrypted, plain_value, expected);
+            evaluator.multiply_scalar(encrypted, value, delta, result);
+            ASSERT_EQ(expected.scale(), result.scale());
+            ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+                result.data()));
+        }
+        for (int64_t value : { int64_t(3), int64_t(-12) })
+        {
+            Plaintext plain_value;
+            encoder.encode(value, parms.parms_id(), plain_value);
+            evaluator.multiply_plain(encrypted, plain_value, expected);
+            evaluator.multiply_scalar(encrypted, value, result);
+            ASSERT_EQ(encrypted.scale(), result.scale());
+            ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+                result.data()));
+        }
+
+        vector<double> output;
+        evaluator.add_scalar_inplace(encrypted, int64_t(2));
+        evaluator.multiply_scalar_inplace(encrypted, -1.5, pow(2.0, 20));
+        decryptor.decrypt(encrypted, plain);
+        encoder.decode(plain, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            ASSERT_NEAR((input[i] + 2.0) * -1.5, output[i], 0.001);
+        }
+
+        // Too large
+        ASSERT_THROW(evaluator.add_scalar_inplace(encrypted, pow(2.0, 100)), 
+            invalid_argument);
+        ASSERT_THROW(evaluator.multiply_scalar_inplace(encrypted, 1.0, pow(2.0, 100)), 
+            invalid_argument);
+    }
+
+    TEST(EvaluatorTest, CKKSEncryptPlainValuesDecrypt)
+    {
+        EncryptionParameters parms(scheme_type::CKKS);
+        size_t slot_size = 32;
+        parms.set_poly_modulus_degree(slot_size * 2);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0), 
+            DefaultParams::small_mods_60bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        CKKSEncoder encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+
+        vector<double> input(slot_size), constant(slot_size);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            input[i] = static_cast<double>(i) * 0.5 - 3.0;
+            constant[i] = 1.0 + static_cast<double>(i % 3);
+        }
+        double delta = pow(2.0, 40);
+
+        Plaintext plain;
+        Ciphertext encrypted;
+        Ciphertext expected;
+        encoder.encode(input, parms.parms_id(), delta, plain);
+        encryptor.encrypt(plain, encrypted);
+
+        // Same result as encoding the constant separately, and the second use
+        // of the constant at the same level and scale comes from the cache
+        encoder.set_cache_capacity(4);
+        Plaintext plain_constant;
+        encoder.encode(constant, parms.parms_id(), delta, plain_constant);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        evaluator.add_plain(encrypted, plain_constant, expected);
+        Ciphertext result = encrypted;
+        evaluator.add_plain_inplace(result, constant, encoder);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+            result.data()));
+
+        evaluator.sub_plain(encrypted, plain_constant, expected);
+        result = encrypted;
+        evaluator.sub_plain_inplace(result, constant, encoder);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+            result.data()));
+
+        evaluator.multiply_plain(encrypted, plain_constant, expected);
+        result = encrypted;
+        evaluator.multiply_plain_inplace(result, constant, delta, encoder);
+        ASSERT_EQ(1ULL, encoder.cache_size());
+        ASSERT_EQ(expected.scale(), result.scale());
+        ASSERT_TRUE(equal(expected.data(), expected.data() + expected.uint64_count(),
+            result.data()));
+
+        vector<double> output;
+        decryptor.decrypt(result, plain);
+        encoder.decode(plain, output);
+        for (size_t i = 0; i < slot_size; i++)
+        {
+            ASSERT_NEAR(input[i] * constant[i], output[i], 0.001);
+        }
+    }
+
     TEST(EvaluatorTest, FVEncryptApplyGaloisDecrypt)
     {
         EncryptionParameters parms(scheme_type::BFV);
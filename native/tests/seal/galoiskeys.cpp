@@ -7,6 +7,12 @@
 #include "seal/keygenerator.h"
 #include "seal/util/uintcore.h"
 #include "seal/defaultparams.h"
+#include "seal/batchencoder.h"
+#include "seal/encryptor.h"
+#include "seal/decryptor.h"
+#include "seal/evaluator.h"
+#include <cstdio>
+#include <fstream>
 #include <vector>
 
 using namespace seal;
@@ -147,4 +153,271 @@ namespace SEALTest
             ASSERT_EQ(14ULL, keys.size());
         }
     }
+
+    TEST(GaloisKeysTest, GaloisKeysSaveLoadCompressed)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(65537);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        GaloisKeys keys = keygen.galois_keys(8);
+
+        for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz,
+            compr_mode_type::deflate })
+        {
+            stringstream stream;
+            keys.save(stream, compr_mode);
+            GaloisKeys test_keys;
+            test_keys.load(context, stream);
+            ASSERT_EQ(keys.size(), test_keys.size());
+            ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+            ASSERT_EQ(keys.decomposition_bit_count(), test_keys.decomposition_bit_count());
+            for (size_t j = 0; j < test_keys.data().size(); j++)
+            {
+                ASSERT_EQ(keys.data()[j].size(), test_keys.data()[j].size());
+                for (size_t i = 0; i < test_keys.data()[j].size(); i++)
+                {
+                    ASSERT_EQ(keys.data()[j][i].uint64_count(), test_keys.data()[j][i].uint64_count());
+                    ASSERT_TRUE(is_equal_uint_uint(keys.data()[j][i].data(),
+                        test_keys.data()[j][i].data(), keys.data()[j][i].uint64_count()));
+                }
+            }
+        }
+    }
+
+    TEST(GaloisKeysTest, GaloisKeysSaveLoadMapped)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(257);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        GaloisKeys keys = keygen.galois_keys(20);
+
+        string path = "galoiskeys_mapped_test.seal";
+        {
+            ofstream file(path, ios_base::binary);
+            keys.save_mappable(file);
+        }
+
+        GaloisKeys test_keys;
+        test_keys.load_mapped(context, path);
+        ASSERT_EQ(keys.size(), test_keys.size());
+        ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+        ASSERT_EQ(keys.decomposition_bit_count(), test_keys.decomposition_bit_count());
+        for (size_t j = 0; j < test_keys.data().size(); j++)
+        {
+            ASSERT_EQ(keys.data()[j].size(), test_keys.data()[j].size());
+            for (size_t i = 0; i < test_keys.data()[j].size(); i++)
+            {
+                auto &test_key = test_keys.data()[j][i];
+                ASSERT_EQ(keys.data()[j][i].uint64_count(), test_key.uint64_count());
+                ASSERT_TRUE(is_equal_uint_uint(keys.data()[j][i].data(),
+                    test_key.data(), test_key.uint64_count()));
+                ASSERT_EQ(0ULL, reinterpret_cast<uintptr_t>(test_key.data()) % 64);
+            }
+        }
+
+        // The mapped keys are used directly for rotations
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        vector<uint64_t> values(batch_encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i;
+        }
+        Plaintext plain;
+        batch_encoder.encode(values, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+        evaluator.rotate_rows_inplace(encrypted, 3, test_keys);
+        evaluator.rotate_columns_inplace(encrypted, test_keys);
+        decryptor.decrypt(encrypted, plain);
+        vector<uint64_t> result;
+        batch_encoder.decode(plain, result);
+        size_t row_size = values.size() / 2;
+        for (size_t i = 0; i < row_size; i++)
+        {
+            ASSERT_EQ(values[row_size + (i + 3) % row_size], result[i]);
+            ASSERT_EQ(values[(i + 3) % row_size], result[row_size + i]);
+        }
+
+        // Copies do not depend on the mapping
+        GaloisKeys copied_keys = test_keys;
+        test_keys = GaloisKeys();
+        ASSERT_TRUE(is_equal_uint_uint(keys.data()[1][0].data(),
+            copied_keys.data()[1][0].data(), keys.data()[1][0].uint64_count()));
+        ASSERT_EQ(0, remove(path.c_str()));
+
+        // Truncated and missing files
+        {
+            stringstream stream;
+            keys.save_mappable(stream);
+            string data = stream.str();
+            ofstream file(path, ios_base::binary);
+            file.write(data.data(), static_cast<streamsize>(data.size() - 8));
+        }
+        ASSERT_THROW(test_keys.unsafe_load_mapped(path), invalid_argument);
+        ASSERT_EQ(0, remove(path.c_str()));
+        ASSERT_THROW(test_keys.unsafe_load_mapped(path), runtime_error);
+    }
+
+    TEST(GaloisKeysTest, GaloisKeysSaveLoadIndexed)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(257);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        GaloisKeys keys = keygen.galois_keys(20);
+        uint64_t elt1 = steps_to_galois_elt(1, 64);
+        uint64_t elt4 = steps_to_galois_elt(4, 64);
+        uint64_t elt_column = steps_to_galois_elt(0, 64);
+
+        // Anything written after the keys stays readable
+        stringstream stream;
+        keys.save_indexed(stream, compr_mode_type::lz);
+        uint64_t marker = 0x1234;
+        stream.write(reinterpret_cast<const char*>(&marker), sizeof(uint64_t));
+
+        GaloisKeys test_keys;
+        test_keys.load(context, stream, vector<uint64_t>{ elt4, elt_column, elt4 });
+        ASSERT_EQ(2ULL, test_keys.size());
+        ASSERT_TRUE(test_keys.has_key(elt4));
+        ASSERT_TRUE(test_keys.has_key(elt_column));
+        ASSERT_FALSE(test_keys.has_key(elt1));
+        ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+        ASSERT_EQ(keys.decomposition_bit_count(), test_keys.decomposition_bit_count());
+        for (auto elt : { elt4, elt_column })
+        {
+            ASSERT_EQ(keys.key(elt).size(), test_keys.key(elt).size());
+            for (size_t i = 0; i < keys.key(elt).size(); i++)
+            {
+                ASSERT_TRUE(is_equal_uint_uint(keys.key(elt)[i].data(),
+                    test_keys.key(elt)[i].data(), keys.key(elt)[i].uint64_count()));
+            }
+        }
+        uint64_t test_marker = 0;
+        stream.read(reinterpret_cast<char*>(&test_marker), sizeof(uint64_t));
+        ASSERT_EQ(marker, test_marker);
+
+        BatchEncoder batch_encoder(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        vector<uint64_t> values(batch_encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i;
+        }
+        Plaintext plain;
+        batch_encoder.encode(values, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+        evaluator.rotate_rows_inplace(encrypted, 4, test_keys);
+        evaluator.rotate_columns_inplace(encrypted, test_keys);
+        decryptor.decrypt(encrypted, plain);
+        vector<uint64_t> result;
+        batch_encoder.decode(plain, result);
+        size_t row_size = values.size() / 2;
+        for (size_t i = 0; i < row_size; i++)
+        {
+            ASSERT_EQ(values[row_size + (i + 4) % row_size], result[i]);
+            ASSERT_EQ(values[(i + 4) % row_size], result[row_size + i]);
+        }
+        ASSERT_THROW(evaluator.rotate_rows_inplace(encrypted, 1, test_keys),
+            invalid_argument);
+
+        // Loading by steps, and loading all keys
+        stream.seekg(0);
+        test_keys.load(context, stream, vector<int>{ 1 });
+        ASSERT_EQ(1ULL, test_keys.size());
+        ASSERT_TRUE(test_keys.has_key(elt1));
+        stream.seekg(0);
+        test_keys.load(context, stream);
+        ASSERT_EQ(keys.size(), test_keys.size());
+
+        // Keys saved without an index are read in full and then selected
+        stringstream plain_stream;
+        keys.save(plain_stream);
+        test_keys.load(context, plain_stream, vector<uint64_t>{ elt1 });
+        ASSERT_EQ(1ULL, test_keys.size());
+        ASSERT_TRUE(is_equal_uint_uint(keys.key(elt1)[0].data(),
+            test_keys.key(elt1)[0].data(), keys.key(elt1)[0].uint64_count()));
+
+        // Missing keys and invalid elements
+        GaloisKeys partial_keys = keygen.galois_keys(20, vector<uint64_t>{ elt1 });
+        stringstream partial_stream;
+        partial_keys.save_indexed(partial_stream);
+        ASSERT_THROW(test_keys.unsafe_load(partial_stream, vector<uint64_t>{ elt4 }),
+            invalid_argument);
+        partial_stream.seekg(0);
+        ASSERT_THROW(test_keys.unsafe_load(partial_stream, vector<uint64_t>{ 2 }),
+            invalid_argument);
+        partial_stream.seekg(0);
+        ASSERT_THROW(test_keys.unsafe_load(partial_stream, vector<uint64_t>{ 1ULL << 20 | 1 }),
+            invalid_argument);
+    }
+
+    TEST(GaloisKeysTest, GaloisKeysContiguous)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(257);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+
+        // Every key is stored in a single aligned buffer
+        auto is_contiguous = [](const GaloisKeys &keys)
+        {
+            for (auto &key : keys.data())
+            {
+                if (key.empty())
+                {
+                    continue;
+                }
+                if (reinterpret_cast<uintptr_t>(key[0].data()) % 64)
+                {
+                    return false;
+                }
+                for (size_t i = 1; i < key.size(); i++)
+                {
+                    if (key[i].data() != key[i - 1].data() + key[i - 1].uint64_count())
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        GaloisKeys keys = keygen.galois_keys(20);
+        ASSERT_TRUE(is_contiguous(keys));
+        uint64_t elt = steps_to_galois_elt(1, 64);
+
+        GaloisKeys copied_keys = keys;
+        ASSERT_TRUE(is_contiguous(copied_keys));
+        ASSERT_TRUE(copied_keys.key(elt)[0].data() != keys.key(elt)[0].data());
+        ASSERT_TRUE(is_equal_uint_uint(keys.key(elt)[1].data(),
+            copied_keys.key(elt)[1].data(), keys.key(elt)[1].uint64_count()));
+
+        stringstream stream;
+        keys.save(stream);
+        GaloisKeys test_keys;
+        test_keys.load(context, stream);
+        ASSERT_TRUE(is_contiguous(test_keys));
+        keys = GaloisKeys();
+        ASSERT_TRUE(is_equal_uint_uint(copied_keys.key(elt)[1].data(),
+            test_keys.key(elt)[1].data(), test_keys.key(elt)[1].uint64_count()));
+    }
 }
@@ -177,4 +177,31 @@ namespace SEALTest
         ASSERT_EQ(arr[0], arr2[0]);
         ASSERT_EQ(arr[1], arr2[1]);
     }
+
+    TEST(IntArrayTest, AliasingIntArray)
+    {
+        uint64_t data[4]{ 1, 2, 3, 4 };
+        auto arr = IntArray<uint64_t>::Aliasing(data, 4);
+        ASSERT_TRUE(arr.is_alias());
+        ASSERT_EQ(4ULL, arr.size());
+        ASSERT_EQ(4ULL, arr.capacity());
+        ASSERT_TRUE(arr.begin() == data);
+        arr[1] = 5;
+        ASSERT_EQ(5ULL, data[1]);
+
+        // Copies own their data
+        IntArray<uint64_t> arr2(arr);
+        ASSERT_FALSE(arr2.is_alias());
+        ASSERT_EQ(5ULL, arr2[1]);
+
+        // Growing moves the data to a new allocation
+        arr.resize(6);
+        ASSERT_FALSE(arr.is_alias());
+        ASSERT_TRUE(arr.begin() != data);
+        ASSERT_EQ(4ULL, arr[3]);
+        ASSERT_EQ(0ULL, arr[5]);
+        ASSERT_EQ(4ULL, data[3]);
+
+        ASSERT_THROW(IntArray<uint64_t>::Aliasing(nullptr, 1), invalid_argument);
+    }
 }
@@ -7,6 +7,8 @@
 #include "seal/defaultparams.h"
 #include <cstdint>
 #include <cstddef>
+#include <limits>
+#include <vector>
 
 using namespace seal;
 using namespace std;
@@ -436,4 +438,102 @@ namespace SEALTest
         poly11[5] = 0x7FFE; // 32766
         ASSERT_EQ(static_cast<int32_t>(1 + -1 * 2 + -2 * 4 + -32767 * 8 + 32767 * 16 + 32766 * 32), encoder2.decode_int32(poly11));
     }
+
+    TEST(Encoder, IntDecodeRange)
+    {
+        SmallModulus modulus(0xFFFF);
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_plain_modulus(modulus);
+        auto context = SEALContext::Create(parms);
+        IntegerEncoder encoder(context);
+
+        // Extreme 64-bit values
+        int64_t int64_max = numeric_limits<int64_t>::max();
+        int64_t int64_min = numeric_limits<int64_t>::min();
+        uint64_t uint64_max = numeric_limits<uint64_t>::max();
+        ASSERT_EQ(int64_max, encoder.decode_int64(encoder.encode(int64_max)));
+        ASSERT_EQ(int64_min, encoder.decode_int64(encoder.encode(int64_min)));
+        ASSERT_EQ(uint64_max, encoder.decode_uint64(encoder.encode(uint64_max)));
+        ASSERT_THROW(encoder.decode_int64(encoder.encode(uint64_max)), invalid_argument);
+        ASSERT_THROW(encoder.decode_uint64(encoder.encode(int64_t(-1))), invalid_argument);
+
+        // One past the extremes
+        Plaintext plain(65);
+        plain[64] = 1;
+        ASSERT_THROW(encoder.decode_uint64(plain), invalid_argument);
+        ASSERT_THROW(encoder.decode_int64(plain), invalid_argument);
+        ASSERT_EQ("10000000000000000", encoder.decode_biguint(plain).to_string());
+        plain.resize(64);
+        plain[63] = 1;
+        ASSERT_THROW(encoder.decode_int64(plain), invalid_argument);
+        plain[63] = 0xFFFE;
+        plain[0] = 0xFFFE;
+        ASSERT_THROW(encoder.decode_int64(plain), invalid_argument);
+
+        // Large coefficients that cancel out
+        plain.resize(100);
+        plain.set_zero();
+        plain[99] = 1;
+        plain[98] = 0xFFFD;
+        plain[0] = 0x7FFF;
+        ASSERT_EQ(int64_t(0x7FFF), encoder.decode_int64(plain));
+        ASSERT_EQ(uint64_t(0x7FFF), encoder.decode_uint64(plain));
+
+        // Results larger than 128 bits use the general path
+        plain.resize(200);
+        plain.set_zero();
+        plain[199] = 1;
+        plain[130] = 0x7FFF;
+        plain[0] = 3;
+        BigUInt expected(200);
+        expected = 3;
+        BigUInt term(200);
+        term = 0x7FFF;
+        term <<= 130;
+        expected += term;
+        term = 1;
+        term <<= 199;
+        expected += term;
+        ASSERT_TRUE(expected == encoder.decode_biguint(plain));
+        ASSERT_THROW(encoder.decode_uint64(plain), invalid_argument);
+        plain[199] = 0xFFFE;
+        ASSERT_THROW(encoder.decode_biguint(plain), invalid_argument);
+
+        // Invalid coefficients are detected on all paths
+        plain[199] = 1;
+        plain[0] = 0xFFFF;
+        ASSERT_THROW(encoder.decode_biguint(plain), invalid_argument);
+        ASSERT_THROW(encoder.decode_uint64(plain), invalid_argument);
+    }
+
+    TEST(Encoder, IntEncodeDecodeBatch)
+    {
+        SmallModulus modulus(0x10000);
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_plain_modulus(modulus);
+        auto context = SEALContext::Create(parms);
+        IntegerEncoder encoder(context);
+
+        vector<int64_t> values{ 0, 1, -1, 12345, -67890, numeric_limits<int64_t>::min() };
+        vector<Plaintext> plains;
+        encoder.encode(values, plains);
+        ASSERT_EQ(values.size(), plains.size());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            ASSERT_TRUE(encoder.encode(values[i]) == plains[i]);
+        }
+        vector<int64_t> decoded;
+        encoder.decode_int64(plains, decoded);
+        ASSERT_TRUE(values == decoded);
+
+        vector<uint64_t> uvalues{ 7, numeric_limits<uint64_t>::max() };
+        encoder.encode(uvalues, plains);
+        ASSERT_EQ(uvalues.size(), plains.size());
+        vector<uint64_t> udecoded;
+        encoder.decode_uint64(plains, udecoded);
+        ASSERT_TRUE(uvalues == udecoded);
+
+        plains.emplace_back(encoder.encode(int64_t(-3)));
+        ASSERT_THROW(encoder.decode_uint64(plains, udecoded), invalid_argument);
+    }
 }
@@ -8,6 +8,9 @@
 #include "seal/defaultparams.h"
 #include "seal/encryptor.h"
 #include "seal/decryptor.h"
+#include "seal/evaluator.h"
+#include "seal/batchencoder.h"
+#include <sstream>
 
 using namespace seal;
 using namespace seal::util;
@@ -571,4 +574,104 @@ namespace SEALTest
             }
         }
     }
+
+    TEST(KeyGeneratorTest, FVParallelAndStreamedKeyGeneration)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_noise_standard_deviation(3.20);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(257);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0), 
+            DefaultParams::small_mods_60bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        BatchEncoder batch_encoder(context);
+        size_t row_size = batch_encoder.slot_count() / 2;
+
+        vector<uint64_t> values(batch_encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i;
+        }
+        Plaintext plain;
+        batch_encoder.encode(values, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+
+        auto check_rotation = [&](const GaloisKeys &galks, int steps)
+        {
+            Ciphertext rotated;
+            evaluator.rotate_rows(encrypted, steps, galks, rotated);
+            Plaintext plain_rotated;
+            decryptor.decrypt(rotated, plain_rotated);
+            vector<uint64_t> values_rotated;
+            batch_encoder.decode(plain_rotated, values_rotated);
+            size_t shift = static_cast<size_t>(
+                (steps + static_cast<int>(row_size)) % static_cast<int>(row_size));
+            for (size_t i = 0; i < row_size; i++)
+            {
+                ASSERT_EQ(values[(i + shift) % row_size], values_rotated[i]);
+                ASSERT_EQ(values[row_size + (i + shift) % row_size], 
+                    values_rotated[row_size + i]);
+            }
+        };
+
+        for (size_t thread_count : { size_t(0), size_t(1), size_t(3) })
+        {
+            GaloisKeys galks = keygen.galois_keys(20, vector<int>{ 1, -3, 1 }, 
+                thread_count);
+            ASSERT_TRUE(galks.is_valid_for(context));
+            ASSERT_EQ(2ULL, galks.size());
+            check_rotation(galks, 1);
+            check_rotation(galks, -3);
+
+            RelinKeys rlk = keygen.relin_keys(20, 2, thread_count);
+            ASSERT_TRUE(rlk.is_valid_for(context));
+            Ciphertext cubed;
+            evaluator.square(encrypted, cubed);
+            evaluator.multiply_inplace(cubed, encrypted);
+            evaluator.relinearize_inplace(cubed, rlk);
+            ASSERT_EQ(2ULL, cubed.size());
+            Plaintext plain_cubed;
+            decryptor.decrypt(cubed, plain_cubed);
+            vector<uint64_t> values_cubed;
+            batch_encoder.decode(plain_cubed, values_cubed);
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                uint64_t square = (values[i] * values[i]) % 257;
+                ASSERT_EQ((square * values[i]) % 257, values_cubed[i]);
+            }
+
+            // Streamed keys load as keys saved with GaloisKeys::save
+            stringstream stream;
+            keygen.save_galois_keys(stream, 20, vector<int>{ -3, 1 }, thread_count);
+            GaloisKeys loaded;
+            loaded.load(context, stream);
+            ASSERT_EQ(2ULL, loaded.size());
+            ASSERT_EQ(20, loaded.decomposition_bit_count());
+            check_rotation(loaded, 1);
+            check_rotation(loaded, -3);
+
+            stringstream stream2;
+            galks.save(stream2);
+            ASSERT_EQ(stream2.str().size(), stream.str().size());
+        }
+
+        stringstream stream;
+        keygen.save_galois_keys(stream, 30);
+        GaloisKeys loaded;
+        loaded.load(context, stream);
+        ASSERT_EQ(keygen.galois_keys(30).size(), loaded.size());
+        check_rotation(loaded, 5);
+
+        stringstream empty_stream;
+        keygen.save_galois_keys(empty_stream, 30, vector<uint64_t>{});
+        loaded.load(context, empty_stream);
+        ASSERT_EQ(0ULL, loaded.size());
+        ASSERT_THROW(keygen.save_galois_keys(empty_stream, 30, vector<uint64_t>{ 2 }),
+            invalid_argument);
+    }
 }
@@ -148,4 +148,40 @@ namespace SEALTest
             ASSERT_TRUE(plain2.is_ntt_form());
         }
     }
+
+    TEST(PlaintextTest, SaveLoadCompactPlaintext)
+    {
+        stringstream stream;
+
+        // Small coefficients take only as many bits as they need
+        Plaintext plain(1024);
+        for (size_t i = 0; i < plain.coeff_count(); i++)
+        {
+            plain[i] = i % 16;
+        }
+        plain.save(stream);
+        ASSERT_GT(plain.coeff_count() * sizeof(uint64_t), stream.str().size());
+        Plaintext plain2;
+        plain2.unsafe_load(stream);
+        ASSERT_TRUE(plain == plain2);
+
+        // Plaintexts in the original format can still be loaded
+        stringstream legacy_stream;
+        parms_id_type parms_id{ 1, 2, 3, 4 };
+        double scale = 3.5;
+        legacy_stream.write(reinterpret_cast<const char*>(&parms_id), sizeof(parms_id_type));
+        legacy_stream.write(reinterpret_cast<const char*>(&scale), sizeof(double));
+        IntArray<uint64_t> legacy_data(3);
+        legacy_data[0] = 5;
+        legacy_data[1] = 0xFFFFFFFFFFFFFFFFULL;
+        legacy_data[2] = 7;
+        legacy_data.save(legacy_stream);
+        plain2.unsafe_load(legacy_stream);
+        ASSERT_TRUE(plain2.parms_id() == parms_id);
+        ASSERT_EQ(3.5, plain2.scale());
+        ASSERT_EQ(3ULL, plain2.coeff_count());
+        ASSERT_EQ(5ULL, plain2[0]);
+        ASSERT_EQ(0xFFFFFFFFFFFFFFFFULL, plain2[1]);
+        ASSERT_EQ(7ULL, plain2[2]);
+    }
 }
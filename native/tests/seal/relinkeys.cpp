@@ -7,6 +7,11 @@
 #include "seal/keygenerator.h"
 #include "seal/util/uintcore.h"
 #include "seal/defaultparams.h"
+#include "seal/encryptor.h"
+#include "seal/decryptor.h"
+#include "seal/evaluator.h"
+#include <cstdio>
+#include <fstream>
 
 using namespace seal;
 using namespace seal::util;
@@ -176,4 +181,88 @@ namespace SEALTest
             }
         }
     }
+
+    TEST(RelinKeysTest, RelinKeysSaveLoadMapped)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_40bit(0),
+            DefaultParams::small_mods_40bit(1) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        RelinKeys keys = keygen.relin_keys(30, 2);
+
+        string path = "relinkeys_mapped_test.seal";
+        {
+            ofstream file(path, ios_base::binary);
+            keys.save_mappable(file);
+        }
+
+        RelinKeys test_keys;
+        test_keys.load_mapped(context, path);
+        ASSERT_EQ(keys.size(), test_keys.size());
+        ASSERT_TRUE(keys.parms_id() == test_keys.parms_id());
+        ASSERT_EQ(keys.decomposition_bit_count(), test_keys.decomposition_bit_count());
+        for (size_t j = 0; j < test_keys.size(); j++)
+        {
+            ASSERT_EQ(keys.data()[j].size(), test_keys.data()[j].size());
+            for (size_t i = 0; i < test_keys.data()[j].size(); i++)
+            {
+                ASSERT_EQ(keys.data()[j][i].uint64_count(), test_keys.data()[j][i].uint64_count());
+                ASSERT_TRUE(is_equal_uint_uint(keys.data()[j][i].data(),
+                    test_keys.data()[j][i].data(), keys.data()[j][i].uint64_count()));
+            }
+        }
+
+        // The mapped keys are used directly for relinearization
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        Ciphertext encrypted, encrypted2;
+        encryptor.encrypt(Plaintext("1x^2 + 3"), encrypted);
+        evaluator.square(encrypted, encrypted2);
+        evaluator.multiply_inplace(encrypted2, encrypted);
+        ASSERT_EQ(4ULL, encrypted2.size());
+        evaluator.relinearize(encrypted2, test_keys, encrypted);
+        ASSERT_EQ(2ULL, encrypted.size());
+        Plaintext plain;
+        decryptor.decrypt(encrypted, plain);
+        ASSERT_EQ("1x^6 + 9x^4 + 1Bx^2 + 1B", plain.to_string());
+
+        test_keys = RelinKeys();
+        ASSERT_EQ(0, remove(path.c_str()));
+    }
+
+    TEST(RelinKeysTest, RelinKeysSaveLoadBuffer)
+    {
+        EncryptionParameters parms(scheme_type::BFV);
+        parms.set_poly_modulus_degree(64);
+        parms.set_plain_modulus(1 << 6);
+        parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0),
+            DefaultParams::small_mods_30bit(0) });
+        auto context = SEALContext::Create(parms);
+        KeyGenerator keygen(context);
+        RelinKeys keys = keygen.relin_keys(30, 2);
+
+        stringstream stream;
+        keys.save(stream);
+        size_t size = keys.save_size();
+        ASSERT_EQ(stream.str().size(), size);
+
+        vector<SEAL_BYTE> buffer(size);
+        ASSERT_THROW(keys.save(buffer.data(), size - 1), invalid_argument);
+        ASSERT_EQ(size, keys.save(buffer.data(), size));
+        RelinKeys test_keys;
+        ASSERT_EQ(size, test_keys.load(context, buffer.data(), size));
+        ASSERT_EQ(keys.size(), test_keys.size());
+        for (size_t j = 0; j < keys.size(); j++)
+        {
+            for (size_t i = 0; i < keys.key(j + 2).size(); i++)
+            {
+                ASSERT_TRUE(is_equal_uint_uint(keys.key(j + 2)[i].data(),
+                    test_keys.key(j + 2)[i].data(), keys.key(j + 2)[i].uint64_count()));
+            }
+        }
+    }
 }
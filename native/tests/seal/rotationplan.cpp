@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/rotationplan.h"
+#include "seal/context.h"
+#include "seal/keygenerator.h"
+#include "seal/encryptor.h"
+#include "seal/decryptor.h"
+#include "seal/evaluator.h"
+#include "seal/batchencoder.h"
+#include "seal/defaultparams.h"
+#include <numeric>
+#include <sstream>
+
+using namespace seal;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace
+    {
+        shared_ptr<SEALContext> create_bfv_context()
+        {
+            EncryptionParameters parms(scheme_type::BFV);
+            parms.set_noise_standard_deviation(3.20);
+            parms.set_poly_modulus_degree(64);
+            parms.set_plain_modulus(257);
+            parms.set_coeff_modulus({ DefaultParams::small_mods_60bit(0),
+                DefaultParams::small_mods_60bit(1) });
+            return SEALContext::Create(parms);
+        }
+
+        void check_decomposition(const RotationPlan &plan, int steps)
+        {
+            auto keys = plan.decomposition(steps);
+            ASSERT_EQ(keys.size(), plan.key_switch_count(steps));
+            int sum = accumulate(keys.begin(), keys.end(), 0);
+            ASSERT_EQ(0, (sum - steps + 64) % 32);
+            for (auto key : keys)
+            {
+                ASSERT_TRUE(binary_search(plan.key_steps().begin(),
+                    plan.key_steps().end(), key));
+            }
+        }
+    }
+
+    TEST(RotationPlanTest, PlanKeys)
+    {
+        auto context = create_bfv_context();
+
+        // 12 polynomials of two 64-coefficient primes
+        RotationPlan unlimited(context, { { 1, 10 }, { 5, 1 }, { 7, 1 }, { -1, 3 }, { 0, 1 } },
+            size_t(1) << 30, 20);
+        ASSERT_EQ(12ULL * 64 * 2 * 8, unlimited.key_byte_count());
+        ASSERT_EQ(20, unlimited.decomposition_bit_count());
+        ASSERT_TRUE(unlimited.parms_id() == context->first_parms_id());
+        ASSERT_EQ((vector<int>{ 1, 5, 7, 31 }), unlimited.key_steps());
+        ASSERT_EQ(4ULL, unlimited.galois_elts().size());
+        ASSERT_DOUBLE_EQ(1.0, unlimited.expected_key_switch_count());
+        ASSERT_EQ(0ULL, unlimited.key_switch_count(0));
+        ASSERT_EQ(1ULL, unlimited.key_switch_count(-1));
+        ASSERT_EQ(2ULL, unlimited.key_switch_count(6));
+        ASSERT_THROW(unlimited.decomposition(32), invalid_argument);
+
+        // Fifteen rotations with room for eight keys need a key set shared
+        // between the rotations
+        map<int, double> step_frequencies;
+        for (int steps = 1; steps <= 15; steps++)
+        {
+            step_frequencies[steps] = 1;
+        }
+        RotationPlan limited(context, step_frequencies, 8 * unlimited.key_byte_count(), 20);
+        ASSERT_TRUE(limited.key_steps().size() <= 8);
+        ASSERT_TRUE(limited.expected_key_switch_count() <= 2.0);
+        ASSERT_TRUE(limited.expected_key_switch_count() > 1.0);
+        for (int steps = -31; steps < 32; steps++)
+        {
+            try
+            {
+                check_decomposition(limited, steps);
+            }
+            catch (const invalid_argument &)
+            {
+                // Rotations outside the workload need not be possible
+                ASSERT_FALSE(steps >= 1 && steps <= 15);
+            }
+        }
+        for (int steps = 1; steps <= 15; steps++)
+        {
+            ASSERT_TRUE(limited.key_switch_count(steps) <= 2);
+        }
+
+        // Frequent rotations get their own keys when possible
+        step_frequencies[13] = 1000;
+        RotationPlan weighted(context, step_frequencies, 8 * unlimited.key_byte_count(), 20);
+        ASSERT_EQ(1ULL, weighted.key_switch_count(13));
+
+        RotationPlan empty(context, {}, 0, 20);
+        ASSERT_EQ(0ULL, empty.key_steps().size());
+        ASSERT_DOUBLE_EQ(0.0, empty.expected_key_switch_count());
+
+        ASSERT_THROW(RotationPlan(context, { { 1, 1 }, { 2, 1 }, { 3, 1 } },
+            unlimited.key_byte_count() - 1, 20), invalid_argument);
+        ASSERT_THROW(RotationPlan(context, { { 32, 1 } }, size_t(1) << 30, 20),
+            invalid_argument);
+        ASSERT_THROW(RotationPlan(context, { { 1, -1 } }, size_t(1) << 30, 20),
+            invalid_argument);
+        ASSERT_THROW(RotationPlan(context, { { 1, 1 } }, size_t(1) << 30, 0),
+            invalid_argument);
+    }
+
+    TEST(RotationPlanTest, RotateWithPlan)
+    {
+        auto context = create_bfv_context();
+        KeyGenerator keygen(context);
+        Encryptor encryptor(context, keygen.public_key());
+        Decryptor decryptor(context, keygen.secret_key());
+        Evaluator evaluator(context);
+        BatchEncoder batch_encoder(context);
+        size_t row_size = batch_encoder.slot_count() / 2;
+
+        map<int, double> step_frequencies;
+        for (int steps = -7; steps <= 7; steps++)
+        {
+            step_frequencies[steps] = 1;
+        }
+        RotationPlan plan(context, step_frequencies, 6 * size_t(12 * 64 * 2 * 8), 20);
+        GaloisKeys galois_keys = plan.generate_keys(keygen);
+        ASSERT_EQ(plan.key_steps().size(), galois_keys.size());
+
+        stringstream stream;
+        plan.save_keys(keygen, stream);
+        GaloisKeys loaded_keys;
+        loaded_keys.load(context, stream);
+        ASSERT_EQ(plan.key_steps().size(), loaded_keys.size());
+
+        vector<uint64_t> values(batch_encoder.slot_count());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i;
+        }
+        Plaintext plain;
+        batch_encoder.encode(values, plain);
+        Ciphertext encrypted;
+        encryptor.encrypt(plain, encrypted);
+        for (int steps = -7; steps <= 7; steps++)
+        {
+            Ciphertext rotated;
+            evaluator.rotate_rows(encrypted, steps, plan,
+                (steps & 1) ? galois_keys : loaded_keys, rotated);
+            Plaintext plain_rotated;
+            decryptor.decrypt(rotated, plain_rotated);
+            vector<uint64_t> values_rotated;
+            batch_encoder.decode(plain_rotated, values_rotated);
+            size_t shift = static_cast<size_t>(steps + 32) % row_size;
+            for (size_t i = 0; i < row_size; i++)
+            {
+                ASSERT_EQ(values[(i + shift) % row_size], values_rotated[i]);
+                ASSERT_EQ(values[row_size + (i + shift) % row_size],
+                    values_rotated[row_size + i]);
+            }
+        }
+
+        ASSERT_THROW(evaluator.rotate_vector_inplace(encrypted, 1, plan, galois_keys),
+            logic_error);
+        EncryptionParameters other_parms = context->context_data()->parms();
+        other_parms.set_plain_modulus(641);
+        KeyGenerator mismatched_keygen(SEALContext::Create(other_parms));
+        ASSERT_THROW(plan.generate_keys(mismatched_keygen), invalid_argument);
+    }
+}
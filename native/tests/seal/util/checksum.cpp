@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/checksum.h"
+#include <cstdint>
+#include <vector>
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+   namespace util
+   {
+        TEST(ChecksumTest, Digest)
+        {
+            Checksum empty;
+            ASSERT_EQ(0xEF46DB3751D8E999ULL, empty.digest());
+
+            Checksum abc;
+            SEAL_BYTE abc_data[3]{ SEAL_BYTE('a'), SEAL_BYTE('b'), SEAL_BYTE('c') };
+            abc.update(abc_data, 3);
+            ASSERT_EQ(0x44BC2CF5AD770999ULL, abc.digest());
+
+            vector<SEAL_BYTE> data(1000);
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                data[i] = static_cast<SEAL_BYTE>((i * 7 + 1) & 0xFF);
+            }
+            vector<pair<size_t, uint64_t>> expected{
+                { 1, 0x8A4127811B21E730ULL }, { 4, 0x22EDA2CF6AF4C124ULL },
+                { 31, 0x6AB1C40E29F50073ULL }, { 32, 0x5A0756FBE9ECD3D1ULL },
+                { 33, 0xDC50CDC37BB9C183ULL }, { 100, 0xD248BFC5208B0B16ULL },
+                { 1000, 0x6BE03ACBF959C413ULL } };
+            for (auto &size_and_digest : expected)
+            {
+                Checksum checksum;
+                checksum.update(data.data(), size_and_digest.first);
+                ASSERT_EQ(size_and_digest.second, checksum.digest());
+            }
+        }
+
+        TEST(ChecksumTest, DigestInPieces)
+        {
+            vector<SEAL_BYTE> data(1000);
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                data[i] = static_cast<SEAL_BYTE>((i * 7 + 1) & 0xFF);
+            }
+            for (size_t piece_size : { 1, 5, 31, 32, 33, 999 })
+            {
+                Checksum checksum;
+                for (size_t offset = 0; offset < data.size(); offset += piece_size)
+                {
+                    checksum.update(data.data() + offset,
+                        min(piece_size, data.size() - offset));
+                }
+                ASSERT_EQ(0x6BE03ACBF959C413ULL, checksum.digest());
+            }
+        }
+   }
+}
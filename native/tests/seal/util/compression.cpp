@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/compression.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+   namespace util
+   {
+        TEST(CompressionTest, CompressDecompress)
+        {
+            mt19937 engine(5);
+            vector<vector<SEAL_BYTE>> inputs;
+            inputs.emplace_back();
+            inputs.emplace_back(1, SEAL_BYTE(7));
+            inputs.emplace_back(100000, SEAL_BYTE(0));
+            {
+                // Random bytes do not compress
+                vector<SEAL_BYTE> random(5000);
+                for (auto &b : random)
+                {
+                    b = static_cast<SEAL_BYTE>(engine() & 0xFF);
+                }
+                inputs.push_back(random);
+
+                // Repeated random blocks separated by zero runs do
+                vector<SEAL_BYTE> repeated;
+                for (int i = 0; i < 20; i++)
+                {
+                    repeated.insert(repeated.end(), random.begin(), random.begin() + 300);
+                    repeated.insert(repeated.end(), static_cast<size_t>(i * 37), SEAL_BYTE(0));
+                }
+                inputs.push_back(repeated);
+            }
+
+            for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz,
+                compr_mode_type::deflate })
+            {
+                for (auto &input : inputs)
+                {
+                    vector<SEAL_BYTE> compressed;
+                    compr_mode_type used_mode = compress(input.data(), input.size(),
+                        compr_mode, compressed);
+                    if (is_supported_compr_mode(compr_mode))
+                    {
+                        ASSERT_TRUE(compr_mode == used_mode);
+                    }
+                    else
+                    {
+                        ASSERT_TRUE(compr_mode_type::lz == used_mode);
+                    }
+
+                    vector<SEAL_BYTE> decompressed(input.size());
+                    decompress(compressed.data(), compressed.size(), used_mode,
+                        decompressed.data(), decompressed.size());
+                    ASSERT_TRUE(input == decompressed);
+                }
+
+                if (compr_mode != compr_mode_type::none)
+                {
+                    vector<SEAL_BYTE> compressed;
+                    compress(inputs[2].data(), inputs[2].size(), compr_mode, compressed);
+                    ASSERT_GT(inputs[2].size() / 100, compressed.size());
+                }
+            }
+        }
+
+        TEST(CompressionTest, DecompressInvalid)
+        {
+            vector<SEAL_BYTE> input(1000, SEAL_BYTE(1));
+            vector<SEAL_BYTE> compressed;
+            compress(input.data(), input.size(), compr_mode_type::lz, compressed);
+            vector<SEAL_BYTE> decompressed(input.size());
+
+            // Wrong decompressed size
+            ASSERT_THROW(decompress(compressed.data(), compressed.size(),
+                compr_mode_type::lz, decompressed.data(), input.size() - 1), invalid_argument);
+
+            // Truncated input
+            ASSERT_THROW(decompress(compressed.data(), compressed.size() - 1,
+                compr_mode_type::lz, decompressed.data(), input.size()), invalid_argument);
+            ASSERT_THROW(decompress(compressed.data(), 0,
+                compr_mode_type::lz, decompressed.data(), input.size()), invalid_argument);
+
+            // Back-reference before the start of the output
+            SEAL_BYTE bad[]{ SEAL_BYTE(0x10), SEAL_BYTE(1), SEAL_BYTE(2), SEAL_BYTE(0) };
+            ASSERT_THROW(decompress(bad, 4, compr_mode_type::lz, decompressed.data(), 5),
+                invalid_argument);
+        }
+    }
+}
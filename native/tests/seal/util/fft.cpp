@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/fft.h"
+#include "seal/util/common.h"
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+   namespace util
+   {
+        namespace
+        {
+            // Straightforward radix-2 reference transforms on std::complex
+            void reference_fft(vector<complex<double>> &values,
+                const vector<complex<double>> &roots)
+            {
+                size_t n = values.size();
+                size_t root_index = 1;
+                for (size_t m = 1; m < n; m <<= 1)
+                {
+                    size_t gap = n / (2 * m);
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        complex<double> s = roots[root_index++];
+                        size_t offset = 2 * i * gap;
+                        for (size_t j = offset; j < offset + gap; j++)
+                        {
+                            complex<double> u = values[j];
+                            complex<double> v = values[j + gap] * s;
+                            values[j] = u + v;
+                            values[j + gap] = u - v;
+                        }
+                    }
+                }
+            }
+
+            void reference_inverse_fft(vector<complex<double>> &values,
+                const vector<complex<double>> &inv_roots)
+            {
+                size_t n = values.size();
+                for (size_t gap = 1, m = n >> 1; m >= 1; gap <<= 1, m >>= 1)
+                {
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        complex<double> s = inv_roots[m + i];
+                        size_t offset = 2 * i * gap;
+                        for (size_t j = offset; j < offset + gap; j++)
+                        {
+                            complex<double> u = values[j];
+                            complex<double> v = values[j + gap];
+                            values[j] = u + v;
+                            values[j + gap] = (u - v) * s;
+                        }
+                    }
+                }
+            }
+
+            void check_fft(int logn)
+            {
+                size_t n = size_t(1) << logn;
+                FFTTables tables(logn);
+                ASSERT_EQ(logn, tables.coeff_count_power());
+                ASSERT_EQ(n, tables.coeff_count());
+
+                vector<complex<double>> roots(n), inv_roots(n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    roots[i] = complex<double>(
+                        tables.root_real()[i], tables.root_imag()[i]);
+                    inv_roots[i] = complex<double>(
+                        tables.inv_root_real()[i], tables.inv_root_imag()[i]);
+                }
+
+                mt19937_64 engine(static_cast<unsigned long>(logn));
+                uniform_real_distribution<double> dist(-1.0, 1.0);
+                vector<complex<double>> input(n);
+                for (auto &v : input)
+                {
+                    v = complex<double>(dist(engine), dist(engine));
+                }
+
+                // Forward transform
+                vector<complex<double>> expected(input);
+                reference_fft(expected, roots);
+                vector<double> real(n), imag(n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    real[i] = input[i].real();
+                    imag[i] = input[i].imag();
+                }
+                fft_negacyclic(real.data(), imag.data(), tables);
+                for (size_t i = 0; i < n; i++)
+                {
+                    ASSERT_NEAR(expected[i].real(), real[i], 1e-9);
+                    ASSERT_NEAR(expected[i].imag(), imag[i], 1e-9);
+                }
+
+                // Inverse transform with scaling undoes the forward transform
+                double n_inv = 1.0 / static_cast<double>(n);
+                inverse_fft_negacyclic(real.data(), imag.data(), tables, n_inv);
+                for (size_t i = 0; i < n; i++)
+                {
+                    ASSERT_NEAR(input[i].real(), real[i], 1e-9);
+                    ASSERT_NEAR(input[i].imag(), imag[i], 1e-9);
+                }
+
+                // Inverse transform agrees with the reference
+                expected = input;
+                reference_inverse_fft(expected, inv_roots);
+                for (size_t i = 0; i < n; i++)
+                {
+                    real[i] = input[i].real();
+                    imag[i] = input[i].imag();
+                }
+                inverse_fft_negacyclic(real.data(), imag.data(), tables, 2.0);
+                for (size_t i = 0; i < n; i++)
+                {
+                    ASSERT_NEAR(2.0 * expected[i].real(), real[i], 1e-9);
+                    ASSERT_NEAR(2.0 * expected[i].imag(), imag[i], 1e-9);
+                }
+            }
+        }
+
+        TEST(FFTTest, FFTTablesRoots)
+        {
+            int logn = 4;
+            size_t n = size_t(1) << logn;
+            FFTTables tables(logn);
+            double pi = 3.1415926535897932384626433832795028842;
+            for (size_t i = 0; i < n; i++)
+            {
+                uint64_t power = reverse_bits(i, logn);
+                double angle = pi * static_cast<double>(power) / static_cast<double>(n);
+                ASSERT_NEAR(cos(angle), tables.root_real()[i], 1e-12);
+                ASSERT_NEAR(sin(angle), tables.root_imag()[i], 1e-12);
+                ASSERT_NEAR(cos(angle), tables.inv_root_real()[i], 1e-12);
+                ASSERT_NEAR(-sin(angle), tables.inv_root_imag()[i], 1e-12);
+            }
+        }
+
+        TEST(FFTTest, FFTMatchesReference)
+        {
+            // Cover both even and odd numbers of stages, and sizes below and
+            // above the vector width
+            for (int logn = 1; logn <= 12; logn++)
+            {
+                check_fft(logn);
+            }
+        }
+
+        TEST(FFTTest, GetMaxAbs)
+        {
+            ASSERT_EQ(0.0, get_max_abs(nullptr, 0));
+
+            vector<double> values{ 1.5, -2.5, 0.0, 2.0, -0.5, 1.0, 2.25 };
+            ASSERT_EQ(2.5, get_max_abs(values.data(), values.size()));
+            ASSERT_EQ(1.5, get_max_abs(values.data(), 1));
+
+            values.assign(37, 1.0);
+            values[36] = -7.0;
+            ASSERT_EQ(7.0, get_max_abs(values.data(), values.size()));
+            values[36] = 1.0;
+            values[3] = 8.0;
+            ASSERT_EQ(8.0, get_max_abs(values.data(), values.size()));
+
+            // NaN anywhere, in the vectorized part or the tail, is returned
+            values[5] = numeric_limits<double>::quiet_NaN();
+            ASSERT_TRUE(std::isnan(get_max_abs(values.data(), values.size())));
+            values[5] = 1.0;
+            values[36] = -numeric_limits<double>::quiet_NaN();
+            ASSERT_TRUE(std::isnan(get_max_abs(values.data(), values.size())));
+        }
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/galois.h"
+#include "seal/util/polyarithsmallmod.h"
+#include "seal/util/threadpool.h"
+#include "seal/defaultparams.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace util
+    {
+        TEST(GaloisToolTest, ApplyGalois)
+        {
+            GaloisTool tool(2);
+            ASSERT_EQ(2, tool.coeff_count_power());
+            ASSERT_EQ(4ULL, tool.coeff_count());
+            ASSERT_EQ(0ULL, tool.table_count());
+
+            // 1 + 2x + 3x^2 + 4x^3 -> 1 + 2x^3 - 3x^2 + 4x modulo x^4 + 1
+            SmallModulus modulus(17);
+            vector<uint64_t> input{ 1, 2, 3, 4 };
+            vector<uint64_t> result(4);
+            tool.apply_galois(input.data(), 3, modulus, result.data());
+            ASSERT_EQ((vector<uint64_t>{ 1, 4, 14, 2 }), result);
+
+            // Coefficient form needs no tables
+            ASSERT_EQ(0ULL, tool.table_count());
+
+            // Zero stays zero when negated
+            input = { 0, 0, 0, 5 };
+            tool.apply_galois(input.data(), 7, modulus, result.data());
+            ASSERT_EQ((vector<uint64_t>{ 0, 12, 0, 0 }), result);
+            input = { 0, 0, 0, 0 };
+            tool.apply_galois(input.data(), 7, modulus, result.data());
+            ASSERT_EQ((vector<uint64_t>{ 0, 0, 0, 0 }), result);
+
+            // The values in NTT form are at the roots w, w^5, w^3, w^7, which
+            // x -> x^3 maps to w^3, w^7, w, w^5
+            input = { 1, 2, 3, 4 };
+            tool.apply_galois_ntt(input.data(), 3, result.data());
+            ASSERT_EQ((vector<uint64_t>{ 3, 4, 1, 2 }), result);
+            ASSERT_EQ(1ULL, tool.table_count());
+            tool.apply_galois_ntt(input.data(), 3, result.data());
+            ASSERT_EQ(1ULL, tool.table_count());
+
+            ASSERT_THROW(tool.apply_galois(input.data(), 2, modulus, result.data()),
+                invalid_argument);
+            ASSERT_THROW(tool.apply_galois(input.data(), 9, modulus, result.data()),
+                invalid_argument);
+            ASSERT_THROW(tool.apply_galois_ntt(input.data(), 9, result.data()),
+                invalid_argument);
+            ASSERT_THROW(GaloisTool(0), invalid_argument);
+            ASSERT_THROW(GaloisTool(16), invalid_argument);
+        }
+
+        TEST(GaloisToolTest, MatchesDirectComputation)
+        {
+            // More Galois elements than tables are kept
+            int coeff_count_power = 7;
+            size_t coeff_count = size_t(1) << coeff_count_power;
+            SmallModulus modulus(DefaultParams::small_mods_60bit(0));
+            GaloisTool tool(coeff_count_power);
+
+            random_device rd;
+            vector<uint64_t> input(coeff_count);
+            for (auto &value : input)
+            {
+                value = (static_cast<uint64_t>(rd()) << 32 | rd()) % modulus.value();
+            }
+            input[5] = 0;
+
+            vector<uint64_t> expected(coeff_count);
+            vector<uint64_t> result(coeff_count);
+            for (uint64_t galois_elt = 1; galois_elt < 2 * coeff_count; galois_elt += 2)
+            {
+                // Twice, so that the second time uses the cached tables if the
+                // element has one
+                for (int i = 0; i < 2; i++)
+                {
+                    apply_galois(input.data(), coeff_count_power, galois_elt, modulus,
+                        expected.data());
+                    tool.apply_galois(input.data(), galois_elt, modulus, result.data());
+                    ASSERT_EQ(expected, result);
+
+                    apply_galois_ntt(input.data(), coeff_count_power, galois_elt,
+                        expected.data());
+                    tool.apply_galois_ntt(input.data(), galois_elt, result.data());
+                    ASSERT_EQ(expected, result);
+                }
+            }
+            size_t max_table_count = GaloisTool::max_table_count;
+            ASSERT_GT(coeff_count, max_table_count);
+            ASSERT_EQ(max_table_count, tool.table_count());
+        }
+
+        TEST(GaloisToolTest, ConcurrentUse)
+        {
+            int coeff_count_power = 8;
+            size_t coeff_count = size_t(1) << coeff_count_power;
+            GaloisTool tool(coeff_count_power);
+            vector<uint64_t> input(coeff_count);
+            for (size_t i = 0; i < coeff_count; i++)
+            {
+                input[i] = i;
+            }
+
+            // Threads race to create the same few tables
+            size_t task_count = 64;
+            vector<char> matches(task_count, 0);
+            ThreadPool pool(3);
+            pool.parallel_for(task_count, 4, [&](size_t begin, size_t end, size_t)
+            {
+                vector<uint64_t> expected(coeff_count);
+                vector<uint64_t> result(coeff_count);
+                for (size_t i = begin; i < end; i++)
+                {
+                    uint64_t galois_elt = 2 * (i % 4) + 3;
+                    apply_galois_ntt(input.data(), coeff_count_power, galois_elt,
+                        expected.data());
+                    tool.apply_galois_ntt(input.data(), galois_elt, result.data());
+                    matches[i] = (expected == result);
+                }
+            });
+            for (auto match : matches)
+            {
+                ASSERT_TRUE(match);
+            }
+            ASSERT_EQ(4ULL, tool.table_count());
+        }
+    }
+}
@@ -7,6 +7,7 @@
 #include "seal/util/polyarithsmallmod.h"
 #include <cstdint>
 #include <cstddef>
+#include <vector>
 
 using namespace seal;
 using namespace seal::util;
@@ -103,6 +104,28 @@ namespace SEALTest
             ASSERT_EQ(3ULL, poly[0]);
             ASSERT_EQ(4ULL, poly[1]);
             ASSERT_EQ(2ULL, poly[2]);
+
+            // Scalar larger than modulus
+            multiply_poly_scalar_coeffmod(poly.get(), 3, 7, mod, poly.get());
+            ASSERT_EQ(1ULL, poly[0]);
+            ASSERT_EQ(3ULL, poly[1]);
+            ASSERT_EQ(4ULL, poly[2]);
+
+            // Large modulus; inputs need not be reduced
+            SmallModulus mod2(0xFFFFFFFFFFFFFFFULL);
+            poly[0] = 0xFFFFFFFFFFFFFFEULL;
+            poly[1] = 0xFFFFFFFFFFFFFFFFULL;
+            poly[2] = 0x123456789ABCDEFULL;
+            scalar = 0xFFFFFFFFFFFFFFDULL;
+            vector<uint64_t> expected(3);
+            for (size_t i = 0; i < 3; i++)
+            {
+                expected[i] = multiply_uint_uint_mod(poly[i], scalar, mod2);
+            }
+            multiply_poly_scalar_coeffmod(poly.get(), 3, scalar, mod2, poly.get());
+            ASSERT_EQ(expected[0], poly[0]);
+            ASSERT_EQ(expected[1], poly[1]);
+            ASSERT_EQ(expected[2], poly[2]);
         }
 
         TEST(PolyArithSmallMod, MultiplyPolyPolyCoeffSmallMod)
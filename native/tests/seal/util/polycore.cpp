@@ -5,6 +5,7 @@
 #include "seal/util/polycore.h"
 #include "seal/util/uintarith.h"
 #include <cstdint>
+#include <vector>
 
 using namespace seal::util;
 using namespace std;
@@ -284,5 +285,24 @@ namespace SEALTest
             max[0] = 10;
             ASSERT_TRUE(are_poly_coefficients_less_than(poly.get(), 3, 2, max.get(), 1));
         }
+
+        TEST(PolyCore, ArePolyCoeffsLessThanSingleWord)
+        {
+            vector<uint64_t> poly{ 3, 0, 5, 4, 0xFFFFFFFFFFFFFFFE };
+            ASSERT_TRUE(are_poly_coefficients_less_than(poly.data(), 0, 0));
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 4, 0));
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 4, 5));
+            ASSERT_TRUE(are_poly_coefficients_less_than(poly.data(), 4, 6));
+            ASSERT_TRUE(are_poly_coefficients_less_than(poly.data(), 4, uint64_t(1) << 63));
+
+            // Coefficients and bounds of 2^63 and above
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 5, 6));
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 5, uint64_t(1) << 63));
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 5, 0xFFFFFFFFFFFFFFFE));
+            ASSERT_TRUE(are_poly_coefficients_less_than(poly.data(), 5, 0xFFFFFFFFFFFFFFFF));
+            poly[1] = uint64_t(1) << 63;
+            ASSERT_FALSE(are_poly_coefficients_less_than(poly.data(), 4, uint64_t(1) << 63));
+            ASSERT_TRUE(are_poly_coefficients_less_than(poly.data(), 4, (uint64_t(1) << 63) + 1));
+        }
    }
 }
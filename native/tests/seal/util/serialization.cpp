@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/serialization.h"
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace seal;
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+    namespace util
+    {
+        TEST(SerializationTest, PackedUInt64Count)
+        {
+            ASSERT_EQ(0ULL, packed_uint64_count(0, 30));
+            ASSERT_EQ(0ULL, packed_uint64_count(100, 0));
+            ASSERT_EQ(1ULL, packed_uint64_count(1, 1));
+            ASSERT_EQ(1ULL, packed_uint64_count(2, 32));
+            ASSERT_EQ(2ULL, packed_uint64_count(3, 30));
+            ASSERT_EQ(30ULL, packed_uint64_count(64, 30));
+            ASSERT_EQ(7ULL, packed_uint64_count(7, 64));
+
+            uint64_t values[]{ 0, 1, 0x10, 0x3 };
+            ASSERT_EQ(5, get_max_significant_bit_count(values, 4));
+            ASSERT_EQ(0, get_max_significant_bit_count(values, 1));
+            ASSERT_EQ(0, get_max_significant_bit_count(values, 0));
+        }
+
+        TEST(SerializationTest, PackUnpackUInt)
+        {
+            mt19937_64 engine(17);
+            for (int bit_count = 0; bit_count <= 64; bit_count++)
+            {
+                uint64_t mask = (bit_count == 64) ? ~uint64_t(0) :
+                    (uint64_t(1) << bit_count) - 1;
+                for (size_t count : { size_t(1), size_t(63), size_t(64), size_t(131) })
+                {
+                    vector<uint64_t> values(count);
+                    for (auto &value : values)
+                    {
+                        value = engine() & mask;
+                    }
+
+                    vector<uint64_t> packed(packed_uint64_count(count, bit_count) + 1, 0xABCD);
+                    pack_uint(values.data(), count, bit_count, packed.data());
+                    ASSERT_EQ(0xABCDULL, packed.back());
+
+                    vector<uint64_t> unpacked(count, 0xFFFF);
+                    unpack_uint(packed.data(), count, bit_count, unpacked.data());
+                    ASSERT_TRUE(values == unpacked);
+                }
+            }
+
+            // Values are laid out from the least significant bit
+            uint64_t values[]{ 1, 2, 3, 0x1F };
+            uint64_t packed[1]{};
+            pack_uint(values, 4, 5, packed);
+            ASSERT_EQ(0xF8C41ULL, packed[0]);
+        }
+
+        TEST(SerializationTest, SaveLoadPackedUInt)
+        {
+            mt19937_64 engine(23);
+            for (int bit_count : { 0, 17, 60, 64 })
+            {
+                uint64_t mask = (bit_count == 64) ? ~uint64_t(0) :
+                    (uint64_t(1) << bit_count) - 1;
+
+                // Spans several internal chunks
+                size_t count = 1500;
+                vector<uint64_t> values(count);
+                for (auto &value : values)
+                {
+                    value = engine() & mask;
+                }
+
+                stringstream stream;
+                save_packed_uint(values.data(), count, bit_count, stream);
+                ASSERT_EQ(packed_uint64_count(count, bit_count) * sizeof(uint64_t),
+                    stream.str().size());
+
+                vector<uint64_t> loaded(count);
+                load_packed_uint(stream, count, bit_count, loaded.data());
+                ASSERT_TRUE(values == loaded);
+            }
+
+            stringstream stream;
+            uint64_t value = 0;
+            ASSERT_THROW(load_packed_uint(stream, 1, 65, &value), invalid_argument);
+        }
+
+        TEST(SerializationTest, SaveLoadVersioned)
+        {
+            // Spans several compressed chunks, some of which do not compress
+            mt19937_64 engine(29);
+            vector<uint64_t> values(600000);
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                values[i] = (i < 300000) ? (i & 0xFF) : engine();
+            }
+            auto save_members = [&](ostream &stream)
+            {
+                stream.write(reinterpret_cast<const char*>(values.data()),
+                    static_cast<streamsize>(values.size() * sizeof(uint64_t)));
+            };
+            vector<uint64_t> loaded(values.size());
+            auto load_members = [&](istream &stream)
+            {
+                stream.read(reinterpret_cast<char*>(loaded.data()),
+                    static_cast<streamsize>(loaded.size() * sizeof(uint64_t)));
+            };
+
+            for (auto compr_mode : { compr_mode_type::none, compr_mode_type::lz })
+            {
+                stringstream stream;
+                save_versioned(stream, compr_mode, save_members);
+                if (compr_mode != compr_mode_type::none)
+                {
+                    ASSERT_GT(values.size() * sizeof(uint64_t), stream.str().size());
+                }
+                uint64_t magic = 0;
+                stream.read(reinterpret_cast<char*>(&magic), sizeof(uint64_t));
+                ASSERT_EQ(serialization_magic, magic);
+                fill(loaded.begin(), loaded.end(), uint64_t(0));
+                load_versioned(stream, load_members);
+                ASSERT_TRUE(values == loaded);
+            }
+
+            // Chunk sizes beyond the chunk size limit are rejected before
+            // anything of that size is allocated
+            auto forge = [](uint8_t version, uint64_t size, uint64_t compressed_size)
+            {
+                auto stream = make_shared<stringstream>();
+                stream->put(static_cast<char>(version));
+                stream->put(static_cast<char>(compr_mode_type::lz));
+                uint64_t sizes[]{ size, compressed_size };
+                stream->write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+                stream->exceptions(ios_base::badbit | ios_base::failbit);
+                return stream;
+            };
+            ASSERT_THROW(load_versioned(*forge(serialization_version,
+                uint64_t(1) << 60, 100), load_members), invalid_argument);
+
+            // Only the current version is accepted
+            ASSERT_THROW(load_versioned(*forge(
+                static_cast<uint8_t>(serialization_version + 1), 0, 0),
+                load_members), invalid_argument);
+        }
+    }
+}
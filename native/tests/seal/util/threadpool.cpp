@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "gtest/gtest.h"
+#include "seal/util/threadpool.h"
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+using namespace seal::util;
+using namespace std;
+
+namespace SEALTest
+{
+   namespace util
+   {
+        TEST(ThreadPoolTest, ParallelForCoverage)
+        {
+            ThreadPool pool(3);
+            ASSERT_EQ(3ULL, pool.worker_count());
+            ASSERT_EQ(4ULL, pool.max_thread_count());
+
+            // Empty range does nothing
+            atomic<size_t> calls{ 0 };
+            pool.parallel_for(0, 0, [&](size_t, size_t, size_t) { calls++; });
+            ASSERT_EQ(0ULL, calls.load());
+
+            for (size_t count : { size_t(1), size_t(7), size_t(100), size_t(1000) })
+            {
+                for (size_t thread_count = 0; thread_count <= 5; thread_count++)
+                {
+                    vector<atomic<int>> hits(count);
+                    atomic<bool> bad_thread_index{ false };
+                    size_t expected_threads = thread_count ? thread_count : 4;
+                    pool.parallel_for(count, thread_count,
+                        [&](size_t begin, size_t end, size_t thread_index) {
+                            if (thread_index >= expected_threads)
+                            {
+                                bad_thread_index = true;
+                            }
+                            for (size_t i = begin; i < end; i++)
+                            {
+                                hits[i]++;
+                            }
+                        });
+                    ASSERT_FALSE(bad_thread_index.load());
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        ASSERT_EQ(1, hits[i].load());
+                    }
+                }
+            }
+        }
+
+        TEST(ThreadPoolTest, ParallelForDistinctThreadIndices)
+        {
+            ThreadPool pool(3);
+
+            // Per-thread state indexed by thread_index must never be shared
+            vector<atomic<int>> in_use(4);
+            atomic<bool> collision{ false };
+            pool.parallel_for(10000, 0,
+                [&](size_t begin, size_t end, size_t thread_index) {
+                    if (in_use[thread_index]++)
+                    {
+                        collision = true;
+                    }
+                    volatile size_t sum = 0;
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        sum += i;
+                    }
+                    in_use[thread_index]--;
+                });
+            ASSERT_FALSE(collision.load());
+        }
+
+        TEST(ThreadPoolTest, ParallelForNested)
+        {
+            ThreadPool pool(2);
+            atomic<size_t> total{ 0 };
+            pool.parallel_for(8, 0, [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    pool.parallel_for(16, 0, [&](size_t b, size_t e, size_t) {
+                        total += e - b;
+                    });
+                }
+            });
+            ASSERT_EQ(128ULL, total.load());
+        }
+
+        TEST(ThreadPoolTest, ParallelForException)
+        {
+            ThreadPool pool(3);
+            ASSERT_THROW(pool.parallel_for(100, 0,
+                [](size_t begin, size_t end, size_t) {
+                    if (begin <= 50 && 50 < end)
+                    {
+                        throw runtime_error("task failed");
+                    }
+                }), runtime_error);
+
+            // The pool remains usable after an exception
+            atomic<size_t> total{ 0 };
+            pool.parallel_for(100, 0, [&](size_t begin, size_t end, size_t) {
+                total += end - begin;
+            });
+            ASSERT_EQ(100ULL, total.load());
+
+            // Inline execution also propagates exceptions
+            ASSERT_THROW(pool.parallel_for(10, 1,
+                [](size_t, size_t, size_t) { throw invalid_argument("bad"); }),
+                invalid_argument);
+        }
+    }
+}
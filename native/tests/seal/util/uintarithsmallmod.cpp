@@ -183,6 +183,34 @@ namespace SEALTest
             ASSERT_EQ(1010101010101ULL, barrett_reduce_128(input, mod));
         }
 
+        TEST(UIntArithSmallMod, BarrettReduce64)
+        {
+            SmallModulus mod(2);
+            ASSERT_EQ(0ULL, barrett_reduce_64(0ULL, mod));
+            ASSERT_EQ(1ULL, barrett_reduce_64(1ULL, mod));
+            ASSERT_EQ(1ULL, barrett_reduce_64(0xFFFFFFFFFFFFFFFFULL, mod));
+
+            mod = 3;
+            ASSERT_EQ(0ULL, barrett_reduce_64(0ULL, mod));
+            ASSERT_EQ(1ULL, barrett_reduce_64(1ULL, mod));
+            ASSERT_EQ(0ULL, barrett_reduce_64(123ULL, mod));
+            ASSERT_EQ(0ULL, barrett_reduce_64(0xFFFFFFFFFFFFFFFFULL, mod));
+
+            mod = 13131313131313ULL;
+            ASSERT_EQ(0ULL, barrett_reduce_64(0ULL, mod));
+            ASSERT_EQ(1ULL, barrett_reduce_64(1ULL, mod));
+            ASSERT_EQ(123ULL, barrett_reduce_64(123ULL, mod));
+            ASSERT_EQ(0ULL, barrett_reduce_64(13131313131313ULL, mod));
+            ASSERT_EQ(0xFFFFFFFFFFFFFFFFULL % 13131313131313ULL,
+                barrett_reduce_64(0xFFFFFFFFFFFFFFFFULL, mod));
+
+            mod = 0x3FFFFFFFFFFFFFFFULL;
+            ASSERT_EQ(0ULL, barrett_reduce_64(0x3FFFFFFFFFFFFFFFULL, mod));
+            ASSERT_EQ(3ULL, barrett_reduce_64(0xFFFFFFFFFFFFFFFFULL, mod));
+            ASSERT_EQ(0x3FFFFFFFFFFFFFFEULL,
+                barrett_reduce_64(0xBFFFFFFFFFFFFFFCULL, mod));
+        }
+
         TEST(UIntArithSmallMod, MultiplyUIntUIntSmallMod)
         {
             SmallModulus mod(2);